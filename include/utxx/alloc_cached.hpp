@@ -87,7 +87,6 @@ class cached_allocator {
         return allocator;
     }
 
-    void* alloc_size_class(size_t size_class);
 public:
     typedef ::std::size_t    size_type;
     typedef ::std::ptrdiff_t difference_type;
@@ -130,6 +129,18 @@ public:
     void destroy(T* obj) { obj->~T(); }
 #endif
 
+    /// Allocate a chunk of the given size class. This operation is thread-safe.
+    /// Chunks of size classes above max_size_class bypass the free lists.
+    void* alloc_size_class(size_t size_class);
+
+    /// Size class of a chunk needed to satisfy a request of \a sz bytes.
+    static int size_class_of(size_t sz) {
+        size_t alloc_sz = sz + versioned_stack::header_size();
+        return (alloc_sz < min_size)
+             ? log<upper_power<min_size, 2>::value, 2>::value
+             : math::upper_log2(alloc_sz);
+    }
+
     /// For internal use.
     void free_node(node_t* nd);
     static node_t* to_node(void* p) { return node_t::to_node(p); }
@@ -164,13 +175,7 @@ template <class T, class AllocT, int MinSize, int SizeClasses>
 inline T* cached_allocator<T, AllocT, MinSize, SizeClasses>
 ::allocate(size_t count) 
 {
-    using namespace container;
-
-    size_t alloc_sz = sizeof(T)*count + versioned_stack::header_size();
-    char size_class = (alloc_sz < min_size)
-              ? upper_power<min_size, 2>::value 
-              : math::upper_log2(alloc_sz);
-    return static_cast<T*>(alloc_size_class(size_class));
+    return static_cast<T*>(alloc_size_class(size_class_of(sizeof(T)*count)));
 }
 
 template <class T, class AllocT, int MinSize, int SizeClasses>
@@ -199,10 +204,7 @@ void* cached_allocator<T, AllocT, MinSize, SizeClasses>
     BOOST_ASSERT(nd->valid());
 
     char old_size_class = nd->size_class();
-    size_t alloc_sz     = sz + versioned_stack::header_size();
-    char new_size_class = (alloc_sz < min_size)
-                        ? log<min_size, 2>::value
-                        : math::upper_log2(alloc_sz);
+    char new_size_class = size_class_of(sz);
     if (new_size_class <= old_size_class)
         return p;
 
@@ -213,7 +215,8 @@ void* cached_allocator<T, AllocT, MinSize, SizeClasses>
     // Copy old data
     node_t* nnd = node_t::to_node(pnew);
     void* data = nnd->data();
-    memcpy(data, nd->data(), old_size_class - versioned_stack::header_size());
+    memcpy(data, nd->data(),
+           (size_t(1) << old_size_class) - versioned_stack::header_size());
     // Free old node
     free(p);
     return data;
@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/noncopyable.hpp>
 #include <boost/cstdint.hpp>
 #include <utxx/atomic.hpp>
+#include <utxx/alloc_page_policy.hpp>
 #include <stdlib.h>
 #ifdef _ALLOCATOR_MEM_DEBUG
 #include <stdio.h>
@@ -56,10 +57,15 @@ namespace memory {
  * deallocation method is very weak for cases when some of the
  * objects in the page have short lifetime and some have long
  * lifetime.
+ * The PagePolicy determines the backing of the pages (see
+ * alloc_page_policy.hpp), e.g. use
+ * mmap_page_policy<page_kind::HUGETLB, Node, true> with a 2M page size
+ * for a pre-faulted huge-page pool bound to a NUMA node.
  */
 template <
       typename T
-    , size_t   PageSize  = 64*1024
+    , size_t   PageSize   = 64*1024
+    , typename PagePolicy = heap_page_policy
 >
 class aligned_page_allocator : public boost::noncopyable {
     struct header {
@@ -90,14 +96,7 @@ class aligned_page_allocator : public boost::noncopyable {
             char*   pc;
             header* p;
         } u;
-        #if defined(_WIN32) || defined (_WIN64)
-        u.pp = _aligned_malloc(PageSize, PageSize);
-        if (!u.pp)
-            throw std::bad_alloc();
-        #else
-        if (posix_memalign(&u.pp, PageSize, PageSize) < 0)
-            throw std::bad_alloc();
-        #endif
+        u.pp = PagePolicy::allocate(PageSize, PageSize);
         BOOST_ASSERT((u.n & s_page_mask) == 0);
         new (u.p) header();
         u.p->avail_chunk = reinterpret_cast<T*>(u.pc + s_begin_offset);
@@ -112,12 +111,7 @@ class aligned_page_allocator : public boost::noncopyable {
         #ifdef _ALLOCATOR_MEM_DEBUG
         printf("Freeing page %p\n", p);
         #endif
-
-        #if defined(_WIN32) || defined (_WIN64)
-        _aligned_free(p);
-        #else
-        free(p);
-        #endif
+        PagePolicy::deallocate(p, PageSize);
     }
 
 public:
@@ -130,7 +124,7 @@ public:
     
     template <typename U>
     struct rebind {
-        typedef aligned_page_allocator<U, PageSize> other;
+        typedef aligned_page_allocator<U, PageSize, PagePolicy> other;
     };
 
     aligned_page_allocator() : m_page(page_alloc()) {
@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+/// \file   alloc_page_policy.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Page backing policies for paged allocators and shared memory.
+///
+/// By default paged allocators obtain memory from the heap, which is backed
+/// by regular 4K pages placed on whichever NUMA node first touches them.
+/// Large pools of such memory suffer from TLB misses and cross-socket
+/// accesses.  This module provides:
+///
+///   - page_options describing the backing of a memory region: regular,
+///     transparent huge pages (THP) or explicit huge pages (MAP_HUGETLB),
+///     an optional NUMA node the region is bound to, and optional
+///     pre-faulting of the region at allocation time;
+///   - map_pages() / unmap_pages() / apply_page_options() functions
+///     implementing these options for anonymous and file-backed mappings;
+///   - heap_page_policy and mmap_page_policy types that can be passed as
+///     the PagePolicy parameter of aligned_page_allocator and
+///     concurrent_aligned_page_allocator.
+///
+/// NUMA binding is done with the mbind(2) system call directly, so there's
+/// no dependency on libnuma.  Binding failures (e.g. on a non-NUMA kernel)
+/// are not fatal: the memory is then placed by the first-touch rule, and
+/// pre-faulting from a thread pinned to the desired node achieves the same
+/// placement.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_ALLOC_PAGE_POLICY_HPP_
+#define _UTXX_ALLOC_PAGE_POLICY_HPP_
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace utxx   {
+namespace memory {
+
+/// Kind of pages backing a memory region
+enum class page_kind {
+      REGULAR           ///< Regular pages of the system's page size
+    , TRANSPARENT_HUGE  ///< Regular mapping advised to use THP (MADV_HUGEPAGE)
+    , HUGETLB           ///< Explicit huge pages (MAP_HUGETLB), falls back to
+                        ///< TRANSPARENT_HUGE if no huge pages are reserved
+};
+
+/// Backing options of a memory region
+struct page_options {
+    page_kind kind;
+    int       numa_node;    ///< NUMA node to bind the region to (-1 - any)
+    bool      numa_strict;  ///< MPOL_BIND if true, else MPOL_PREFERRED
+    bool      prefault;     ///< Fault in all pages at allocation time
+
+    constexpr page_options
+    (
+        page_kind a_kind   = page_kind::REGULAR,
+        int  a_numa_node   = -1,
+        bool a_prefault    = false,
+        bool a_numa_strict = true
+    )
+        : kind(a_kind), numa_node(a_numa_node)
+        , numa_strict(a_numa_strict), prefault(a_prefault)
+    {}
+};
+
+/// Size of the system's regular page
+inline size_t sys_page_size() {
+    static const size_t s_size = ::sysconf(_SC_PAGESIZE);
+    return s_size;
+}
+
+/// Default huge page size from /proc/meminfo (2M if unavailable)
+inline size_t huge_page_size() {
+    static const size_t s_size = [] {
+        size_t sz = 0;
+        if (FILE* f = ::fopen("/proc/meminfo", "r")) {
+            char line[128];
+            while (::fgets(line, sizeof(line), f))
+                if (::sscanf(line, "Hugepagesize: %zu kB", &sz) == 1) {
+                    sz *= 1024;
+                    break;
+                }
+            ::fclose(f);
+        }
+        return sz ? sz : size_t(2*1024*1024);
+    }();
+    return s_size;
+}
+
+namespace detail {
+    inline size_t page_granularity(page_kind a_kind) {
+        return a_kind == page_kind::HUGETLB ? huge_page_size() : sys_page_size();
+    }
+
+    inline size_t round_up(size_t a_sz, size_t a_align) {
+        return (a_sz + a_align - 1) & ~(a_align - 1);
+    }
+}
+
+/// Bind the region to a NUMA node using mbind(2).
+/// @return 0 on success or errno value on failure
+inline int bind_numa_node(void* a_addr, size_t a_sz, int a_node, bool a_strict = true) {
+    #ifdef SYS_mbind
+    static const int s_mpol_preferred = 1, s_mpol_bind = 2;
+    static const int s_bits = 8 * sizeof(unsigned long);
+    unsigned long mask[1024 / s_bits];
+
+    if (a_node < 0 || a_node >= 1024)
+        return EINVAL;
+    ::memset(mask, 0, sizeof(mask));
+    mask[a_node / s_bits] = 1ul << (a_node % s_bits);
+
+    long rc = ::syscall(SYS_mbind, a_addr, a_sz,
+                        a_strict ? s_mpol_bind : s_mpol_preferred,
+                        mask, sizeof(mask) * 8 + 1, 0);
+    return rc == 0 ? 0 : errno;
+    #else
+    return ENOSYS;
+    #endif
+}
+
+/// Fault in all pages of the region by writing to them.  This doesn't
+/// modify the content of the region, and is safe for shared memory that
+/// other processes may concurrently update.
+inline void prefault_pages(void* a_addr, size_t a_sz) {
+    #ifdef MADV_POPULATE_WRITE
+    static const int s_populate_write = MADV_POPULATE_WRITE;
+    #else
+    static const int s_populate_write = 23;
+    #endif
+    if (::madvise(a_addr, a_sz, s_populate_write) == 0)
+        return;
+    // Kernels older than 5.14: touch every page
+    const size_t step = sys_page_size();
+    char*        p    = static_cast<char*>(a_addr);
+    for (char* e = p + a_sz; p < e; p += step)
+        __sync_fetch_and_add(p, 0);
+}
+
+/// Apply THP advice, NUMA binding and pre-faulting to an existing mapping.
+/// The region must be aligned on the system page size.
+/// @return 0 on success or the errno value of the NUMA binding failure
+///         (the other steps are best effort)
+inline int apply_page_options(void* a_addr, size_t a_sz, const page_options& a_opts) {
+    #ifdef MADV_HUGEPAGE
+    if (a_opts.kind == page_kind::TRANSPARENT_HUGE)
+        ::madvise(a_addr, a_sz, MADV_HUGEPAGE);
+    #endif
+    // Binding must precede faulting the pages in
+    int rc = a_opts.numa_node < 0
+           ? 0 : bind_numa_node(a_addr, a_sz, a_opts.numa_node, a_opts.numa_strict);
+    if (a_opts.prefault)
+        prefault_pages(a_addr, a_sz);
+    return rc;
+}
+
+/// Size of a mapping created by map_pages() for a request of \a a_sz bytes
+inline size_t mapped_size(size_t a_sz, const page_options& a_opts) {
+    return detail::round_up(a_sz, detail::page_granularity(a_opts.kind));
+}
+
+/// Map an anonymous private region of at least \a a_sz bytes aligned on
+/// \a a_align boundary (a power of 2) with the given backing options.
+/// @return pointer to the region or NULL on failure
+inline void* map_pages(size_t a_sz, size_t a_align, const page_options& a_opts) {
+    page_options opts = a_opts;
+    size_t       gran = detail::page_granularity(opts.kind);
+    size_t       len  = detail::round_up(a_sz, gran);
+    size_t       extra= a_align > gran ? a_align : 0;
+    int          flags= MAP_PRIVATE | MAP_ANONYMOUS;
+    void*        p    = MAP_FAILED;
+
+    #ifdef MAP_HUGETLB
+    if (opts.kind == page_kind::HUGETLB) {
+        p = ::mmap(NULL, len + extra, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED)
+            opts.kind = page_kind::TRANSPARENT_HUGE;
+    }
+    #endif
+    if (p == MAP_FAILED) {
+        if (opts.kind == page_kind::HUGETLB)
+            opts.kind = page_kind::TRANSPARENT_HUGE;
+        // Regular pages are only aligned on the system page size
+        extra = a_align > sys_page_size() ? a_align : 0;
+        p = ::mmap(NULL, len + extra, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED)
+            return NULL;
+    }
+
+    // Trim the mapping to the requested alignment
+    if (extra) {
+        char* b = static_cast<char*>(p);
+        char* a = reinterpret_cast<char*>(
+                    detail::round_up(reinterpret_cast<size_t>(b), a_align));
+        if (a != b)
+            ::munmap(b, a - b);
+        if (size_t tail = (b + len + extra) - (a + len))
+            ::munmap(a + len, tail);
+        p = a;
+    }
+
+    apply_page_options(p, len, opts);
+    return p;
+}
+
+/// Unmap a region obtained from map_pages() with the same size and options.
+inline void unmap_pages(void* a_addr, size_t a_sz, const page_options& a_opts) {
+    if (a_addr)
+        ::munmap(a_addr, mapped_size(a_sz, a_opts));
+}
+
+//-----------------------------------------------------------------------------
+// PAGE POLICIES
+//-----------------------------------------------------------------------------
+
+/// Allocate pages from the heap (posix_memalign)
+struct heap_page_policy {
+    static void* allocate(size_t a_sz, size_t a_align) {
+        void* p;
+        #if defined(_WIN32) || defined (_WIN64)
+        p = _aligned_malloc(a_sz, a_align);
+        if (!p)
+            throw std::bad_alloc();
+        #else
+        if (::posix_memalign(&p, a_align, a_sz) != 0)
+            throw std::bad_alloc();
+        #endif
+        return p;
+    }
+
+    static void deallocate(void* a_addr, size_t) {
+        #if defined(_WIN32) || defined (_WIN64)
+        _aligned_free(a_addr);
+        #else
+        ::free(a_addr);
+        #endif
+    }
+};
+
+/// Allocate pages from anonymous memory mappings.  Each allocation is a
+/// separate mapping, so with HUGETLB pages the allocator's page size should
+/// be a multiple of the huge page size.
+/// @tparam Kind     kind of pages backing the mappings
+/// @tparam NumaNode NUMA node to bind the mappings to (-1 - no binding)
+/// @tparam Prefault fault in the pages of a mapping at allocation time
+template <
+      page_kind Kind     = page_kind::TRANSPARENT_HUGE
+    , int       NumaNode = -1
+    , bool      Prefault = false
+>
+struct mmap_page_policy {
+    static constexpr page_options options() {
+        return page_options(Kind, NumaNode, Prefault);
+    }
+
+    static void* allocate(size_t a_sz, size_t a_align) {
+        void* p = map_pages(a_sz, a_align, options());
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    static void deallocate(void* a_addr, size_t a_sz) {
+        unmap_pages(a_addr, a_sz, options());
+    }
+};
+
+} // namespace memory
+} // namespace utxx
+
+#endif // _UTXX_ALLOC_PAGE_POLICY_HPP_
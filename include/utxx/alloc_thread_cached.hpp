@@ -0,0 +1,391 @@
+//----------------------------------------------------------------------------
+/// \file   alloc_thread_cached.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Thread-caching front end for size-class allocators
+///
+/// This module implements a per-thread magazine layer (see J.Bonwick
+/// "Magazines and Vmem", USENIX 2001) in front of a concurrent size-class
+/// allocator such as memory::cached_allocator or memory::pow2_allocator.
+/// Allocations and deallocations are served from thread-local arrays of
+/// pointers without any atomic operations.  Only when a thread's magazines
+/// run empty (or full) a whole magazine is exchanged with a global depot
+/// using a single ABA-safe double-word CAS, so the shared free list heads
+/// of the back-end allocator are touched once per batch rather than once
+/// per object.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_ALLOC_THREAD_CACHED_HPP_
+#define _UTXX_ALLOC_THREAD_CACHED_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <utxx/atomic.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/thread_local.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace utxx   {
+namespace memory {
+
+namespace detail {
+    //-------------------------------------------------------------------------
+    /// Lock-free intrusive stack of nodes having a \a next member.
+    /// The head pointer is tagged with a modification counter updated with
+    /// a double-word CAS, so the stack is not subject to the ABA problem.
+    /// Nodes pushed to the stack must not be freed while the stack is in use.
+    //-------------------------------------------------------------------------
+    template <class Node>
+    class tagged_stack {
+        struct head_t {
+            Node*         ptr;
+            unsigned long tag;
+        } __attribute__((aligned(16)));
+
+        volatile head_t m_head;
+
+        head_t load() const {
+            head_t h;
+            h.tag = m_head.tag;
+            atomic::memory_barrier();
+            h.ptr = m_head.ptr;
+            return h;
+        }
+    public:
+        tagged_stack() { m_head.ptr = nullptr; m_head.tag = 0; }
+
+        void push(Node* a_node) {
+            head_t old_head, new_head;
+            do {
+                old_head      = load();
+                a_node->next  = old_head.ptr;
+                new_head.ptr  = a_node;
+                new_head.tag  = old_head.tag + 1;
+            } while (!atomic::dcas(&m_head, old_head, new_head));
+        }
+
+        Node* pop() {
+            head_t old_head, new_head;
+            do {
+                old_head = load();
+                if (!old_head.ptr)
+                    return nullptr;
+                new_head.ptr = old_head.ptr->next;
+                new_head.tag = old_head.tag + 1;
+            } while (!atomic::dcas(&m_head, old_head, new_head));
+            return old_head.ptr;
+        }
+
+        bool empty() const { return m_head.ptr == nullptr; }
+    };
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+// THREAD_CACHED_ALLOCATOR
+//-----------------------------------------------------------------------------
+
+/// Thread-caching front end of a concurrent size-class allocator.
+///
+/// Each thread owns a pair of magazines (arrays of up to \a MagazineSize
+/// cached chunk pointers) per size class.  An allocation pops a pointer off
+/// the loaded magazine, and a deallocation pushes it back.  When both of a
+/// thread's magazines are exhausted a full magazine is taken from the global
+/// depot, or if the depot is empty the loaded magazine is refilled from the
+/// back-end allocator in one batch.  When both magazines are full, one of them
+/// is handed over to the depot.  The depot keeps at most \a a_max_depot full
+/// magazines per size class - the excess is released to the back-end.
+///
+/// A chunk may be freed by a thread other than the one that allocated it.
+/// The chunk simply lands in the freeing thread's magazine and, in a
+/// producer/consumer setup, travels back to the allocating thread through
+/// the depot one magazine at a time.
+///
+/// On thread exit the thread's magazines are returned to the depot.
+///
+/// @tparam Backend must provide the following interface
+///     (implemented by cached_allocator and pow2_allocator):
+/// <code>
+///     static const unsigned max_size_class;
+///     static int    size_class_of(size_t bytes);
+///     static size_t size_class(void* p);
+///     void*         alloc_size_class(size_t size_class);
+///     void          free(void* p);
+/// </code>
+/// @tparam MagazineSize number of chunk pointers per magazine.
+/// @tparam Tag          thread-local tag (see utxx::thr_local_ptr).
+template <class Backend, int MagazineSize = 64, class Tag = Backend>
+class thread_cached_allocator : private boost::noncopyable {
+    static_assert(MagazineSize > 1, "Invalid magazine size");
+
+    static const int s_classes = Backend::max_size_class + 1;
+
+    struct magazine {
+        magazine* next;
+        int       count;
+        void*     items[MagazineSize];
+
+        magazine() : next(nullptr), count(0) {}
+        bool empty() const { return count == 0;            }
+        bool full()  const { return count == MagazineSize; }
+    };
+
+    using mag_stack = detail::tagged_stack<magazine>;
+
+    struct depot {
+        mag_stack        full;
+        mag_stack        empty;
+        std::atomic<int> full_count;
+        depot() : full_count(0) {}
+    } __attribute__((aligned(UTXX_CL_SIZE)));
+
+    // Cache of a single thread. It's only ever modified by its owner thread
+    // except on destruction of the parent allocator.
+    struct thread_cache {
+        struct slot {
+            magazine* loaded;
+            magazine* previous;
+        };
+
+        thread_cached_allocator* m_parent;
+        slot                     m_slots[s_classes];
+
+        explicit thread_cache(thread_cached_allocator& a_parent)
+            : m_parent(&a_parent), m_slots()
+        {}
+
+        ~thread_cache() {
+            if (m_parent)
+                m_parent->release_cache(*this, false);
+        }
+    };
+
+public:
+    static const unsigned int max_size_class = Backend::max_size_class;
+
+    explicit thread_cached_allocator(Backend& a_backend, int a_max_depot = 64)
+        : m_backend(a_backend), m_max_depot(a_max_depot)
+    {}
+
+    ~thread_cached_allocator();
+
+    /// Allocate \a a_size bytes. This operation is thread-safe.
+    void* allocate(size_t a_size) {
+        return alloc_size_class(Backend::size_class_of(a_size));
+    }
+
+    /// Allocate a chunk of a given size class. This operation is thread-safe.
+    void* alloc_size_class(size_t a_class) {
+        if (UNLIKELY(a_class > max_size_class))
+            return m_backend.alloc_size_class(a_class);
+
+        magazine* m = local()->m_slots[a_class].loaded;
+        return LIKELY(m && !m->empty())
+             ? m->items[--m->count] : refill(a_class);
+    }
+
+    /// Free a chunk. It may have been allocated by another thread.
+    void free(void* a_ptr) {
+        if (UNLIKELY(!a_ptr)) return;
+
+        size_t a_class = Backend::size_class(a_ptr);
+        if (UNLIKELY(a_class > max_size_class)) {
+            m_backend.free(a_ptr);
+            return;
+        }
+
+        magazine* m = local()->m_slots[a_class].loaded;
+        if (LIKELY(m && !m->full()))
+            m->items[m->count++] = a_ptr;
+        else
+            flush(a_class, a_ptr);
+    }
+
+    void deallocate(void* a_ptr, size_t) { free(a_ptr); }
+
+    /// Return the calling thread's cached chunks to the depot.
+    void flush_thread_cache() { release_cache(*local(), false); }
+
+    /// Number of full magazines in the depot of a given size class.
+    int depot_size(size_t a_class) const {
+        return a_class > max_size_class
+             ? -1 : m_depot[a_class].full_count.load(std::memory_order_relaxed);
+    }
+
+    Backend&       backend()       { return m_backend; }
+    const Backend& backend() const { return m_backend; }
+
+private:
+    Backend&                        m_backend;
+    const int                       m_max_depot;
+    depot                           m_depot[s_classes];
+    thr_local_ptr<thread_cache,Tag> m_cache;    // Must be last for dtor ordering
+
+    thread_cache* local() {
+        thread_cache* cache = m_cache.get();
+        if (UNLIKELY(!cache || !cache->m_parent)) {
+            cache = new thread_cache(*this);
+            m_cache.reset(cache);
+        }
+        return cache;
+    }
+
+    magazine* get_empty(size_t a_class) {
+        magazine* m = m_depot[a_class].empty.pop();
+        return m ? m : new magazine();
+    }
+
+    void put_full(size_t a_class, magazine* a_mag) {
+        depot& d = m_depot[a_class];
+        if (d.full_count.fetch_add(1, std::memory_order_relaxed) < m_max_depot) {
+            d.full.push(a_mag);
+            return;
+        }
+        // The depot is over the limit - return the chunks to the back-end
+        d.full_count.fetch_sub(1, std::memory_order_relaxed);
+        drain(a_mag);
+        d.empty.push(a_mag);
+    }
+
+    magazine* get_full(size_t a_class) {
+        depot&    d = m_depot[a_class];
+        magazine* m = d.full.pop();
+        if (m) d.full_count.fetch_sub(1, std::memory_order_relaxed);
+        return m;
+    }
+
+    void drain(magazine* a_mag) {
+        for (int i = 0; i < a_mag->count; ++i)
+            m_backend.free(a_mag->items[i]);
+        a_mag->count = 0;
+    }
+
+    void* refill(size_t a_class);
+    void  flush (size_t a_class, void* a_ptr);
+    void  release_cache(thread_cache& a_cache, bool a_drain);
+};
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+template <class Backend, int MagazineSize, class Tag>
+thread_cached_allocator<Backend, MagazineSize, Tag>::
+~thread_cached_allocator()
+{
+    for (auto& cache : m_cache.access_all_threads()) {
+        release_cache(cache, true);
+        cache.m_parent = nullptr;
+    }
+
+    for (auto& d : m_depot) {
+        for (magazine* m; (m = d.full.pop()) != nullptr; ) {
+            drain(m);
+            delete m;
+        }
+        for (magazine* m; (m = d.empty.pop()) != nullptr; )
+            delete m;
+    }
+}
+
+template <class Backend, int MagazineSize, class Tag>
+void* thread_cached_allocator<Backend, MagazineSize, Tag>::
+refill(size_t a_class)
+{
+    auto& s = local()->m_slots[a_class];
+
+    // The previous magazine is either full or empty
+    if (s.previous && !s.previous->empty()) {
+        std::swap(s.loaded, s.previous);
+        return s.loaded->items[--s.loaded->count];
+    }
+
+    magazine* m = get_full(a_class);
+    if (m) {
+        if (s.previous)
+            m_depot[a_class].empty.push(s.previous);
+        s.previous = s.loaded;
+        s.loaded   = m;
+        return m->items[--m->count];
+    }
+
+    // The depot is empty - refill the loaded magazine from the back-end
+    if (!s.loaded)
+        s.loaded = get_empty(a_class);
+
+    m = s.loaded;
+    while (m->count < MagazineSize) {
+        void* p = m_backend.alloc_size_class(a_class);
+        if (UNLIKELY(!p)) break;
+        m->items[m->count++] = p;
+    }
+    return m->empty() ? nullptr : m->items[--m->count];
+}
+
+template <class Backend, int MagazineSize, class Tag>
+void thread_cached_allocator<Backend, MagazineSize, Tag>::
+flush(size_t a_class, void* a_ptr)
+{
+    auto& s = local()->m_slots[a_class];
+
+    if (!s.loaded)
+        s.loaded = get_empty(a_class);
+    else if (s.previous && s.previous->empty())
+        std::swap(s.loaded, s.previous);
+    else {
+        if (s.previous)
+            put_full(a_class, s.previous);
+        s.previous = s.loaded;
+        s.loaded   = get_empty(a_class);
+    }
+    s.loaded->items[s.loaded->count++] = a_ptr;
+}
+
+template <class Backend, int MagazineSize, class Tag>
+void thread_cached_allocator<Backend, MagazineSize, Tag>::
+release_cache(thread_cache& a_cache, bool a_drain)
+{
+    for (int i = 0; i < s_classes; ++i) {
+        auto& s = a_cache.m_slots[i];
+        for (magazine* m : {s.loaded, s.previous}) {
+            if (!m) continue;
+            if (a_drain) {
+                drain(m);
+                delete m;
+            } else if (m->empty())
+                m_depot[i].empty.push(m);
+            else
+                put_full(i, m);
+        }
+        s.loaded = s.previous = nullptr;
+    }
+}
+
+} // namespace memory
+} // namespace utxx
+
+#endif // _UTXX_ALLOC_THREAD_CACHED_HPP_
@@ -62,6 +62,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string.h>
 #include <errno.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -69,6 +70,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/meta.hpp>
 #include <utxx/math.hpp>
 #include <utxx/atomic.hpp>
+#include <utxx/alloc_page_policy.hpp>
 
 #ifdef ALLOC_TRACE
 #  include <iomanip>
@@ -96,10 +98,16 @@ public:
     ///            <total_mem_size>.
     /// @param <remove_on_destruct> if true then the memory mapped file
     ///            will be deleted on destruction of this instance.
+    /// @param <opts> backing of the mapping.  Transparent huge pages apply
+    ///            to files on tmpfs (e.g. /dev/shm) when THP for shmem is
+    ///            set to "advise".  HUGETLB requires the file to reside on a
+    ///            hugetlbfs mount, and rounds <sz> up to the huge page size.
+    ///            The region can be bound to a NUMA node and pre-faulted.
+    /// @throws io_error if the file cannot be opened or mapped.
     shmem_manager(const char* filename, size_t sz = 0,
                   init_mode mode = ATTACH_SHARED_MEMORY,
-                  bool remove_on_destruct = false)
-        throw(std::runtime_error);
+                  bool remove_on_destruct = false,
+                  const page_options& opts = page_options());
 
     ~shmem_manager();
 
@@ -141,7 +149,8 @@ private:
 template <int MinSize = 8, int MaxPow2Size = 32>
 class pow2_allocator {
 public:
-    static const unsigned int max_bucket = MaxPow2Size-1;
+    static const unsigned int max_bucket     = MaxPow2Size-1;
+    static const unsigned int max_size_class = max_bucket;
 
     typedef struct {
         int   next_free;
@@ -263,6 +272,22 @@ public:
 
     void* allocate(size_t sz);
     void  release(void* p);
+    void  free(void* p) { release(p); }
+
+    /// Allocate a chunk of a given size class.
+    /// @return NULL if \a size_class exceeds max_bucket or memory is exhausted.
+    void* alloc_size_class(size_t size_class);
+
+    /// Size class of a chunk needed to satisfy a request of \a sz bytes.
+    static int size_class_of(size_t sz) {
+        size_t alloc_sz = sz + sizeof(node);
+        return (alloc_sz < (size_t)min_size)
+             ? log<min_size, 2>::value
+             : math::upper_log2(alloc_sz);
+    }
+
+    /// Size class of a chunk pointed to by \a p.
+    static size_t size_class(void* p) { return ptr_to_node(p)->size_class; }
 
     int freelist_size(int bucket) {
         return (bucket < MaxPow2Size) ? m_header->freelist[bucket].length() : -1;
@@ -478,16 +503,18 @@ template <int MinSize, int MaxPow2Size>
 void* pow2_allocator<MinSize, MaxPow2Size>
 ::allocate(size_t sz)
 {
-    size_t alloc_sz = sz + sizeof(node);
-    char size_class = (alloc_sz < min_size)
-              ? log<min_size, 2>::value
-              : math::upper_log2(alloc_sz);
-    size_t size = 1 << size_class;
+    return alloc_size_class(size_class_of(sz));
+}
 
+template <int MinSize, int MaxPow2Size>
+void* pow2_allocator<MinSize, MaxPow2Size>
+::alloc_size_class(size_t size_class)
+{
     if (size_class > max_bucket)
         return NULL;
 
-    node* nd = m_header->freelist[size_class].pop();
+    size_t size = 1 << size_class;
+    node*  nd   = m_header->freelist[size_class].pop();
     if (nd == NULL)
         return allocate_main_memory(size, size_class);
 
@@ -498,7 +525,7 @@ void* pow2_allocator<MinSize, MaxPow2Size>
     #endif
 
     TRACEIT("Allocated<" << m_pid_id << '>' << std::setw(9) 
-            << size << '/' << sz << " bytes (offset="
+            << size << " bytes (offset="
             << reinterpret_cast<int>(nd)-reinterpret_cast<int>(m_header)
             << ", addr=" << (nd+1) << ") - from pool[" << (int)size_class << ']');
     return ++nd;
@@ -543,6 +570,78 @@ void pow2_allocator<MinSize, MaxPow2Size>
     }
 }
 
+//-----------------------------------------------------------------------------
+inline shmem_manager::shmem_manager(
+    const char* filename, size_t sz, init_mode mode, bool remove_on_destruct,
+    const page_options& opts)
+    : m_size(sz)
+    , m_fd(-1)
+    , m_filename(filename)
+    , m_mode(mode)
+    , m_address(NULL)
+    , m_remove_file(remove_on_destruct)
+    , m_offset(0)
+    , m_truncated(false)
+{
+    bool truncate = mode == TRUNCATE_SHARED_MEMORY;
+    m_fd = ::open(filename, truncate ? O_RDWR | O_CREAT : O_RDWR, 0660);
+    if (m_fd < 0)
+        UTXX_THROW_IO_ERROR(errno, "Cannot open file ", filename);
+
+    int ec = 0;
+    if (truncate) {
+        m_size = mapped_size(sz, opts);
+        if (::ftruncate(m_fd, m_size) < 0)
+            ec = errno;
+        m_truncated = true;
+    } else {
+        struct stat st;
+        if (::fstat(m_fd, &st) < 0)
+            ec = errno;
+        else if (sz > size_t(st.st_size))
+            ec = EINVAL;
+        else
+            m_size = st.st_size;
+    }
+
+    if (!ec) {
+        void* p = ::mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED)
+            ec = errno;
+        else
+            m_address = static_cast<char*>(p);
+    }
+
+    if (ec) {
+        ::close(m_fd);
+        UTXX_THROW_IO_ERROR(ec, "Cannot map file ", filename, " (size=", m_size, ')');
+    }
+
+    apply_page_options(m_address, m_size, opts);
+}
+
+inline shmem_manager::~shmem_manager()
+{
+    if (m_address)
+        ::munmap(m_address, m_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+    if (m_remove_file)
+        ::unlink(m_filename.c_str());
+}
+
+inline void* shmem_manager::reserve(size_t sz)
+{
+    sz = (sz + sizeof(long) - 1) & ~(sizeof(long) - 1);
+    size_t curr;
+    do {
+        curr = m_offset;
+        if (curr + sz > m_size)
+            return NULL;
+    } while (!atomic::cas(&m_offset, curr, curr + sz));
+    return m_address + curr;
+}
+
 } // namespace memory
 } // namespace utxx 
 
@@ -31,13 +31,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 ***** END LICENSE BLOCK *****
 */
 
-#ifndef _ALLOC_FIXED_PAGE_HPP_
-#define _ALLOC_FIXED_PAGE_HPP_
+#ifndef _CONCURRENT_ALLOC_FIXED_PAGE_HPP_
+#define _CONCURRENT_ALLOC_FIXED_PAGE_HPP_
 
 #include <new>
+#include <atomic>
 #include <boost/noncopyable.hpp>
 #include <boost/cstdint.hpp>
-#include <utxx/atomic.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <utxx/alloc_page_policy.hpp>
+#include <utxx/compiler_hints.hpp>
 #include <stdlib.h>
 #ifdef _ALLOCATOR_MEM_DEBUG
 #include <stdio.h>
@@ -50,26 +54,32 @@ namespace memory {
  * Implementation of paged allocator that allocates memory in
  * aligned pages of PageSize. A new page is allocated when
  * there is no more room to store an object of size T in a page.
+ * Each thread carves objects out of its own current page, so
+ * allocation involves no contention.  Objects may be deallocated
+ * by any thread.  A page is recycled when all of its objects are
+ * freed and its owning thread moved on to another page.  Up to
+ * MaxFreePages recycled pages are cached per thread.
+ * The PagePolicy determines the backing of the pages (see
+ * alloc_page_policy.hpp).
  */
 template <
       typename T
     , size_t   PageSize     = 64*1024
     , size_t   MaxFreePages = 10
+    , typename PagePolicy   = heap_page_policy
 >
 class concurrent_aligned_page_allocator : public boost::noncopyable {
     struct header {
         static const uint32_t s_magic = 1234567890;
-        const uint32_t magic;   ///< Magic version that must match s_magic.
-        T*      avail_chunk;    ///< Next available chunk on this page
-        long    alloc_count;    ///< Number of allocated chunks on this page
-        header* next;
-        header() : magic(s_magic), next(NULL) {}
+        const uint32_t    magic;       ///< Magic version that must match s_magic.
+        T*                avail_chunk; ///< Next available chunk on this page
+        std::atomic<long> alloc_count; ///< Allocated chunks (+1 while owned)
+        header*           next;
+        header() : magic(s_magic), avail_chunk(NULL), alloc_count(0), next(NULL) {}
     };
 
-    typedef std::allocator<T> base;
     static const size_t s_page_mask    = PageSize-1;
     static const size_t s_begin_offset = sizeof(header);
-    static const size_t s_end_chunks   = PageSize / sizeof(T);
     static const int    s_max_chunks   = ((PageSize-s_begin_offset) / sizeof(T));
 
     // Page size must be a power of 2
@@ -77,100 +87,112 @@ class concurrent_aligned_page_allocator : public boost::noncopyable {
     BOOST_STATIC_ASSERT(s_begin_offset < PageSize);
     BOOST_STATIC_ASSERT(s_max_chunks > 0);
 
-    static __thread header* m_page;
-    static __thread header* m_free;
-    static __thread long    m_free_count;
+    /// Per-thread state
+    struct thread_cache {
+        header* page;
+        header* free;
+        long    free_count;
+
+        thread_cache() : page(NULL), free(NULL), free_count(0) {}
+        ~thread_cache() {
+            if (page)
+                release(page);
+            while (free) {
+                header* h = free;
+                free = h->next;
+                page_free(h);
+            }
+        }
+    };
+
+    static thread_cache& cache() {
+        static thread_local thread_cache s_cache;
+        return s_cache;
+    }
+
+    static T* end_chunk(header* h) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) + s_begin_offset)
+             + s_max_chunks;
+    }
 
     static header* page_alloc() {
-        union {
-            unsigned long n;
-            void*   pp;
-            char*   pc;
-            header* p;
-        } u;
-        #if defined(_WIN32) || defined (_WIN64)
-        u.pp = _aligned_malloc(PageSize, PageSize);
-        if (!u.pp)
-            throw std::bad_alloc();
-        #else
-        if (posix_memalign(&u.pp, PageSize, PageSize) < 0)
-            throw std::bad_alloc();
-        #endif
-        BOOST_ASSERT(u.n & s_page_mask == 0);
-        new (u.p) header();
-        u.p->avail_chunk = reinterpret_cast<T*>(u.pc + s_begin_offset);
-        u.p->alloc_count = 0;
+        thread_cache& c = cache();
+        header*       h = c.free;
+        if (h) {
+            c.free = h->next;
+            --c.free_count;
+        } else
+            h = static_cast<header*>(PagePolicy::allocate(PageSize, PageSize));
+        BOOST_ASSERT((reinterpret_cast<unsigned long>(h) & s_page_mask) == 0);
+        new (h) header();
+        h->avail_chunk = reinterpret_cast<T*>(reinterpret_cast<char*>(h) + s_begin_offset);
+        // The owning thread holds a reference until the page is exhausted
+        h->alloc_count.store(1, std::memory_order_relaxed);
         #ifdef _ALLOCATOR_MEM_DEBUG
-        printf("Allocated page %p\n", u.p);
+        printf("Allocated page %p\n", h);
         #endif
-        return u.p;
+        return h;
     }
 
     static void page_free(header* p) {
         #ifdef _ALLOCATOR_MEM_DEBUG
         printf("Freeing page %p\n", p);
         #endif
+        p->~header();
+        PagePolicy::deallocate(p, PageSize);
+    }
 
-        #if defined(_WIN32) || defined (_WIN64)
-        _aligned_free(p);
-        #else
-        free(p);
-        #endif
+    /// Drop a reference to the page, recycling it when it's no longer used
+    static void release(header* h) {
+        if (h->alloc_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        thread_cache& c = cache();
+        if (c.free_count < long(MaxFreePages)) {
+            h->next = c.free;
+            c.free  = h;
+            ++c.free_count;
+        } else
+            page_free(h);
     }
 
 public:
     typedef T*      pointer;
     typedef size_t  size_type;
 
-    concurrent_aligned_page_allocator() : m_page(page_alloc()) {
+    concurrent_aligned_page_allocator() {
         #ifdef _ALLOCATOR_MEM_DEBUG
         printf("Page size: %d\n", PageSize);
         #endif
-        m_free       = NULL;
-        m_free_count = 0;
-
-        if (!m_page)
-            throw std::bad_alloc();
     }
 
-    ~concurrent_aligned_page_allocator() {
-        if (m_page && (m_page->alloc_count == 0)) {
-            page_free(m_page);
-            m_page = NULL;
+    /// Allocate a single object of type T (\a n is ignored).
+    pointer allocate(size_type n = 1, const void *hint = 0) {
+        (void)n; (void)hint;
+        thread_cache& c = cache();
+        header*       h = c.page;
+        if (UNLIKELY(!h || h->avail_chunk >= end_chunk(h))) {
+            if (h)
+                release(h);
+            h = c.page = page_alloc();
         }
-    }
-
-    pointer allocate(size_type n, const void *hint = 0) {
-        pointer end = reinterpret_cast<pointer>(
-                        reinterpret_cast<char*>(m_page) + PageSize);
-
-        m_page = page_alloc();
-
-        atomic::add(&m_page->alloc_count);
-
-        pointer p;
-        do {
-            p = m_page->avail_chunk;
-            if (p >= end)
-                reinterpret_cast<pointer>(
-            atomic::add(&m_page->avail_chunk, sizeof(T)));
+        h->alloc_count.fetch_add(1, std::memory_order_relaxed);
+        pointer p = h->avail_chunk++;
         #ifdef _ALLOCATOR_MEM_DEBUG
         printf("  Allocated: %p\n", p);
         #endif
         return p;
     }
 
-    void deallocate(pointer p, size_type n){
+    /// Deallocate an object.  Can be called by any thread.
+    void deallocate(pointer p, size_type n = 1) {
+        (void)n;
         unsigned long addr = reinterpret_cast<unsigned long>(p) & ~s_page_mask;
         header* h = reinterpret_cast<header*>(addr);
         #ifdef _ALLOCATOR_MEM_DEBUG
         printf("  Deallocating %p, page=%p\n", p, h);
         #endif
         BOOST_ASSERT(h->magic == header::s_magic);
-        long n = h->alloc_count;
-        atomic::dec(h->alloc_count);
-        if (h->alloc_count == 0 && h != m_page)
-            page_free(h);
+        release(h);
     }
 
      void construct(pointer p, const T &val){
@@ -181,10 +203,11 @@ public:
          p->~T();
      }
 
-     const header* address() const { return m_page; }
+     /// Current page of the calling thread
+     const header* address() const { return cache().page; }
 };
 
 } // namespace memory
 } // namespace utxx
 
-#endif // _ALLOC_FIXED_PAGE_HPP_
+#endif // _CONCURRENT_ALLOC_FIXED_PAGE_HPP_
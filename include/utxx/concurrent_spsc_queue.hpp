@@ -42,8 +42,10 @@
 #include <utxx/math.hpp>
 #include <utxx/error.hpp>
 #include <utxx/compiler_hints.hpp>
+#include <utxx/shm_liveness.hpp>
 #include <boost/noncopyable.hpp>
 #include <atomic>
+#include <new>
 #include <cassert>
 #include <cstdlib>
 #include <stdexcept>
@@ -72,9 +74,16 @@ private:
     //-----------------------------------------------------------------------//
     struct header
     {
+        static const uint32_t  s_magic = 0x51435053;   // "SPCQ"
+
         std::atomic<uint32_t>  m_head;
         std::atomic<uint32_t>  m_tail;
         uint32_t    const      m_capacity;
+        // Set once the header is initialized in external storage:
+        std::atomic<uint32_t>  m_magic;
+        // Liveness of the processes attached to the producer and consumer
+        // sides (see attach() and recover()):
+        shm_peer               m_peers[2];
         T                      __padding[0];
 
         static uint32_t adjust_capacity(uint32_t a_capacity)
@@ -94,16 +103,19 @@ private:
             : m_head    (0)
             , m_tail    (0)
             , m_capacity(0)
+            , m_magic   (0)
         {}
 
         header(uint32_t a_capacity)
             : m_head(0)
             , m_tail(0)
             , m_capacity(adjust_capacity(a_capacity))
+            , m_magic(0)
         {
             assert((m_capacity & (m_capacity-1)) == 0);  // Power of 2 indeed
             if (m_capacity < 2)
                 UTXX_THROW_BADARG_ERROR("Invalid capacity=", m_capacity);
+            m_magic.store(s_magic, std::memory_order_release);
         }
     };
 
@@ -144,6 +156,10 @@ public:
     /// StaticCapacity is 0.
     /// NB: In this case, Arg2 is really a memory size in bytes, NOT the capac-
     /// ity which is the items count!
+    /// If the storage doesn't hold an initialized queue header (e.g. it is
+    /// zero-filled or recycled), the header is initialized as an empty queue.
+    /// Otherwise the queue in the storage is re-attached, and its capacity
+    /// must match \a a_size.
     concurrent_spsc_queue
     (
         void*    a_storage,
@@ -167,6 +183,15 @@ public:
         if (unlikely(StaticCapacity != 0))
             UTXX_THROW_RUNTIME_ERROR("Cannot specify both static and dynamic "
                                      "capacity!");
+
+        // Initialize the header on first use of the storage. Otherwise we are
+        // re-attaching to an existing queue, whose capacity must match:
+        if (m_header_ptr->m_magic.load(std::memory_order_acquire) != header::s_magic)
+            new (m_header_ptr) header(m_header.m_capacity);
+        else if (unlikely(m_header_ptr->m_capacity != m_header.m_capacity))
+            UTXX_THROW_BADARG_ERROR("Storage capacity mismatch: expected=",
+                                    m_header.m_capacity, ", found=",
+                                    m_header_ptr->m_capacity);
     }
 
     /// Non-Default Ctor with automatic memory allocation on the heap;
@@ -406,6 +431,96 @@ public:
     /// Queue Capacity (static or dynamic):
     uint32_t capacity() const { return m_header.m_capacity; }
 
+    //=======================================================================//
+    // Liveness and Crash Recovery (for queues in shared memory):            //
+    //=======================================================================//
+    // Each side of the queue has a liveness record (pid, generation and the
+    // time of the last progress) in the shared header. A process attaches to
+    // its side(s) with attach(), reports progress with heartbeat(), and can
+    // check on the other side with peer_status().
+    //
+    // Since "head" and "tail" are only advanced after an item is completely
+    // consumed / produced, they always hold the last committed indices. A
+    // restarted process calls recover() to take the place of its dead prede-
+    // cessor and resumes from these indices:
+    // (*) a restarted Producer overwrites the slot at "tail" which may hold a
+    //     partially constructed item that was never published;
+    // (*) a restarted Consumer re-reads the item at "head" if its predecessor
+    //     crashed before committing the pop (ie delivery is at-least-once).
+    //
+    /// Attach the current process to the given side of the queue (the side
+    /// the queue was created with by default).
+    /// @param a_force take over the side even if its owner is still alive
+    /// @return new generation of the side (of the consumer side for "both")
+    /// @throw  runtime_error if the side is owned by another live process
+    uint32_t attach(side_t a_side = side_t::invalid, bool a_force = false)
+    {
+        if (a_side == side_t::invalid)
+            a_side = m_side;
+        uint32_t gen = 0;
+        if (a_side != side_t::consumer)
+            gen = peer(side_t::producer).attach(a_force);
+        if (a_side != side_t::producer)
+            gen = peer(side_t::consumer).attach(a_force);
+        return gen;
+    }
+
+    /// Detach the current process from its side(s) of the queue.
+    void detach()
+    {
+        if (m_side != side_t::consumer)
+            peer(side_t::producer).detach();
+        if (m_side != side_t::producer)
+            peer(side_t::consumer).detach();
+    }
+
+    /// Record progress of this side. Call it periodically (e.g. from the
+    /// polling loop), so that the other side can detect a stalled process.
+    void heartbeat()
+    {
+        int64_t now = monotonic_ns();
+        if (m_side != side_t::consumer)
+            peer(side_t::producer).beat(now);
+        if (m_side != side_t::producer)
+            peer(side_t::consumer).beat(now);
+    }
+
+    /// Liveness of the process attached to the given side.
+    /// @param a_timeout_ns if positive, the process is considered STALLED if
+    ///                     it didn't call heartbeat() within this interval
+    peer_state peer_status(side_t a_side, int64_t a_timeout_ns = 0) const
+    {
+        assert(a_side == side_t::producer || a_side == side_t::consumer);
+        return peer(a_side).state(a_timeout_ns);
+    }
+
+    /// Generation of the given side (number of attachments so far).
+    uint32_t generation(side_t a_side) const
+    {
+        assert(a_side == side_t::producer || a_side == side_t::consumer);
+        return peer(a_side).generation.load(std::memory_order_acquire);
+    }
+
+    /// Re-attach a restarted process to its side of the queue.
+    /// Validates the shared header and attaches to the side of the queue
+    /// (see attach()).
+    /// @return the last committed index to resume from: "tail" for the
+    ///         Producer, "head" for the Consumer
+    /// @throw  runtime_error if the header is corrupt or the side is owned
+    ///         by another live process
+    uint32_t recover(bool a_force = false)
+    {
+        uint32_t h = head().load(std::memory_order_acquire);
+        uint32_t t = tail().load(std::memory_order_acquire);
+        if (unlikely(m_header_ptr->m_capacity != capacity() ||
+                     h >= capacity() || t >= capacity()))
+            UTXX_THROW_RUNTIME_ERROR("Corrupt queue header: capacity=",
+                                     m_header_ptr->m_capacity, ", head=", h,
+                                     ", tail=", t);
+        attach(m_side, a_force);
+        return m_side == side_t::producer ? t : h;
+    }
+
     //=======================================================================//
     // UNSAFE iterators over the queue:                                      //
     //=======================================================================//
@@ -749,6 +864,9 @@ private:
     std::atomic<uint32_t>&       tail()       { return m_header_ptr->m_tail; }
     std::atomic<uint32_t> const& head() const { return m_header_ptr->m_head; }
     std::atomic<uint32_t> const& tail() const { return m_header_ptr->m_tail; }
+
+    shm_peer&       peer(side_t a)       { return m_header_ptr->m_peers[a == side_t::consumer]; }
+    shm_peer const& peer(side_t a) const { return m_header_ptr->m_peers[a == side_t::consumer]; }
 };
 
 } // namespace utxx
@@ -0,0 +1,915 @@
+//----------------------------------------------------------------------------
+/// \file   btree_map.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Cache-conscious B+tree sorted associative container.
+///
+/// The container exposes the same interface as utxx::assoc_vector so that it
+/// can be used as a drop-in replacement for medium-size maps (10K - 1M items)
+/// for which the O(N) insert/erase cost of a sorted vector becomes
+/// prohibitive.  Keys of every node are kept in a contiguous array sized to
+/// an integral number of cache lines, and for integral keys compared with
+/// std::less the in-node search is done with SSE/AVX2 compare instructions.
+/// Leaves are linked in a doubly-linked list giving sequential in-order
+/// iteration without touching inner nodes.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+#pragma once
+
+#include <utxx/config.h>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/detail/bit_count.hpp>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#ifndef UTXX_CL_SIZE
+#  define UTXX_CL_SIZE 64
+#endif
+
+namespace utxx {
+
+    namespace detail {
+        //----------------------------------------------------------------------
+        /// Generic in-node search used for arbitrary keys and comparators.
+        /// Both functions operate on a sorted array \a a_keys of \a a_n items.
+        //----------------------------------------------------------------------
+        template <class K, class C, class Enable = void>
+        struct btree_search {
+            /// Return the number of keys that compare less than \a a_key.
+            static int lower(const K* a_keys, int a_n, const K& a_key, const C& a_cmp) {
+                int lo = 0, hi = a_n;
+                while (lo < hi) {
+                    int mid = (lo + hi) >> 1;
+                    if (a_cmp(a_keys[mid], a_key)) lo = mid + 1;
+                    else                           hi = mid;
+                }
+                return lo;
+            }
+
+            /// Return the number of keys that don't compare greater than \a a_key.
+            static int upper(const K* a_keys, int a_n, const K& a_key, const C& a_cmp) {
+                int lo = 0, hi = a_n;
+                while (lo < hi) {
+                    int mid = (lo + hi) >> 1;
+                    if (!a_cmp(a_key, a_keys[mid])) lo = mid + 1;
+                    else                            hi = mid;
+                }
+                return lo;
+            }
+        };
+
+#if defined(__SSE2__)
+        //----------------------------------------------------------------------
+        /// SIMD in-node search for 32/64-bit integral keys ordered by std::less.
+        /// The key array must be readable up to the next multiple of the SIMD
+        /// width (node arrays are always padded to a multiple of 8 keys).
+        /// Unsigned keys are biased by the sign bit so that the signed SIMD
+        /// compare instructions give the correct order.
+        //----------------------------------------------------------------------
+        template <class K>
+        struct btree_search<K, std::less<K>,
+            typename std::enable_if<std::is_integral<K>::value &&
+                                    (sizeof(K) == 4 || sizeof(K) == 8)>::type>
+        {
+            using C = std::less<K>;
+
+            static int lower(const K* a_keys, int a_n, const K& a_key, const C&) {
+                return count<false>(a_keys, a_n, a_key);
+            }
+
+            static int upper(const K* a_keys, int a_n, const K& a_key, const C&) {
+                return count<true>(a_keys, a_n, a_key);
+            }
+
+        private:
+            static constexpr bool s_signed = std::is_signed<K>::value;
+
+            /// Count keys that are less than (or less or equal if \a Equal)
+            /// \a a_key. Since the keys are sorted the SIMD lane mask is a
+            /// contiguous run of ones, so we stop at the first partial mask.
+            template <bool Equal>
+            static int count(const K* a_keys, int a_n, K a_key) {
+                return count<Equal>(a_keys, a_n, a_key,
+                    std::integral_constant<int, sizeof(K)>());
+            }
+
+            template <bool Equal>
+            static int count(const K* a_keys, int a_n, K a_key,
+                             std::integral_constant<int, 4>)
+            {
+                const int bias = s_signed ? 0 : int(0x80000000u);
+                int cnt = 0;
+#  if defined(__AVX2__)
+                const __m256i b = _mm256_set1_epi32(bias);
+                const __m256i k = _mm256_xor_si256(_mm256_set1_epi32(int(a_key)), b);
+                for (int i = 0; i < a_n; i += 8) {
+                    __m256i x = _mm256_xor_si256(
+                        _mm256_loadu_si256((const __m256i*)(a_keys + i)), b);
+                    __m256i r = Equal ? _mm256_cmpgt_epi32(x, k)   // key >  a_key
+                                      : _mm256_cmpgt_epi32(k, x);  // key <  a_key
+                    unsigned m = _mm256_movemask_ps(_mm256_castsi256_ps(r));
+                    if (Equal) m = ~m & 0xFF;
+                    if (a_n - i < 8) m &= (1u << (a_n - i)) - 1;
+                    cnt += bitcount32(m);
+                    if (m != 0xFF) break;
+                }
+#  else
+                const __m128i b = _mm_set1_epi32(bias);
+                const __m128i k = _mm_xor_si128(_mm_set1_epi32(int(a_key)), b);
+                for (int i = 0; i < a_n; i += 4) {
+                    __m128i x = _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(a_keys + i)), b);
+                    __m128i r = Equal ? _mm_cmpgt_epi32(x, k) : _mm_cmpgt_epi32(k, x);
+                    unsigned m = _mm_movemask_ps(_mm_castsi128_ps(r));
+                    if (Equal) m = ~m & 0xF;
+                    if (a_n - i < 4) m &= (1u << (a_n - i)) - 1;
+                    cnt += bitcount32(m);
+                    if (m != 0xF) break;
+                }
+#  endif
+                return cnt;
+            }
+
+            template <bool Equal>
+            static int count(const K* a_keys, int a_n, K a_key,
+                             std::integral_constant<int, 8>)
+            {
+#  if defined(__AVX2__) || defined(__SSE4_2__)
+                const long long bias = s_signed ? 0 : (long long)(1ull << 63);
+                int cnt = 0;
+#    if defined(__AVX2__)
+                const __m256i b = _mm256_set1_epi64x(bias);
+                const __m256i k = _mm256_xor_si256(_mm256_set1_epi64x((long long)a_key), b);
+                for (int i = 0; i < a_n; i += 4) {
+                    __m256i x = _mm256_xor_si256(
+                        _mm256_loadu_si256((const __m256i*)(a_keys + i)), b);
+                    __m256i r = Equal ? _mm256_cmpgt_epi64(x, k) : _mm256_cmpgt_epi64(k, x);
+                    unsigned m = _mm256_movemask_pd(_mm256_castsi256_pd(r));
+                    if (Equal) m = ~m & 0xF;
+                    if (a_n - i < 4) m &= (1u << (a_n - i)) - 1;
+                    cnt += bitcount32(m);
+                    if (m != 0xF) break;
+                }
+#    else
+                const __m128i b = _mm_set1_epi64x(bias);
+                const __m128i k = _mm_xor_si128(_mm_set1_epi64x((long long)a_key), b);
+                for (int i = 0; i < a_n; i += 2) {
+                    __m128i x = _mm_xor_si128(
+                        _mm_loadu_si128((const __m128i*)(a_keys + i)), b);
+                    __m128i r = Equal ? _mm_cmpgt_epi64(x, k) : _mm_cmpgt_epi64(k, x);
+                    unsigned m = _mm_movemask_pd(_mm_castsi128_pd(r));
+                    if (Equal) m = ~m & 0x3;
+                    if (a_n - i < 2) m &= 1u;
+                    cnt += bitcount32(m);
+                    if (m != 0x3) break;
+                }
+#    endif
+                return cnt;
+#  else
+                // No 64-bit integer compare in plain SSE2
+                using base = btree_search<K, C, K>;
+                return Equal ? base::upper(a_keys, a_n, a_key, C())
+                             : base::lower(a_keys, a_n, a_key, C());
+#  endif
+            }
+        };
+#endif // __SSE2__
+    } // namespace detail
+
+    //--------------------------------------------------------------------------
+    /// A cache-conscious B+tree offering the interface of utxx::assoc_vector.
+    ///
+    /// All values are stored in leaf nodes that are linked in a list for fast
+    /// in-order traversal.  Each node keeps its keys in a contiguous array
+    /// occupying \a NodeCacheLines cache lines (the node capacity is that
+    /// number of keys rounded down to a multiple of 8, and clamped to the
+    /// [8, 64] range).  Leaves additionally hold a copy of each key inside
+    /// the stored value_type, so the in-node search only touches the
+    /// compact key array.
+    ///
+    /// BEWARE: just like assoc_vector, the container doesn't respect all of
+    /// the map's guarantees:
+    /// * iterators are invalidated by insert and erase operations
+    /// * value_type is std::pair<K, V> not std::pair<const K, V>, however
+    ///   the key of a stored value must never be modified
+    /// * keys must be default-constructible and copy-assignable
+    /// Unlike assoc_vector the complexity of insert/erase is O(log N) and
+    /// iterators are bidirectional rather than random-access.
+    //--------------------------------------------------------------------------
+    template
+    <
+        class K,
+        class V,
+        class C              = std::less<K>,
+        class A              = std::allocator<std::pair<K, V>>,
+        int   NodeCacheLines = 2
+    >
+    class btree_map {
+        static_assert(NodeCacheLines > 0, "Invalid number of cache lines");
+
+        static constexpr int calc_capacity() {
+            return (int(NodeCacheLines * UTXX_CL_SIZE / sizeof(K)) & ~7) < 8  ? 8
+                 : (int(NodeCacheLines * UTXX_CL_SIZE / sizeof(K)) & ~7) > 64 ? 64
+                 : (int(NodeCacheLines * UTXX_CL_SIZE / sizeof(K)) & ~7);
+        }
+
+    public:
+        using key_type              = K;
+        using mapped_type           = V;
+        using value_type            = std::pair<K, V>;
+        using key_compare           = C;
+        using allocator_type        = A;
+        using reference             = value_type&;
+        using const_reference       = const value_type&;
+        using pointer               = value_type*;
+        using const_pointer         = const value_type*;
+        using size_type             = size_t;
+        using difference_type       = ptrdiff_t;
+
+        /// Max number of keys in a node
+        static constexpr int s_capacity = calc_capacity();
+
+    private:
+        static constexpr int s_min_keys = s_capacity / 2;
+        static constexpr int s_max_depth = 32;
+
+        using search = detail::btree_search<K, C>;
+
+        struct node {
+            K        m_keys[s_capacity];    // Must be first - cacheline-aligned
+            int      m_count;
+            bool     m_leaf;
+            uint8_t  m_offset;              // Offset of the node from the raw
+                                            // allocated address
+            explicit node(bool a_leaf) : m_keys(), m_count(0), m_leaf(a_leaf) {}
+        };
+
+        struct leaf : node {
+            using slot = typename std::aligned_storage<
+                             sizeof(value_type), alignof(value_type)>::type;
+            leaf* m_prev;
+            leaf* m_next;
+            slot  m_data[s_capacity];
+
+            leaf() : node(true), m_prev(nullptr), m_next(nullptr) {}
+
+            value_type*       value(int i)       { return reinterpret_cast<value_type*>(m_data+i); }
+            const value_type* value(int i) const { return reinterpret_cast<const value_type*>(m_data+i); }
+        };
+
+        struct inner : node {
+            node* m_child[s_capacity+1];
+            inner() : node(false), m_child() {}
+        };
+
+        /// Path element recorded while descending from the root to a leaf
+        struct step {
+            inner* node;
+            int    idx;     // Index of the child we descended to
+        };
+
+        using char_alloc  = typename std::allocator_traits<A>::template rebind_alloc<char>;
+        using char_traits = std::allocator_traits<char_alloc>;
+
+        template <bool Const>
+        class iter {
+            using leaf_ptr = typename std::conditional<Const, const leaf*, leaf*>::type;
+            leaf_ptr m_leaf;
+            int      m_idx;
+
+            friend class btree_map;
+            iter(leaf_ptr a_leaf, int a_idx) : m_leaf(a_leaf), m_idx(a_idx) {}
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = typename btree_map::value_type;
+            using difference_type   = ptrdiff_t;
+            using pointer           = typename std::conditional<Const,
+                                         const value_type*, value_type*>::type;
+            using reference         = typename std::conditional<Const,
+                                         const value_type&, value_type&>::type;
+
+            iter() : m_leaf(nullptr), m_idx(0) {}
+
+            /// Conversion of iterator to const_iterator
+            template <bool B, class = typename std::enable_if<Const && !B>::type>
+            iter(const iter<B>& a) : m_leaf(a.m_leaf), m_idx(a.m_idx) {}
+
+            reference operator*()  const { return *m_leaf->value(m_idx); }
+            pointer   operator->() const { return  m_leaf->value(m_idx); }
+
+            iter& operator++() {
+                if (++m_idx == m_leaf->m_count && m_leaf->m_next) {
+                    m_leaf = m_leaf->m_next;
+                    m_idx  = 0;
+                }
+                return *this;
+            }
+
+            iter& operator--() {
+                if (m_idx == 0) {
+                    m_leaf = m_leaf->m_prev;
+                    m_idx  = m_leaf->m_count;
+                }
+                --m_idx;
+                return *this;
+            }
+
+            iter operator++(int) { iter t(*this); ++*this; return t; }
+            iter operator--(int) { iter t(*this); --*this; return t; }
+
+            template <bool B>
+            bool operator==(const iter<B>& a) const
+            { return m_leaf == a.m_leaf && m_idx == a.m_idx; }
+            template <bool B>
+            bool operator!=(const iter<B>& a) const { return !operator==(a); }
+
+            friend class iter<!Const>;
+        };
+
+    public:
+        using iterator              = iter<false>;
+        using const_iterator        = iter<true>;
+        using reverse_iterator      = std::reverse_iterator<iterator>;
+        using const_reverse_iterator= std::reverse_iterator<const_iterator>;
+
+        class value_compare {
+            friend class btree_map;
+            key_compare m_cmp;
+        protected:
+            value_compare(key_compare a_pred) : m_cmp(a_pred) {}
+        public:
+            bool operator()(const value_type& lhs, const value_type& rhs) const
+            { return m_cmp(lhs.first, rhs.first); }
+        };
+
+        explicit btree_map(const key_compare& comp = key_compare(), const A& alloc = A())
+            : m_cmp(comp), m_alloc(alloc)
+            , m_root(nullptr), m_head(nullptr), m_tail(nullptr), m_size(0)
+        {}
+
+        btree_map(const btree_map& rhs)
+            : btree_map(rhs.m_cmp, A(rhs.m_alloc))
+        { insert(rhs.cbegin(), rhs.cend()); }
+
+        btree_map(btree_map&& rhs)
+            : btree_map(rhs.m_cmp, A(rhs.m_alloc))
+        { swap(rhs); }
+
+        explicit btree_map(std::initializer_list<value_type> items,
+            const key_compare& comp = key_compare(), const A& alloc = A())
+            : btree_map(comp, alloc)
+        { insert(items.begin(), items.end()); }
+
+        template <class InputIterator>
+        btree_map(InputIterator first, InputIterator last,
+            const key_compare&  comp  = key_compare(),
+            const A&            alloc = A())
+            : btree_map(comp, alloc)
+        { insert(first, last); }
+
+        ~btree_map() { clear(); }
+
+        btree_map& operator=(btree_map&& rhs) {
+            swap(rhs);
+            return *this;
+        }
+        btree_map& operator=(const btree_map& rhs) {
+            if (this != &rhs)
+                btree_map(rhs).swap(*this);
+            return *this;
+        }
+
+        // iterators:
+        iterator                begin()         { return iterator(m_head, 0);        }
+        const_iterator          begin()   const { return const_iterator(m_head, 0);  }
+        const_iterator          cbegin()  const { return begin();                    }
+        iterator                end()           { return iterator(m_tail, m_tail ? m_tail->m_count : 0); }
+        const_iterator          end()     const { return const_iterator(m_tail, m_tail ? m_tail->m_count : 0); }
+        const_iterator          cend()    const { return end();                      }
+        reverse_iterator        rbegin()        { return reverse_iterator(end());    }
+        const_reverse_iterator  crbegin() const { return const_reverse_iterator(end());   }
+        reverse_iterator        rend()          { return reverse_iterator(begin());  }
+        const_reverse_iterator  crend()   const { return const_reverse_iterator(begin()); }
+
+        // capacity:
+        bool                    empty()   const { return m_size == 0; }
+        size_type               size()    const { return m_size;      }
+        size_type               max_size() const{ return size_type(-1) / sizeof(value_type); }
+
+        /// Number of levels in the tree (0 - empty, 1 - root is a leaf)
+        int depth() const {
+            int n = 0;
+            for (const node* p = m_root; p; ++n)
+                p = p->m_leaf ? nullptr : static_cast<const inner*>(p)->m_child[0];
+            return n;
+        }
+
+        // element access:
+        mapped_type& operator[](const key_type& key)
+        { return insert(value_type(key, mapped_type())).first->second; }
+
+        // modifiers:
+        std::pair<iterator, bool> insert(const value_type& val) {
+            return do_insert(val.first, val);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& val) {
+            return do_insert(val.first, std::move(val));
+        }
+
+        /// The hint is ignored - insertion is always O(log N)
+        iterator insert(const_iterator, const value_type& val)
+        { return insert(val).first; }
+
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last)
+        { for (; first != last; ++first) insert(*first); }
+
+        /// Erase the item pointed by \a pos.
+        /// @return iterator following the removed element
+        iterator erase(const_iterator pos) {
+            K k(pos->first);
+            erase(k);
+            return lower_bound(k);
+        }
+
+        size_type erase(const key_type& k) {
+            step path[s_max_depth];
+            int  depth = 0;
+            leaf* lf   = descend(k, path, depth);
+            if (!lf) return 0;
+
+            int j = search::lower(lf->m_keys, lf->m_count, k, m_cmp);
+            if (j == lf->m_count || m_cmp(k, lf->m_keys[j]))
+                return 0;
+
+            remove_value(lf, j);
+            --m_size;
+            rebalance_leaf(lf, path, depth);
+            return 1;
+        }
+
+        void erase(const_iterator first, const_iterator last) {
+            if (first == last) return;
+            if (first == cbegin() && last == cend()) {
+                clear();
+                return;
+            }
+            bool to_end = last == cend();
+            K    stop   = to_end ? K() : last->first;
+            for (auto it = lower_bound(first->first);
+                 it != end() && (to_end || m_cmp(it->first, stop));)
+                it = erase(it);
+        }
+
+        void swap(btree_map& other) {
+            using std::swap;
+            swap(m_cmp,   other.m_cmp);
+            swap(m_alloc, other.m_alloc);
+            swap(m_root,  other.m_root);
+            swap(m_head,  other.m_head);
+            swap(m_tail,  other.m_tail);
+            swap(m_size,  other.m_size);
+        }
+
+        void clear() {
+            if (m_root) free_tree(m_root);
+            m_root = nullptr;
+            m_head = m_tail = nullptr;
+            m_size = 0;
+        }
+
+        // observers:
+        key_compare    key_comp()       const { return m_cmp; }
+        value_compare  value_comp()     const { return value_compare(m_cmp); }
+        allocator_type get_allocator()  const { return allocator_type(m_alloc); }
+
+        // map operations:
+        iterator find(const key_type& k) {
+            iterator i(lower_bound(k));
+            return (i == end() || m_cmp(k, i->first)) ? end() : i;
+        }
+
+        const_iterator find(const key_type& k) const {
+            const_iterator i(lower_bound(k));
+            return (i == end() || m_cmp(k, i->first)) ? end() : i;
+        }
+
+        size_type count(const key_type& k) const
+        { return find(k) != end(); }
+
+        /// Return first element that doesn't compare less than \a k.
+        iterator lower_bound(const key_type& k) {
+            leaf* lf = find_leaf(k);
+            return lf ? to_iter(lf, search::lower(lf->m_keys, lf->m_count, k, m_cmp))
+                      : end();
+        }
+
+        /// Return first element that doesn't compare less than \a k.
+        const_iterator lower_bound(const key_type& k) const {
+            return const_cast<btree_map*>(this)->lower_bound(k);
+        }
+
+        /// Return first element that compares greater than \a k.
+        iterator upper_bound(const key_type& k) {
+            leaf* lf = find_leaf(k);
+            return lf ? to_iter(lf, search::upper(lf->m_keys, lf->m_count, k, m_cmp))
+                      : end();
+        }
+
+        /// Return first element that compares greater than \a k.
+        const_iterator upper_bound(const key_type& k) const {
+            return const_cast<btree_map*>(this)->upper_bound(k);
+        }
+
+        std::pair<iterator, iterator>
+        equal_range(const key_type& k)
+        { return std::make_pair(lower_bound(k), upper_bound(k)); }
+
+        std::pair<const_iterator, const_iterator>
+        equal_range(const key_type& k) const
+        { return std::make_pair(lower_bound(k), upper_bound(k)); }
+
+        friend bool operator==(const btree_map& lhs, const btree_map& rhs) {
+            return lhs.size() == rhs.size()
+                && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+        }
+
+        bool operator<(const btree_map& rhs) const {
+            return std::lexicographical_compare(cbegin(), cend(),
+                                                rhs.cbegin(), rhs.cend());
+        }
+
+        friend bool operator!=(const btree_map& lhs, const btree_map& rhs)
+        { return !(lhs == rhs); }
+
+        friend bool operator> (const btree_map& lhs, const btree_map& rhs)
+        { return rhs < lhs; }
+
+        friend bool operator>=(const btree_map& lhs, const btree_map& rhs)
+        { return !(lhs < rhs); }
+
+        friend bool operator<=(const btree_map& lhs, const btree_map& rhs)
+        { return !(rhs < lhs); }
+
+    private:
+        C          m_cmp;
+        char_alloc m_alloc;
+        node*      m_root;
+        leaf*      m_head;
+        leaf*      m_tail;
+        size_t     m_size;
+
+        //----------------------------------------------------------------------
+        // Node allocation (nodes are aligned on the cache line boundary)
+        //----------------------------------------------------------------------
+        template <class Node>
+        Node* new_node() {
+            static_assert(UTXX_CL_SIZE <= 256, "Offset must fit in uint8_t");
+            char* raw = char_traits::allocate(m_alloc, sizeof(Node) + UTXX_CL_SIZE - 1);
+            char* p   = reinterpret_cast<char*>(
+                            (reinterpret_cast<uintptr_t>(raw) + UTXX_CL_SIZE - 1)
+                            & ~uintptr_t(UTXX_CL_SIZE - 1));
+            Node* n = new (p) Node();
+            n->m_offset = uint8_t(p - raw);
+            return n;
+        }
+
+        template <class Node>
+        void delete_node(Node* a_node) {
+            char* raw = reinterpret_cast<char*>(a_node) - a_node->m_offset;
+            a_node->~Node();
+            char_traits::deallocate(m_alloc, raw, sizeof(Node) + UTXX_CL_SIZE - 1);
+        }
+
+        void free_tree(node* a_node) {
+            if (a_node->m_leaf) {
+                leaf* lf = static_cast<leaf*>(a_node);
+                for (int i = 0; i < lf->m_count; ++i)
+                    lf->value(i)->~value_type();
+                delete_node(lf);
+            } else {
+                inner* in = static_cast<inner*>(a_node);
+                for (int i = 0; i <= in->m_count; ++i)
+                    free_tree(in->m_child[i]);
+                delete_node(in);
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Lookup helpers
+        //----------------------------------------------------------------------
+        iterator to_iter(leaf* a_leaf, int a_idx) {
+            // The position past the last key of a leaf other than the
+            // tail is the first position in the next leaf
+            return (a_idx == a_leaf->m_count && a_leaf->m_next)
+                 ? iterator(a_leaf->m_next, 0) : iterator(a_leaf, a_idx);
+        }
+
+        leaf* find_leaf(const K& k) const {
+            node* n = m_root;
+            if (!n) return nullptr;
+            while (!n->m_leaf) {
+                inner* in = static_cast<inner*>(n);
+                n = in->m_child[search::upper(in->m_keys, in->m_count, k, m_cmp)];
+            }
+            return static_cast<leaf*>(n);
+        }
+
+        leaf* descend(const K& k, step* a_path, int& a_depth) {
+            node* n = m_root;
+            if (!n) return nullptr;
+            for (a_depth = 0; !n->m_leaf; ++a_depth) {
+                assert(a_depth < s_max_depth);
+                inner* in = static_cast<inner*>(n);
+                int    i  = search::upper(in->m_keys, in->m_count, k, m_cmp);
+                a_path[a_depth] = step{in, i};
+                n = in->m_child[i];
+            }
+            return static_cast<leaf*>(n);
+        }
+
+        //----------------------------------------------------------------------
+        // Leaf value manipulation
+        //----------------------------------------------------------------------
+        /// Move \a a_n values from \a a_src[a_si] to the uninitialized slots
+        /// of \a a_dst[a_di] (non-overlapping ranges or a_di < a_si)
+        static void move_values(leaf* a_dst, int a_di, leaf* a_src, int a_si, int a_n) {
+            for (int i = 0; i < a_n; ++i) {
+                new (a_dst->m_data + a_di + i)
+                    value_type(std::move(*a_src->value(a_si + i)));
+                a_src->value(a_si + i)->~value_type();
+                a_dst->m_keys[a_di + i] = a_src->m_keys[a_si + i];
+            }
+        }
+
+        /// Shift values [a_from, count) of a leaf one slot to the right
+        static void shift_right(leaf* a_leaf, int a_from) {
+            for (int i = a_leaf->m_count; i > a_from; --i) {
+                new (a_leaf->m_data + i) value_type(std::move(*a_leaf->value(i-1)));
+                a_leaf->value(i-1)->~value_type();
+                a_leaf->m_keys[i] = a_leaf->m_keys[i-1];
+            }
+        }
+
+        void remove_value(leaf* a_leaf, int a_idx) {
+            a_leaf->value(a_idx)->~value_type();
+            move_values(a_leaf, a_idx, a_leaf, a_idx+1, a_leaf->m_count - a_idx - 1);
+            --a_leaf->m_count;
+        }
+
+        template <class Val>
+        std::pair<iterator, bool> do_insert(const K& k, Val&& val) {
+            if (UNLIKELY(!m_root)) {
+                leaf* lf = new_node<leaf>();
+                m_root = m_head = m_tail = lf;
+            }
+
+            step path[s_max_depth];
+            int   depth = 0;
+            leaf* lf    = descend(k, path, depth);
+            int   j     = search::lower(lf->m_keys, lf->m_count, k, m_cmp);
+
+            if (j < lf->m_count && !m_cmp(k, lf->m_keys[j]))
+                return std::make_pair(iterator(lf, j), false);
+
+            if (lf->m_count == s_capacity) {
+                // Split the leaf in two halves
+                leaf* rt = new_node<leaf>();
+                int   n  = s_capacity / 2;
+                move_values(rt, 0, lf, n, s_capacity - n);
+                rt->m_count = s_capacity - n;
+                lf->m_count = n;
+                rt->m_prev  = lf;
+                rt->m_next  = lf->m_next;
+                if (lf->m_next) lf->m_next->m_prev = rt;
+                else            m_tail = rt;
+                lf->m_next  = rt;
+
+                insert_inner(path, depth, rt->m_keys[0], rt);
+
+                if (j > n) { lf = rt; j -= n; }
+            }
+
+            // Note: the key must be copied before \a val is moved from
+            shift_right(lf, j);
+            lf->m_keys[j] = k;
+            new (lf->m_data + j) value_type(std::forward<Val>(val));
+            ++lf->m_count;
+            ++m_size;
+            return std::make_pair(iterator(lf, j), true);
+        }
+
+        /// Insert separator \a a_key and its right child \a a_right into the
+        /// parent of the node found at \a a_depth in the path.
+        void insert_inner(step* a_path, int a_depth, const K& a_key, node* a_right) {
+            if (a_depth == 0) {
+                inner* root = new_node<inner>();
+                root->m_keys[0]  = a_key;
+                root->m_child[0] = m_root;
+                root->m_child[1] = a_right;
+                root->m_count    = 1;
+                m_root = root;
+                return;
+            }
+
+            inner* p   = a_path[a_depth-1].node;
+            int    pos = a_path[a_depth-1].idx;
+
+            if (p->m_count < s_capacity) {
+                std::move_backward(p->m_keys  + pos,   p->m_keys  + p->m_count,
+                                   p->m_keys  + p->m_count + 1);
+                std::move_backward(p->m_child + pos+1, p->m_child + p->m_count + 1,
+                                   p->m_child + p->m_count + 2);
+                p->m_keys[pos]    = a_key;
+                p->m_child[pos+1] = a_right;
+                ++p->m_count;
+                return;
+            }
+
+            // The parent is full - split it
+            K     keys [s_capacity+1];
+            node* child[s_capacity+2];
+            std::copy(p->m_keys,  p->m_keys  + pos,            keys);
+            keys[pos] = a_key;
+            std::copy(p->m_keys  + pos, p->m_keys + s_capacity, keys + pos + 1);
+            std::copy(p->m_child, p->m_child + pos + 1,         child);
+            child[pos+1] = a_right;
+            std::copy(p->m_child + pos + 1, p->m_child + s_capacity + 1, child + pos + 2);
+
+            const int mid = (s_capacity + 1) / 2;
+            inner*    rt  = new_node<inner>();
+
+            std::copy(keys,  keys  + mid,     p->m_keys);
+            std::copy(child, child + mid + 1, p->m_child);
+            p->m_count = mid;
+
+            std::copy(keys  + mid + 1, keys  + s_capacity + 1, rt->m_keys);
+            std::copy(child + mid + 1, child + s_capacity + 2, rt->m_child);
+            rt->m_count = s_capacity - mid;
+
+            insert_inner(a_path, a_depth-1, keys[mid], rt);
+        }
+
+        /// Remove the key at \a a_idx and the child at \a a_idx+1 of \a a_node
+        static void remove_inner(inner* a_node, int a_idx) {
+            std::move(a_node->m_keys  + a_idx + 1, a_node->m_keys  + a_node->m_count,
+                      a_node->m_keys  + a_idx);
+            std::move(a_node->m_child + a_idx + 2, a_node->m_child + a_node->m_count + 1,
+                      a_node->m_child + a_idx + 1);
+            --a_node->m_count;
+        }
+
+        void rebalance_leaf(leaf* a_leaf, step* a_path, int a_depth) {
+            if (a_depth == 0) {
+                if (a_leaf->m_count == 0) {
+                    delete_node(a_leaf);
+                    m_root = nullptr;
+                    m_head = m_tail = nullptr;
+                }
+                return;
+            }
+            if (a_leaf->m_count >= s_min_keys)
+                return;
+
+            inner* p   = a_path[a_depth-1].node;
+            int    idx = a_path[a_depth-1].idx;
+            leaf*  lt  = idx > 0          ? static_cast<leaf*>(p->m_child[idx-1]) : nullptr;
+            leaf*  rt  = idx < p->m_count ? static_cast<leaf*>(p->m_child[idx+1]) : nullptr;
+
+            if (lt && lt->m_count > s_min_keys) {
+                // Borrow the last value of the left sibling
+                shift_right(a_leaf, 0);
+                move_values(a_leaf, 0, lt, lt->m_count-1, 1);
+                --lt->m_count;
+                ++a_leaf->m_count;
+                p->m_keys[idx-1] = a_leaf->m_keys[0];
+                return;
+            }
+            if (rt && rt->m_count > s_min_keys) {
+                // Borrow the first value of the right sibling
+                move_values(a_leaf, a_leaf->m_count, rt, 0, 1);
+                ++a_leaf->m_count;
+                move_values(rt, 0, rt, 1, rt->m_count-1);
+                --rt->m_count;
+                p->m_keys[idx] = rt->m_keys[0];
+                return;
+            }
+
+            // Merge with a sibling
+            int sep = lt ? idx-1 : idx;
+            if (lt) rt = a_leaf;
+            else    lt = a_leaf;
+
+            move_values(lt, lt->m_count, rt, 0, rt->m_count);
+            lt->m_count += rt->m_count;
+            lt->m_next   = rt->m_next;
+            if (rt->m_next) rt->m_next->m_prev = lt;
+            else            m_tail = lt;
+            rt->m_count  = 0;
+            delete_node(rt);
+
+            remove_inner(p, sep);
+            rebalance_inner(a_path, a_depth-1);
+        }
+
+        void rebalance_inner(step* a_path, int a_depth) {
+            inner* n = a_path[a_depth].node;
+
+            if (a_depth == 0) {
+                if (n->m_count == 0) {
+                    m_root = n->m_child[0];
+                    delete_node(n);
+                }
+                return;
+            }
+            if (n->m_count >= s_min_keys)
+                return;
+
+            inner* p   = a_path[a_depth-1].node;
+            int    idx = a_path[a_depth-1].idx;
+            inner* lt  = idx > 0          ? static_cast<inner*>(p->m_child[idx-1]) : nullptr;
+            inner* rt  = idx < p->m_count ? static_cast<inner*>(p->m_child[idx+1]) : nullptr;
+
+            if (lt && lt->m_count > s_min_keys) {
+                // Rotate right through the parent
+                std::move_backward(n->m_keys,  n->m_keys  + n->m_count,
+                                   n->m_keys  + n->m_count + 1);
+                std::move_backward(n->m_child, n->m_child + n->m_count + 1,
+                                   n->m_child + n->m_count + 2);
+                n->m_keys[0]     = p->m_keys[idx-1];
+                n->m_child[0]    = lt->m_child[lt->m_count];
+                p->m_keys[idx-1] = lt->m_keys[lt->m_count-1];
+                --lt->m_count;
+                ++n->m_count;
+                return;
+            }
+            if (rt && rt->m_count > s_min_keys) {
+                // Rotate left through the parent
+                n->m_keys[n->m_count]    = p->m_keys[idx];
+                n->m_child[n->m_count+1] = rt->m_child[0];
+                p->m_keys[idx]           = rt->m_keys[0];
+                std::move(rt->m_keys+1,  rt->m_keys  + rt->m_count,     rt->m_keys);
+                std::move(rt->m_child+1, rt->m_child + rt->m_count + 1, rt->m_child);
+                --rt->m_count;
+                ++n->m_count;
+                return;
+            }
+
+            // Merge with a sibling pulling down the separator from the parent
+            int sep = lt ? idx-1 : idx;
+            if (lt) rt = n;
+            else    lt = n;
+
+            lt->m_keys[lt->m_count] = p->m_keys[sep];
+            std::copy(rt->m_keys,  rt->m_keys  + rt->m_count,     lt->m_keys  + lt->m_count + 1);
+            std::copy(rt->m_child, rt->m_child + rt->m_count + 1, lt->m_child + lt->m_count + 1);
+            lt->m_count += rt->m_count + 1;
+            delete_node(rt);
+
+            remove_inner(p, sep);
+            rebalance_inner(a_path, a_depth-1);
+        }
+    };
+
+    // specialized algorithms:
+    template <class K, class V, class C, class A, int N>
+    void swap(btree_map<K, V, C, A, N>& lhs, btree_map<K, V, C, A, N>& rhs)
+    { lhs.swap(rhs); }
+
+} // namespace utxx
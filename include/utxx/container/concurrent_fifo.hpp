@@ -57,17 +57,24 @@ public:
 
 //-----------------------------------------------------------------------------
 /// @class unbound_lock_free_queue
+/// By default dequeued nodes are cached on a free list and never returned
+/// to the heap.  Use reclaiming_lock_free_queue to release memory through
+/// the epoch-based reclamation domain (see utxx/epoch_reclaim.hpp).
 //-----------------------------------------------------------------------------
 
-template <typename T>
+template <typename T, typename AllocT = detail::unbound_cached_allocator<T> >
 class unbound_lock_free_queue
-    : public detail::lock_free_queue<T, detail::unbound_cached_allocator<T> > {
-    typedef detail::lock_free_queue<T, detail::unbound_cached_allocator<T> > base_t;
-    detail::unbound_cached_allocator<T> m_allocator;
+    : public detail::lock_free_queue<T, AllocT> {
+    typedef detail::lock_free_queue<T, AllocT> base_t;
+    AllocT m_allocator;
 public:
     unbound_lock_free_queue() : base_t(m_allocator) {}
 };
 
+template <typename T>
+using reclaiming_lock_free_queue =
+    unbound_lock_free_queue<T, detail::epoch_reclaim_allocator<T> >;
+
 //-----------------------------------------------------------------------------
 /// @class blocking_unbound_fifo
 //-----------------------------------------------------------------------------
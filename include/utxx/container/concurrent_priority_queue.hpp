@@ -3,6 +3,11 @@
 /// \author Serge Aleynikov
 //----------------------------------------------------------------------------
 /// \brief Concurrent priority queue
+///
+/// The queue used to be a fixed set of per-priority sub-queues, which only
+/// supported a small number of discrete priority levels.  It is now an
+/// alias of concurrent_skip_list ordered by arbitrary 64-bit keys (such as
+/// deadlines or prices) with lock-free insert(), pop_min() and erase().
 //----------------------------------------------------------------------------
 // Created: 2010-02-03
 //----------------------------------------------------------------------------
@@ -33,68 +38,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #ifndef _UTXX_CONCURRENT_PRI_QUEUE_HPP_
 #define _UTXX_CONCURRENT_PRI_QUEUE_HPP_
 
-#include <boost/cstdint.hpp>
-#include <utxx/bitmap.hpp>
+#include <utxx/container/concurrent_skip_list.hpp>
 
-template <typename T, int Priorities, typename Queue>
-class concurrent_priority_queue {
-    union versioned_bitmask {
-        uint64_t index;
-        struct {
-            bitmap_low<Priorities> bitmask : Priorities;
-            uint32_t version               : 64 - Priorities;
-        } s;
-    };
+namespace utxx {
+namespace container {
 
-    volatile versioned_bitmask m_idx;
-    char __pad[64 - sizeof(versioned_bitmask)];
-    Queue m_queues[N];
+template <typename T, int MaxLevel = 20>
+using concurrent_priority_queue = concurrent_skip_list<T, MaxLevel>;
 
-    static const int s_max_version = 64 - Priorities - 1;
-
-    static uint64_t inc_version(uint64_t value) {
-        versioned_bitmask u.index = value;
-        u.s.version = (u.s.version+1) & s_max_version;
-        return u.index;
-    }
-public:
-    static const int max_priority = Priorities - 1;
-
-    concurrent_priority_queue() {
-        STATIC_ASSERT(0 < Priorities && Priorities <= 56, Invalid_priority_bound);
-    }
-
-    bool get(T& item) {
-        versioned_bitmask old = m_idx;
-        int pri = old.s.bitmask.first();
-        if (pri == old.s.bitmask.end())
-            return false;
-        if (m_queues[pri].get(item)) {
-            while(1) {
-                if (!m_queues[pri].empty())
-                    break;
-                old.s.bitmask.clear(pri);
-                if (atomic::cas(m_idx.index, old.index, inc_version(old.index)))
-                    break;
-                old = m_idx;
-            } 
-            return true;
-        }
-        return false;
-    }
-
-    bool put(int priority, T& item) {
-        versioned_bitmask old = m_idx;
-        if (!m_queues[priority].put(item))
-            return false;
-        while(1) {
-            old.s.bitmask.set(priority);
-            if (atomic::cas(m_idx.index, old.index, inc_version(old.index)))
-                break;
-            old = m_idx;
-        }
-        return true;
-    }
-};
+} // namespace container
+} // namespace utxx
 
 #endif // _UTXX_CONCURRENT_PRI_QUEUE_HPP_
@@ -0,0 +1,369 @@
+//----------------------------------------------------------------------------
+/// \file   concurrent_skip_list.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Lock-free ordered skip list keyed by 64-bit integers.
+///
+/// The list is ordered by a 64-bit key (e.g. a deadline or a price) and
+/// supports concurrent insert(), pop_min() and erase() by any number of
+/// threads, which makes it suitable for timer scheduling and order-expiry
+/// queues shared by several threads.
+///
+/// The implementation follows K.Fraser "Practical lock freedom" (2004):
+/// a node is logically removed by marking its next pointers (the low bit),
+/// and physically unlinked by any thread traversing past it.  Removed
+/// nodes are retired to an epoch_domain (see utxx/epoch_reclaim.hpp), so
+/// memory is released while other threads may still be reading them.
+///
+/// Equal keys are allowed: every inserted item is assigned a unique
+/// sequence number, and items with equal keys are popped in the insertion
+/// order.  insert() returns a handle that can be used to erase the item.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_CONCURRENT_SKIP_LIST_HPP_
+#define _UTXX_CONCURRENT_SKIP_LIST_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/epoch_reclaim.hpp>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <stdint.h>
+
+namespace utxx {
+namespace container {
+
+/// @class container::concurrent_skip_list
+/// Lock-free skip list of items of type T ordered by a 64-bit key.
+/// @tparam T        item type (must be copy or move constructible)
+/// @tparam MaxLevel maximum number of levels in the list (the list works
+///                  best with up to 2^MaxLevel items)
+template <typename T, int MaxLevel = 20>
+class concurrent_skip_list : boost::noncopyable {
+    static_assert(0 < MaxLevel && MaxLevel <= 32, "Invalid MaxLevel");
+
+    struct node {
+        const uint64_t      key;
+        const uint64_t      seq;
+        const int           top;    ///< Highest level of this node
+        std::atomic<int>    refs;   ///< Inserter + remover references
+        T                   value;
+        std::atomic<uintptr_t> next[1];
+
+        template <typename... Args>
+        node(uint64_t a_key, uint64_t a_seq, int a_top, Args&&... a_args)
+            : key(a_key), seq(a_seq), top(a_top), refs(2)
+            , value(std::forward<Args>(a_args)...)
+        {}
+
+        bool less(uint64_t a_key, uint64_t a_seq) const {
+            return key < a_key || (key == a_key && seq < a_seq);
+        }
+    };
+
+    struct head_node {
+        std::atomic<uintptr_t> next[MaxLevel];
+    };
+
+    static node*     ptr(uintptr_t a)    { return reinterpret_cast<node*>(a & ~uintptr_t(1)); }
+    static bool      marked(uintptr_t a) { return a & 1; }
+    static uintptr_t ref(node* a)        { return reinterpret_cast<uintptr_t>(a); }
+
+    static std::atomic<uintptr_t>* next_of(node* a_pred, head_node* a_head, int a_level) {
+        return a_pred ? &a_pred->next[a_level] : &a_head->next[a_level];
+    }
+
+    head_node               m_head;
+    std::atomic<uint64_t>   m_seq;
+    std::atomic<long>       m_size;
+    memory::epoch_domain&   m_domain;
+
+    template <typename... Args>
+    static node* make_node(uint64_t a_key, uint64_t a_seq, int a_top, Args&&... a_args) {
+        void* p = ::operator new(sizeof(node) + a_top * sizeof(std::atomic<uintptr_t>));
+        return new (p) node(a_key, a_seq, a_top, std::forward<Args>(a_args)...);
+    }
+
+    static void free_node(void*, void* a_node) {
+        node* p = static_cast<node*>(a_node);
+        p->~node();
+        ::operator delete(p);
+    }
+
+    static int random_level() {
+        static thread_local uint64_t s_seed =
+            0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&s_seed);
+        s_seed ^= s_seed << 13;
+        s_seed ^= s_seed >> 7;
+        s_seed ^= s_seed << 17;
+        int n = __builtin_ctzll(s_seed | (1ull << (MaxLevel-1)));
+        return n;
+    }
+
+    /// Locate the predecessors and successors of (key, seq) on all levels,
+    /// unlinking marked nodes along the way.
+    /// The caller must be pinned to the epoch.
+    /// @return true if a node with the given key/seq was found.
+    bool find(uint64_t a_key, uint64_t a_seq, node** a_preds, node** a_succs) {
+    retry:
+        node* pred = nullptr;   // nullptr stands for the head
+        for (int level = MaxLevel-1; level >= 0; --level) {
+            node* curr = ptr(next_of(pred, &m_head, level)->load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t succ = curr->next[level].load(std::memory_order_acquire);
+                while (marked(succ)) {
+                    uintptr_t expected = ref(curr);
+                    if (!next_of(pred, &m_head, level)->compare_exchange_strong(
+                            expected, succ & ~uintptr_t(1),
+                            std::memory_order_acq_rel, std::memory_order_relaxed))
+                        goto retry;
+                    curr = ptr(succ);
+                    if (!curr)
+                        break;
+                    succ = curr->next[level].load(std::memory_order_acquire);
+                }
+                if (!curr || !curr->less(a_key, a_seq))
+                    break;
+                pred = curr;
+                curr = ptr(succ);
+            }
+            a_preds[level] = pred;
+            a_succs[level] = curr;
+        }
+        node* n = a_succs[0];
+        return n && n->key == a_key && n->seq == a_seq;
+    }
+
+    /// Drop a reference to a node unlinked by the caller's last find().
+    void release(node* a_node) {
+        if (a_node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            m_domain.retire(a_node, &free_node);
+    }
+
+    /// Logically remove the node.  The caller must be pinned.
+    /// @return true if this thread removed the node
+    bool remove(node* a_node) {
+        // Mark upper levels first, so that no new links to the node appear
+        for (int level = a_node->top; level > 0; --level) {
+            uintptr_t succ = a_node->next[level].load(std::memory_order_relaxed);
+            while (!marked(succ) &&
+                   !a_node->next[level].compare_exchange_weak(succ, succ | 1,
+                        std::memory_order_acq_rel, std::memory_order_relaxed));
+        }
+        // The thread that marks the bottom level owns the removal
+        uintptr_t succ = a_node->next[0].load(std::memory_order_relaxed);
+        while (true) {
+            if (marked(succ))
+                return false;
+            if (a_node->next[0].compare_exchange_weak(succ, succ | 1,
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+                break;
+        }
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Physically unlink a removed node and release the remover's reference
+    void unlink(node* a_node) {
+        node* preds[MaxLevel];
+        node* succs[MaxLevel];
+        find(a_node->key, a_node->seq, preds, succs);
+        release(a_node);
+    }
+
+    template <typename... Args>
+    std::pair<uint64_t, uint64_t> do_insert(uint64_t a_key, Args&&... a_args);
+
+public:
+    /// Handle of an inserted item used to erase it
+    struct handle {
+        uint64_t key;
+        uint64_t seq;
+    };
+
+    explicit concurrent_skip_list(
+        memory::epoch_domain& a_domain = memory::epoch_domain::global())
+        : m_seq(0), m_size(0), m_domain(a_domain)
+    {
+        for (auto& p : m_head.next)
+            p.store(0, std::memory_order_relaxed);
+    }
+
+    /// Not thread safe: no other thread may be using the list.
+    ~concurrent_skip_list() { clear(); }
+
+    /// Insert an item with the given key.
+    template <typename... Args>
+    handle emplace(uint64_t a_key, Args&&... a_args) {
+        auto r = do_insert(a_key, std::forward<Args>(a_args)...);
+        return handle{r.first, r.second};
+    }
+
+    handle insert(uint64_t a_key, const T& a_value) { return emplace(a_key, a_value); }
+    handle insert(uint64_t a_key, T&& a_value) { return emplace(a_key, std::move(a_value)); }
+
+    /// Remove the item with the smallest key.
+    /// @param a_value  the removed item
+    /// @param a_key    if not NULL, set to the key of the removed item
+    /// @return false if the list is empty
+    bool pop_min(T& a_value, uint64_t* a_key = nullptr) {
+        memory::epoch_domain::guard g(m_domain);
+        while (true) {
+            node* n = ptr(m_head.next[0].load(std::memory_order_acquire));
+            // Skip nodes being removed by other threads
+            while (n && marked(n->next[0].load(std::memory_order_acquire)))
+                n = ptr(n->next[0].load(std::memory_order_acquire));
+            if (!n)
+                return false;
+            if (remove(n)) {
+                a_value = std::move(n->value);
+                if (a_key) *a_key = n->key;
+                unlink(n);
+                return true;
+            }
+        }
+    }
+
+    /// Key of the smallest item.
+    /// @return false if the list is empty
+    bool peek_min(uint64_t& a_key) {
+        memory::epoch_domain::guard g(m_domain);
+        node* n = ptr(m_head.next[0].load(std::memory_order_acquire));
+        while (n && marked(n->next[0].load(std::memory_order_acquire)))
+            n = ptr(n->next[0].load(std::memory_order_acquire));
+        if (n)
+            a_key = n->key;
+        return n != nullptr;
+    }
+
+    /// Remove the item identified by the handle.
+    /// @return false if the item was already removed
+    bool erase(const handle& a_handle) {
+        memory::epoch_domain::guard g(m_domain);
+        node* preds[MaxLevel];
+        node* succs[MaxLevel];
+        if (!find(a_handle.key, a_handle.seq, preds, succs))
+            return false;
+        node* n = succs[0];
+        if (!remove(n))
+            return false;
+        unlink(n);
+        return true;
+    }
+
+    /// @return true if the list contains the item identified by the handle
+    bool contains(const handle& a_handle) {
+        memory::epoch_domain::guard g(m_domain);
+        node* preds[MaxLevel];
+        node* succs[MaxLevel];
+        return find(a_handle.key, a_handle.seq, preds, succs);
+    }
+
+    /// Approximate number of items in the list
+    long size()  const { return m_size.load(std::memory_order_relaxed); }
+    bool empty() const { return !ptr(m_head.next[0].load(std::memory_order_acquire)); }
+
+    /// Remove all items.  Not thread safe.
+    void clear() {
+        node* n = ptr(m_head.next[0].load(std::memory_order_relaxed));
+        while (n) {
+            node* next = ptr(n->next[0].load(std::memory_order_relaxed));
+            free_node(nullptr, n);
+            n = next;
+        }
+        for (auto& p : m_head.next)
+            p.store(0, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    /// Reclamation domain used by the list
+    memory::epoch_domain& domain() { return m_domain; }
+};
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+template <typename T, int MaxLevel>
+template <typename... Args>
+std::pair<uint64_t, uint64_t>
+concurrent_skip_list<T, MaxLevel>::do_insert(uint64_t a_key, Args&&... a_args)
+{
+    memory::epoch_domain::guard g(m_domain);
+
+    uint64_t seq = m_seq.fetch_add(1, std::memory_order_relaxed);
+    int      top = random_level();
+    node*    n   = make_node(a_key, seq, top, std::forward<Args>(a_args)...);
+    node*    preds[MaxLevel];
+    node*    succs[MaxLevel];
+
+    // Link the bottom level, which makes the item visible
+    while (true) {
+        find(a_key, seq, preds, succs);
+        for (int level = 0; level <= top; ++level)
+            n->next[level].store(ref(succs[level]), std::memory_order_relaxed);
+        uintptr_t expected = ref(succs[0]);
+        if (next_of(preds[0], &m_head, 0)->compare_exchange_strong(
+                expected, ref(n), std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+    m_size.fetch_add(1, std::memory_order_relaxed);
+
+    // Link the upper levels
+    for (int level = 1; level <= top; ++level) {
+        while (true) {
+            uintptr_t nx = n->next[level].load(std::memory_order_acquire);
+            if (marked(nx))
+                goto done;  // The node is being removed
+            if (ptr(nx) != succs[level] &&
+               !n->next[level].compare_exchange_strong(nx, ref(succs[level]),
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+                goto done;  // Marked concurrently
+            uintptr_t expected = ref(succs[level]);
+            if (next_of(preds[level], &m_head, level)->compare_exchange_strong(
+                    expected, ref(n), std::memory_order_release, std::memory_order_relaxed))
+                break;
+            find(a_key, seq, preds, succs);
+            if (succs[0] != n)
+                goto done;  // Removed and unlinked by another thread
+        }
+    }
+
+done:
+    // If the node was removed while being linked, the remover's unlinking
+    // may have missed the levels linked afterwards
+    if (marked(n->next[0].load(std::memory_order_acquire)))
+        find(a_key, seq, preds, succs);
+    release(n);
+    return std::make_pair(a_key, seq);
+}
+
+} // namespace container
+} // namespace utxx
+
+#endif // _UTXX_CONCURRENT_SKIP_LIST_HPP_
@@ -4,7 +4,9 @@
 //----------------------------------------------------------------------------
 /// \brief Concurrent lock-free stack.
 /// 
-/// Note: this implementation has ABA problem.
+/// Note: versioned_stack relies on three version bits of the head pointer
+/// and therefore is not entirely free of the ABA problem.  lock_free_stack
+/// uses epoch-based reclamation (see utxx/epoch_reclaim.hpp) instead.
 //----------------------------------------------------------------------------
 // Created: 2010-01-06
 //----------------------------------------------------------------------------
@@ -38,7 +40,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/type_traits.hpp>
 #include <utxx/meta.hpp>
 #include <utxx/atomic.hpp>
+#include <utxx/epoch_reclaim.hpp>
 #include <utxx/synch.hpp>
+#include <atomic>
 #include <time.h>
 
 namespace utxx {
@@ -247,6 +251,77 @@ public:
     }
 };
 
+//-----------------------------------------------------------------------------
+// LOCK-FREE STACK
+//-----------------------------------------------------------------------------
+
+/// @class container::lock_free_stack
+/// Unbound lock-free stack owning copies of its items.  Popped nodes are
+/// retired to an epoch-based reclamation domain and deleted once no thread
+/// can reference them, so the stack is free of the ABA problem and
+/// releases memory under sustained push/pop churn.
+template <typename T>
+class lock_free_stack : boost::noncopyable {
+    struct node_t {
+        T       data;
+        node_t* next;
+
+        template <typename... Args>
+        explicit node_t(Args&&... a_args)
+            : data(std::forward<Args>(a_args)...), next(nullptr)
+        {}
+    };
+
+    std::atomic<node_t*>  m_head;
+    memory::epoch_domain& m_domain;
+
+public:
+    explicit lock_free_stack(memory::epoch_domain& a_domain = memory::epoch_domain::global())
+        : m_head(nullptr), m_domain(a_domain)
+    {}
+
+    /// Not thread safe: no other thread may be using the stack.
+    ~lock_free_stack() {
+        for (node_t* p = m_head.load(std::memory_order_relaxed); p; ) {
+            node_t* next = p->next;
+            delete p;
+            p = next;
+        }
+    }
+
+    /// Construct an item in place on top of the stack.
+    template <typename... Args>
+    void emplace(Args&&... a_args) {
+        node_t* nd = new node_t(std::forward<Args>(a_args)...);
+        nd->next   = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(nd->next, nd,
+                    std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void push(const T& a_item) { emplace(a_item); }
+    void push(T&& a_item)      { emplace(std::move(a_item)); }
+
+    /// Pop an item in the LIFO order.
+    /// @return false if the stack is empty.
+    bool pop(T& a_item) {
+        memory::epoch_domain::guard g(m_domain);
+        node_t* p = m_head.load(std::memory_order_acquire);
+        while (p && !m_head.compare_exchange_weak(p, p->next,
+                        std::memory_order_acquire, std::memory_order_acquire));
+        if (!p)
+            return false;
+        a_item = std::move(p->data);
+        m_domain.retire(p);
+        return true;
+    }
+
+    /// @return true if stack is empty
+    bool empty() const { return m_head.load(std::memory_order_relaxed) == nullptr; }
+
+    /// Reclamation domain used by the stack
+    memory::epoch_domain& domain() { return m_domain; }
+};
+
 } // namespace container
 } // namespace utxx
 
@@ -38,6 +38,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/noncopyable.hpp>
 #include <utxx/atomic.hpp>
 #include <utxx/container/concurrent_stack.hpp>
+#include <utxx/epoch_reclaim.hpp>
 
 namespace utxx {
 namespace container {
@@ -56,9 +57,19 @@ struct node_t {
 //-----------------------------------------------------------------------------
 // ALLOCATORS
 //-----------------------------------------------------------------------------
+// Each allocator defines a guard type instantiated by a container for the
+// duration of an operation that dereferences shared nodes.  Allocators that
+// recycle nodes internally don't need protection and use no_reclaim_guard.
+
+struct no_reclaim_guard {
+    template <typename AllocT>
+    explicit no_reclaim_guard(const AllocT&) {}
+};
 
 template <typename T>
 struct unbound_allocator {
+    typedef no_reclaim_guard guard;
+
     node_t<T>* allocate()           const { return new node_t<T>(); }
     void       free(node_t<T>* nd)  const { delete nd; }
 };
@@ -79,6 +90,8 @@ class unbound_cached_allocator {
 
     versioned_stack m_free_list;
 public:
+    typedef no_reclaim_guard guard;
+
     alloc_node_t* allocate() {
         free_node_t* nd = reinterpret_cast<free_node_t*>(m_free_list.pop());
         if (nd == NULL)
@@ -98,6 +111,8 @@ class bound_allocator {
     char m_memory[memory::heap_fixed_size_object_pool::storage_size<sizeof(node_t<T>), Size>::value];
     memory::heap_fixed_size_object_pool& m_pool;
 public:
+    typedef no_reclaim_guard guard;
+
     bound_allocator() 
         : m_pool(memory::heap_fixed_size_object_pool::create(
                     &m_memory, sizeof(m_memory), sizeof(node_t<T>)))
@@ -115,6 +130,24 @@ public:
     }
 };
 
+/// Allocator returning freed nodes to the heap through the epoch-based
+/// reclamation domain, so that the memory of an unbound queue is released
+/// under sustained churn and popped nodes are never reused while another
+/// thread may still be reading them.
+template <typename T>
+struct epoch_reclaim_allocator {
+    struct guard : memory::epoch_domain::guard {
+        explicit guard(const epoch_reclaim_allocator& a)
+            : memory::epoch_domain::guard(a.domain())
+        {}
+    };
+
+    node_t<T>* allocate()           const { return new node_t<T>(); }
+    void       free(node_t<T>* nd)  const { if (nd) domain().retire(nd); }
+
+    memory::epoch_domain& domain()  const { return memory::epoch_domain::global(); }
+};
+
 
 } // namespace detail
 } // namespace container
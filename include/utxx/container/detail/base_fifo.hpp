@@ -95,6 +95,7 @@ public:
         new (nd) node_type(item);
 
         volatile node_type* old_tail;
+        typename AllocT::guard g(m_allocator);
 
         while(1) {
             old_tail        = m_tail;
@@ -121,6 +122,7 @@ public:
 
     bool dequeue(T& item) {
         volatile node_type* old_head;
+        typename AllocT::guard g(m_allocator);
         while(1) {
             old_head        = m_head;
             volatile node_type* next = old_head->next;
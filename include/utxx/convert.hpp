@@ -44,7 +44,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/bits.hpp>
 #include <utxx/types.hpp>
 #include <utxx/compiler_hints.hpp>
+#include <utxx/detail/fp_tables.hpp>
 #include <stdint.h>
+#include <stdlib.h>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#endif
 
 namespace utxx {
 
@@ -635,6 +642,10 @@ inline const char* fast_atoi(const char* a_str, const char* a_end, T& res) {
     return a_str;
 }
 
+template <typename T>
+inline typename std::enable_if<std::numeric_limits<T>::is_integer, char*>::
+type itoa10(T a_value, char* a_buf);
+
 /// Convert a number to string
 ///
 /// Note: the function doesn't perform boundary checking. Make sure there's enough
@@ -645,6 +656,13 @@ template <typename T>
 char* itoa(T value, char*& result, int base = 10) {
     BOOST_ASSERT(base >= 2 || base <= 36);
 
+    if (base == 10) {
+        char* begin = result;
+        result  = itoa10(value, result);
+        *result = '\0';
+        return begin;
+    }
+
     char* p = result, *q = p;
     T tmp;
 
@@ -816,7 +834,7 @@ inline int ftoa_left(double f, char* buffer, int buffer_size, int precision, boo
         *p++ = '0';
     } else {
         while (int_part != 0) {
-            int j = int_part / 10;
+            int64_t j = int_part / 10;
             *p++ = (char)(int_part - ((j << 3) + (j << 1)) + '0');
             int_part = j;
         }
@@ -961,7 +979,7 @@ inline void ftoa_right(double f, char* buffer, int width, int precision, char lp
     } else {
         //char* end = p;
         while (int_part) {
-            int j = int_part / 10;
+            int64_t j = int_part / 10;
             *(--p) = (char)(int_part - ((j << 3) + (j << 1)) + '0');
             int_part = j;
         }
@@ -984,15 +1002,457 @@ inline void ftoa_right(double f, char* buffer, int width, int precision, char lp
     for (char* q = buffer; q != p; *q++ = lpad);
 }
 
+namespace detail {
+    typedef unsigned __int128 uint128_t;
+
+    constexpr char cs_digits100[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    constexpr double cs_pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /// Write \a a_len decimal digits of \a a_val ending at \a a_end
+    inline void write_digits(char* a_end, uint64_t a_val, int a_len) {
+        for (; a_len > 1; a_len -= 2, a_val /= 100) {
+            const char* d = cs_digits100 + 2 * (a_val % 100);
+            *--a_end = d[1];
+            *--a_end = d[0];
+        }
+        if (a_len)
+            *--a_end = char('0' + a_val);
+    }
+
+    constexpr uint64_t cs_pow10_u64[] = {
+        1ull,                 10ull,                 100ull,
+        1000ull,              10000ull,              100000ull,
+        1000000ull,           10000000ull,           100000000ull,
+        1000000000ull,        10000000000ull,        100000000000ull,
+        1000000000000ull,     10000000000000ull,     100000000000000ull,
+        1000000000000000ull,  10000000000000000ull,  100000000000000000ull,
+        1000000000000000000ull, 10000000000000000000ull
+    };
+
+    /// Number of decimal digits in \a a_val (1 for 0)
+    inline int decimal_length(uint64_t a_val) {
+        // log10(2) ~ 1233/4096 estimates the length from the bit count,
+        // which is then corrected by at most one
+        int t = ((64 - __builtin_clzll(a_val | 1)) * 1233) >> 12;
+        return t + 1 - ((a_val | 1) < cs_pow10_u64[t]);
+    }
+
+    //-------------------------------------------------------------------------
+    // Shortest round-trip decimal representation of a double.
+    // Ulf Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018
+    //-------------------------------------------------------------------------
+    inline int32_t  pow5bits (int32_t e) { return int32_t((uint32_t(e) * 1217359) >> 19) + 1; }
+    inline uint32_t log10pow2(int32_t e) { return (uint32_t(e) * 78913)  >> 18; }
+    inline uint32_t log10pow5(int32_t e) { return (uint32_t(e) * 732923) >> 20; }
+
+    inline bool multiple_of_pow5(uint64_t a_val, uint32_t a_pow) {
+        uint32_t n = 0;
+        for (; a_val % 5 == 0; a_val /= 5)
+            ++n;
+        return n >= a_pow;
+    }
+
+    inline bool multiple_of_pow2(uint64_t a_val, uint32_t a_pow) {
+        return (a_val & ((1ull << a_pow) - 1)) == 0;
+    }
+
+    inline uint64_t mul_shift64(uint64_t a_m, const uint64_t* a_mul, int32_t a_shift) {
+        uint128_t b0 = uint128_t(a_m) * a_mul[0];
+        uint128_t b2 = uint128_t(a_m) * a_mul[1];
+        return uint64_t(((b0 >> 64) + b2) >> (a_shift - 64));
+    }
+
+    /// Shortest decimal \a a_mant * 10^a_exp rounding to the double with given
+    /// IEEE mantissa and biased exponent bits (the number must be finite and
+    /// non-zero)
+    inline void shortest_decimal(uint64_t a_ieee_mant, uint32_t a_ieee_exp,
+                                 uint64_t& a_mant, int32_t& a_exp)
+    {
+        typedef fp_tables tbl;
+        int32_t  e2;
+        uint64_t m2;
+        if (a_ieee_exp == 0) {
+            e2 = 1 - 1023 - 52 - 2;
+            m2 = a_ieee_mant;
+        } else {
+            e2 = int32_t(a_ieee_exp) - 1023 - 52 - 2;
+            m2 = (1ull << 52) | a_ieee_mant;
+        }
+        const bool accept_bounds = (m2 & 1) == 0;
+
+        // Interval of valid representations: [mv - 1 - mm_shift, mv + 2] / 4
+        const uint64_t mv       = 4 * m2;
+        const uint32_t mm_shift = a_ieee_mant != 0 || a_ieee_exp <= 1;
+
+        uint64_t vr, vp, vm;
+        int32_t  e10;
+        bool     vm_trailing_zeros = false;
+        bool     vr_trailing_zeros = false;
+
+        if (e2 >= 0) {
+            const uint32_t q = log10pow2(e2) - (e2 > 3);
+            e10 = int32_t(q);
+            const int32_t k  = tbl::POW5_INV_BITCOUNT + pow5bits(int32_t(q)) - 1;
+            const int32_t i  = -e2 + int32_t(q) + k;
+            const uint64_t* mul = tbl::pow5_inv_split[q];
+            vr = mul_shift64(mv,                mul, i);
+            vp = mul_shift64(mv + 2,            mul, i);
+            vm = mul_shift64(mv - 1 - mm_shift, mul, i);
+            if (q <= 21) {
+                // Only one of mp, mv, and mm can be a multiple of 5, if any
+                if (mv % 5 == 0)
+                    vr_trailing_zeros = multiple_of_pow5(mv, q);
+                else if (accept_bounds)
+                    vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+                else
+                    vp -= multiple_of_pow5(mv + 2, q);
+            }
+        } else {
+            const uint32_t q = log10pow5(-e2) - (-e2 > 1);
+            e10 = int32_t(q) + e2;
+            const int32_t i  = -e2 - int32_t(q);
+            const int32_t k  = pow5bits(i) - tbl::POW5_BITCOUNT;
+            const int32_t j  = int32_t(q) - k;
+            const uint64_t* mul = tbl::pow5_split[i];
+            vr = mul_shift64(mv,                mul, j);
+            vp = mul_shift64(mv + 2,            mul, j);
+            vm = mul_shift64(mv - 1 - mm_shift, mul, j);
+            if (q <= 1) {
+                // mv = 4 * m2 always has at least two trailing 0 bits
+                vr_trailing_zeros = true;
+                if (accept_bounds)
+                    vm_trailing_zeros = mm_shift == 1;
+                else
+                    --vp;
+            } else if (q < 63)
+                vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+
+        // Remove digits while the interval still contains a shorter number
+        int32_t  removed    = 0;
+        uint8_t  last_digit = 0;
+        uint64_t output;
+
+        if (UNLIKELY(vm_trailing_zeros || vr_trailing_zeros)) {
+            for (; vp / 10 > vm / 10; ++removed) {
+                vm_trailing_zeros &= vm % 10 == 0;
+                vr_trailing_zeros &= last_digit == 0;
+                last_digit = uint8_t(vr % 10);
+                vr /= 10; vp /= 10; vm /= 10;
+            }
+            if (vm_trailing_zeros)
+                for (; vm % 10 == 0; ++removed) {
+                    vr_trailing_zeros &= last_digit == 0;
+                    last_digit = uint8_t(vr % 10);
+                    vr /= 10; vp /= 10; vm /= 10;
+                }
+            // Round to even if the exact number is .....50..0
+            if (vr_trailing_zeros && last_digit == 5 && vr % 2 == 0)
+                last_digit = 4;
+            output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros))
+                           || last_digit >= 5);
+        } else {
+            bool round_up = false;
+            if (vp / 100 > vm / 100) {
+                round_up = vr % 100 >= 50;
+                vr /= 100; vp /= 100; vm /= 100;
+                removed += 2;
+            }
+            for (; vp / 10 > vm / 10; ++removed) {
+                round_up = vr % 10 >= 5;
+                vr /= 10; vp /= 10; vm /= 10;
+            }
+            output = vr + (vr == vm || round_up);
+        }
+        a_mant = output;
+        a_exp  = e10 + removed;
+    }
+
+    //-------------------------------------------------------------------------
+    // Correctly rounded conversion of a decimal w * 10^q to double.
+    // D. Lemire, "Number Parsing at a Gigabyte per Second", 2021;
+    // N. Mushtak, D. Lemire, "Fast Number Parsing Without Fallback", 2023
+    //-------------------------------------------------------------------------
+    inline double decimal_to_double(uint64_t a_w, int64_t a_q) {
+        typedef fp_tables tbl;
+        union { uint64_t u; double d; } res;
+
+        if (a_w == 0 || a_q < tbl::POW5_128_MIN_EXP)
+            return 0.0;
+        if (a_q > tbl::POW5_128_MAX_EXP)
+            return std::numeric_limits<double>::infinity();
+
+        const int32_t   q  = int32_t(a_q);
+        const int       lz = __builtin_clzll(a_w);
+        const uint64_t  w  = a_w << lz;
+        const uint64_t* pw = tbl::pow5_128[q - tbl::POW5_128_MIN_EXP];
+
+        // 55 significant bits are needed; refine the product with the lower
+        // word of the power of five only when the truncation may affect them
+        uint128_t prod = uint128_t(w) * pw[0];
+        uint64_t  hi   = uint64_t(prod >> 64);
+        uint64_t  lo   = uint64_t(prod);
+        if ((hi & 0x1FF) == 0x1FF) {
+            uint64_t x = uint64_t((uint128_t(w) * pw[1]) >> 64);
+            lo += x;
+            hi += lo < x;
+        }
+
+        const int upper = int(hi >> 63);
+        const int shift = upper + 64 - 52 - 3;
+        uint64_t  mant  = hi >> shift;
+        int32_t   exp2  = (((152170 + 65536) * q) >> 16) + 63 + upper - lz + 1023;
+
+        if (exp2 <= 0) {
+            // Subnormal number
+            if (-exp2 + 1 >= 64)
+                return 0.0;
+            mant >>= -exp2 + 1;
+            mant  += mant & 1;
+            mant >>= 1;
+            exp2   = mant < (1ull << 52) ? 0 : 1;
+        } else {
+            // Exactly halfway between two doubles: round to even
+            if (lo <= 1 && q >= -4 && q <= 23 && (mant & 3) == 1 &&
+                (mant << shift) == hi)
+                mant &= ~1ull;
+            mant  += mant & 1;
+            mant >>= 1;
+            if (mant >= (2ull << 52)) {
+                mant = 1ull << 52;
+                ++exp2;
+            }
+            mant &= ~(1ull << 52);
+            if (exp2 >= 0x7FF)
+                return std::numeric_limits<double>::infinity();
+        }
+        res.u = mant | (uint64_t(exp2) << 52);
+        return res.d;
+    }
+} // namespace detail
+
+//--------------------------------------------------------------------------------
+/// Convert a floating point number to the shortest left-justified string that
+/// reads back to the same number.
+/// Numbers with decimal exponent in [-6, 21) are written in fixed notation
+/// with at least one fractional digit (e.g. "1.0", "0.001", "123.45"), others
+/// in scientific notation (e.g. "1e+21", "2.5e-7").
+/// @param f is the number to convert
+/// @param buffer is the output buffer (32 bytes is always sufficient)
+/// @param buffer_size is the size of the output buffer
+/// @return number of characters written (excluding terminator) or -1 if
+///         the buffer is too small
+//--------------------------------------------------------------------------------
+template <bool WithTerminator = true, char Terminator = '\0'>
+inline int ftoa_shortest(double f, char* buffer, int buffer_size)
+{
+    union { double F; uint64_t L; } x;
+    x.F = f;
+    const bool     neg  = (x.L >> 63) != 0;
+    const uint64_t mant = x.L & detail::FTOA::FRAC_MASK;
+    const uint32_t exp  = uint32_t(x.L >> detail::FTOA::FRAC_SIZE) & detail::FTOA::EXP_MASK;
+
+    char  tmp[32];
+    char* out = buffer_size >= int(sizeof(tmp)) ? buffer : tmp;
+    char* p   = out;
+
+    if (neg && !(exp == detail::FTOA::EXP_MASK && mant))
+        *p++ = '-';
+
+    if (UNLIKELY(exp == detail::FTOA::EXP_MASK)) {
+        memcpy(p, mant ? "nan" : "inf", 3);
+        p += 3;
+    } else if (exp == 0 && mant == 0) {
+        memcpy(p, "0.0", 3);
+        p += 3;
+    } else {
+        uint64_t digits;
+        int32_t  e10;
+        int      len;
+        int32_t  e2 = int32_t(exp) - 1023 - detail::FTOA::FRAC_SIZE;
+
+        // Integers below 2^53 need no conversion
+        if (e2 <= 0 && e2 >= -detail::FTOA::FRAC_SIZE &&
+            detail::multiple_of_pow2(mant, uint32_t(-e2)))
+        {
+            digits = ((1ull << detail::FTOA::FRAC_SIZE) | mant) >> -e2;
+            e10    = 0;
+        } else
+            detail::shortest_decimal(mant, exp, digits, e10);
+
+        len = detail::decimal_length(digits);
+        int32_t sci = e10 + len - 1;    // Exponent in scientific notation
+
+        if (sci >= 21 || sci < -6) {
+            // d[.ddd]e(+|-)xx
+            detail::write_digits(p + len + (len > 1), digits, len);
+            if (len > 1) {
+                p[0] = p[1];
+                p[1] = '.';
+                ++p;
+            }
+            p   += len;
+            *p++ = 'e';
+            *p++ = sci < 0 ? '-' : '+';
+            int n = sci < 0 ? -sci : sci;
+            int l = detail::decimal_length(n);
+            detail::write_digits(p + l, n, l);
+            p   += l;
+        } else if (e10 >= 0) {
+            // ddd000.0
+            detail::write_digits(p + len, digits, len);
+            p += len;
+            memset(p, '0', e10);
+            p += e10;
+            *p++ = '.';
+            *p++ = '0';
+        } else if (sci >= 0) {
+            // ddd.ddd
+            int n = sci + 1;
+            detail::write_digits(p + len + 1, digits, len);
+            memmove(p, p + 1, n);
+            p[n] = '.';
+            p   += len + 1;
+        } else {
+            // 0.000ddd
+            int z = -sci - 1;
+            *p++  = '0';
+            *p++  = '.';
+            memset(p, '0', z);
+            p    += z;
+            detail::write_digits(p + len, digits, len);
+            p    += len;
+        }
+    }
+
+    int n = p - out;
+    if (out == tmp) {
+        if (n + (WithTerminator ? 1 : 0) > buffer_size)
+            return -1;
+        memcpy(buffer, tmp, n);
+    }
+    if (WithTerminator)
+        buffer[n] = Terminator;
+    return n;
+}
+
+/// Convert a floating point number to the shortest string that reads back to
+/// the same number (see ftoa_shortest())
+inline std::string ftoa_shortest(double f) {
+    char buf[32];
+    int  n = ftoa_shortest<false>(f, buf, sizeof(buf));
+    return std::string(buf, n);
+}
+
+namespace detail {
+    //-------------------------------------------------------------------------
+    /// Parse a decimal number with optional sign, fraction and (if
+    /// \a Exponent is true) exponent into a correctly rounded double.
+    /// Numbers with up to 15 significant digits and up to 22 decimals (such
+    /// as prices and quantities) are converted with a single floating point
+    /// multiplication or division, others with the Eisel-Lemire algorithm.
+    /// @param a_zeros when true, leading '0' characters are skipped along
+    ///                with spaces before the sign (legacy atof() behavior)
+    //-------------------------------------------------------------------------
+    template <bool Exponent>
+    inline const char* parse_double(const char* p, const char* end,
+                                    double& result, bool a_zeros)
+    {
+        const char* begin = p;
+        bool        any   = false;
+
+        // Skip leading white space, if any.
+        for (; p < end && (*p == ' ' || (a_zeros && *p == '0')); ++p)
+            any |= *p == '0';
+
+        bool neg = false;
+
+        if (p < end && (*p == '-' || *p == '+'))
+            neg = *p++ == '-';
+
+        const char* num = p;
+
+        // Accumulate up to 19 significant digits in the mantissa
+        uint64_t w      = 0;
+        int      digits = 0;
+        int64_t  exp10  = 0;
+        bool     trunc  = false;    // Some non-zero digits didn't fit the mantissa
+        unsigned d;
+
+        for (; p < end && (d = unsigned(*p - '0')) < 10u; ++p) {
+            any = true;
+            if (digits < 19) {
+                w = w * 10 + d;
+                digits += w != 0;
+            } else {
+                ++exp10;
+                trunc |= d != 0;
+            }
+        }
+
+        if (p < end && *p == '.')
+            for (++p; p < end && (d = unsigned(*p - '0')) < 10u; ++p) {
+                any = true;
+                if (digits < 19) {
+                    w = w * 10 + d;
+                    digits += w != 0;
+                    --exp10;
+                } else
+                    trunc |= d != 0;
+            }
+
+        if (UNLIKELY(!any))
+            return begin;
+
+        // Exponent is only consumed if followed by at least one digit
+        if (Exponent && p < end && (*p == 'e' || *p == 'E')) {
+            const char* q    = p + 1;
+            bool        eneg = false;
+            if (q < end && (*q == '-' || *q == '+'))
+                eneg = *q++ == '-';
+            if (q < end && unsigned(*q - '0') < 10u) {
+                int64_t e = 0;
+                for (; q < end && (d = unsigned(*q - '0')) < 10u; ++q)
+                    if (e < 100000)
+                        e = e * 10 + d;
+                exp10 += eneg ? -e : e;
+                p = q;
+            }
+        }
+
+        double value;
+
+        if (LIKELY(!trunc && w <= (1ull << 53) && exp10 >= -22 && exp10 <= 22))
+            value = exp10 < 0 ? double(w) / cs_pow10[-exp10]
+                              : double(w) * cs_pow10[ exp10];
+        else {
+            value = decimal_to_double(w, exp10);
+            // If the dropped digits could change the rounding, let the C
+            // library resolve it
+            if (UNLIKELY(trunc) && value != decimal_to_double(w + 1, exp10))
+                value = strtod(std::string(num, p).c_str(), nullptr);
+        }
+
+        result = neg ? -value : value;
+        return p;
+    }
+} // namespace detail
+
 //--------------------------------------------------------------------------------
 /// Parses floating point numbers with fixed number of decimal digits from string.
+/// Leading spaces and '0' characters are skipped, followed by an optional sign,
+/// digits and an optional decimal point with fraction (e.g. "-12.5", ".25").
+/// The exponent is not parsed (use atof_exp() for that).  The result is
+/// correctly rounded.
 /// @return pointer past the last successfully parsed character or \a p if
 /// nothing was parsed.
-//
-// atof:
-//      09-May-2009 Tom Van Baak (tvb) www.LeapSecond.com
-//      http://www.leapsecond.com/tools/fast_atof.c
-//      Contributor: 2010-10-15 Serge Aleynikov
 //--------------------------------------------------------------------------------
 template <typename T>
 inline typename std::enable_if<std::is_same<T,double>::value ||
@@ -1000,64 +1460,210 @@ inline typename std::enable_if<std::is_same<T,double>::value ||
 type atof(const char* p, const char* end, T& result)
 {
     BOOST_ASSERT(p != nullptr && end != nullptr);
+    double res;
+    const char* q = detail::parse_double<false>(p, end, res, true);
+    if (q != p)
+        result = T(res);
+    return q;
+}
 
-    // Skip leading white space, if any.
-    while (p < end && (*p == ' ' || *p == '0'))
-        ++p;
+//--------------------------------------------------------------------------------
+/// Parses a floating point number in fixed or scientific notation from string.
+/// Accepts leading spaces, an optional sign, digits with an optional decimal
+/// point, and an optional exponent (e.g. "-12.5", "1e-7", ".25").  Unlike
+/// atof(), leading '0' characters are not skipped before the sign.  The result
+/// is correctly rounded.
+/// @return pointer past the last successfully parsed character or \a p if
+/// nothing was parsed.
+//--------------------------------------------------------------------------------
+template <typename T>
+inline typename std::enable_if<std::is_same<T,double>::value ||
+                               std::is_same<T,float >::value, const char*>::
+type atof_exp(const char* p, const char* end, T& result)
+{
+    BOOST_ASSERT(p != nullptr && end != nullptr);
+    double res;
+    const char* q = detail::parse_double<true>(p, end, res, false);
+    if (q != p)
+        result = T(res);
+    return q;
+}
 
-    // Get sign, if any.
+//--------------------------------------------------------------------------------
+// Fixed-width decimal fields
+//--------------------------------------------------------------------------------
 
-    double sign = 1.0;
+namespace detail {
+    /// True if the SSE4.1 kernels can be used on this CPU
+    inline bool has_sse41() {
+      #if defined(__SSE4_1__)
+        return true;
+      #elif defined(__x86_64__) || defined(__i386__)
+        static const bool s_sse41 = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1") != 0;
+        }();
+        return s_sse41;
+      #else
+        return false;
+      #endif
+    }
 
-    if (*p == '-') {
-        sign = -1.0;
-        ++p;
-    } else if (*p == '+') {
-        ++p;
+    /// Load N (1..8) characters into a word so that they are right-aligned
+    /// in a field of 8 characters left-filled with '0'.  The first character
+    /// is placed in the lowest byte.
+    template <int N>
+    inline uint64_t load_digits8(const char* a_p) {
+        static_assert(N > 0 && N <= 8, "Invalid N");
+        uint64_t v = 0x3030303030303030ull;
+        memcpy(reinterpret_cast<char*>(&v) + 8 - N, a_p, N);
+      #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap64(v);
+      #endif
+        return v;
     }
 
-    // Get digits before decimal point or exponent, if any.
+    /// Check that all bytes of the word loaded by load_digits8() are digits
+    inline bool all_digits8(uint64_t a_v) {
+        return ((a_v & 0xF0F0F0F0F0F0F0F0ull) |
+               (((a_v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4))
+            == 0x3333333333333333ull;
+    }
 
-    double value = 0.0;
-    uint8_t n = *p - '0';
-    while (p < end && n < 10u) {
-        value = value * 10.0 + n;
-        n = *(++p) - '0';
+    /// Convert 8 digits loaded by load_digits8() to an integer in three
+    /// multiplications (D. Lemire, "Number Parsing at a Gigabyte per Second")
+    inline uint32_t swar_digits8(uint64_t a_v) {
+        a_v -= 0x3030303030303030ull;
+        a_v  = a_v * 10 + (a_v >> 8);
+        a_v  = (((a_v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+               (((a_v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+        return uint32_t(a_v);
     }
 
-    // Get digits after decimal point, if any.
+  #if defined(__x86_64__) || defined(__i386__)
+    /// Validate and convert 16 digits using SSE4.1
+    __attribute__((target("sse4.1")))
+    inline bool sse_digits16(const char* a_p, uint64_t& a_val) {
+        const __m128i nine = _mm_set1_epi8(9);
+        __m128i d = _mm_sub_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_p)), _mm_set1_epi8('0'));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine)) != 0xFFFF)
+            return false;
+        // Combine digits into groups of 2, 4 and 8 digits
+        d = _mm_maddubs_epi16(d, _mm_setr_epi8(10,1,10,1,10,1,10,1,10,1,10,1,10,1,10,1));
+        d = _mm_madd_epi16(d, _mm_setr_epi16(100,1,100,1,100,1,100,1));
+        d = _mm_packus_epi32(d, d);
+        d = _mm_madd_epi16(d, _mm_setr_epi16(10000,1,10000,1,10000,1,10000,1));
+        a_val = uint64_t(uint32_t(_mm_cvtsi128_si32(d))) * 100000000
+              + uint32_t(_mm_extract_epi32(d, 1));
+        return true;
+    }
+  #endif
 
-    if (*p == '.') {
-        ++p;
+    //-------------------------------------------------------------------------
+    // Parsing of N-digit fields: up to 8 digits are converted in a 64-bit
+    // register, up to 16 - in an SSE register (or two 64-bit registers when
+    // SSE4.1 is not available), up to 19 - in two steps.
+    //-------------------------------------------------------------------------
+    template <int N, int K = (N <= 8 ? 0 : N <= 16 ? 1 : 2)>
+    struct fixed_digits;
 
-        double pow10 = 1.0;
-        double acc   = 0.0;
-        n = *p - '0';
-        while (p < end && n < 10u) {
-            acc = acc * 10.0 + n;
-            n = *(++p) - '0';
-            pow10 *= 10.0;
+    template <int N>
+    struct fixed_digits<N, 0> {
+        static bool parse(const char* a_p, uint64_t& a_val, bool) {
+            uint64_t v = load_digits8<N>(a_p);
+            if (!all_digits8(v))
+                return false;
+            a_val = swar_digits8(v);
+            return true;
         }
-        value += acc / pow10;
-    }
+    };
 
-    result = sign * value;
-    return p;
+    template <int N>
+    struct fixed_digits<N, 1> {
+        static bool parse(const char* a_p, uint64_t& a_val, bool a_simd) {
+          #if defined(__x86_64__) || defined(__i386__)
+            if (a_simd) {
+                if (N == 16)
+                    return sse_digits16(a_p, a_val);
+                // Don't read past the field
+                char buf[16];
+                memset(buf, '0', 16 - N);
+                memcpy(buf + 16 - N, a_p, N);
+                return sse_digits16(buf, a_val);
+            }
+          #endif
+            uint64_t hi = load_digits8<N-8>(a_p);
+            uint64_t lo = load_digits8<8>(a_p + N - 8);
+            if (!all_digits8(hi) || !all_digits8(lo))
+                return false;
+            a_val = uint64_t(swar_digits8(hi)) * 100000000 + swar_digits8(lo);
+            return true;
+        }
+    };
+
+    template <int N>
+    struct fixed_digits<N, 2> {
+        static_assert(N <= 19, "At most 19 digits are supported");
+
+        static bool parse(const char* a_p, uint64_t& a_val, bool a_simd) {
+            uint64_t hi, lo;
+            if (!fixed_digits<N-16>::parse(a_p, hi, a_simd) ||
+                !fixed_digits<16>  ::parse(a_p + N - 16, lo, a_simd))
+                return false;
+            a_val = hi * 10000000000000000ull + lo;
+            return true;
+        }
+    };
+} // namespace detail
+
+/// Parse a zero-padded unsigned decimal field of exactly N (1..19) characters.
+/// Unlike unsafe_fixed_atoul(), every character is validated, and digits
+/// are converted 8 or 16 at a time using SWAR arithmetic or SSE4.1
+/// instructions selected at run time.  No bytes past the field are read.
+/// @return true if all N characters are digits, in which case \a a_value
+///         is set to the value of the field
+template <int N>
+inline bool atoul_fixed(const char* a_p, uint64_t& a_value) {
+    return detail::fixed_digits<N>::parse(a_p, a_value, N > 8 && detail::has_sse41());
+}
+
+/// Write \a a_value as exactly N zero-padded decimal digits (two digits at
+/// a time).  The value must be less than 10^N.
+/// @return pointer past the last digit written
+template <int N>
+inline char* utoa_fixed(char* a_p, uint64_t a_value) {
+    static_assert(N > 0 && N <= 20, "Invalid N");
+    BOOST_ASSERT(N == 20 || a_value < detail::cs_pow10_u64[N % 20]);
+    detail::write_digits(a_p + N, a_value, N);
+    return a_p + N;
+}
+
+/// Convert an integer to a left-aligned decimal string two digits at a time.
+/// The buffer must have space for 20 characters (21 for negative 64-bit
+/// values).  No terminator is written.
+/// @return pointer past the last character written
+template <typename T>
+inline typename std::enable_if<std::numeric_limits<T>::is_integer, char*>::
+type itoa10(T a_value, char* a_buf) {
+    typedef typename std::make_unsigned<T>::type U;
+    U u = U(a_value);
+    if (std::numeric_limits<T>::is_signed && a_value < T(0)) {
+        *a_buf++ = '-';
+        u = U(U(0) - u);
+    }
+    int len = detail::decimal_length(u);
+    detail::write_digits(a_buf + len, u, len);
+    return a_buf + len;
 }
 
 /// Convert an integer to string.
 template <typename T>
 inline typename std::enable_if<std::numeric_limits<T>::is_integer, std::string>::
 type int_to_string(T n) {
-    static const int s_size =
-        sizeof(T) == 1 ?  2 :
-        sizeof(T) == 2 ?  6 :
-        sizeof(T) == 4 ? 10 :
-        sizeof(T) == 8 ? 20 : -1;
-    static_assert(s_size != -1, "Invalid type T");
-    char buf[s_size];
-    itoa_left(buf, n);
-    return buf;
+    static_assert(sizeof(T) <= 8, "Invalid type T");
+    char buf[24];
+    return std::string(buf, itoa10(n, buf));
 }
 
 namespace detail {
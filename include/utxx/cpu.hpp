@@ -47,4 +47,144 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #  error Platform not supported!
 #endif
 
+#include <utxx/os.hpp>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace utxx {
+
+/// Topology of a logical CPU
+struct cpu_info {
+    int              id;        ///< Logical CPU id
+    int              core;      ///< Physical core id within the package
+    int              package;   ///< Physical package (socket) id
+    int              numa_node; ///< NUMA node (-1 if unknown)
+    bool             isolated;  ///< Excluded from scheduling by "isolcpus"
+    std::vector<int> siblings;  ///< Hyperthread siblings (including this CPU)
+};
+
+/// Topology of online CPUs read from sysfs
+class cpu_topology {
+    std::vector<cpu_info> m_cpus;
+    std::vector<int>      m_isolated;
+
+    static bool read_file(const std::string& a_file, std::string& a_val) {
+        std::ifstream f(a_file);
+        return f && std::getline(f, a_val);
+    }
+
+    static int read_int(const std::string& a_file, int a_default) {
+        std::string s;
+        return read_file(a_file, s) && !s.empty() ? atoi(s.c_str()) : a_default;
+    }
+
+    static std::vector<int> read_list(const std::string& a_file) {
+        std::string s;
+        return read_file(a_file, s) ? os::parse_cpu_list(s) : std::vector<int>();
+    }
+
+    static int numa_node_of(const std::string& a_cpu_dir) {
+        int node = -1;
+        if (DIR* d = ::opendir(a_cpu_dir.c_str())) {
+            while (struct dirent* e = ::readdir(d))
+                if (!strncmp(e->d_name, "node", 4) && isdigit(e->d_name[4])) {
+                    node = atoi(e->d_name + 4);
+                    break;
+                }
+            ::closedir(d);
+        }
+        return node;
+    }
+
+public:
+    /// Read the topology from the sysfs directory \a a_sysfs.
+    /// Missing information is filled in assuming one core per CPU.
+    explicit cpu_topology(const std::string& a_sysfs = "/sys/devices/system/cpu") {
+        auto online = read_list(a_sysfs + "/online");
+        if (online.empty())
+            for (unsigned i = 0; i < detail::cpu_count(); ++i)
+                online.push_back(i);
+
+        m_isolated = read_list(a_sysfs + "/isolated");
+
+        for (int cpu : online) {
+            auto dir  = a_sysfs + "/cpu" + std::to_string(cpu);
+            auto topo = dir + "/topology/";
+            cpu_info ci;
+            ci.id        = cpu;
+            ci.core      = read_int(topo + "core_id", cpu);
+            ci.package   = read_int(topo + "physical_package_id", 0);
+            ci.numa_node = numa_node_of(dir);
+            ci.isolated  = std::binary_search(m_isolated.begin(), m_isolated.end(), cpu);
+            ci.siblings  = read_list(topo + "thread_siblings_list");
+            if (ci.siblings.empty())
+                ci.siblings.push_back(cpu);
+            m_cpus.push_back(std::move(ci));
+        }
+    }
+
+    /// Topology of the current host read once
+    static const cpu_topology& instance() {
+        static const cpu_topology s_topology;
+        return s_topology;
+    }
+
+    /// Online CPUs ordered by id
+    const std::vector<cpu_info>& cpus() const { return m_cpus; }
+
+    /// Information about CPU \a a_cpu or NULL if it's not online
+    const cpu_info* find(int a_cpu) const {
+        auto it = std::lower_bound(m_cpus.begin(), m_cpus.end(), a_cpu,
+                    [](const cpu_info& a, int b) { return a.id < b; });
+        return it != m_cpus.end() && it->id == a_cpu ? &*it : nullptr;
+    }
+
+    /// Hyperthread siblings of \a a_cpu (including \a a_cpu)
+    std::vector<int> siblings(int a_cpu) const {
+        auto p = find(a_cpu);
+        return p ? p->siblings : std::vector<int>();
+    }
+
+    /// CPUs isolated from the scheduler with the "isolcpus" boot parameter
+    const std::vector<int>& isolated() const { return m_isolated; }
+
+    /// One CPU (the first hyperthread) of each physical core
+    std::vector<int> physical_cores() const {
+        std::vector<int> res;
+        for (auto& c : m_cpus) {
+            // The first online sibling represents the core
+            auto it = std::find_if(c.siblings.begin(), c.siblings.end(),
+                                   [this](int s) { return find(s) != nullptr; });
+            if (it == c.siblings.end() || *it == c.id)
+                res.push_back(c.id);
+        }
+        return res;
+    }
+
+    /// CPUs belonging to NUMA node \a a_node
+    std::vector<int> node_cpus(int a_node) const {
+        std::vector<int> res;
+        for (auto& c : m_cpus)
+            if (c.numa_node == a_node)
+                res.push_back(c.id);
+        return res;
+    }
+
+    /// Number of physical packages (sockets)
+    int packages() const {
+        int n = 0;
+        for (auto& c : m_cpus)
+            n = std::max(n, c.package + 1);
+        return n;
+    }
+};
+
+} // namespace utxx
+
 #endif // _UTXX_CPU_HPP_
@@ -35,7 +35,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define _UTXX_RUNNING_STAT_IMPL_HPP_
 
 #include <deque>
+#include <limits>
+#include <stddef.h>
 #include <utxx/compiler_hints.hpp>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #ifdef UTXX_RUNNING_MINMAX_DEBUG
 #include <iostream>
@@ -222,6 +227,123 @@ namespace detail {
 
         void update_minmax(T sample) {}
     };
+
+    /// Add the sum of \a a_n samples to \a a_sum, and update \a a_min and
+    /// \a a_max with their minimum and maximum
+    template <typename T, typename S>
+    inline void sum_minmax(const T* a_data, size_t a_n, S& a_sum, T& a_min, T& a_max) {
+        S sum = 0;
+        T mn  = a_min, mx = a_max;
+        for (size_t i = 0; i < a_n; ++i) {
+            T x  = a_data[i];
+            sum += x;
+            mn   = x < mn ? x : mn;
+            mx   = x > mx ? x : mx;
+        }
+        a_sum += sum;
+        a_min  = mn;
+        a_max  = mx;
+    }
+
+    inline void sum_minmax(const double* a_data, size_t a_n,
+                           double& a_sum, double& a_min, double& a_max) {
+        size_t i   = 0;
+        double sum = 0;
+      #if defined(__SSE2__)
+        auto s2 = _mm_setzero_pd(), mn2 = _mm_set1_pd(a_min), mx2 = _mm_set1_pd(a_max);
+      #if defined(__AVX__)
+        if (a_n >= 8) {
+            // Two sum accumulators hide the latency of addition
+            auto s4  = _mm256_setzero_pd(), t4 = _mm256_setzero_pd();
+            auto mn4 = _mm256_set1_pd(a_min), mx4 = _mm256_set1_pd(a_max);
+            for (; i + 8 <= a_n; i += 8) {
+                auto x = _mm256_loadu_pd(a_data + i);
+                auto y = _mm256_loadu_pd(a_data + i + 4);
+                s4  = _mm256_add_pd(s4, x);
+                t4  = _mm256_add_pd(t4, y);
+                mn4 = _mm256_min_pd(mn4, _mm256_min_pd(x, y));
+                mx4 = _mm256_max_pd(mx4, _mm256_max_pd(x, y));
+            }
+            s4  = _mm256_add_pd(s4, t4);
+            s2  = _mm_add_pd(_mm256_castpd256_pd128(s4), _mm256_extractf128_pd(s4, 1));
+            mn2 = _mm_min_pd(_mm256_castpd256_pd128(mn4), _mm256_extractf128_pd(mn4, 1));
+            mx2 = _mm_max_pd(_mm256_castpd256_pd128(mx4), _mm256_extractf128_pd(mx4, 1));
+        }
+      #endif
+        for (; i + 2 <= a_n; i += 2) {
+            auto x = _mm_loadu_pd(a_data + i);
+            s2  = _mm_add_pd(s2,  x);
+            mn2 = _mm_min_pd(mn2, x);
+            mx2 = _mm_max_pd(mx2, x);
+        }
+        double s[2], mn[2], mx[2];
+        _mm_storeu_pd(s,  s2);
+        _mm_storeu_pd(mn, mn2);
+        _mm_storeu_pd(mx, mx2);
+        sum   = s[0] + s[1];
+        a_min = mn[0] < mn[1] ? mn[0] : mn[1];
+        a_max = mx[0] > mx[1] ? mx[0] : mx[1];
+      #endif
+        double r = 0;
+        sum_minmax<double, double>(a_data + i, a_n - i, r, a_min, a_max);
+        a_sum += sum + r;
+    }
+
+    /// Sum of squared deviations of \a a_n samples from their mean
+    /// \a a_mean computed in the first pass.  The rounding error of the mean
+    /// is compensated by subtracting (sum(x - a_mean))^2 / a_n.
+    template <typename T>
+    inline double sum_sq_dev(const T* a_data, size_t a_n, double a_mean) {
+        double s = 0, s2 = 0;
+        for (size_t i = 0; i < a_n; ++i) {
+            double d = double(a_data[i]) - a_mean;
+            s  += d;
+            s2 += d * d;
+        }
+        return a_n ? s2 - s * s / a_n : 0.0;
+    }
+
+    inline double sum_sq_dev(const double* a_data, size_t a_n, double a_mean) {
+        size_t i = 0;
+        double s = 0, s2 = 0;
+      #if defined(__AVX__)
+        if (a_n >= 4) {
+            auto m4 = _mm256_set1_pd(a_mean);
+            auto d4 = _mm256_setzero_pd(), q4 = _mm256_setzero_pd();
+            for (; i + 4 <= a_n; i += 4) {
+                auto d = _mm256_sub_pd(_mm256_loadu_pd(a_data + i), m4);
+                d4 = _mm256_add_pd(d4, d);
+                q4 = _mm256_add_pd(q4, _mm256_mul_pd(d, d));
+            }
+            double d[4], q[4];
+            _mm256_storeu_pd(d, d4);
+            _mm256_storeu_pd(q, q4);
+            s  = (d[0] + d[1]) + (d[2] + d[3]);
+            s2 = (q[0] + q[1]) + (q[2] + q[3]);
+        }
+      #elif defined(__SSE2__)
+        if (a_n >= 2) {
+            auto m2 = _mm_set1_pd(a_mean);
+            auto d2 = _mm_setzero_pd(), q2 = _mm_setzero_pd();
+            for (; i + 2 <= a_n; i += 2) {
+                auto d = _mm_sub_pd(_mm_loadu_pd(a_data + i), m2);
+                d2 = _mm_add_pd(d2, d);
+                q2 = _mm_add_pd(q2, _mm_mul_pd(d, d));
+            }
+            double d[2], q[2];
+            _mm_storeu_pd(d, d2);
+            _mm_storeu_pd(q, q2);
+            s  = d[0] + d[1];
+            s2 = q[0] + q[1];
+        }
+      #endif
+        for (; i < a_n; ++i) {
+            double d = a_data[i] - a_mean;
+            s  += d;
+            s2 += d * d;
+        }
+        return a_n ? s2 - s * s / a_n : 0.0;
+    }
 }
 
 
@@ -0,0 +1,458 @@
+//----------------------------------------------------------------------------
+/// \file   epoch_reclaim.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Epoch-based safe memory reclamation for lock-free containers
+///
+/// A lock-free container cannot free a node as soon as it is unlinked,
+/// because concurrent readers may still hold a pointer to it (and reusing
+/// the node exposes the container to the ABA problem).  This module
+/// implements epoch-based reclamation (see K.Fraser "Practical lock
+/// freedom", 2004):
+///
+///   - A thread accessing shared nodes pins itself to the current global
+///     epoch for the duration of the operation (see epoch_domain::guard).
+///   - Unlinked nodes are retired to a per-thread bag.  Full bags are sealed
+///     with the global epoch and handed over to the domain.
+///   - The global epoch advances only when all pinned threads have observed
+///     it.  A bag sealed at epoch E is disposed of once the global epoch
+///     reaches E+2, since by then no thread can hold a reference to it.
+///
+/// Sealed bags are collected either inline by the retiring threads or by
+/// a background reclamation thread (see epoch_domain::start_reclaimer()).
+///
+/// Example:
+/// <code>
+///     epoch_domain& d = epoch_domain::global();
+///     {
+///         epoch_domain::guard g(d);
+///         node* p = m_head.load();
+///         ...                         // p is safe to dereference here
+///         if (m_head.compare_exchange_strong(p, p->next))
+///             d.retire(p);            // deleted when no longer referenced
+///     }
+/// </code>
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_EPOCH_RECLAIM_HPP_
+#define _UTXX_EPOCH_RECLAIM_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <utxx/atomic.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/thread_local.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <stdlib.h>
+
+namespace utxx   {
+namespace memory {
+
+//-----------------------------------------------------------------------------
+/// Epoch-based reclamation domain.
+/// Containers sharing a domain share the epoch and the retire lists.
+/// Most applications can use the process-wide epoch_domain::global().
+//-----------------------------------------------------------------------------
+class epoch_domain : boost::noncopyable {
+public:
+    /// Function disposing of a retired object \a a_ptr.
+    /// \a a_ctx is the context pointer passed to retire().
+    using deleter_fun = void (*)(void* a_ctx, void* a_ptr);
+
+    /// Number of retired objects accumulated by a thread before they
+    /// are handed over to the domain for reclamation
+    enum { s_bag_size = 64 };
+
+private:
+    struct retired {
+        void*       ptr;
+        deleter_fun fun;
+        void*       ctx;
+    };
+
+    struct bag {
+        bag*        next;
+        uint64_t    epoch;
+        int         count;
+        retired     items[s_bag_size];
+
+        bag() : next(nullptr), epoch(0), count(0) {}
+
+        void dispose() {
+            for (int i = 0; i < count; ++i)
+                items[i].fun(items[i].ctx, items[i].ptr);
+            count = 0;
+        }
+    };
+
+    /// Per-thread record.  Records are never freed until the domain is
+    /// destroyed, and are reused by new threads after the owner exits.
+    struct thread_rec {
+        /// (epoch << 1) | 1 while the thread is pinned, 0 otherwise
+        std::atomic<uint64_t>    epoch;
+        std::atomic<bool>        in_use;
+        int                      nesting;
+        bag*                     current;
+        thread_rec*              next;
+        epoch_domain*            domain;
+        char                     pad[UTXX_CL_SIZE];
+    };
+
+    std::atomic<uint64_t>        m_epoch;
+    char                         m_pad[UTXX_CL_SIZE - sizeof(uint64_t)];
+    std::atomic<thread_rec*>     m_records;
+    std::atomic<bag*>            m_sealed;
+    std::atomic<long>            m_pending;
+    thr_local_ptr<thread_rec, epoch_domain> m_local;
+
+    std::atomic<bool>            m_background;
+    std::thread                  m_reclaimer;
+    std::mutex                   m_mutex;
+    std::condition_variable      m_cond;
+    bool                         m_stop;
+
+    template <class T>
+    static void delete_fun(void*, void* a_ptr) { delete static_cast<T*>(a_ptr); }
+
+    thread_rec* local() {
+        thread_rec* r = m_local.get();
+        return LIKELY(r != nullptr) ? r : register_thread();
+    }
+
+    thread_rec* register_thread();
+    void        unregister_thread(thread_rec* a_rec);
+    void        seal(bag* a_bag);
+    void        reclaimer_loop(long a_interval_usec);
+
+public:
+    //-------------------------------------------------------------------------
+    /// RAII guard pinning the calling thread to the current epoch.
+    /// Pointers to shared nodes loaded while the guard is alive remain
+    /// valid until the guard is destroyed.  Guards can be nested.
+    //-------------------------------------------------------------------------
+    class guard : boost::noncopyable {
+        thread_rec* m_rec;
+    public:
+        explicit guard(epoch_domain& a_domain) : m_rec(a_domain.enter()) {}
+        ~guard() { epoch_domain::leave(m_rec); }
+    };
+
+    epoch_domain()
+        : m_epoch(1), m_records(nullptr), m_sealed(nullptr), m_pending(0)
+        , m_background(false), m_stop(false)
+    {}
+
+    /// The domain must not be destroyed while any thread is using it.
+    /// All retired objects are disposed of.
+    ~epoch_domain();
+
+    /// Process-wide default domain
+    static epoch_domain& global() {
+        static epoch_domain s_domain;
+        return s_domain;
+    }
+
+    /// Pin the calling thread to the current epoch.
+    /// Prefer using epoch_domain::guard.
+    thread_rec* enter() {
+        thread_rec* r = local();
+        if (r->nesting++ == 0) {
+            // The announcement must be visible before any shared node is
+            // loaded.  On x86 a locked exchange is a full barrier, and is
+            // cheaper than an exchange followed by a fence.
+            uint64_t e = (m_epoch.load(std::memory_order_relaxed) << 1) | 1;
+            r->epoch.exchange(e, std::memory_order_seq_cst);
+            #if !defined(__x86_64__) && !defined(__i386__)
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            #endif
+        }
+        return r;
+    }
+
+    /// Unpin the thread previously pinned by enter().
+    static void leave(thread_rec* a_rec) {
+        if (--a_rec->nesting == 0)
+            a_rec->epoch.store(0, std::memory_order_release);
+    }
+
+    /// Retire an object unlinked from a shared structure.
+    /// \a a_fun(a_ctx, a_ptr) is called once no pinned thread can
+    /// reference the object.
+    void retire(void* a_ptr, deleter_fun a_fun, void* a_ctx = nullptr) {
+        thread_rec* r = local();
+        bag*        b = r->current;
+        b->items[b->count++] = retired{a_ptr, a_fun, a_ctx};
+        if (UNLIKELY(b->count == s_bag_size)) {
+            r->current = new bag();
+            seal(b);
+            if (!m_background.load(std::memory_order_relaxed))
+                collect();
+        }
+    }
+
+    /// Retire an object to be deleted with the delete operator.
+    template <class T>
+    void retire(T* a_ptr) { retire(a_ptr, &delete_fun<T>); }
+
+    /// Hand over the calling thread's partially filled retire bag to the
+    /// domain, so that it can be collected without waiting for more
+    /// retirements from this thread.
+    void flush();
+
+    /// Try to advance the global epoch.
+    /// @return true if all pinned threads observed the current epoch and
+    ///         it was advanced
+    bool try_advance();
+
+    /// Advance the epoch if possible and dispose of all sealed bags that
+    /// are no longer referenced.
+    /// @return number of objects disposed of
+    long collect();
+
+    /// Repeatedly collect until all sealed bags are disposed of or the
+    /// given number of attempts is exhausted.  The calling thread must not
+    /// be pinned.
+    /// @return number of objects that remain pending
+    long drain(int a_attempts = 16);
+
+    /// Start a background thread collecting sealed bags every
+    /// \a a_interval_usec microseconds.  When the reclaimer is running,
+    /// retiring threads don't collect inline.
+    void start_reclaimer(long a_interval_usec = 1000);
+
+    /// Stop the background reclamation thread.
+    void stop_reclaimer();
+
+    /// Current value of the global epoch
+    uint64_t epoch()   const { return m_epoch.load(std::memory_order_relaxed); }
+
+    /// Number of retired objects in sealed bags awaiting reclamation
+    long     pending() const { return m_pending.load(std::memory_order_relaxed); }
+};
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+inline epoch_domain::~epoch_domain()
+{
+    stop_reclaimer();
+
+    for (bag* b = m_sealed.exchange(nullptr); b; ) {
+        bag* next = b->next;
+        b->dispose();
+        delete b;
+        b = next;
+    }
+
+    for (thread_rec* r = m_records.exchange(nullptr); r; ) {
+        thread_rec* next = r->next;
+        if (r->current) {
+            r->current->dispose();
+            delete r->current;
+        }
+        r->~thread_rec();
+        ::free(r);
+        r = next;
+    }
+}
+
+inline epoch_domain::thread_rec* epoch_domain::register_thread()
+{
+    thread_rec* r = m_records.load(std::memory_order_acquire);
+
+    // Reuse a record released by an exited thread
+    for (; r; r = r->next) {
+        bool free = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+             r->in_use.compare_exchange_strong(free, true))
+            break;
+    }
+
+    if (!r) {
+        void* p;
+        if (::posix_memalign(&p, UTXX_CL_SIZE, sizeof(thread_rec)) != 0)
+            throw std::bad_alloc();
+        r = new (p) thread_rec();
+        r->epoch.store(0, std::memory_order_relaxed);
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->domain  = this;
+        r->current = nullptr;
+        r->next    = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(r->next, r,
+                    std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    r->nesting = 0;
+    if (!r->current)
+        r->current = new bag();
+
+    // On thread exit the record is released back to the domain.  When the
+    // domain itself is destroyed the records are freed by the destructor.
+    m_local.reset(r, [](thread_rec* a_rec, tlp_destruct_mode a_mode) {
+        if (a_mode == tlp_destruct_mode::THIS_THREAD)
+            a_rec->domain->unregister_thread(a_rec);
+    });
+    return r;
+}
+
+inline void epoch_domain::unregister_thread(thread_rec* a_rec)
+{
+    if (a_rec->current && a_rec->current->count) {
+        seal(a_rec->current);
+        a_rec->current = nullptr;
+    }
+    a_rec->nesting = 0;
+    a_rec->epoch.store(0, std::memory_order_relaxed);
+    a_rec->in_use.store(false, std::memory_order_release);
+}
+
+inline void epoch_domain::seal(bag* a_bag)
+{
+    // Objects in the bag were unlinked no later than the current epoch
+    a_bag->epoch = m_epoch.load(std::memory_order_acquire);
+    m_pending.fetch_add(a_bag->count, std::memory_order_relaxed);
+    a_bag->next  = m_sealed.load(std::memory_order_relaxed);
+    while (!m_sealed.compare_exchange_weak(a_bag->next, a_bag,
+                std::memory_order_release, std::memory_order_relaxed));
+}
+
+inline void epoch_domain::flush()
+{
+    thread_rec* r = local();
+    if (r->current->count) {
+        seal(r->current);
+        r->current = new bag();
+    }
+}
+
+inline bool epoch_domain::try_advance()
+{
+    uint64_t e = m_epoch.load(std::memory_order_relaxed);
+
+    // Pairs with the barrier in enter()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (thread_rec* r = m_records.load(std::memory_order_acquire); r; r = r->next) {
+        uint64_t n = r->epoch.load(std::memory_order_acquire);
+        if ((n & 1) && (n >> 1) != e)
+            return false;
+    }
+
+    return m_epoch.compare_exchange_strong(e, e+1, std::memory_order_acq_rel);
+}
+
+inline long epoch_domain::collect()
+{
+    try_advance();
+
+    uint64_t e    = m_epoch.load(std::memory_order_acquire);
+    // Take ownership of the whole list, so that concurrent collectors
+    // never dispose of the same bag
+    bag*     list = m_sealed.exchange(nullptr, std::memory_order_acquire);
+    bag*     keep = nullptr;
+    bag*     tail = nullptr;
+    long     n    = 0;
+
+    while (list) {
+        bag* b = list;
+        list   = b->next;
+        if (b->epoch + 2 <= e) {
+            n += b->count;
+            b->dispose();
+            delete b;
+        } else {
+            b->next = keep;
+            keep    = b;
+            if (!tail) tail = b;
+        }
+    }
+
+    if (keep) {
+        tail->next = m_sealed.load(std::memory_order_relaxed);
+        while (!m_sealed.compare_exchange_weak(tail->next, keep,
+                    std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    if (n)
+        m_pending.fetch_sub(n, std::memory_order_relaxed);
+    return n;
+}
+
+inline long epoch_domain::drain(int a_attempts)
+{
+    for (int i = 0; i < a_attempts && pending() > 0; ++i)
+        if (!collect())
+            std::this_thread::yield();
+    return pending();
+}
+
+inline void epoch_domain::start_reclaimer(long a_interval_usec)
+{
+    std::lock_guard<std::mutex> g(m_mutex);
+    if (m_reclaimer.joinable())
+        return;
+    m_stop      = false;
+    m_reclaimer = std::thread([this, a_interval_usec] {
+        reclaimer_loop(a_interval_usec);
+    });
+    m_background.store(true, std::memory_order_relaxed);
+}
+
+inline void epoch_domain::stop_reclaimer()
+{
+    {
+        std::lock_guard<std::mutex> g(m_mutex);
+        if (!m_reclaimer.joinable())
+            return;
+        m_stop = true;
+    }
+    m_cond.notify_one();
+    m_reclaimer.join();
+    m_reclaimer = std::thread();
+    m_background.store(false, std::memory_order_relaxed);
+}
+
+inline void epoch_domain::reclaimer_loop(long a_interval_usec)
+{
+    std::unique_lock<std::mutex> g(m_mutex);
+    while (!m_stop) {
+        g.unlock();
+        collect();
+        g.lock();
+        m_cond.wait_for(g, std::chrono::microseconds(a_interval_usec));
+    }
+}
+
+} // namespace memory
+} // namespace utxx
+
+#endif // _UTXX_EPOCH_RECLAIM_HPP_
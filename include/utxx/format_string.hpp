@@ -0,0 +1,455 @@
+//----------------------------------------------------------------------------
+/// \file   format_string.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Format strings with "{}" replacement fields parsed at compile time.
+///
+/// A format string is wrapped in a type by the UTXX_FMT() macro, so that it
+/// is parsed by constexpr functions when the formatting code is instantiated.
+/// Every replacement field is checked against the type of its argument, the
+/// number of fields is checked against the number of arguments, and the
+/// maximum length of the output is computed statically (plus the lengths of
+/// string arguments).  Formatting then takes a single capacity check followed
+/// by straight-line stores:
+/// \code
+///   buffered_print buf;
+///   buf.format(UTXX_FMT("{} {:>8} @ {:.2f} [{:08x}]"), side, qty, px, id);
+///   std::string s = utxx::format(UTXX_FMT("{:<6}|{}"), "abc", 1.5);
+/// \endcode
+///
+/// Replacement field syntax (a subset of the one of std::format):
+/// \code
+///   {[:[[fill]align][0][width][.precision][type]]}
+///     align      '<' (default for strings) or '>' (default for numbers)
+///     0          sign-aware zero padding of numbers
+///     precision  digits after the decimal point of floating point numbers
+///                (trailing zeros are trimmed unless type is 'f'), or
+///                the maximum number of characters of strings
+///     type       'd', 'x', 'X' for integers, 'f' for floating point,
+///                's' for strings and bool, 'c' for char
+/// \endcode
+/// Floating point numbers without precision are printed in the shortest
+/// form that reads back to the same value (see ftoa_shortest()).
+/// "{{" and "}}" stand for literal braces.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_FORMAT_STRING_HPP_
+#define _UTXX_FORMAT_STRING_HPP_
+
+#include <utxx/convert.hpp>
+#include <cmath>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <string.h>
+
+namespace utxx {
+
+/// Format string known at compile time.  Use UTXX_FMT() to create one.
+/// @tparam S class with a static constexpr str() method returning the string
+template <class S>
+struct format_string {
+    static constexpr const char* str() { return S::str(); }
+};
+
+/// Create a compile-time format string from a string literal
+#define UTXX_FMT(Str)                                                         \
+    ([] {                                                                     \
+        struct utxx_fmt_str { static constexpr const char* str() { return Str; } }; \
+        return utxx::format_string<utxx_fmt_str>();                           \
+    }())
+
+namespace detail {
+    //-------------------------------------------------------------------------
+    // Parsing of the format string
+    //-------------------------------------------------------------------------
+
+    /// Node of a format string: a literal text or a replacement field
+    struct fmt_node {
+        int  begin;     // Offset of the literal text
+        int  len;       // Length of the literal text (-1 for a field)
+        int  arg;       // Argument index of the field
+        char fill;
+        char align;     // '<', '>' or '\0' (default)
+        bool zero;      // Sign-aware zero padding
+        int  width;
+        int  precision; // -1 if not given
+        char type;      // '\0' or one of "dxXfsc"
+        int  next;      // Offset of the next node (-1 if malformed)
+    };
+
+    constexpr bool fmt_digit(char c) { return c >= '0' && c <= '9'; }
+
+    /// Parse the node starting at offset \a i of the format string \a s.
+    /// \a a_arg is the number of fields preceding the node.
+    constexpr fmt_node fmt_parse(const char* s, int i, int a_arg) {
+        fmt_node n{i, 0, a_arg, ' ', '\0', false, 0, -1, '\0', -1};
+
+        if ((s[i] == '{' && s[i+1] == '{') || (s[i] == '}' && s[i+1] == '}')) {
+            n.len  = 1;
+            n.next = i + 2;
+            return n;
+        }
+        if (s[i] == '}')        // Unmatched '}'
+            return n;
+        if (s[i] != '{') {
+            int j = i;
+            while (s[j] && s[j] != '{' && s[j] != '}') ++j;
+            n.len  = j - i;
+            n.next = j;
+            return n;
+        }
+
+        n.len = -1;
+        int p = i + 1;
+        if (s[p] == ':') {
+            ++p;
+            if (s[p] && s[p] != '}' && (s[p+1] == '<' || s[p+1] == '>')) {
+                n.fill  = s[p];
+                n.align = s[p+1];
+                p += 2;
+            } else if (s[p] == '<' || s[p] == '>')
+                n.align = s[p++];
+
+            if (!n.align && s[p] == '0') {
+                n.zero = true;
+                ++p;
+            }
+            while (fmt_digit(s[p]))
+                n.width = n.width * 10 + (s[p++] - '0');
+            if (s[p] == '.') {
+                if (!fmt_digit(s[++p]))
+                    return n;
+                n.precision = 0;
+                while (fmt_digit(s[p]))
+                    n.precision = n.precision * 10 + (s[p++] - '0');
+            }
+            switch (s[p]) {
+                case 'd': case 'x': case 'X': case 'f': case 's': case 'c':
+                    n.type = s[p++];
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (s[p] == '}')
+            n.next = p + 1;
+        return n;
+    }
+
+    /// Number of nodes (or fields if \a a_fields is true) of the format
+    /// string, or -1 if it is malformed
+    constexpr int fmt_count(const char* s, bool a_fields) {
+        int nodes = 0, fields = 0;
+        for (int i = 0; s[i]; ) {
+            fmt_node n = fmt_parse(s, i, fields);
+            if (n.next < 0)
+                return -1;
+            ++nodes;
+            if (n.len < 0)
+                ++fields;
+            i = n.next;
+        }
+        return a_fields ? fields : nodes;
+    }
+
+    /// The \a k-th node of a well-formed format string
+    constexpr fmt_node fmt_get(const char* s, int k) {
+        int i = 0, fields = 0;
+        while (true) {
+            fmt_node n = fmt_parse(s, i, fields);
+            if (k-- == 0)
+                return n;
+            if (n.len < 0)
+                ++fields;
+            i = n.next;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Formatting of arguments
+    //-------------------------------------------------------------------------
+
+    enum class fmt_kind { INT, BOOL, CHAR, FLOAT, STRING, NONE };
+
+    template <class T, class D = typename std::decay<T>::type>
+    struct fmt_kind_of : std::integral_constant<fmt_kind,
+        std::is_same<D, bool>::value        ? fmt_kind::BOOL   :
+        std::is_same<D, char>::value        ? fmt_kind::CHAR   :
+        std::is_integral<D>::value          ? fmt_kind::INT    :
+        std::is_floating_point<D>::value    ? fmt_kind::FLOAT  :
+        std::is_same<D, const char*>::value ||
+        std::is_same<D, char*>::value       ||
+        std::is_same<D, std::string>::value ? fmt_kind::STRING :
+                                              fmt_kind::NONE>
+    {};
+
+    template <fmt_kind K>
+    using fmt_kind_t = std::integral_constant<fmt_kind, K>;
+
+    inline size_t      fmt_len (const char* s)        { return s ? strlen(s) : 0; }
+    inline size_t      fmt_len (const std::string& s) { return s.size();          }
+    inline const char* fmt_data(const char* s)        { return s;                 }
+    inline const char* fmt_data(const std::string& s) { return s.data();          }
+
+    template <bool Upper, class T>
+    inline char* fmt_hex(char* p, T a_val) {
+        typedef typename std::make_unsigned<T>::type U;
+        static const char* s_digits = Upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        U   u = U(a_val);
+        int n = 1;
+        for (U t = U(u >> 4); t; t = U(t >> 4)) ++n;
+        for (char* q = p + n; q != p; u = U(u >> 4))
+            *--q = s_digits[u & 0xF];
+        return p + n;
+    }
+
+    /// Pad the text [p, e) to the field's width
+    template <char Fill, char Align, bool Zero, int Width>
+    inline char* fmt_pad(char* p, char* e, bool a_numeric) {
+        size_t n = size_t(e - p);
+        if (size_t(Width) <= n)
+            return e;
+        size_t pad = Width - n;
+        if (Align == '<' || (Align == '\0' && !a_numeric))
+            memset(e, Fill, pad);
+        else if (Zero && a_numeric) {
+            size_t s = n > 0 && *p == '-';
+            memmove(p + s + pad, p + s, n - s);
+            memset(p + s, '0', pad);
+        } else {
+            memmove(p + pad, p, n);
+            memset(p, Fill, pad);
+        }
+        return p + Width;
+    }
+
+    template <int A, int B>
+    struct fmt_max : std::integral_constant<int, (A > B ? A : B)> {};
+
+    /// Formatter of a replacement field
+    template <char Fill, char Align, bool Zero, int Width, int Prec, char Type>
+    struct fmt_field {
+        /// Maximum number of characters written for the argument
+        template <class T>
+        static size_t size(const T& a) { return size(a, fmt_kind_of<T>()); }
+
+        /// Write the argument, \a p must have room for size() characters
+        template <class T>
+        static char* write(char* p, const T& a) { return write(p, a, fmt_kind_of<T>()); }
+
+    private:
+        template <class T>
+        static size_t size(const T&, fmt_kind_t<fmt_kind::INT>) {
+            return fmt_max<Width, (Type == 'x' || Type == 'X')
+                                  ? int(2 * sizeof(T))
+                                  : std::numeric_limits<T>::digits10 + 2>::value;
+        }
+        template <class T>
+        static size_t size(const T&, fmt_kind_t<fmt_kind::FLOAT>) {
+            // Shortest form takes at most 24 characters, fixed form - the
+            // sign, 16 integer digits, decimal point and the fraction
+            return fmt_max<Width, fmt_max<32, Prec + 20>::value>::value;
+        }
+        template <class T>
+        static size_t size(const T&, fmt_kind_t<fmt_kind::BOOL>) {
+            return fmt_max<Width, 5>::value;
+        }
+        template <class T>
+        static size_t size(const T&, fmt_kind_t<fmt_kind::CHAR>) {
+            return fmt_max<Width, 1>::value;
+        }
+        template <class T>
+        static size_t size(const T& a, fmt_kind_t<fmt_kind::STRING>) {
+            if (Prec >= 0)
+                return fmt_max<Width, Prec>::value;
+            size_t n = fmt_len(a);
+            return n > size_t(Width) ? n : size_t(Width);
+        }
+        template <class T>
+        static size_t size(const T&, fmt_kind_t<fmt_kind::NONE>) {
+            static_assert(sizeof(T) == 0, "Unsupported type of format argument");
+            return 0;
+        }
+
+        template <class T>
+        static char* write(char* p, T a, fmt_kind_t<fmt_kind::INT>) {
+            static_assert(Prec < 0, "Precision is not allowed for integers");
+            static_assert(!Type || Type == 'd' || Type == 'x' || Type == 'X',
+                          "Invalid type of integer format field");
+            char* e = Type == 'x' ? fmt_hex<false>(p, a)
+                    : Type == 'X' ? fmt_hex<true> (p, a)
+                    : itoa10(a, p);
+            return fmt_pad<Fill, Align, Zero, Width>(p, e, true);
+        }
+        template <class T>
+        static char* write(char* p, T a, fmt_kind_t<fmt_kind::FLOAT>) {
+            static_assert(!Type || Type == 'f', "Invalid type of floating point format field");
+            static_assert(Prec < FTOA::MAX_DECIMALS, "Precision is too large");
+            static_assert(Type != 'f' || Prec >= 0, "Type 'f' requires precision");
+            double v = double(a);
+            char*  e;
+            if (Prec < 0 || !std::isfinite(v) || std::abs(v) >= double(FTOA::MAX_FLOAT))
+                e = p + ftoa_shortest<false>(v, p, 32);
+            else
+                e = p + ftoa_left<false>(v, p, Prec + 20, Prec, Type != 'f');
+            return fmt_pad<Fill, Align, Zero, Width>(p, e, true);
+        }
+        template <class T>
+        static char* write(char* p, T a, fmt_kind_t<fmt_kind::BOOL>) {
+            static_assert(Prec < 0 && !Zero, "Precision or zero padding of bool");
+            static_assert(!Type || Type == 's', "Invalid type of bool format field");
+            memcpy(p, a ? "true" : "false", 5);
+            return fmt_pad<Fill, Align, false, Width>(p, p + (a ? 4 : 5), false);
+        }
+        template <class T>
+        static char* write(char* p, T a, fmt_kind_t<fmt_kind::CHAR>) {
+            static_assert(Prec < 0 && !Zero, "Precision or zero padding of char");
+            static_assert(!Type || Type == 'c', "Invalid type of char format field");
+            *p = a;
+            return fmt_pad<Fill, Align, false, Width>(p, p + 1, false);
+        }
+        template <class T>
+        static char* write(char* p, const T& a, fmt_kind_t<fmt_kind::STRING>) {
+            static_assert(!Zero, "Zero padding of string");
+            static_assert(!Type || Type == 's', "Invalid type of string format field");
+            size_t n = fmt_len(a);
+            if (Prec >= 0 && n > size_t(Prec))
+                n = Prec;
+            memcpy(p, fmt_data(a), n);
+            return fmt_pad<Fill, Align, false, Width>(p, p + n, false);
+        }
+        template <class T>
+        static char* write(char* p, const T&, fmt_kind_t<fmt_kind::NONE>) { return p; }
+    };
+
+    /// Sizing and formatting of the \a I-th node of the format string \a S
+    template <class S, int I, bool Field = (fmt_get(S::str(), I).len < 0)>
+    struct fmt_emit;
+
+    template <class S, int I>
+    struct fmt_emit<S, I, false> {
+        enum {
+              BEGIN = fmt_get(S::str(), I).begin
+            , LEN   = fmt_get(S::str(), I).len
+        };
+
+        template <class Tuple>
+        static size_t size(const Tuple&) { return LEN; }
+
+        template <class Tuple>
+        static char* write(char* p, const Tuple&) {
+            memcpy(p, S::str() + BEGIN, LEN);
+            return p + LEN;
+        }
+    };
+
+    template <class S, int I>
+    struct fmt_emit<S, I, true> {
+        enum {
+              ARG   = fmt_get(S::str(), I).arg
+            , FILL  = fmt_get(S::str(), I).fill
+            , ALIGN = fmt_get(S::str(), I).align
+            , ZERO  = fmt_get(S::str(), I).zero
+            , WIDTH = fmt_get(S::str(), I).width
+            , PREC  = fmt_get(S::str(), I).precision
+            , TYPE  = fmt_get(S::str(), I).type
+        };
+
+        typedef fmt_field<char(FILL), char(ALIGN), bool(ZERO),
+                          int(WIDTH), int(PREC), char(TYPE)> field;
+
+        template <class Tuple>
+        static size_t size(const Tuple& a) { return field::size(std::get<ARG>(a)); }
+
+        template <class Tuple>
+        static char* write(char* p, const Tuple& a) {
+            return field::write(p, std::get<ARG>(a));
+        }
+    };
+
+    template <class S, class... Args>
+    struct fmt_check {
+        enum {
+              NODES  = fmt_count(S::str(), false)
+            , FIELDS = fmt_count(S::str(), true)
+        };
+        static_assert(NODES >= 0, "Malformed format string");
+        static_assert(NODES < 0 || FIELDS == int(sizeof...(Args)),
+                      "Number of arguments doesn't match the format string");
+
+        typedef std::make_integer_sequence<int, (NODES > 0 ? NODES : 0)> nodes;
+    };
+
+    template <class S, class Tuple, int... I>
+    inline size_t fmt_size(const Tuple& a, std::integer_sequence<int, I...>) {
+        size_t n = 0;
+        int dummy[] = { 0, (n += fmt_emit<S, I>::size(a), 0)... };
+        (void)dummy;
+        return n;
+    }
+
+    template <class S, class Tuple, int... I>
+    inline char* fmt_write(char* p, const Tuple& a, std::integer_sequence<int, I...>) {
+        int dummy[] = { 0, (p = fmt_emit<S, I>::write(p, a), 0)... };
+        (void)dummy;
+        return p;
+    }
+} // namespace detail
+
+/// Maximum number of characters that format_to() writes for the arguments.
+/// Only the lengths of string arguments are computed at run time.
+template <class S, class... Args>
+inline size_t format_size(format_string<S>, const Args&... a_args) {
+    typedef detail::fmt_check<S, Args...> check;
+    return detail::fmt_size<S>(std::forward_as_tuple(a_args...), typename check::nodes());
+}
+
+/// Format the arguments to \a a_buf, which must have room for at least
+/// format_size() characters.  No terminator is written.
+/// @return pointer past the last character written
+template <class S, class... Args>
+inline char* format_to(char* a_buf, format_string<S>, const Args&... a_args) {
+    typedef detail::fmt_check<S, Args...> check;
+    return detail::fmt_write<S>(a_buf, std::forward_as_tuple(a_args...),
+                                typename check::nodes());
+}
+
+/// Format the arguments to a string
+template <class S, class... Args>
+inline std::string format(format_string<S> a_fmt, const Args&... a_args) {
+    std::string s(format_size(a_fmt, a_args...), '\0');
+    char* b = &s[0];
+    s.resize(format_to(b, a_fmt, a_args...) - b);
+    return s;
+}
+
+} // namespace utxx
+
+#endif // _UTXX_FORMAT_STRING_HPP_
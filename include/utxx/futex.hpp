@@ -41,8 +41,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <errno.h>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
 #include <mutex>
+#include <thread>
 #include <condition_variable>
+#include <utxx/compiler_hints.hpp>
 
 //-----------------------------------------------------------------------------
 
@@ -70,6 +73,20 @@ wakeup_result futex_wait_slow(int* old, int val, const timespec* rel = 0);
 /// @return 0 on success and -1 on error.
 int           futex_wake_slow(int* value, int count = 1);
 
+/// Call FUTEX_WAIT_BITSET and loop in case of EINTR. The caller is only
+/// woken by futex_wake_bitset_slow() calls whose bitset intersects \a bitset.
+/// @param abs absolute CLOCK_MONOTONIC deadline (NULL means infinity)
+/// @return same as futex_wait_slow()
+wakeup_result futex_wait_bitset_slow(int* old, int val, uint32_t bitset,
+                                     const timespec* abs = 0);
+
+/// Wake up \a count threads waiting for the futex associated with \a value
+/// whose wait bitsets intersect \a bitset.
+/// Note: function loops on EINTR.
+/// @return number of threads woken up or -1 on error.
+int           futex_wake_bitset_slow(int* value, uint32_t bitset,
+                                     int count = INT_MAX);
+
 /** Fast futex-based concurrent notification primitive.
  * Supports signal/wait semantics.
  */
@@ -270,6 +287,265 @@ private:
     std::atomic<int> m_count;
 };
 
+namespace detail {
+    /// Spin-wait hint to the CPU
+    inline void cpu_relax() {
+        #if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+        #elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+        #endif
+    }
+
+    template <bool Stats> struct adaptive_mutex_counters {
+        void add(unsigned long, unsigned long, unsigned long, unsigned long) {}
+        void reset() {}
+    };
+
+    template <> struct adaptive_mutex_counters<true> {
+        std::atomic<unsigned long> acquisitions{0};
+        std::atomic<unsigned long> contended{0};
+        std::atomic<unsigned long> spins{0};
+        std::atomic<unsigned long> parks{0};
+        std::atomic<unsigned long> wait_ns{0};
+
+        // Called by the lock owner, so updates don't need to be atomic RMWs
+        static void inc(std::atomic<unsigned long>& a_cnt, unsigned long a_n) {
+            a_cnt.store(a_cnt.load(std::memory_order_relaxed) + a_n,
+                        std::memory_order_relaxed);
+        }
+
+        void add(unsigned long a_contended, unsigned long a_spins,
+                 unsigned long a_parks,     unsigned long a_wait_ns)
+        {
+            inc(acquisitions, 1);
+            if (!a_contended)
+                return;
+            inc(contended, 1);
+            inc(spins,     a_spins);
+            inc(parks,     a_parks);
+            inc(wait_ns,   a_wait_ns);
+        }
+
+        void reset() {
+            for (auto* p : {&acquisitions, &contended, &spins, &parks, &wait_ns})
+                p->store(0, std::memory_order_relaxed);
+        }
+    };
+}
+
+/// Contention statistics of basic_adaptive_mutex<true>
+struct adaptive_mutex_stats {
+    unsigned long acquisitions; ///< Number of times the mutex was locked
+    unsigned long contended;    ///< Number of lock() calls that had to wait
+    unsigned long spins;        ///< Total spin iterations of contended calls
+    unsigned long parks;        ///< Number of times a thread slept on the futex
+    unsigned long wait_ns;      ///< Total time spent in contended lock() calls
+};
+
+/// Adaptive spin-then-park mutex.
+///
+/// A contended lock() spins with a CPU pause for up to a learned number of
+/// iterations before sleeping on a futex.  The spin budget tracks the number
+/// of iterations it took to acquire the mutex by spinning (an estimate of
+/// the owner's hold time), and shrinks when spinning fails, so that locks
+/// held for a short time are acquired without a context switch, and locks
+/// held for long don't burn CPU.  On uniprocessor systems it never spins.
+///
+/// @tparam Stats collect contention statistics (see stats())
+template <bool Stats = false>
+class basic_adaptive_mutex {
+    enum { UNLOCKED, LOCKED, CONTENDED };
+
+    std::atomic<int> m_state;
+    std::atomic<int> m_spin;    // Learned spin budget
+    detail::adaptive_mutex_counters<Stats> m_stats;
+
+    static bool smp() {
+        static const bool s_smp = std::thread::hardware_concurrency() > 1;
+        return s_smp;
+    }
+
+    static unsigned long now_ns() {
+        if (!Stats) return 0;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void lock_slow();
+
+public:
+    typedef std::lock_guard<basic_adaptive_mutex> scoped_lock;
+
+    /// Maximum number of spin iterations before parking
+    enum { s_max_spin = 1000 };
+
+    basic_adaptive_mutex() : m_state(UNLOCKED), m_spin(s_max_spin / 10) {}
+
+    basic_adaptive_mutex(const basic_adaptive_mutex&) = delete;
+    basic_adaptive_mutex& operator=(const basic_adaptive_mutex&) = delete;
+
+    void lock() {
+        int s = UNLOCKED;
+        if (LIKELY(m_state.compare_exchange_strong(s, LOCKED, std::memory_order_acquire,
+                                                   std::memory_order_relaxed))) {
+            m_stats.add(0, 0, 0, 0);
+            return;
+        }
+        lock_slow();
+    }
+
+    bool try_lock() {
+        int s = UNLOCKED;
+        if (!m_state.compare_exchange_strong(s, LOCKED, std::memory_order_acquire,
+                                             std::memory_order_relaxed))
+            return false;
+        m_stats.add(0, 0, 0, 0);
+        return true;
+    }
+
+    void unlock() {
+        if (UNLIKELY(m_state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED))
+            futex_wake_slow(reinterpret_cast<int*>(&m_state), 1);
+    }
+
+    /// Returns true if mutex is locked
+    bool locked()     const { return m_state.load(std::memory_order_relaxed) != UNLOCKED; }
+
+    /// Current spin budget of a contended lock() call
+    int  spin_count() const { return m_spin.load(std::memory_order_relaxed); }
+
+    /// Snapshot of contention statistics (all zeros unless Stats is true)
+    adaptive_mutex_stats stats() const;
+
+    /// Reset contention statistics
+    void reset_stats() { m_stats.reset(); }
+};
+
+typedef basic_adaptive_mutex<false> adaptive_mutex;
+typedef basic_adaptive_mutex<true>  adaptive_stats_mutex;
+
+template <bool Stats>
+void basic_adaptive_mutex<Stats>::lock_slow()
+{
+    unsigned long start = now_ns();
+    int           spin  = m_spin.load(std::memory_order_relaxed);
+    int           max   = smp() ? std::min<int>(int(s_max_spin), 2*spin + 10) : 0;
+    int           cnt   = 0;
+
+    while (cnt < max) {
+        ++cnt;
+        detail::cpu_relax();
+        int s = m_state.load(std::memory_order_relaxed);
+        if (s == UNLOCKED &&
+            m_state.compare_exchange_weak(s, LOCKED, std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+            // Move the budget towards the observed wait
+            m_spin.store(spin + (cnt - spin) / 8, std::memory_order_relaxed);
+            m_stats.add(1, cnt, 0, now_ns() - start);
+            return;
+        }
+    }
+
+    if (max)
+        m_spin.store(spin - spin / 8, std::memory_order_relaxed);
+
+    // Mark the mutex contended so that unlock() wakes us up
+    unsigned long parks = 0;
+    while (m_state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+        futex_wait_slow(reinterpret_cast<int*>(&m_state), CONTENDED);
+        ++parks;
+    }
+    m_stats.add(1, cnt, parks, now_ns() - start);
+}
+
+template <>
+inline adaptive_mutex_stats basic_adaptive_mutex<false>::stats() const {
+    return adaptive_mutex_stats{0, 0, 0, 0, 0};
+}
+
+template <>
+inline adaptive_mutex_stats basic_adaptive_mutex<true>::stats() const {
+    auto load = [](const std::atomic<unsigned long>& a) {
+        return a.load(std::memory_order_relaxed);
+    };
+    return adaptive_mutex_stats{
+        load(m_stats.acquisitions), load(m_stats.contended),
+        load(m_stats.spins), load(m_stats.parks), load(m_stats.wait_ns)};
+}
+
+/// Group of up to 32 auto-reset events sharing a single futex word.
+///
+/// Each event is a bit of the futex word.  A thread waits for any event of
+/// a mask with a single FUTEX_WAIT_BITSET call, and a publisher signals any
+/// subset of events and wakes the threads waiting on them with a single
+/// FUTEX_WAKE_BITSET call, which leaves the threads waiting on other events
+/// asleep.  No system call is made if nobody is waiting.  The futex is not
+/// process-private, so the group can be placed in shared memory.
+class futex_event_group {
+    std::atomic<uint32_t> m_pending;    // Bit N is set if event N is signaled
+    std::atomic<int>      m_waiters;    // Number of threads in wait()
+
+    int* word() { return reinterpret_cast<int*>(&m_pending); }
+
+public:
+    /// Maximum number of events in a group
+    enum { s_max_events = 32 };
+
+    /// Mask of the event number \a a_event
+    static constexpr uint32_t mask(int a_event) { return 1u << a_event; }
+
+    futex_event_group() : m_pending(0), m_waiters(0) {}
+
+    futex_event_group(const futex_event_group&) = delete;
+    futex_event_group& operator=(const futex_event_group&) = delete;
+
+    /// Mask of the events signaled and not yet consumed
+    uint32_t pending() const { return m_pending.load(std::memory_order_relaxed); }
+
+    /// Number of threads waiting for events
+    int      waiters() const { return m_waiters.load(std::memory_order_relaxed); }
+
+    /// Signal the events in \a a_mask and wake up to \a a_count threads
+    /// waiting for any of them.
+    /// @return number of threads woken up
+    int signal(uint32_t a_mask, int a_count = INT_MAX) {
+        m_pending.fetch_or(a_mask, std::memory_order_seq_cst);
+        // Pairs with the increment in wait(): either the waiter sees the
+        // event before sleeping, or we see the waiter
+        if (m_waiters.load(std::memory_order_seq_cst) == 0 || !a_mask)
+            return 0;
+        return futex_wake_bitset_slow(word(), a_mask, a_count);
+    }
+
+    /// Consume the signaled events of \a a_mask without waiting.
+    /// @return mask of the consumed events (0 if none were signaled)
+    uint32_t try_wait(uint32_t a_mask = ~0u) {
+        uint32_t p = m_pending.load(std::memory_order_relaxed);
+        while (p & a_mask)
+            if (m_pending.compare_exchange_weak(p, p & ~a_mask,
+                    std::memory_order_acquire, std::memory_order_relaxed))
+                return p & a_mask;
+        return 0;
+    }
+
+    /// Wait until any event of \a a_mask is signaled, and consume the
+    /// signaled events of \a a_mask.
+    /// @param a_timeout max time to wait (NULL means infinity)
+    /// @return mask of the consumed events (0 on timeout)
+    uint32_t wait(uint32_t a_mask, const struct timespec* a_timeout = NULL);
+
+    /// \copydoc wait()
+    uint32_t wait(uint32_t a_mask, const std::chrono::milliseconds& a_timeout) {
+        struct timespec ts = { time_t(a_timeout.count() / 1000),
+                               long(a_timeout.count() % 1000) * 1000000L };
+        return wait(a_mask, &ts);
+    }
+
+    /// Clear all signaled events
+    void reset() { m_pending.store(0, std::memory_order_release); }
+};
+
 } // namespace utxx
 
 #endif // __cplusplus
@@ -0,0 +1,236 @@
+//----------------------------------------------------------------------------
+/// \file   hdr_histogram.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief High dynamic range histogram of latencies.
+///
+/// This is an implementation of HdrHistogram (G. Tene, hdrhistogram.org).
+/// Values from a lowest discernible value (e.g. 1ns) to a highest trackable
+/// value (e.g. one hour) are recorded with a configured number of
+/// significant decimal digits.  Values are counted in buckets of
+/// exponentially growing width, each split into linear sub-buckets fine
+/// enough for the requested precision, so that recording is a bit scan, a
+/// shift and an increment of a preallocated counter.  Unlike perf_histogram,
+/// arbitrary percentiles (e.g. p99.9, p99.99) are reported with the
+/// configured precision.
+///
+/// Recording with add() is single-threaded, and add_atomic() may be called
+/// concurrently by any number of threads.  Alternatively, per-thread
+/// histograms may be merged on demand (see thread_cached_hdr_histogram in
+/// thread_cached_stat.hpp).  A histogram can be serialized to the compressed
+/// base64 form of HdrHistogram's V2 encoding used in histogram log files.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_HDR_HISTOGRAM_HPP_
+#define _UTXX_HDR_HISTOGRAM_HPP_
+
+#include <utxx/compiler_hints.hpp>
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace utxx {
+
+/// High dynamic range histogram (see file description)
+class hdr_histogram {
+public:
+    /// @param a_lowest  lowest discernible value (at least 1)
+    /// @param a_highest highest trackable value (at least 2 * a_lowest).
+    ///                  Larger values are recorded as \a a_highest.
+    /// @param a_digits  number of significant decimal digits (1 to 5)
+    /// @throw badarg_error if the arguments are invalid
+    explicit hdr_histogram(int64_t a_lowest  = 1,
+                           int64_t a_highest = 3600 * 1000000000L,
+                           int     a_digits  = 3);
+
+    int64_t lowest()       const { return m_lowest;        }
+    int64_t highest()      const { return m_highest;       }
+    int     digits()       const { return m_digits;        }
+    int     bucket_count() const { return m_bucket_count;  }
+    int     sub_buckets()  const { return int(m_sub_count); }
+    /// Number of counters (the histogram takes 8 bytes per counter)
+    size_t  counts_size()  const { return m_counts.size(); }
+
+    /// Record \a a_count occurrences of \a a_value
+    void add(int64_t a_value, int64_t a_count = 1) {
+        m_counts[index(a_value)] += a_count;
+    }
+
+    /// Record \a a_count occurrences of \a a_value.  This function can be
+    /// called concurrently by any number of threads.
+    void add_atomic(int64_t a_value, int64_t a_count = 1) {
+        __atomic_fetch_add(&m_counts[index(a_value)], a_count, __ATOMIC_RELAXED);
+    }
+
+    /// Clear all counts
+    void reset() { std::fill(m_counts.begin(), m_counts.end(), 0); }
+
+    /// Add the counts of another histogram.  If its configuration differs,
+    /// the values of its counters are recorded with this histogram's precision.
+    hdr_histogram& operator+=(const hdr_histogram& a_rhs);
+
+    /// Total number of recorded values
+    int64_t total_count() const {
+        int64_t n = 0;
+        for (size_t i = 0; i < m_counts.size(); ++i) n += count_at_index(i);
+        return n;
+    }
+
+    /// Number of recorded values equivalent to \a a_value
+    int64_t count_at_value(int64_t a_value) const { return count_at_index(index(a_value)); }
+
+    /// Smallest recorded value (the lowest value equivalent to it)
+    int64_t min() const {
+        for (size_t i = 0; i < m_counts.size(); ++i)
+            if (count_at_index(i))
+                return value_at_index(i);
+        return 0;
+    }
+
+    /// Largest recorded value (the highest value equivalent to it)
+    int64_t max() const {
+        for (size_t i = m_counts.size(); i > 0; --i)
+            if (count_at_index(i-1))
+                return highest_equivalent(value_at_index(i-1));
+        return 0;
+    }
+
+    /// Mean of recorded values
+    double mean() const;
+
+    /// Standard deviation of recorded values
+    double stddev() const;
+
+    /// Value at percentile \a a_percentile (0 to 100) of recorded values,
+    /// i.e. the highest value equivalent to the recorded value at that rank
+    int64_t value_at_percentile(double a_percentile) const;
+
+    /// Lowest value that is counted together with \a a_value
+    int64_t lowest_equivalent(int64_t a_value) const {
+        int b = bucket_index(a_value);
+        return sub_bucket_index(a_value, b) << (b + m_unit_mag);
+    }
+
+    /// Highest value that is counted together with \a a_value
+    int64_t highest_equivalent(int64_t a_value) const {
+        return lowest_equivalent(a_value) + equivalent_range(a_value) - 1;
+    }
+
+    /// Value in the middle of the range of values counted with \a a_value
+    int64_t median_equivalent(int64_t a_value) const {
+        return lowest_equivalent(a_value) + (equivalent_range(a_value) >> 1);
+    }
+
+    /// Size of the range of values counted together with \a a_value
+    int64_t equivalent_range(int64_t a_value) const {
+        int b = bucket_index(a_value);
+        int s = int(sub_bucket_index(a_value, b));
+        return int64_t(1) << (m_unit_mag + (s >= m_sub_count ? b + 1 : b));
+    }
+
+    /// Print the percentile distribution in the format of HdrHistogram's
+    /// outputPercentileDistribution().
+    /// @param a_ticks number of reporting points per halving of the
+    ///                distance to 100%
+    /// @param a_scale divisor of printed values (e.g. 1000.0 to print
+    ///                microseconds from nanosecond values)
+    void dump(std::ostream& out, int a_ticks = 5, double a_scale = 1.0) const;
+
+    /// Return the percentile distribution printed to string
+    std::string to_string(int a_ticks = 5, double a_scale = 1.0) const;
+
+    /// Serialize the histogram to the base64 form of HdrHistogram's V2
+    /// encoding, compressed with zlib if utxx is built with it
+    std::string encode() const;
+
+    /// Create a histogram from the output of encode() (or of another
+    /// HdrHistogram implementation)
+    /// @throw runtime_error if the input is not valid
+    static hdr_histogram decode(const std::string& a_base64);
+
+private:
+    int64_t              m_lowest;
+    int64_t              m_highest;
+    int                  m_digits;
+    int                  m_unit_mag;        // log2(a_lowest)
+    int                  m_sub_half_mag;    // log2(m_sub_count / 2)
+    int64_t              m_sub_count;       // Sub-buckets per bucket
+    int64_t              m_sub_mask;        // Mask of the sub-bucket bits
+    int                  m_bucket_count;
+    std::vector<int64_t> m_counts;
+
+    int64_t count_at_index(size_t a_idx) const {
+        return __atomic_load_n(&m_counts[a_idx], __ATOMIC_RELAXED);
+    }
+
+    int bucket_index(int64_t a_value) const {
+        // Smallest power of two containing the value
+        int pow2 = 64 - __builtin_clzll(uint64_t(a_value | m_sub_mask));
+        return pow2 - m_unit_mag - (m_sub_half_mag + 1);
+    }
+
+    int64_t sub_bucket_index(int64_t a_value, int a_bucket) const {
+        return a_value >> (a_bucket + m_unit_mag);
+    }
+
+    size_t index(int64_t a_value) const {
+        if (UNLIKELY(a_value < 0))
+            a_value = 0;
+        else if (UNLIKELY(a_value > m_highest))
+            a_value = m_highest;
+        int b = bucket_index(a_value);
+        // The lower half of sub-buckets of all but bucket 0 overlaps with
+        // the previous bucket, so only the upper half is stored
+        return size_t(((b + 1) << m_sub_half_mag) +
+                      sub_bucket_index(a_value, b) - (m_sub_count >> 1));
+    }
+
+    /// Lowest value counted in the counter \a a_idx
+    int64_t value_at_index(size_t a_idx) const {
+        int     b = int(a_idx >> m_sub_half_mag) - 1;
+        int64_t s = int64_t(a_idx & ((m_sub_count >> 1) - 1)) + (m_sub_count >> 1);
+        if (b < 0) {
+            s -= m_sub_count >> 1;
+            b  = 0;
+        }
+        return s << (b + m_unit_mag);
+    }
+
+    /// Index past the last non-zero counter
+    size_t used_size() const {
+        size_t n = m_counts.size();
+        while (n > 0 && !count_at_index(n-1)) --n;
+        return n;
+    }
+};
+
+} // namespace utxx
+
+#endif // _UTXX_HDR_HISTOGRAM_HPP_
@@ -43,6 +43,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <utxx/detail/get_tick_count.hpp>
 #include <utxx/time_val.hpp>
+#include <utxx/tsc_clock.hpp>
 #include <utxx/compiler_hints.hpp>
 //#include <utxx/meta.hpp>
 
@@ -122,6 +123,17 @@ public:
         return nsec >> 10;
     }
 
+    /// @return number of nanoseconds elapsed, converted with the TSC frequency
+    /// calibrated by tsc_clock rather than with the CPU frequency reported
+    /// by the OS.  Falls back to elapsed_nsec() if tsc_clock isn't driven by
+    /// the TSC.
+    hrtime_t elapsed_nsec_tsc() const {
+        auto& clock = tsc_clock::instance();
+        return clock.tsc()
+             ? hrtime_t(clock.ticks_to_ns(elapsed_hrtime(m_end, m_start)))
+             : elapsed_nsec();
+    }
+
     /// @return elapsed (stop - start) time in microseconds.
     hrtime_t elapsed_usec() const {
         hrtime_t elapsed = elapsed_hrtime(m_end, m_start);
@@ -153,6 +165,10 @@ public:
         return hrtime_to_tv(detail::get_tick_count());
     }
 
+    /// Get the current wall-clock time from the calibrated tsc_clock.
+    /// Unlike gettimeofday_hr(), it is kept in sync with CLOCK_REALTIME.
+    static time_val now_tsc() { return tsc_clock::now(); }
+
     /// Converts an @a hrt to @a tv using s_global_scale_factor.
     static time_val hrtime_to_tv(const hrtime_t hrt) {
         // The following are based on the units of s_global_scale_factor
@@ -33,9 +33,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #pragma once
 
 #include <utxx/synch.hpp>
+#include <utxx/os.hpp>
 #include <iostream>
 #include <functional>
 #include <atomic>
+#include <exception>
 #include <thread>
 #include <memory>
 #include <string>
@@ -159,6 +161,9 @@ protected:
     bool                         m_close_on_exit;
     std::mutex                   m_starter_mtx;
     std::condition_variable      m_starter_cv;
+    bool                         m_started;
+    std::exception_ptr           m_start_error;
+    os::thread_placement         m_thread_placement;
 
     // Invoked by the async thread to flush messages from queue to file
     int  commit(const struct timespec* tsp = NULL);
@@ -225,6 +230,10 @@ public:
     /// Close file handle on exit
     bool                close_on_exit()      const { return m_close_on_exit; }
 
+    /// Set the name, CPU affinity and scheduling of the I/O thread applied
+    /// by start(), which throws if the placement cannot be applied.
+    void thread_placement(const os::thread_placement& a) { m_thread_placement = a; }
+
     /// Approximate uncommitted queue size
     long queue_size() const { return m_queue_size.load(std::memory_order_relaxed); }
 
@@ -342,9 +351,17 @@ start(typename traits::file_type a_file,
 
     std::unique_lock<std::mutex> guard(m_starter_mtx);
 
+    m_started     = false;
+    m_start_error = nullptr;
     m_thread.reset(new std::thread([this]() { run(); }));
 
-    m_starter_cv.wait(guard);
+    m_starter_cv.wait(guard, [this] { return m_started; });
+
+    if (m_start_error) {
+        guard.unlock();
+        stop();
+        std::rethrow_exception(m_start_error);
+    }
     return 0;
 }
 
@@ -368,9 +385,20 @@ void basic_async_logger<traits>::stop()
 template<typename traits>
 void basic_async_logger<traits>::run()
 {
+    // Place the thread before doing any work.  On failure start() stops
+    // the thread and rethrows the error.
+    std::exception_ptr err;
+    try {
+        m_thread_placement.apply();
+    } catch (...) {
+        err = std::current_exception();
+    }
+
     // Notify the caller this thread is ready
     {
         std::unique_lock<std::mutex> guard(m_starter_mtx);
+        m_started     = true;
+        m_start_error = err;
         m_starter_cv.notify_all();
     }
 
@@ -56,6 +56,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/concurrent_mpsc_queue.hpp>
 #include <utxx/logger/logger_enums.hpp>
 #include <utxx/synch.hpp>
+#include <utxx/os.hpp>
+#include <utxx/tsc_clock.hpp>
+#include <utxx/time_zone.hpp>
 #include <thread>
 #include <mutex>
 
@@ -222,7 +225,7 @@ struct logger : boost::noncopyable {
             const Fun& a_fun,
             const char* a_src_loc, std::size_t a_sloc_len,
             const char* a_src_fun, std::size_t a_sfun_len
-        )   : m_timestamp   (now_utc())
+        )   : m_timestamp   (logger::instance().now())
             , m_level       (a_ll)
             , m_category    (a_category)
             , m_src_loc_len (a_sloc_len)
@@ -398,6 +401,8 @@ private:
     unsigned int                    m_level_filter          = LEVEL_NO_DEBUG;
     implementations_vector          m_implementations;
     stamp_type                      m_timestamp_type        = TIME;
+    clock_source                    m_clock                 = clock_source::REALTIME;
+    std::shared_ptr<const time_zone> m_timestamp_zone;
     char                            m_src_location[256];
     bool                            m_show_location         = true;
     int                             m_show_fun_namespaces   = 3;
@@ -408,6 +413,7 @@ private:
     bool                            m_silent_finish         = false;
     int                             m_fatal_kill_signal     = 0;
     long                            m_sched_yield_us        = 250;
+    os::thread_placement            m_thread_placement;
     macro_var_map                   m_macro_var_map;
 
     /// Signal set handled by the installed crash signal handler
@@ -522,6 +528,16 @@ public:
     /// @param a_interval_us interval in microseconds (use -1 to disable)
     void sched_yield_us(long a_interval_us) { m_sched_yield_us = a_interval_us; }
 
+    /// Set the name, CPU affinity and scheduling of the logger's async thread
+    /// (by default the thread is named after ident()). Must be called before
+    /// init(), which overrides it with the "logger.thread" config section.
+    void set_thread_placement(const os::thread_placement& a_placement) {
+        m_thread_placement = a_placement;
+    }
+
+    /// Placement of the logger's async thread
+    const os::thread_placement& thread_placement() const { return m_thread_placement; }
+
     /// Set a callback to be called on start of the logger's async thread
     void set_on_before_run(std::function<void()> a_cb) { m_on_before_run = a_cb; }
 
@@ -545,6 +561,28 @@ public:
     /// @return format type of timestamp written to log
     stamp_type  timestamp_type() const { return m_timestamp_type;}
 
+    /// Set the time zone of timestamps written to log (by default the
+    /// local time zone of the process is used).
+    /// @param a_tz time zone or NULL to use the local time zone
+    void timestamp_zone(std::shared_ptr<const time_zone> a_tz) { m_timestamp_zone = a_tz; }
+
+    /// @return time zone of timestamps written to log (NULL - local time zone)
+    const std::shared_ptr<const time_zone>& timestamp_zone() const { return m_timestamp_zone; }
+
+    /// Set the clock used to timestamp messages.  Selecting the TSC clock
+    /// starts its background synchronization with CLOCK_REALTIME.
+    void time_source(clock_source a_src) {
+        m_clock = a_src;
+        if (a_src == clock_source::TSC)
+            tsc_clock::instance().start_sync();
+    }
+
+    /// @return the clock used to timestamp messages
+    clock_source time_source() const { return m_clock; }
+
+    /// @return current time according to time_source()
+    time_val    now()            const { return now_utc(m_clock); }
+
     /// @return true if category logging is enabled by default.
     bool        show_category()  const { return m_show_category; }
     /// @return true if ident logging is enabled by default.
@@ -625,6 +663,18 @@ public:
                 const char (&a_src_loc)[N], const char (&a_src_fun)[M],
                 const char*  a_fmt, Args&&... a_args);
 
+    /// Log a message formatted by a compile-time format string created with
+    /// UTXX_FMT() (see format_string.hpp), e.g.:
+    /// \code
+    ///   UTXX_LOG_INFO(UTXX_FMT("Order {} filled {}@{:.2f}"), id, qty, px);
+    /// \endcode
+    /// The arguments are type-checked against the format string at compile
+    /// time, and the message is formatted without calling snprintf().
+    template<int N, int M, class S, typename... Args>
+    bool logfmt(log_level a_level, const std::string& a_cat,
+                const char (&a_src_loc)[N], const char (&a_src_fun)[M],
+                format_string<S> a_fmt, const Args&... a_args);
+
     /// Log a message of given log level to the registered implementations.
     /// Formatting of the resulting string to be logged happens in the caller's
     /// context, but actual message logging is handled asynchronously.
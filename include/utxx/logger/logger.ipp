@@ -127,6 +127,26 @@ inline bool logger::logfmt(
     return res;
 }
 
+template <int N, int M, class S, typename... Args>
+inline bool logger::logfmt(
+    log_level           a_level,
+    const std::string&  a_cat,
+    const char        (&a_src_loc)[N],
+    const char        (&a_src_fun)[M],
+    format_string<S>    a_fmt,
+    const Args&...      a_args)
+{
+    if (!is_enabled(a_level))
+        return false;
+
+    detail::basic_buffered_print<1024> buf;
+    buf.format(a_fmt, a_args...);
+    std::string sbuf(buf.str(), buf.size());
+    bool res = m_queue.emplace(a_level, a_cat, sbuf, a_src_loc, N-1, a_src_fun, M-1);
+    m_event.signal_fast();
+    return res;
+}
+
 template <typename... Args>
 inline bool logger::logs(
     log_level           a_level,
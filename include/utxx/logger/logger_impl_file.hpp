@@ -56,6 +56,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define _UTXX_LOGGER_FILE_HPP_
 
 #include <utxx/logger.hpp>
+#include <utxx/futex.hpp>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <boost/thread.hpp>
@@ -63,16 +64,16 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 namespace utxx {
 
 class logger_impl_file: public logger_impl {
-    std::string  m_name;
-    std::string  m_filename;
-    bool         m_append;
-    std::string  m_symlink;
-    bool         m_use_mutex;
-    uint32_t     m_levels;
-    mode_t       m_mode;
-    int          m_fd;
-    boost::mutex m_mutex;
-    bool         m_no_header;
+    std::string    m_name;
+    std::string    m_filename;
+    bool           m_append;
+    std::string    m_symlink;
+    bool           m_use_mutex;
+    uint32_t       m_levels;
+    mode_t         m_mode;
+    int            m_fd;
+    adaptive_mutex m_mutex;
+    bool           m_no_header;
 
     logger_impl_file(const char* a_name)
         : m_name(a_name), m_append(true), m_use_mutex(false)
@@ -44,6 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/compiler_hints.hpp>
 #include <utxx/time_val.hpp>
 #include <utxx/logger.hpp>
+#include <utxx/os.hpp>
 #include <iostream>
 #include <memory>
 #include <atomic>
@@ -51,6 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <exception>
 #include <string>
 #include <stdio.h>
 #include <stdarg.h>
@@ -158,6 +160,8 @@ private:
 
     std::mutex                                      m_mutex;
     std::condition_variable                         m_cond_var;
+    bool                                            m_started;
+    std::exception_ptr                              m_start_error;
     std::shared_ptr<std::thread>                    m_thread;
     cmd_allocator                                   m_cmd_allocator;
     msg_allocator                                   m_msg_allocator;
@@ -173,6 +177,7 @@ private:
     double                                          m_reconnect_sec;
     err_handler                                     m_err_handler;
     bool                                            m_use_sched_yield;
+    os::thread_placement                            m_thread_placement;
 #ifdef PERF_STATS
     std::atomic<size_t>                             m_stats_enque_spins;
     std::atomic<size_t>                             m_stats_deque_spins;
@@ -346,6 +351,12 @@ public:
     /// sched_yield() can cause system resource starvation.
     void use_sched_yield(bool a_enable) { m_use_sched_yield = a_enable; }
 
+    /// Set the name, CPU affinity and scheduling of the logging thread
+    /// applied by start(), which throws if the placement cannot be applied.
+    void set_thread_placement(const os::thread_placement& a_placement) {
+        m_thread_placement = a_placement;
+    }
+
     /// Close one log file
     /// @param a_id identifier of the file to be closed. After return the value
     ///             will be reset.
@@ -781,14 +792,22 @@ start() {
         return -1;
 
     m_event.reset();
-    m_cancel = false;
+    m_cancel      = false;
+    m_started     = false;
+    m_start_error = nullptr;
 
     m_thread.reset(
         new std::thread(
             std::bind(&basic_multi_file_async_logger<traits>::run, this))
     );
 
-    m_cond_var.wait(lock);
+    m_cond_var.wait(lock, [this] { return m_started; });
+
+    if (m_start_error) {
+        lock.unlock();
+        stop();
+        std::rethrow_exception(m_start_error);
+    }
 
     return 0;
 }
@@ -813,9 +832,20 @@ stop() {
 template<typename traits>
 void basic_multi_file_async_logger<traits>::
 run() {
+    // Place the thread before doing any work.  On failure start() stops
+    // the thread and rethrows the error.
+    std::exception_ptr err;
+    try {
+        m_thread_placement.apply();
+    } catch (...) {
+        err = std::current_exception();
+    }
+
     // Notify the caller that we are ready
     {
         std::unique_lock<std::mutex> lock(m_mutex);
+        m_started     = true;
+        m_start_error = err;
         m_cond_var.notify_all();
     }
 
@@ -33,6 +33,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utxx/error.hpp>
 #include <utxx/compiler_hints.hpp>
 
 namespace utxx {
@@ -50,5 +58,216 @@ inline std::string username() {
     return unlikely(cuserid(buf) == nullptr) ? "" : buf;
 }
 
+/// Parse a Linux CPU list (such as "0-3,8,10-11") as found in sysfs and
+/// accepted by "taskset -c".
+/// @return sorted list of unique CPU ids
+inline std::vector<int> parse_cpu_list(const std::string& a_list) {
+    std::vector<int> res;
+    const char* p = a_list.c_str();
+    while (*p && *p != '\n') {
+        char* e;
+        long  from = strtol(p, &e, 10), to = from;
+        if (e == p || from < 0)
+            UTXX_THROW_BADARG_ERROR("Invalid CPU list: ", a_list);
+        if (*e == '-') {
+            p  = e + 1;
+            to = strtol(p, &e, 10);
+            if (e == p || to < from)
+                UTXX_THROW_BADARG_ERROR("Invalid CPU list: ", a_list);
+        }
+        for (long i = from; i <= to; ++i)
+            res.push_back(int(i));
+        p = e;
+        if (*p == ',')
+            ++p;
+        else if (*p && *p != '\n')
+            UTXX_THROW_BADARG_ERROR("Invalid CPU list: ", a_list);
+    }
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+/// Format a list of CPU ids as a CPU list (e.g. "0-3,8")
+inline std::string format_cpu_list(std::vector<int> a_cpus) {
+    std::sort(a_cpus.begin(), a_cpus.end());
+    a_cpus.erase(std::unique(a_cpus.begin(), a_cpus.end()), a_cpus.end());
+    std::string res;
+    for (size_t i = 0; i < a_cpus.size(); ) {
+        size_t j = i;
+        while (j+1 < a_cpus.size() && a_cpus[j+1] == a_cpus[j] + 1)
+            ++j;
+        if (!res.empty())
+            res += ',';
+        res += std::to_string(a_cpus[i]);
+        if (j > i)
+            res += '-' + std::to_string(a_cpus[j]);
+        i = j + 1;
+    }
+    return res;
+}
+
+//-----------------------------------------------------------------------------
+// Thread placement
+//-----------------------------------------------------------------------------
+
+/// Bind thread \a a_thread to the CPUs in \a a_cpus
+inline void set_thread_affinity(const std::vector<int>& a_cpus,
+                                pthread_t a_thread = pthread_self()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : a_cpus) {
+        if (c < 0 || c >= CPU_SETSIZE)
+            UTXX_THROW_BADARG_ERROR("Invalid CPU id: ", c);
+        CPU_SET(c, &set);
+    }
+    int rc = pthread_setaffinity_np(a_thread, sizeof(set), &set);
+    if (rc)
+        UTXX_THROW_IO_ERROR(rc, "Cannot bind thread to CPUs ", format_cpu_list(a_cpus));
+}
+
+/// CPUs thread \a a_thread is bound to
+inline std::vector<int> thread_affinity(pthread_t a_thread = pthread_self()) {
+    cpu_set_t set;
+    int rc = pthread_getaffinity_np(a_thread, sizeof(set), &set);
+    if (rc)
+        UTXX_THROW_IO_ERROR(rc, "Cannot get thread affinity");
+    std::vector<int> res;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set))
+            res.push_back(c);
+    return res;
+}
+
+/// Set the name of thread \a a_thread (truncated to 15 characters). The name
+/// is shown in the log when the logger's "show-thread" option is enabled.
+inline void set_thread_name(const std::string& a_name,
+                            pthread_t a_thread = pthread_self()) {
+    int rc = pthread_setname_np(a_thread, a_name.substr(0, 15).c_str());
+    if (rc)
+        UTXX_THROW_IO_ERROR(rc, "Cannot set thread name to '", a_name, '\'');
+}
+
+/// Name of thread \a a_thread
+inline std::string thread_name(pthread_t a_thread = pthread_self()) {
+    char buf[16];
+    return pthread_getname_np(a_thread, buf, sizeof(buf)) ? std::string() : buf;
+}
+
+/// Thread scheduling policy
+enum class sched_policy {
+      OTHER     ///< SCHED_OTHER - default time-sharing
+    , FIFO      ///< SCHED_FIFO  - real-time first-in first-out
+    , RR        ///< SCHED_RR    - real-time round-robin
+    , BATCH     ///< SCHED_BATCH - CPU-intensive non-interactive
+    , IDLE      ///< SCHED_IDLE  - very low priority background
+};
+
+/// Convert sched_policy to string
+inline const char* to_string(sched_policy a_policy) {
+    static const char* s_names[] = {"other", "fifo", "rr", "batch", "idle"};
+    return s_names[int(a_policy)];
+}
+
+/// Parse sched_policy (case-insensitive "other", "fifo", "rr", "batch", "idle")
+inline sched_policy parse_sched_policy(const std::string& a_policy) {
+    for (int i = 0; i <= int(sched_policy::IDLE); ++i)
+        if (!strcasecmp(a_policy.c_str(), to_string(sched_policy(i))))
+            return sched_policy(i);
+    UTXX_THROW_BADARG_ERROR("Invalid scheduling policy: ", a_policy);
+}
+
+/// Maximum real-time priority accepted by set_thread_scheduling() by default.
+/// Threaded IRQ handlers and other kernel threads run at priority 50, and
+/// starving them can hang the host.
+static const int MAX_SAFE_RT_PRIORITY = 49;
+
+/// Set scheduling policy and priority of thread \a a_thread.
+/// @param a_priority     static priority for FIFO and RR policies (1..99),
+///                       nice value for OTHER and BATCH (applied only to the
+///                       calling thread), ignored for IDLE
+/// @param a_max_priority real-time priorities above this limit are rejected
+inline void set_thread_scheduling
+(
+    sched_policy a_policy,
+    int          a_priority     = 0,
+    pthread_t    a_thread       = pthread_self(),
+    int          a_max_priority = MAX_SAFE_RT_PRIORITY
+) {
+    static const int s_policies[] =
+        {SCHED_OTHER, SCHED_FIFO, SCHED_RR, SCHED_BATCH, SCHED_IDLE};
+    int  policy = s_policies[int(a_policy)];
+    bool rt     = a_policy == sched_policy::FIFO || a_policy == sched_policy::RR;
+
+    struct sched_param param;
+    param.sched_priority = 0;
+    if (rt) {
+        int lo = sched_get_priority_min(policy);
+        int hi = std::min(sched_get_priority_max(policy), a_max_priority);
+        if (a_priority < lo || a_priority > hi)
+            UTXX_THROW_BADARG_ERROR("Real-time priority ", a_priority,
+                                    " is out of the allowed range [", lo, ", ", hi, ']');
+        param.sched_priority = a_priority;
+    }
+    int rc = pthread_setschedparam(a_thread, policy, &param);
+    if (rc)
+        UTXX_THROW_IO_ERROR(rc, "Cannot set scheduling policy ", to_string(a_policy),
+                            " with priority ", a_priority);
+
+    if (!rt && a_policy != sched_policy::IDLE && a_priority &&
+        pthread_equal(a_thread, pthread_self()) &&
+        setpriority(PRIO_PROCESS, 0, a_priority) < 0)
+        UTXX_THROW_IO_ERROR(errno, "Cannot set nice value ", a_priority);
+}
+
+/// Limit CPU time a real-time thread of this process may consume without a
+/// blocking system call (RLIMIT_RTTIME). A runaway thread gets SIGXCPU rather
+/// than locking up a CPU.
+inline void set_rt_time_limit(long a_usec) {
+    struct rlimit rl;
+    rl.rlim_cur = a_usec;
+    rl.rlim_max = a_usec;
+    if (setrlimit(RLIMIT_RTTIME, &rl) < 0)
+        UTXX_THROW_IO_ERROR(errno, "Cannot set RLIMIT_RTTIME to ", a_usec);
+}
+
+/// Placement of a thread: name, CPU affinity and scheduling
+struct thread_placement {
+    std::string      name;                          ///< Empty - don't change
+    std::vector<int> cpus;                          ///< Empty - don't change
+    sched_policy     policy   = sched_policy::OTHER;
+    int              priority = 0;
+
+    thread_placement() {}
+    thread_placement(const std::string& a_name, const std::string& a_cpus,
+                     sched_policy a_policy = sched_policy::OTHER, int a_priority = 0)
+        : name(a_name), cpus(parse_cpu_list(a_cpus))
+        , policy(a_policy), priority(a_priority)
+    {}
+
+    /// True if applying the placement leaves the thread intact
+    bool empty() const {
+        return name.empty() && cpus.empty() &&
+               policy == sched_policy::OTHER && !priority;
+    }
+
+    /// Apply the placement to thread \a a_thread
+    void apply(pthread_t a_thread = pthread_self()) const {
+        if (!name.empty())
+            set_thread_name(name, a_thread);
+        if (!cpus.empty())
+            set_thread_affinity(cpus, a_thread);
+        if (policy != sched_policy::OTHER || priority)
+            set_thread_scheduling(policy, priority, a_thread);
+    }
+
+    /// Human-readable representation
+    std::string to_string() const {
+        return "name="       + name + " cpus=" + format_cpu_list(cpus) +
+               " policy="    + os::to_string(policy) +
+               " priority="  + std::to_string(priority);
+    }
+};
+
 } // namespace os
 } // namespace utxx
@@ -42,7 +42,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <ostream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <boost/concept_check.hpp>
+#include <utxx/tsc_clock.hpp>
 
 namespace utxx {
 
@@ -53,6 +55,7 @@ struct perf_histogram {
         , MONOTONIC   = CLOCK_MONOTONIC
         , HIGH_RES    = CLOCK_PROCESS_CPUTIME_ID
         , THREAD_SPEC = CLOCK_THREAD_CPUTIME_ID
+        , TSC         = -1      ///< tsc_clock (not a clockid_t)
     };
 
 private:
@@ -65,6 +68,7 @@ private:
     int                 m_latencies[BUCKETS];
     double              m_min_time, m_max_time, m_sum_time;
     struct timespec     m_last_start;
+    uint64_t            m_last_tsc;
     long                m_count;
     std::string         m_header;
     clock_type          m_clock_type;
@@ -107,20 +111,32 @@ public:
     void reset(const char* a_header = NULL, clock_type a_type = DEFAULT) {
         if (a_header) m_header      = a_header;
         if (a_type)   m_clock_type  = a_type;
+        if (m_clock_type == TSC && !tsc_clock::instance().tsc())
+            m_clock_type = MONOTONIC;
         m_count   = 0;
         m_min_time = 9999999;
         m_max_time = m_sum_time = 0;
         memset(m_latencies,   0, sizeof(m_latencies));
         memset(&m_last_start, 0, sizeof(struct timespec));
+        m_last_tsc = 0;
     }
 
     /// Start a measurement sample
     void start() {
-        clock_gettime(m_clock_type, &m_last_start);
+        if (m_clock_type == TSC)
+            m_last_tsc = tsc_clock::ticks();
+        else
+            clock_gettime(m_clock_type, &m_last_start);
     }
 
     /// Stop the measurement sample started with start().
     void stop() {
+        if (m_clock_type == TSC) {
+            auto ticks = std::max<int64_t>(0, tsc_clock::ticks() - m_last_tsc);
+            add(double(tsc_clock::instance().ticks_to_ns(ticks)) / 1000000000.0);
+            return;
+        }
+
         struct timespec now;
         clock_gettime(m_clock_type, &now);
 
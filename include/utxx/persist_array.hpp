@@ -45,11 +45,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/crc.hpp>
 #include <utxx/compiler_hints.hpp>
 #include <utxx/meta.hpp>
 #include <utxx/scope_exit.hpp>
 #include <utxx/error.hpp>
+#include <utxx/futex.hpp>
 #include <stdexcept>
+#include <algorithm>
 #include <fstream>
 #include <thread>
 #include <mutex>
@@ -59,12 +62,93 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstddef>
 #include <cstdlib>
 #include <atomic>
+#include <memory>
+#include <type_traits>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
 
 namespace utxx {
 
     namespace        { namespace bip = boost::interprocess; }
-    namespace detail { struct empty_data {}; }
+    namespace detail {
+        struct empty_data {};
+
+        /// CRC-32C of a memory region (hardware accelerated with SSE4.2)
+        inline uint32_t crc32c(const void* a_data, size_t a_size) {
+            auto p = static_cast<const char*>(a_data);
+        #if defined(__SSE4_2__)
+            uint64_t crc = 0xFFFFFFFF;
+            for (auto e = p + (a_size & ~size_t(7)); p != e; p += 8) {
+                uint64_t v; ::memcpy(&v, p, 8);
+                crc = _mm_crc32_u64(crc, v);
+            }
+            for (auto e = p + (a_size & 7); p != e; ++p)
+                crc = _mm_crc32_u8(uint32_t(crc), *p);
+            return ~uint32_t(crc);
+        #else
+            boost::crc_optimal<32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, true> crc;
+            crc.process_bytes(p, a_size);
+            return crc.checksum();
+        #endif
+        }
+    }
+
+    /// Lock type selecting the seqlock records mode of persist_array.
+    ///
+    /// Each lock stripe holds a version counter instead of a mutex.  A writer
+    /// makes the version odd before modifying records of the stripe and even
+    /// again when done, so lock()/unlock() never block on readers.  Readers
+    /// use persist_array::read() that copies a record optimistically and
+    /// retries if the version changed during the copy.  Writers of the same
+    /// stripe are serialized by spinning on an odd version, so the mode is
+    /// meant for a single writer per stripe.  With NLocks >= capacity every
+    /// record has a version of its own.
+    class persist_seqlock {
+        std::atomic<uint64_t> m_version;
+    public:
+        persist_seqlock() : m_version(0) {}
+
+        /// Begin a write: make the version odd
+        void lock() {
+            while (!try_lock());
+        }
+
+        bool try_lock() {
+            uint64_t v = m_version.load(std::memory_order_relaxed);
+            if ((v & 1) ||
+                !m_version.compare_exchange_weak(v, v+1, std::memory_order_acquire))
+                return false;
+            // Order the version bump before the writes to the record
+            std::atomic_thread_fence(std::memory_order_release);
+            return true;
+        }
+
+        /// Publish a write: make the version even
+        void unlock() {
+            m_version.store(m_version.load(std::memory_order_relaxed)+1,
+                            std::memory_order_release);
+        }
+
+        /// Begin an optimistic read
+        /// @return even version to pass to read_retry()
+        uint64_t read_begin() const {
+            uint64_t v;
+            while ((v = m_version.load(std::memory_order_acquire)) & 1);
+            return v;
+        }
+
+        /// @return true if a write intervened since read_begin()
+        bool read_retry(uint64_t a_version) const {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return m_version.load(std::memory_order_relaxed) != a_version;
+        }
+
+        uint64_t version() const { return m_version.load(std::memory_order_acquire); }
+    };
 
     enum class persist_attach_type {
         OPEN_READ_ONLY,     // Open-only
@@ -75,20 +159,29 @@ namespace utxx {
         READ_WRITE          // Create or open
     };
 
+    /// Array of fixed-size records stored in a memory-mapped file.
+    /// @tparam Lock type of the record locks kept in the file header, e.g.
+    ///              std::mutex, adaptive_mutex, null_lock or persist_seqlock.
+    ///              A file must be opened with the Lock it was created with.
     template <
         typename    T,
         std::size_t NLocks          = 32,
         typename    Lock            = std::mutex,
         typename    ExtraHeaderData = detail::empty_data>
     struct persist_array {
+        /// True if records are guarded by seqlock versions
+        static const bool s_seqlock = std::is_same<Lock, persist_seqlock>::value;
+
         struct header : public ExtraHeaderData {
-            static const uint32_t s_version = 0xa0b1c2d3;
+            // Files in the seqlock mode have a distinct version so that they
+            // are never opened with mutex-based locks and vice versa
+            static const uint32_t s_version = s_seqlock ? 0xa0b1c2d4 : 0xa0b1c2d3;
             uint32_t            version;
             std::atomic<long>   rec_count;
             size_t              max_recs;
             size_t              rec_size;
             size_t              recs_offset;
-            Lock                locks[NLocks];
+            mutable Lock        locks[NLocks];
             T                   records[0];
         };
 
@@ -111,6 +204,75 @@ namespace utxx {
         T*      m_begin;
         T*      m_end;
 
+        // Per-record checksums kept in the "<storage_name>.crc" side file
+        bool                m_use_crcs;
+        bip::file_mapping   m_crc_file;
+        bip::mapped_region  m_crc_region;
+        uint32_t*           m_crcs;
+        std::vector<size_t> m_torn;
+
+        // Bitmap of pages of m_region modified since the last checkpoint
+        std::unique_ptr<std::atomic<uint64_t>[]> m_dirty;
+        size_t              m_dirty_words;
+        size_t              m_page_size;
+
+        /// Checksum stored for a record (0 is reserved for unwritten records)
+        static uint32_t checksum(const T& a_rec) {
+            uint32_t crc = detail::crc32c(&a_rec, sizeof(T));
+            return crc ? crc : 1;
+        }
+
+        void set_dirty(size_t a_offset) {
+            size_t pg = a_offset / m_page_size;
+            auto&  w  = m_dirty[pg / 64];
+            auto   b  = uint64_t(1) << (pg % 64);
+            // Avoid the atomic RMW if the page is already dirty
+            if (!(w.load(std::memory_order_relaxed) & b))
+                w.fetch_or(b, std::memory_order_relaxed);
+        }
+
+        size_t rec_offset(size_t a_id) const {
+            return offsetof(header, records) + a_id*sizeof(T);
+        }
+
+        void init_dirty_map() {
+            m_page_size   = getpagesize();
+            size_t pages  = (m_region.get_size() + m_page_size - 1) / m_page_size;
+            m_dirty_words = (pages + 63) / 64;
+            m_dirty.reset(new std::atomic<uint64_t>[m_dirty_words]);
+            for (size_t i = 0; i < m_dirty_words; ++i)
+                m_dirty[i].store(0, std::memory_order_relaxed);
+        }
+
+        void init_checksums(const char* a_filename, bool a_read_only);
+
+        /// msync(2) requires the address to be page-aligned
+        static bool flush_range(bip::mapped_region& a_region, size_t a_offset,
+                                size_t a_size, bool a_async = false) {
+            static const size_t s_page_size = getpagesize();
+            size_t off = a_offset - a_offset % s_page_size;
+            size_t end = a_size ? std::min(a_offset + a_size, a_region.get_size())
+                                : a_region.get_size();
+            return off < end && a_region.flush(off, end - off, a_async);
+        }
+
+        void do_read(size_t a_id, T& a_rec, std::true_type) const {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "Seqlock mode requires trivially copyable records");
+            const Lock& l = m_header->locks[a_id & s_lock_mask];
+            const T*    p = m_begin + a_id;
+            uint64_t    v;
+            do {
+                v = l.read_begin();
+                ::memcpy(static_cast<void*>(&a_rec), p, sizeof(T));
+            } while (unlikely(l.read_retry(v)));
+        }
+
+        void do_read(size_t a_id, T& a_rec, std::false_type) const {
+            scoped_lock guard(m_header->locks[a_id & s_lock_mask]);
+            a_rec = m_begin[a_id];
+        }
+
         void check_range(size_t a_id) const throw (badarg_error) {
             size_t n = m_header->max_recs;
             if (likely(a_id < n))
@@ -124,10 +286,11 @@ namespace utxx {
 
         persist_array()
             : m_header(NULL), m_begin(NULL), m_end(NULL)
+            , m_use_crcs(false), m_crcs(NULL), m_dirty_words(0), m_page_size(0)
         {}
 
 #if __cplusplus >= 201103L
-        persist_array(persist_array&& a_rhs) {
+        persist_array(persist_array&& a_rhs) : persist_array() {
             *this = std::move(a_rhs);
         }
 
@@ -136,11 +299,21 @@ namespace utxx {
             m_header       = a_rhs.m_header;
             m_begin        = a_rhs.m_begin;
             m_end          = a_rhs.m_end;
-            m_file  .swap(a_rhs.m_file);
-            m_region.swap(a_rhs.m_region);
+            m_use_crcs     = a_rhs.m_use_crcs;
+            m_crcs         = a_rhs.m_crcs;
+            m_torn         = std::move(a_rhs.m_torn);
+            m_dirty        = std::move(a_rhs.m_dirty);
+            m_dirty_words  = a_rhs.m_dirty_words;
+            m_page_size    = a_rhs.m_page_size;
+            m_file      .swap(a_rhs.m_file);
+            m_region    .swap(a_rhs.m_region);
+            m_crc_file  .swap(a_rhs.m_crc_file);
+            m_crc_region.swap(a_rhs.m_crc_region);
             a_rhs.m_header = nullptr;
             a_rhs.m_begin  = nullptr;
             a_rhs.m_end    = nullptr;
+            a_rhs.m_crcs   = nullptr;
+            a_rhs.m_dirty_words = 0;
         }
 #endif
         /// Default permission mask used for opening a file
@@ -155,6 +328,20 @@ namespace utxx {
             return sz;
         }
 
+        /// Keep a checksum of every record in the "<filename>.crc" side file.
+        /// Must be called before init(), which then validates the checksums
+        /// of all records and reports the mismatches in torn_records().
+        /// Records modified in place must be passed to mark_dirty() to keep
+        /// their checksums current.  Only supported for file storage.
+        void enable_checksums(bool a_enable = true) { m_use_crcs = a_enable; }
+
+        bool checksums_enabled() const { return m_crcs != nullptr; }
+
+        /// IDs of records whose checksums didn't match on init().  These are
+        /// the records that were being written when the process crashed or
+        /// whose pages didn't reach the disk before a system crash.
+        const std::vector<size_t>& torn_records() const { return m_torn; }
+
         /// Initialize the storage
         /// @return true if the storage file didn't exist and was created
         bool init(const char* a_filename, size_t a_max_recs, bool a_read_only = false,
@@ -194,6 +381,8 @@ namespace utxx {
                 m_header->rec_count.store(capacity(), std::memory_order_relaxed);
                 error();
             }
+            if (m_dirty_words)
+                set_dirty(0);
 
             return n;
         }
@@ -207,11 +396,26 @@ namespace utxx {
             return m_header->locks[a_rec_id & s_lock_mask];
         }
 
+        /// Mark the record modified in place, so that it's written to disk
+        /// by the next checkpoint(), and update its checksum.  Must be
+        /// called while holding the record's lock.  add() and update()
+        /// call it implicitly.
+        void mark_dirty(size_t a_id) {
+            if (!m_dirty_words)
+                return;
+            size_t off = rec_offset(a_id);
+            set_dirty(off);
+            set_dirty(off + sizeof(T) - 1);
+            if (m_crcs)
+                m_crcs[a_id] = checksum(m_begin[a_id]);
+        }
+
         /// Add a record with given ID to the store
         void add(size_t a_id, const T& a_rec) {
             BOOST_ASSERT(a_id < m_header->rec_count.load(std::memory_order_relaxed));
             scoped_lock guard(get_lock(a_id));
             *get(a_id) = a_rec;
+            mark_dirty(a_id);
         }
 
         /// Add a record to the storage and return it's id
@@ -219,6 +423,7 @@ namespace utxx {
             size_t n = allocate_rec();
             scoped_lock guard(get_lock(n));
             *(m_begin+n) = a_rec;
+            mark_dirty(n);
             return n;
         }
 
@@ -230,9 +435,31 @@ namespace utxx {
             scoped_lock guard(get_lock(n));
             T* rec = m_begin+n;
             a_rec_init(n, rec);
+            mark_dirty(n);
             return std::make_pair(rec, n);
         }
 
+        /// Modify a record in place under its lock.  In the seqlock mode
+        /// the modification is published to readers when \a a_fun returns.
+        /// @param a_fun functor accepting (T& rec)
+        template <typename Fun>
+        void update(size_t a_id, const Fun& a_fun) {
+            BOOST_ASSERT(a_id < capacity());
+            scoped_lock guard(get_lock(a_id));
+            a_fun(*(m_begin+a_id));
+            mark_dirty(a_id);
+        }
+
+        /// Copy a consistent snapshot of a record with given ID.
+        /// In the seqlock mode this never blocks writers: the copy is
+        /// retried if a writer modified the record's stripe meanwhile.
+        void read(size_t a_id, T& a_rec) const {
+            BOOST_ASSERT(a_id < capacity());
+            do_read(a_id, a_rec, std::integral_constant<bool, s_seqlock>());
+        }
+
+        T read(size_t a_id) const { T rec; read(a_id, rec); return rec; }
+
         /// @return id of the given object in the storage
         size_t id_of(const T* a_rec) const { return a_rec - m_begin; }
 
@@ -255,12 +482,23 @@ namespace utxx {
         bool flush_header() { return m_region.flush(0, sizeof(header)); }
 
         /// Flush region of cached records to disk
+        /// @param a_num_recs number of records to flush (0 - all to the end)
         bool flush(size_t a_from_rec = 0, size_t a_num_recs = 0) {
-            return m_region.flush(a_from_rec, a_num_recs*sizeof(T));
+            return flush_range(m_region, rec_offset(a_from_rec), a_num_recs*sizeof(T));
         }
 
+        /// Write the pages modified since the last checkpoint to disk
+        /// (together with the checksums of their records).  Unlike flush()
+        /// the cost is proportional to the amount of modified data rather
+        /// than to the size of the storage.
+        /// @param a_async if true, schedule the write-back without waiting
+        /// @return number of pages written
+        size_t checkpoint(bool a_async = false);
+
         /// Remove memory mapped file from disk
         void remove() {
+            if (m_crcs)
+                bip::file_mapping::remove(m_crc_file.get_name());
             m_file.remove(m_file.get_name());
         }
 
@@ -340,7 +578,11 @@ namespace utxx {
                     bip::file_lock flock(a_filename);
                     bip::scoped_lock<bip::file_lock> g_lock(flock);
 
-                    header h;
+                    // Read the header as raw bytes: Lock (and ExtraHeaderData)
+                    // may not be trivially destructible
+                    typename std::aligned_storage
+                        <sizeof(header), alignof(header)>::type buf;
+                    header& h = reinterpret_cast<header&>(buf);
                     f.sgetn(reinterpret_cast<char*>(&h), sizeof(header));
 
                     if (h.version != header::s_version)
@@ -428,6 +670,11 @@ namespace utxx {
                     new (l) Lock();
             }
 
+            init_dirty_map();
+
+            if (m_use_crcs)
+                init_checksums(a_filename, a_read_only);
+
         } catch (io_error& e) {
             throw;
         } catch (std::exception& e) {
@@ -463,6 +710,9 @@ namespace utxx {
                     m_header = reinterpret_cast<header*>(fres.first);
                     m_begin  = m_header->records;
                     m_end    = m_begin + m_header->max_recs;
+                    if (m_header->version != header::s_version)
+                        throw runtime_error("Invalid format of shared memory array '",
+                                            a_name, "'");
                     if (m_header->recs_offset != offsetof(header, records))
                         throw runtime_error("Mismatch in the records offset in '",
                                             a_name, "' (expected=",
@@ -538,6 +788,106 @@ namespace utxx {
         }
         return created;
     }
+
+    template <typename T, size_t NLocks, typename Lock, typename Ext>
+    void persist_array<T,NLocks,Lock,Ext>::
+    init_checksums(const char* a_filename, bool a_read_only)
+    {
+        static const size_t s_pack_size = getpagesize();
+
+        std::string name = std::string(a_filename) + ".crc";
+        size_t      sz   = capacity() * sizeof(uint32_t);
+        sz += (s_pack_size - sz % s_pack_size);
+
+        bool exists = boost::filesystem::exists(name);
+        if (!exists && a_read_only)
+            return;
+
+        if (!a_read_only) {
+            int fd = ::open(name.c_str(), O_RDWR | O_CREAT, default_file_mode());
+            if (fd < 0)
+                throw io_error(errno, "Error opening file ", name);
+            UTXX_SCOPE_EXIT([=]{ ::close(fd); });
+            struct stat st;
+            // The side file grows with the capacity of the storage
+            if (::fstat(fd, &st) < 0 || (size_t(st.st_size) < sz && ::ftruncate(fd, sz) < 0))
+                throw io_error(errno, "Error setting file ", name, " to size ", sz);
+        }
+
+        auto mode = a_read_only ? bip::read_only : bip::read_write;
+        bip::file_mapping  file  (name.c_str(), mode);
+        bip::mapped_region region(file, mode, 0, sz);
+        m_crc_file  .swap(file);
+        m_crc_region.swap(region);
+        m_crcs = static_cast<uint32_t*>(m_crc_region.get_address());
+
+        // Records written before checksums were enabled are trusted
+        if (!exists) {
+            for (size_t i = 0, n = std::min(count(), capacity()); i < n; ++i)
+                m_crcs[i] = checksum(m_begin[i]);
+            m_crc_region.flush();
+            return;
+        }
+
+        m_torn.clear();
+        for (size_t i = 0, n = std::min(count(), capacity()); i < n; ++i) {
+            auto crc = m_crcs[i];
+            if (likely(crc && crc == checksum(m_begin[i])))
+                continue;
+            // A record that was allocated but never written is all zeros
+            if (crc == 0) {
+                auto p = reinterpret_cast<const char*>(m_begin + i);
+                if (std::all_of(p, p + sizeof(T), [](char c) { return c == 0; }))
+                    continue;
+            }
+            m_torn.push_back(i);
+        }
+    }
+
+    template <typename T, size_t NLocks, typename Lock, typename Ext>
+    size_t persist_array<T,NLocks,Lock,Ext>::
+    checkpoint(bool a_async)
+    {
+        const size_t recs = offsetof(header, records);
+        size_t       res  = 0;
+
+        auto sync_pages = [&, this](size_t a_pg, size_t a_end) {
+            size_t off = a_pg  * m_page_size;
+            size_t len = std::min(a_end * m_page_size, m_region.get_size()) - off;
+            flush_range(m_region, off, len, a_async);
+            res += a_end - a_pg;
+            if (!m_crcs || off + len <= recs)
+                return;
+            // Checksums of the records located on these pages
+            size_t from = off > recs ? (off - recs) / sizeof(T) : 0;
+            size_t to   = std::min((off + len - recs + sizeof(T) - 1) / sizeof(T), capacity());
+            if (from < to)
+                flush_range(m_crc_region, from * sizeof(uint32_t),
+                            (to - from) * sizeof(uint32_t), a_async);
+        };
+
+        // Coalesce consecutive dirty pages into a single flush
+        size_t start = 0, end = 0;
+        for (size_t i = 0; i < m_dirty_words; ++i) {
+            uint64_t w = m_dirty[i].load(std::memory_order_relaxed);
+            if (!w)
+                continue;
+            w = m_dirty[i].exchange(0, std::memory_order_relaxed);
+            for (; w; w &= w - 1) {
+                size_t pg = i * 64 + __builtin_ctzll(w);
+                if (pg != end) {
+                    if (end > start)
+                        sync_pages(start, end);
+                    start = pg;
+                }
+                end = pg + 1;
+            }
+        }
+        if (end > start)
+            sync_pages(start, end);
+        return res;
+    }
+
 } // namespace utxx
 
 #endif // _UTXX_PERSISTENT_ARRAY_HPP_
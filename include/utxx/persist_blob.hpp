@@ -47,6 +47,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //#include <sys/mman.h>
 #include <string>
 #include <string.h>
+#include <atomic>
+#include <type_traits>
 #include <utxx/atomic.hpp>
 #include <utxx/meta.hpp>
 #include <utxx/path.hpp>
@@ -59,6 +61,66 @@ namespace utxx {
         namespace bip = boost::interprocess;
     }
 
+/// Lock type selecting the multi-copy mode of persist_blob.
+///
+/// In this mode the file holds \a NCopies copies of T and an atomic
+/// generation number identifying the last published copy.  The writer
+/// fills the copy following the published one and then advances the
+/// generation, so readers never take a lock: they copy the published
+/// data and validate the copy's sequence number, retrying only if the
+/// writer wrapped around all copies during the copy.  Readers can't be
+/// blocked by a writer that died while holding a lock.  Writers must be
+/// serialized by the caller (typically there's a single writer process).
+template <int NCopies = 2>
+struct versioned_copies {
+    static_assert(NCopies >= 2, "At least two copies are required");
+    static const int s_copies = NCopies;
+};
+
+namespace detail {
+    /// Open or create a memory mapped file of \a a_size bytes
+    /// @return true if the file was created or had zero size
+    inline bool map_blob_file(const char* a_file, size_t a_size, bool a_read_only,
+                              int a_mode, bip::file_mapping& a_fm, bip::mapped_region& a_reg)
+        throw (io_error, runtime_error)
+    {
+        bool l_initialized = false;
+        {
+            int  l_fd;
+
+            if ((l_fd = ::open( a_file, a_read_only ? O_RDONLY : O_CREAT|O_RDWR, a_mode ) ) < 0)
+                throw io_error(errno, "Cannot open file ", a_file, " for ",
+                    a_read_only ? "reading" : "writing");
+
+            BOOST_SCOPE_EXIT_TPL( (&l_fd) ) {
+                ::close(l_fd);
+            } BOOST_SCOPE_EXIT_END;
+
+            struct stat buf;
+            if (::fstat(l_fd, &buf) < 0)
+                throw io_error(errno, "Cannot check file size of ", a_file);
+
+            if (buf.st_size == 0) {
+                if (::ftruncate(l_fd, a_size) < 0)
+                    throw io_error(errno, "Cannot set size of file ",
+                        a_file, " to ", a_size);
+                l_initialized = true;
+            } else if (size_t(buf.st_size) != a_size) {
+                // Something is wrong - blob size on disk must match the blob size.
+                throw runtime_error("Size of file", a_file, " is wrong - likely old version."
+                    " Delete it and try again!");
+            }
+        }
+
+        bip::file_mapping  l_shmf(a_file,   a_read_only ? bip::read_only : bip::read_write);
+        bip::mapped_region l_region(l_shmf, a_read_only ? bip::read_only : bip::read_write);
+
+        a_fm.swap(l_shmf);
+        a_reg.swap(l_region);
+        return l_initialized;
+    }
+}
+
 /// Persistent blob of type T stored in memory mapped file.
 template<typename T, typename Lock = robust_lock>
 class persist_blob
@@ -98,7 +160,7 @@ public:
     /// @return true if file didn't exist and was created.
     bool init(const char* a_file, const T* a_init_val = NULL,
         bool a_read_only = true, int a_mode = default_file_mode())
-        throw (io_error);
+        throw (io_error, runtime_error);
 
     bool is_open() const { return m_blob; }
 
@@ -129,65 +191,18 @@ public:
 
 template<typename T, typename L>
 bool persist_blob<T,L>::init(const char* a_file, const T* a_init_val,
-    bool a_read_only, int a_mode) throw (io_error)
+    bool a_read_only, int a_mode) throw (io_error, runtime_error)
 {
     BOOST_ASSERT(a_file);
 
     close();
 
     bool l_created     = !path::file_exists(a_file);
-    bool l_initialized = false;
-    {
-        int  l_fd;
-
-        if ((l_fd = ::open( a_file, a_read_only ? O_RDONLY : O_CREAT|O_RDWR, a_mode ) ) < 0)
-            throw io_error(errno, "Cannot open file ", a_file, " for ",
-                a_read_only ? "reading" : "writing");
-
-        BOOST_SCOPE_EXIT_TPL( (&l_fd) ) {
-            ::close(l_fd);
-        } BOOST_SCOPE_EXIT_END;
-
-        struct stat buf;
-        if (::fstat(l_fd, &buf) < 0)
-            throw io_error(errno, "Cannot check file size of ", a_file);
-
-        if (buf.st_size == 0) {
-            if (::ftruncate(l_fd, sizeof(blob_t)) < 0) {
-                int ec = errno;
-                close();
-                throw io_error(ec, "Cannot set size of file ",
-                    a_file, " to ", sizeof(blob_t));
-            }
-            l_initialized = true;
-        } else if (buf.st_size != sizeof(blob_t)) {
-            // Something is wrong - blob size on disk must match the blob size.
-            close();
-            throw runtime_error("Size of file", a_file, " is wrong - likely old version."
-                " Delete it and try again!");
-        }
-
-    }
-
-    bip::file_mapping  l_shmf(a_file,   a_read_only ? bip::read_only : bip::read_write);
-    bip::mapped_region l_region(l_shmf, a_read_only ? bip::read_only : bip::read_write);
-
-    m_blob = reinterpret_cast<blob_t*>(l_region.get_address());
-
-    m_file.swap(l_shmf);
-    m_region.swap(l_region);
+    bool l_initialized = detail::map_blob_file
+        (a_file, sizeof(blob_t), a_read_only, a_mode, m_file, m_region);
 
-    /*
-    m_blob = reinterpret_cast<blob_t*>(
-        ::mmap(0, sizeof(blob_t),
-            PROT_READ|PROT_WRITE, MAP_SHARED, m_fd, 0));
+    m_blob = reinterpret_cast<blob_t*>(m_region.get_address());
 
-    if (m_blob == MAP_FAILED) {
-        int ec = errno;
-        close();
-        throw io_error(ec, "Error mapping file ", a_file, " to memory");
-    }
-    */
     if (l_initialized) {
         if (a_init_val) {
             m_blob->data = *a_init_val;
@@ -246,6 +261,145 @@ void persist_blob<T,L>::reset() {
 template<typename T, typename L>
 const uint32_t persist_blob<T,L>::blob_t::s_version;
 
+/// Persistent blob with \a N copies of T and wait-free readers.
+/// See versioned_copies for the description of the protocol.
+template<typename T, int N>
+class persist_blob<T, versioned_copies<N>>
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Multi-copy mode requires trivially copyable T");
+
+    struct copy_t {
+        // 2*gen while published, 2*gen-1 while being written for gen
+        std::atomic<uint64_t> seq;
+        T                     data;
+    } __attribute__((aligned(UTXX_CL_SIZE)));
+
+    struct blob_t {
+        // Distinct from the single-copy layout version
+        static const uint32_t s_version = 0xFEAB0100 | N;
+        uint32_t              version;
+        std::atomic<uint64_t> gen;
+        copy_t                copies[N];
+    } __attribute__((aligned(UTXX_CL_SIZE)));
+
+    blob_t*             m_blob;
+    bip::file_mapping   m_file;
+    bip::mapped_region  m_region;
+    std::string         m_filename;
+
+    copy_t& copy(uint64_t a_gen) const { return m_blob->copies[a_gen % N]; }
+
+public:
+    typedef T value_type;
+    static const int s_copies = N;
+
+    persist_blob() : m_blob(NULL) {}
+    ~persist_blob() { close(); }
+
+    /// Default permission mask used for opening a file
+    static int default_file_mode() { return S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP; }
+
+    /// @return true if file didn't exist and was created.
+    bool init(const char* a_file, const T* a_init_val = NULL,
+        bool a_read_only = true, int a_mode = default_file_mode())
+        throw (io_error, runtime_error);
+
+    bool is_open() const { return m_blob; }
+
+    void close() {
+        if (!m_blob)
+            return;
+        m_blob = NULL;
+        bip::file_mapping  l_fm;
+        bip::mapped_region l_reg;
+        m_file.swap(l_fm);
+        m_region.swap(l_reg);
+    }
+
+    void reset() { T v; bzero(&v, sizeof(T)); set(v); }
+
+    int  flush() { return m_blob && m_region.flush() ? 0 : -1; }
+
+    /// Name of the underlying memory mapped file
+    const std::string& filename() const { return m_filename; }
+
+    /// Generation of the published copy (incremented by every set())
+    uint64_t generation() const { return m_blob->gen.load(std::memory_order_acquire); }
+
+    /// Lock-free copy of the published value
+    T get() const {
+        BOOST_ASSERT(m_blob);
+        T res;
+        while (true) {
+            uint64_t g = m_blob->gen.load(std::memory_order_acquire);
+            copy_t&  c = copy(g);
+            uint64_t s = c.seq.load(std::memory_order_acquire);
+            if (unlikely(s != 2*g))
+                continue;       // The writer wrapped around to this copy
+            ::memcpy(static_cast<void*>(&res), &c.data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (likely(c.seq.load(std::memory_order_relaxed) == s))
+                return res;
+        }
+    }
+
+    /// Fill the inactive copy and publish it
+    void set(const T& a_src) {
+        BOOST_ASSERT(m_blob);
+        uint64_t g = m_blob->gen.load(std::memory_order_relaxed) + 1;
+        copy_t&  c = copy(g);
+        c.seq.store(2*g-1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        ::memcpy(static_cast<void*>(&c.data), &a_src, sizeof(T));
+        c.seq.store(2*g, std::memory_order_release);
+        m_blob->gen.store(g, std::memory_order_release);
+    }
+
+    // Non-concurrent "dirty" access to the published copy
+    T&       dirty_get()                { BOOST_ASSERT(m_blob); return copy(generation()).data; }
+    const T& dirty_get() const          { BOOST_ASSERT(m_blob); return copy(generation()).data; }
+    void     dirty_set(const T& src)    { dirty_get() = src; }
+
+    T*       operator->()               { return &dirty_get(); }
+    const T* operator->()       const   { return &dirty_get(); }
+};
+
+template<typename T, int N>
+bool persist_blob<T, versioned_copies<N>>::init(const char* a_file,
+    const T* a_init_val, bool a_read_only, int a_mode) throw (io_error, runtime_error)
+{
+    BOOST_ASSERT(a_file);
+
+    close();
+
+    bool l_created     = !path::file_exists(a_file);
+    bool l_initialized = detail::map_blob_file
+        (a_file, sizeof(blob_t), a_read_only, a_mode, m_file, m_region);
+
+    m_blob     = reinterpret_cast<blob_t*>(m_region.get_address());
+    m_filename = a_file;
+
+    if (l_initialized) {
+        bzero(m_blob, sizeof(blob_t));
+        if (a_init_val)
+            m_blob->copies[0].data = *a_init_val;
+        m_blob->version = blob_t::s_version;
+    } else if (blob_t::s_version != m_blob->version) {
+        close();
+        throw runtime_error("Wrong version of data in the file", a_file,
+            " (expected: ", blob_t::s_version, ", got: ", m_blob->version, ')');
+    }
+    // A writer that crashed in the middle of set() left an unpublished copy
+    // that readers never look at, and that the next set() overwrites
+
+    return l_created;
+}
+
+template<typename T, int N>
+const uint32_t persist_blob<T, versioned_copies<N>>::blob_t::s_version;
+
+
 } // namespace utxx
 
 #endif
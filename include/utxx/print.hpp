@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/scope_exit.hpp>
 #include <utxx/compiler_hints.hpp>
 #include <utxx/convert.hpp>
+#include <utxx/format_string.hpp>
 #include <utxx/error.hpp>
 
 namespace utxx {
@@ -234,19 +235,25 @@ namespace detail {
             itoa(a, out(m_pos));
         }
         void do_print(int a) {
-            reserve(10);
+            reserve(12);
             itoa(a, out(m_pos));
         }
         void do_print(uint16_t a) {
-            reserve(5);
+            reserve(6);
             itoa(a, out(m_pos));
         }
         void do_print(int16_t a) {
-            reserve(6);
+            reserve(7);
             itoa(a, out(m_pos));
         }
         void do_print(double a)
         {
+            // Negative precision requests the shortest round-trip output
+            if (m_precision < 0) {
+                reserve(32);
+                m_pos += ftoa_shortest<false>(a, m_pos, capacity());
+                return;
+            }
             int n = ftoa_left(a, m_pos, capacity(), m_precision, true);
             if (unlikely(n < 0)) {
                 n = snprintf(m_pos, capacity(), "%.*f", m_precision, a);
@@ -372,7 +379,9 @@ namespace detail {
 
         /// Max depth of src_info scope printed
         void        max_src_scope(int a) { m_max_src_scope = a; }
-        /// Precision of floating point (default: 6)
+        /// Precision of floating point (default: 6).  Negative precision
+        /// prints the shortest representation that reads back to the same
+        /// number (see ftoa_shortest()).
         void        precision    (int a) { m_precision     = a; }
 
         /// Reserve space in the buffer to hold additional \a a_sz bytes
@@ -426,6 +435,18 @@ namespace detail {
             m_pos += a_size;
         }
 
+        /// Append arguments formatted according to a compile-time format
+        /// string (see format_string.hpp).  The space is reserved once for
+        /// the statically computed maximum size of the output.
+        /// \code
+        ///   buf.format(UTXX_FMT("{} {:>8} @ {:.2f}"), side, qty, px);
+        /// \endcode
+        template <class S, class... Args>
+        void format(format_string<S> a_fmt, const Args&... a_args) {
+            reserve(format_size(a_fmt, a_args...));
+            m_pos = format_to(m_pos, a_fmt, a_args...);
+        }
+
         int vprintf(const char* a_fmt, va_list a_args) {
             int n = vsnprintf(m_pos, capacity(), a_fmt, a_args);
             if (n < 0)
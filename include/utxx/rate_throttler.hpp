@@ -15,6 +15,12 @@
 /// http://www.devquotes.com/2010/11/24/an-efficient-network-throttling-algorithm.
 /// \note Another article on rate limiting
 /// http://www.pennedobjects.com/2010/10/better-rate-limiting-with-dot-net.
+///
+/// basic_gcra_throttle, basic_token_bucket and basic_sliding_window_throttle
+/// are lock-free throttles that can be shared by many threads (e.g. a
+/// per-exchange message rate limit consulted by all strategy threads).  basic_token_bucket_array stores a
+/// large number of independent token buckets (per session, per symbol)
+/// in compact arrays refilled in bulk.
 //----------------------------------------------------------------------------
 // Created: 2011-01-20
 //----------------------------------------------------------------------------
@@ -45,11 +51,21 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #ifndef _UTXX_THROTTLER_HPP_
 #define _UTXX_THROTTLER_HPP_
 
+#include <utxx/config.h>
 #include <utxx/error.hpp>
 #include <utxx/meta.hpp>
 #include <utxx/time_val.hpp>
 #include <utxx/compiler_hints.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+#include <stdlib.h>
 #include <time.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace utxx {
 
@@ -59,11 +75,13 @@ namespace utxx {
 /// window. The reservation gets freed as the time goes by.  No more than
 /// the "rate()" number of samples are allowed to fit in the "window_msec()"
 /// window.
-template <typename T = uint32_t>
+/// @tparam Clock clock policy with static time_val now() function supplying
+///               the default time (e.g. realtime_clock or tsc_clock)
+template <typename T = uint32_t, typename Clock = realtime_clock>
 class basic_time_spacing_throttle {
 public:
     basic_time_spacing_throttle(uint32_t a_rate, uint32_t a_window_msec = 1000,
-                          time_val a_now = now_utc())
+                          time_val a_now = Clock::now())
         : m_rate        (a_rate)
         , m_window_us   (a_window_msec * 1000)
         , m_step_us     (m_window_us / m_rate)
@@ -74,7 +92,7 @@ public:
     /// @return number of samples that fit in the throttling window. 0 means
     /// that the throttler is fully congested, and more time needs to elapse
     /// before the throttles gets reset to accept more samples.
-    T add(T a_samples  = 1, time_val a_now = now_utc()) {
+    T add(T a_samples  = 1, time_val a_now = Clock::now()) {
         auto next_time = m_next_time;
         next_time.add_usec(a_samples * m_step_us);
         auto diff      = next_time.microseconds()
@@ -98,7 +116,7 @@ public:
     time_val next_time()   const { return m_next_time;        }
 
     /// Return the number of available samples given \a a_now current time.
-    T        available(time_val a_now = now_utc()) const      {
+    T        available(time_val a_now = Clock::now()) const   {
         auto   diff = (a_now - m_next_time).microseconds();
         return diff >= 0 ? m_rate : T(m_window_us + diff) / m_step_us;
     }
@@ -112,6 +130,367 @@ private:
 
 using time_spacing_throttle = basic_time_spacing_throttle<>;
 
+/// @brief Lock-free throttle implementing the Generic Cell Rate Algorithm.
+/// GCRA is the time spacing algorithm of basic_time_spacing_throttle with
+/// its whole state kept in one atomic "theoretical arrival time" (TAT):
+/// each admitted sample moves the TAT forward by step_nsec(), and samples
+/// are admitted as long as the TAT stays within the window (the tolerance)
+/// from the current time.  Any number of threads may call add()
+/// concurrently, each update being a single compare-and-swap.
+///
+/// The sustained rate is "rate()" samples per "window_msec()", and an idle
+/// throttle admits a burst of up to "rate()" samples at once.  A burst
+/// followed by samples at the sustained rate may thus admit up to
+/// 2*rate()-1 samples within one window_msec() interval.  Use
+/// basic_sliding_window_throttle to enforce a hard limit per interval.
+/// \note Before C++17 operator new doesn't honor the cache line alignment
+///       of this class, so it defines its own.
+/// @tparam Clock clock policy with static time_val now() function supplying
+///               the default time (e.g. realtime_clock or tsc_clock)
+template <typename Clock = realtime_clock>
+class basic_gcra_throttle {
+public:
+    basic_gcra_throttle(uint32_t a_rate, uint32_t a_window_msec = 1000,
+                        time_val a_now = Clock::now())
+        : basic_gcra_throttle(a_now, a_rate, int64_t(a_window_msec) * 1000000 / a_rate)
+    {}
+
+    basic_gcra_throttle(const basic_gcra_throttle&) = delete;
+    basic_gcra_throttle& operator=(const basic_gcra_throttle&) = delete;
+
+    /// Add \a a_samples to the throttle if all of them fit in the window.
+    /// @return true if the samples were admitted
+    bool try_add(uint32_t a_samples = 1, time_val a_now = Clock::now()) {
+        return acquire(a_samples, a_now.nanoseconds(), true) != 0;
+    }
+
+    /// Add up to \a a_samples to the throttle.
+    /// @return number of samples that fit in the throttling window. 0 means
+    /// that the throttler is fully congested.
+    uint32_t add(uint32_t a_samples = 1, time_val a_now = Clock::now()) {
+        return acquire(a_samples, a_now.nanoseconds(), false);
+    }
+
+    /// Return the number of available samples given \a a_now current time.
+    uint32_t available(time_val a_now = Clock::now()) const {
+        auto now = a_now.nanoseconds();
+        return room(std::max(m_tat.load(std::memory_order_relaxed), now), now);
+    }
+
+    /// Earliest time when \a a_samples (not exceeding rate()) can be added
+    time_val next_time(uint32_t a_samples = 1, time_val a_now = Clock::now()) const {
+        auto t = m_tat.load(std::memory_order_relaxed) + a_samples * m_step_ns - m_limit_ns;
+        return std::max(a_now, time_val(nsecs(t)));
+    }
+
+    /// Make all samples available
+    void reset(time_val a_now = Clock::now()) {
+        m_tat.store(a_now.nanoseconds(), std::memory_order_relaxed);
+    }
+
+    uint32_t rate()        const { return m_rate;                   }
+    long     step_nsec()   const { return m_step_ns;                }
+    long     window_msec() const { return m_limit_ns / 1000000;     }
+    long     window_usec() const { return m_limit_ns / 1000;        }
+
+    static void* operator new(size_t a_size) {
+        void* p;
+        if (::posix_memalign(&p, UTXX_CL_SIZE, a_size) != 0)
+            throw std::bad_alloc();
+        return p;
+    }
+    static void operator delete(void* a_p) { ::free(a_p); }
+
+protected:
+    basic_gcra_throttle(time_val a_now, uint32_t a_rate, int64_t a_step_ns)
+        : m_tat    (a_now.nanoseconds())
+        , m_step_ns(std::max<int64_t>(1, a_step_ns))
+        , m_limit_ns(a_rate * m_step_ns)
+        , m_rate   (a_rate)
+    {}
+
+private:
+    // The TAT is written by all threads: keep it in its own cache line, so
+    // that it doesn't invalidate the read-only members below
+    alignas(UTXX_CL_SIZE) std::atomic<int64_t> m_tat;
+    char     m_pad[UTXX_CL_SIZE - sizeof(std::atomic<int64_t>)];
+    int64_t  m_step_ns;     // Interval between samples at the sustained rate
+    int64_t  m_limit_ns;    // Max distance of TAT from the current time
+    uint32_t m_rate;
+
+    uint32_t room(int64_t a_tat, int64_t a_now) const {
+        auto n = (a_now + m_limit_ns - a_tat) / m_step_ns;
+        return n > 0 ? uint32_t(n) : 0;
+    }
+
+    uint32_t acquire(uint32_t a_samples, int64_t a_now, bool a_all) {
+        auto tat = m_tat.load(std::memory_order_relaxed);
+        while (true) {
+            auto from = std::max(tat, a_now);
+            auto n    = std::min(a_samples, room(from, a_now));
+            if (!n || (a_all && n < a_samples))
+                return 0;
+            if (m_tat.compare_exchange_weak(tat, from + n * m_step_ns,
+                                            std::memory_order_relaxed))
+                return n;
+        }
+    }
+};
+
+using gcra_throttle = basic_gcra_throttle<>;
+
+/// @brief Lock-free throttle admitting no more than "rate()" samples within
+/// any "window_msec()" interval.
+/// The window is split into sub-windows, each counting the samples admitted
+/// in it.  Samples are admitted if the current sub-window and the
+/// "buckets()" preceding ones, which together cover any window-long
+/// interval ending now, hold no more than rate() samples.  Hence the limit
+/// is enforced over an interval up to one sub-window longer than the
+/// window, and more sub-windows bring it closer to window_msec().
+///
+/// Each counter is an atomic word tagged with its sub-window's sequence
+/// number.  add() increments the counter first and then backs off the
+/// samples that don't fit, so concurrent callers near the limit may be
+/// refused spuriously, but the limit is never exceeded.  Timestamps are
+/// expected to be non-decreasing: samples older than a reused sub-window
+/// are refused.
+/// @tparam Clock clock policy with static time_val now() function supplying
+///               the default time (e.g. realtime_clock or tsc_clock)
+template <typename Clock = realtime_clock>
+class basic_sliding_window_throttle {
+public:
+    /// @param a_rate        max number of samples within the window
+    /// @param a_window_msec window size
+    /// @param a_buckets     number of sub-windows in the window
+    basic_sliding_window_throttle(uint32_t a_rate, uint32_t a_window_msec = 1000,
+                                  uint32_t a_buckets = 10)
+        : m_rate     (a_rate)
+        , m_buckets  (std::max<uint32_t>(1, a_buckets))
+        , m_bucket_ns(std::max<int64_t>(1, int64_t(a_window_msec) * 1000000 / m_buckets))
+        , m_mask     (upper_pow2(m_buckets + 1) - 1)
+        , m_slots    (new std::atomic<uint64_t>[m_mask + 1])
+    {
+        reset();
+    }
+
+    basic_sliding_window_throttle(const basic_sliding_window_throttle&) = delete;
+    basic_sliding_window_throttle& operator=(const basic_sliding_window_throttle&) = delete;
+
+    /// Add \a a_samples to the throttle if all of them fit in the window.
+    /// @return true if the samples were admitted
+    bool try_add(uint32_t a_samples = 1, time_val a_now = Clock::now()) {
+        return acquire(a_samples, a_now.nanoseconds(), true) != 0;
+    }
+
+    /// Add up to \a a_samples to the throttle.
+    /// @return number of samples that fit in the throttling window. 0 means
+    /// that the throttler is fully congested.
+    uint32_t add(uint32_t a_samples = 1, time_val a_now = Clock::now()) {
+        return acquire(a_samples, a_now.nanoseconds(), false);
+    }
+
+    /// Return the number of available samples given \a a_now current time.
+    uint32_t available(time_val a_now = Clock::now()) const {
+        auto n = total(bucket(a_now.nanoseconds()));
+        return n < m_rate ? m_rate - n : 0;
+    }
+
+    /// Make all samples available
+    void reset() {
+        for (uint32_t i = 0; i <= m_mask; ++i)
+            m_slots[i].store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t rate()        const { return m_rate;                         }
+    uint32_t buckets()     const { return m_buckets;                      }
+    long     bucket_nsec() const { return m_bucket_ns;                    }
+    long     window_msec() const { return m_bucket_ns*m_buckets / 1000000;}
+    long     window_usec() const { return m_bucket_ns*m_buckets / 1000;   }
+
+private:
+    uint32_t m_rate;
+    uint32_t m_buckets;
+    int64_t  m_bucket_ns;
+    uint32_t m_mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_slots;
+
+    static uint32_t upper_pow2(uint32_t a) {
+        uint32_t n = 1;
+        while (n < a) n <<= 1;
+        return n;
+    }
+
+    // Sequence numbers wrap around: the ring size is a power of 2 so that
+    // consecutive sub-windows always map to consecutive slots
+    uint32_t bucket(int64_t a_now) const { return uint32_t(a_now / m_bucket_ns); }
+    static uint32_t tag  (uint64_t a)   { return uint32_t(a >> 32);     }
+    static uint32_t count(uint64_t a)   { return uint32_t(a);           }
+    static uint64_t slot (uint32_t a_tag, uint32_t a_cnt) {
+        return uint64_t(a_tag) << 32 | a_cnt;
+    }
+
+    /// Number of samples in sub-window \a a_seq and the buckets() preceding ones
+    uint32_t total(uint32_t a_seq) const {
+        uint32_t n = 0;
+        for (uint32_t i = 0; i <= m_buckets; ++i) {
+            uint32_t seq = a_seq - i;
+            uint64_t v   = m_slots[seq & m_mask].load();
+            if (tag(v) == seq)
+                n += count(v);
+        }
+        return n;
+    }
+
+    uint32_t acquire(uint32_t a_samples, int64_t a_now, bool a_all) {
+        if (UNLIKELY(!a_samples || a_samples > m_rate))
+            return 0;
+        uint32_t seq = bucket(a_now);
+        auto&    s   = m_slots[seq & m_mask];
+        uint64_t v   = s.load(std::memory_order_relaxed);
+        uint32_t cnt;
+        do {
+            if (int32_t(tag(v) - seq) > 0)
+                return 0;       // The slot was reused by a later sub-window
+            cnt = tag(v) == seq ? count(v) : 0;
+            if (cnt >= m_rate)
+                return 0;
+        } while (!s.compare_exchange_weak(v, slot(seq, cnt + a_samples)));
+
+        // Back off the samples exceeding the rate
+        uint32_t n      = total(seq);
+        uint32_t excess = n > m_rate ? std::min(n - m_rate, a_samples) : 0;
+        if (a_all && excess)
+            excess = a_samples;
+        if (excess) {
+            v = s.load(std::memory_order_relaxed);
+            while (tag(v) == seq &&
+                   !s.compare_exchange_weak(v, slot(seq, count(v) - excess)));
+        }
+        return a_samples - excess;
+    }
+};
+
+using sliding_window_throttle = basic_sliding_window_throttle<>;
+
+/// @brief Lock-free token bucket holding up to "capacity()" tokens that are
+/// replenished at "rate()" tokens per second.  The bucket is implemented by
+/// GCRA (see basic_gcra_throttle): rather than counting tokens, it keeps
+/// the time at which the bucket would be empty, so that no refilling is
+/// ever needed and any number of threads can take tokens concurrently.
+template <typename Clock = realtime_clock>
+class basic_token_bucket : public basic_gcra_throttle<Clock> {
+    using base = basic_gcra_throttle<Clock>;
+public:
+    /// Create a full bucket
+    /// @param a_capacity max number of tokens (i.e. the max burst)
+    /// @param a_rate     number of tokens added per second
+    basic_token_bucket(uint32_t a_capacity, double a_rate, time_val a_now = Clock::now())
+        : base(a_now, a_capacity, int64_t(1e9 / a_rate + 0.5))
+    {}
+
+    uint32_t capacity()    const { return base::rate();             }
+    double   rate()        const { return 1e9 / base::step_nsec();  }
+};
+
+using token_bucket = basic_token_bucket<>;
+
+/// @brief Array of independent token buckets stored compactly.
+/// The token counts, capacities and rates of buckets are kept in separate
+/// arrays (12 bytes per bucket), so that refill() replenishes all buckets
+/// in one vectorized pass.  Taking a token is then a compare and decrement
+/// that doesn't need to read the clock.  The array is not thread-safe: it's
+/// meant to be owned by a thread serving many sessions or symbols, calling
+/// refill() periodically (e.g. from a timer).
+/// @tparam Clock clock policy with static time_val now() function supplying
+///               the default time (e.g. realtime_clock or tsc_clock)
+template <typename Clock = realtime_clock>
+class basic_token_bucket_array {
+public:
+    explicit basic_token_bucket_array(time_val a_now = Clock::now()) : m_last(a_now) {}
+
+    /// Create \a a_count full buckets with given capacity and refill rate
+    basic_token_bucket_array(size_t a_count, float a_capacity, float a_rate,
+                             time_val a_now = Clock::now())
+        : m_last(a_now)
+    {
+        resize(a_count, a_capacity, a_rate);
+    }
+
+    size_t size() const { return m_tokens.size(); }
+
+    /// Change the number of buckets.  New buckets are full.
+    void resize(size_t a_count, float a_capacity, float a_rate) {
+        m_tokens.resize(a_count, a_capacity);
+        m_capacity.resize(a_count, a_capacity);
+        m_rate.resize(a_count, a_rate);
+    }
+
+    /// Set the capacity and refill rate (tokens per second) of a bucket,
+    /// and fill it up
+    void set(size_t a_idx, float a_capacity, float a_rate) {
+        m_tokens[a_idx]   = a_capacity;
+        m_capacity[a_idx] = a_capacity;
+        m_rate[a_idx]     = a_rate;
+    }
+
+    float tokens  (size_t a_idx) const { return m_tokens[a_idx];   }
+    float capacity(size_t a_idx) const { return m_capacity[a_idx]; }
+    float rate    (size_t a_idx) const { return m_rate[a_idx];     }
+
+    /// Time of the last refill()
+    time_val last_refill() const { return m_last; }
+
+    /// Take \a a_count tokens from bucket \a a_idx if it has enough of them
+    bool try_acquire(size_t a_idx, float a_count = 1) {
+        auto& t = m_tokens[a_idx];
+        if (t < a_count)
+            return false;
+        t -= a_count;
+        return true;
+    }
+
+    /// Add the tokens accumulated in all buckets since the last refill
+    void refill(time_val a_now = Clock::now()) {
+        auto dt = float((a_now - m_last).seconds());
+        if (dt <= 0)
+            return;
+        m_last = a_now;
+        refill(dt);
+    }
+
+    /// Add tokens accumulated by all buckets in \a a_dt seconds
+    void refill(float a_dt) {
+        size_t n   = m_tokens.size(), i = 0;
+        float* tok = m_tokens.data();
+        auto   cap = m_capacity.data(), rate = m_rate.data();
+      #if defined(__AVX__)
+        auto dt8 = _mm256_set1_ps(a_dt);
+        for (; i + 8 <= n; i += 8) {
+            auto t = _mm256_add_ps(_mm256_loadu_ps(tok + i),
+                                   _mm256_mul_ps(_mm256_loadu_ps(rate + i), dt8));
+            _mm256_storeu_ps(tok + i, _mm256_min_ps(t, _mm256_loadu_ps(cap + i)));
+        }
+      #endif
+      #if defined(__SSE2__)
+        auto dt4 = _mm_set1_ps(a_dt);
+        for (; i + 4 <= n; i += 4) {
+            auto t = _mm_add_ps(_mm_loadu_ps(tok + i), _mm_mul_ps(_mm_loadu_ps(rate + i), dt4));
+            _mm_storeu_ps(tok + i, _mm_min_ps(t, _mm_loadu_ps(cap + i)));
+        }
+      #endif
+        for (; i < n; ++i)
+            tok[i] = std::min(tok[i] + rate[i] * a_dt, cap[i]);
+    }
+
+private:
+    std::vector<float> m_tokens;
+    std::vector<float> m_capacity;
+    std::vector<float> m_rate;
+    time_val           m_last;
+};
+
+using token_bucket_array = basic_token_bucket_array<>;
+
 /**
  * \brief Efficiently calculates the throttling rate over a number of seconds.
  * The algorithm implements a variation of token bucket algorithm that
@@ -126,8 +505,12 @@ using time_spacing_throttle = basic_time_spacing_throttle<>;
  *          in the circuling buffer.
  * @tparam BucketsPerSec defines the number of bucket slots per second.
  *          The larger the number the more accurate the running sum will be.
+ * @tparam Clock clock policy with static time_val now() function used by
+ *          the overloads that don't take time (e.g. realtime_clock or
+ *          tsc_clock).
  */
-template<size_t MaxSeconds = 16, size_t BucketsPerSec = 2>
+template<size_t MaxSeconds = 16, size_t BucketsPerSec = 2,
+         typename Clock = realtime_clock>
 class basic_rate_throttler {
 public:
     static const size_t s_max_seconds       = upper_power<MaxSeconds,2>::value;
@@ -180,8 +563,12 @@ public:
     /// @return current running sum.
     long   add(time_val a_time, int a_count = 1);
 
+    /// Add \a a_count number of items to the bucket of the current time.
+    long   add(int a_count = 1) { return add(Clock::now(), a_count); }
+
     /// Update current timestamp.
     long   refresh(time_val a_time) { return add(a_time, 0); }
+    long   refresh()                { return add(Clock::now(), 0); }
 
     /// Dump the internal state to stream
     void   dump(std::ostream& out, time_val a_time);
@@ -198,8 +585,8 @@ private:
 //------------------------------------------------------------------------------
 // Implementation
 //------------------------------------------------------------------------------
-template<size_t MaxSeconds, size_t BucketsPerSec>
-long basic_rate_throttler<MaxSeconds, BucketsPerSec>::
+template<size_t MaxSeconds, size_t BucketsPerSec, typename Clock>
+long basic_rate_throttler<MaxSeconds, BucketsPerSec, Clock>::
 add(time_val a_time, int a_count)
 {
     time_t l_now = (time_t)(a_time.seconds() * s_buckets_per_sec);
@@ -273,8 +660,8 @@ add(time_val a_time, int a_count)
     return m_sum;
 }
 
-template<size_t MaxSeconds, size_t BucketsPerSec>
-void basic_rate_throttler<MaxSeconds, BucketsPerSec>::
+template<size_t MaxSeconds, size_t BucketsPerSec, typename Clock>
+void basic_rate_throttler<MaxSeconds, BucketsPerSec, Clock>::
 dump(std::ostream& out, time_val a_time)
 {
     time_t l_now    = (time_t)(a_time.seconds() * s_buckets_per_sec);
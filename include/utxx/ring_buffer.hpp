@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/math.hpp>
 #include <utxx/error.hpp>
 #include <utxx/compiler_hints.hpp>
+#include <utxx/shm_liveness.hpp>
 #include <cstddef>
 #include <type_traits>
 #include <atomic>
@@ -72,7 +73,7 @@ private:
 
     // Version of the ring_buffer used to validate it in case we will construct
     // externally allocated buffer (last bit signifies external allocation
-    static const size_t s_version = 0xFF123450;
+    static const size_t s_version = 0xFF123460;
     size_t m_version;
 
     // Total number of Entries inserted (including those which over-wrote the
@@ -90,6 +91,8 @@ private:
     // -oo):
     size_t m_capacity;
     size_t m_mask;
+    // Liveness of the Writer process (see attach_writer() and recover()):
+    shm_peer m_writer;
     T*     m_data;
     T      m_entries[s_static_capacity];
 
@@ -110,7 +113,7 @@ private:
     // voked from within "CreateInShM" only:
     //
     ring_buffer(size_t a_capacity, bool a_external_memory)
-        : m_version   (s_version | a_external_memory ? 1 : 0)
+        : m_version   (s_version | (a_external_memory ? 1 : 0))
         , m_end       (0u)
         , m_capacity  (StaticCapacity
             ? s_static_capacity : math::upper_power(a_capacity, 2))
@@ -254,6 +257,51 @@ public:
         return m_entries[a_idx];
     }
 
+    //-----------------------------------------------------------------------//
+    // Writer Liveness and Crash Recovery:                                   //
+    //-----------------------------------------------------------------------//
+    // "m_end" is only incremented after an entry is completely constructed,
+    // so it always holds the number of committed entries. A Writer restarted
+    // after a crash re-attaches to the buffer in shared memory with create()
+    // (with a_construct=false) followed by recover(), and continues adding
+    // entries after the last committed one.  Readers can detect the death of
+    // the Writer with writer_status().
+    //
+    /// Attach the current process as the Writer.
+    /// @param a_force take over even if the current Writer is still alive
+    /// @return new generation of the Writer (number of attachments so far)
+    /// @throw  runtime_error if another live process is the Writer
+    uint32_t attach_writer(bool a_force = false) {
+        return m_writer.attach(a_force);
+    }
+
+    /// Detach the current process if it's the Writer.
+    void detach_writer() { m_writer.detach(); }
+
+    /// Record progress of the Writer (called by the Writer periodically).
+    void heartbeat() { m_writer.beat(); }
+
+    /// Liveness of the Writer process.
+    /// @param a_timeout_ns if positive, the Writer is considered STALLED if
+    ///                     it didn't call heartbeat() within this interval
+    peer_state writer_status(int64_t a_timeout_ns = 0) const {
+        return m_writer.state(a_timeout_ns);
+    }
+
+    /// Generation of the Writer (number of attachments so far).
+    uint32_t writer_generation() const {
+        return m_writer.generation.load(std::memory_order_acquire);
+    }
+
+    /// Re-attach a restarted Writer to the buffer.
+    /// @return total number of committed entries, ie the position where the
+    ///         next add() will store an entry
+    /// @throw  runtime_error if another live process is the Writer
+    size_t recover(bool a_force = false) {
+        attach_writer(a_force);
+        return load_size<Atomic>(std::memory_order_acquire);
+    }
+
     /// Total memory footprint needed to allocate a ring-buffer of a_capacity
     static size_t memory_size(size_t a_capacity) {
         size_t sz = math::upper_power(a_capacity, 2);
@@ -4,6 +4,14 @@
 //----------------------------------------------------------------------------
 /// This file implements a class that calculates running mean and
 /// standard deviation. 
+///
+/// Samples can be added one at a time or in batches with add_batch(), which
+/// computes the statistics of a batch in vectorized passes and merges them
+/// with the running ones.  Statistics gathered by different threads can be
+/// combined with operator+=.  Windowed (basic_moving_variance) and
+/// exponentially weighted (exp_moving_variance) variants are also provided,
+/// and exp_moving_variance_array updates the statistics of many series
+/// (e.g. instruments) at once.
 //----------------------------------------------------------------------------
 // Created: 2010-05-20
 //----------------------------------------------------------------------------
@@ -40,6 +48,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <algorithm>
 #include <stdexcept>
 #include <assert.h>
+#include <vector>
 #include <utxx/detail/running_stat_impl.hpp>
 #include <utxx/compiler_hints.hpp>
 
@@ -100,6 +109,15 @@ public:
         if (x < m_min) m_min = x;
     }
 
+    /// Add \a a_n sample measurements.
+    void add_batch(const T* a_data, size_t a_n) {
+        if (unlikely(!a_n))
+            return;
+        detail::sum_minmax(a_data, a_n, m_sum, m_min, m_max);
+        m_count += a_n;
+        m_last   = a_data[a_n-1];
+    }
+
     void operator+= (const basic_running_sum<T, CntType>& a) {
         m_count += a.m_count;
         m_sum   += a.m_sum;
@@ -158,6 +176,29 @@ public:
             m_var += diff * (x - base::mean());
     }
 
+    /// Add \a a_n sample measurements.  The mean and variance of the batch
+    /// are computed in two vectorized passes and merged with the running ones.
+    void add_batch(const T* a_data, size_t a_n) {
+        if (unlikely(!a_n))
+            return;
+        basic_running_variance<T, CntType> b;
+        b.base::add_batch(a_data, a_n);
+        b.m_var = detail::sum_sq_dev(a_data, a_n, b.mean());
+        *this  += b;
+        this->m_last = b.m_last;
+    }
+
+    /// Merge statistics of another set of samples (Chan et al. parallel
+    /// algorithm), e.g. when combining per-thread statistics.
+    void operator+= (const basic_running_variance<T, CntType>& a) {
+        if (!a.m_count)
+            return;
+        double na = double(this->m_count), nb = double(a.m_count);
+        double d  = a.mean() - this->mean();
+        m_var    += a.m_var + d * d * na * nb / (na + nb);
+        base::operator+=(a);
+    }
+
     /// Number of samples since last invocation of clear().
     double   variance()  const { return likely(this->m_count) ? m_var/this->m_count : 0.0; }
     double   deviation() const { return sqrt(variance()); }
@@ -255,6 +296,12 @@ struct basic_moving_average
         ++m_end;
     }
 
+    /// Add \a a_n samples
+    void add_batch(const T* a_data, size_t a_n) {
+        for (size_t i = 0; i < a_n; ++i)
+            add(a_data[i]);
+    }
+
     void clear() {
         base::clear();
         if (m_data)
@@ -304,6 +351,212 @@ protected:
     T               m_samples[N];
 };
 
+/// Mean and variance of samples in a moving window.
+/// A sample replacing the oldest one in the window updates the mean and
+/// variance without traversing the window.  To discard the rounding error
+/// of these updates, the statistics are recomputed from the window every
+/// capacity() samples, which adds two vectorized passes per window.
+template <typename T, int N = 0, bool FastMinMax = false>
+class basic_moving_variance : public basic_moving_average<T, N, FastMinMax> {
+    typedef basic_moving_average<T, N, FastMinMax> base;
+
+    double m_mean;
+    double m_m2;        // Sum of squared deviations from the mean
+    double m_inv_cap;   // 1.0 / capacity()
+
+    void resync() {
+        double sum = 0;
+        T      mn  = std::numeric_limits<T>::max();
+        T      mx  = std::numeric_limits<T>::lowest();
+        detail::sum_minmax(this->m_data, this->capacity(), sum, mn, mx);
+        m_mean      = sum * m_inv_cap;
+        m_m2        = detail::sum_sq_dev(this->m_data, this->capacity(), m_mean);
+        this->m_sum = T(sum);
+    }
+public:
+    explicit basic_moving_variance(size_t a_capacity = 0)
+        : base(a_capacity)
+        , m_mean(0), m_m2(0)
+        , m_inv_cap(1.0 / this->capacity())
+    {}
+
+    void add(T a_sample) {
+        double x = a_sample;
+        if (this->m_end > this->MASK) {
+            // The window is full: replace the oldest sample
+            double old  = this->data(this->m_end);
+            double mean = m_mean + (x - old) * m_inv_cap;
+            m_m2       += (x - old) * (x - mean + old - m_mean);
+            m_mean      = mean;
+        } else {
+            double d = x - m_mean;
+            m_mean  += d / double(this->m_end + 1);
+            m_m2    += d * (x - m_mean);
+        }
+        base::add(a_sample);
+        if ((this->m_end & this->MASK) == 0)
+            resync();
+    }
+
+    /// Add \a a_n samples
+    void add_batch(const T* a_data, size_t a_n) {
+        for (size_t i = 0; i < a_n; ++i)
+            add(a_data[i]);
+    }
+
+    void clear() {
+        base::clear();
+        m_mean = m_m2 = 0;
+    }
+
+    double   mean()      const { return m_mean; }
+    /// Variance of samples in the window
+    double   variance()  const {
+        return likely(m_m2 > 0) ? m_m2 / this->size() : 0.0;
+    }
+    double   deviation() const { return sqrt(variance()); }
+};
+
+/// Exponentially weighted moving mean and variance.
+/// The weight of a new sample is alpha, and the weight of previous samples
+/// decays by a factor of (1 - alpha), so that an update takes a few
+/// multiplications without divisions.  The first sample initializes the mean.
+class exp_moving_variance {
+    double m_alpha;
+    double m_mean;
+    double m_var;
+    double m_last;
+    size_t m_count;
+public:
+    /// @param a_alpha weight of a new sample (0 < a_alpha <= 1)
+    explicit exp_moving_variance(double a_alpha) {
+        alpha(a_alpha);
+        clear();
+    }
+
+    /// Alpha giving the same average age of samples as a simple moving
+    /// average over a window of \a a_span samples
+    static double span_alpha(double a_span) { return 2.0 / (a_span + 1); }
+
+    void add(double x) {
+        if (unlikely(!m_count))
+            m_mean = x;
+        else {
+            double d   = x - m_mean;
+            double inc = m_alpha * d;
+            m_mean    += inc;
+            m_var      = (1.0 - m_alpha) * (m_var + d * inc);
+        }
+        m_last = x;
+        ++m_count;
+    }
+
+    /// Add \a a_n samples
+    void add_batch(const double* a_data, size_t a_n) {
+        for (size_t i = 0; i < a_n; ++i)
+            add(a_data[i]);
+    }
+
+    /// Clear internal state
+    void clear() { m_mean = m_var = m_last = 0; m_count = 0; }
+
+    double alpha()     const { return m_alpha; }
+    void   alpha(double a_alpha) {
+        if (!(a_alpha > 0 && a_alpha <= 1))
+            throw std::out_of_range("utxx::exp_moving_variance: alpha must be in (0, 1]");
+        m_alpha = a_alpha;
+    }
+
+    size_t count()     const { return m_count; }
+    bool   empty()     const { return !m_count; }
+    double last()      const { return m_last;  }
+    double mean()      const { return m_mean;  }
+    double variance()  const { return m_var;   }
+    double deviation() const { return sqrt(m_var); }
+};
+
+/// Exponentially weighted moving mean and variance of a number of series
+/// (e.g. prices of instruments) updated together.
+/// The means and variances are kept in separate arrays, so that update()
+/// applies a new sample of every series in one vectorized pass.
+class exp_moving_variance_array {
+    double              m_alpha;
+    size_t              m_count;
+    std::vector<double> m_mean;
+    std::vector<double> m_var;
+public:
+    /// @param a_size  number of series
+    /// @param a_alpha weight of a new sample (0 < a_alpha <= 1)
+    exp_moving_variance_array(size_t a_size, double a_alpha)
+        : m_alpha(a_alpha), m_count(0), m_mean(a_size), m_var(a_size)
+    {
+        if (!(a_alpha > 0 && a_alpha <= 1))
+            throw std::out_of_range
+                ("utxx::exp_moving_variance_array: alpha must be in (0, 1]");
+    }
+
+    /// Add a sample of every series.  The first update initializes the means.
+    /// @param a_values array of size() samples
+    void update(const double* a_values) {
+        size_t  n    = m_mean.size(), i = 0;
+        double* mean = m_mean.data();
+        double* var  = m_var.data();
+        ++m_count;
+        if (unlikely(m_count == 1)) {
+            std::copy(a_values, a_values + n, mean);
+            return;
+        }
+        double a = m_alpha, b = 1.0 - m_alpha;
+      #if defined(__AVX__)
+        auto a4 = _mm256_set1_pd(a), b4 = _mm256_set1_pd(b);
+        for (; i + 4 <= n; i += 4) {
+            auto m   = _mm256_loadu_pd(mean + i);
+            auto d   = _mm256_sub_pd(_mm256_loadu_pd(a_values + i), m);
+            auto inc = _mm256_mul_pd(a4, d);
+            auto v   = _mm256_add_pd(_mm256_loadu_pd(var + i), _mm256_mul_pd(d, inc));
+            _mm256_storeu_pd(mean + i, _mm256_add_pd(m, inc));
+            _mm256_storeu_pd(var  + i, _mm256_mul_pd(b4, v));
+        }
+      #endif
+      #if defined(__SSE2__)
+        auto a2 = _mm_set1_pd(a), b2 = _mm_set1_pd(b);
+        for (; i + 2 <= n; i += 2) {
+            auto m   = _mm_loadu_pd(mean + i);
+            auto d   = _mm_sub_pd(_mm_loadu_pd(a_values + i), m);
+            auto inc = _mm_mul_pd(a2, d);
+            auto v   = _mm_add_pd(_mm_loadu_pd(var + i), _mm_mul_pd(d, inc));
+            _mm_storeu_pd(mean + i, _mm_add_pd(m, inc));
+            _mm_storeu_pd(var  + i, _mm_mul_pd(b2, v));
+        }
+      #endif
+        for (; i < n; ++i) {
+            double d   = a_values[i] - mean[i];
+            double inc = a * d;
+            mean[i]   += inc;
+            var[i]     = b * (var[i] + d * inc);
+        }
+    }
+
+    /// Clear internal state
+    void clear() {
+        std::fill(m_mean.begin(), m_mean.end(), 0.0);
+        std::fill(m_var.begin(),  m_var.end(),  0.0);
+        m_count = 0;
+    }
+
+    size_t        size()                   const { return m_mean.size(); }
+    /// Number of updates since last invocation of clear()
+    size_t        count()                  const { return m_count; }
+    double        alpha()                  const { return m_alpha; }
+
+    double        mean(size_t a_idx)       const { return m_mean[a_idx]; }
+    double        variance(size_t a_idx)   const { return m_var[a_idx];  }
+    double        deviation(size_t a_idx)  const { return sqrt(m_var[a_idx]); }
+
+    const double* means()                  const { return m_mean.data(); }
+    const double* variances()              const { return m_var.data();  }
+};
+
 /**
  * Calculate a running weighted average of values on a given 
  * windowing interval using exponential decay.
@@ -337,6 +590,14 @@ public:
         return m_last_wavg;
     }
 
+    /// Add \a a_n values reported at times \a a_now_sec (non-decreasing)
+    /// @return last weighted average
+    double add_batch(const size_t* a_now_sec, const double* a_values, size_t a_n) {
+        for (size_t i = 0; i < a_n; ++i)
+            calculate(a_now_sec[i], a_values[i]);
+        return m_last_wavg;
+    }
+
     /// Clear internal state
     void clear() { reset(m_sec_interval); }
 
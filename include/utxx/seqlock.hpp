@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+/// \file   seqlock.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Sequence lock protecting a small trivially copyable value.
+///
+/// A seqlock lets one (or a few) writers publish a multi-word value, and
+/// any number of readers take consistent snapshots of it without writing
+/// to shared memory, so that readers never slow down the writer or each
+/// other.  A reader retries its copy if a write overlapped with it.
+///
+/// The value is kept as an array of 64-bit atomic words copied with relaxed
+/// loads and stores, which avoids data races on the payload while compiling
+/// to plain moves.  The fences follow H.-J. Boehm, "Can Seqlocks Get Along
+/// With Programming Language Memory Models?" (MSPC 2012).
+///
+/// The layout is position-independent, so the seqlock can be placed in
+/// shared memory; zero-filled memory is a valid seqlock holding a zeroed
+/// value.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_SEQLOCK_HPP_
+#define _UTXX_SEQLOCK_HPP_
+
+#include <atomic>
+#include <type_traits>
+#include <string.h>
+#include <stdint.h>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/futex.hpp>
+
+namespace utxx {
+
+/// Sequence lock protecting a value of type \a T.
+/// @tparam T            trivially copyable type of the value
+/// @tparam MultiWriter  if true, concurrent writers are serialized by
+///                      spinning on the sequence number; otherwise there
+///                      must be a single writer at a time
+template <class T, bool MultiWriter = false>
+class seqlock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "T must be trivially copyable");
+
+    enum { s_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t) };
+
+    std::atomic<uint64_t> m_seq;            // Odd while a write is in progress
+    std::atomic<uint64_t> m_data[s_words];
+
+    void copy_in(const T& a_value) {
+        uint64_t buf[s_words] = {0};
+        memcpy(buf, &a_value, sizeof(T));
+        for (int i = 0; i < s_words; ++i)
+            m_data[i].store(buf[i], std::memory_order_relaxed);
+    }
+
+    void copy_out(T& a_value) const {
+        uint64_t buf[s_words];
+        for (int i = 0; i < s_words; ++i)
+            buf[i] = m_data[i].load(std::memory_order_relaxed);
+        memcpy(&a_value, buf, sizeof(T));
+    }
+
+public:
+    typedef T value_type;
+
+    seqlock() : m_seq(0) { copy_in(T()); }
+    explicit seqlock(const T& a_value) : m_seq(0) { copy_in(a_value); }
+
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    /// Begin a write: make the sequence number odd
+    void write_lock() {
+        if (!MultiWriter) {
+            m_seq.store(m_seq.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        } else {
+            uint64_t s = m_seq.load(std::memory_order_relaxed);
+            while ((s & 1) ||
+                   !m_seq.compare_exchange_weak(s, s + 1, std::memory_order_relaxed)) {
+                detail::cpu_relax();
+                s = m_seq.load(std::memory_order_relaxed);
+            }
+        }
+        // Order the sequence bump before the writes of the payload
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /// Publish a write: make the sequence number even
+    void write_unlock() {
+        m_seq.store(m_seq.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    }
+
+    /// Publish a new value
+    void store(const T& a_value) {
+        write_lock();
+        copy_in(a_value);
+        write_unlock();
+    }
+
+    /// Modify the value in place with \a a_fun(T&) under the write lock.
+    /// Only the writer(s) may call this method.
+    template <class Fun>
+    void update(Fun&& a_fun) {
+        write_lock();
+        T v;
+        copy_out(v);
+        a_fun(v);
+        copy_in(v);
+        write_unlock();
+    }
+
+    /// Make a single attempt to read a consistent snapshot of the value.
+    /// @return false if the read overlapped with a write
+    bool try_load(T& a_value) const {
+        uint64_t s = m_seq.load(std::memory_order_acquire);
+        if (UNLIKELY(s & 1))
+            return false;
+        copy_out(a_value);
+        // Order the reads of the payload before re-reading the sequence
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_seq.load(std::memory_order_relaxed) == s;
+    }
+
+    /// Read a consistent snapshot of the value
+    void load(T& a_value) const {
+        while (!try_load(a_value))
+            detail::cpu_relax();
+    }
+
+    /// Read a consistent snapshot of the value
+    T load() const { T v; load(v); return v; }
+
+    /// Number of writes so far (times two, odd while a write is in progress)
+    uint64_t sequence() const { return m_seq.load(std::memory_order_acquire); }
+
+    /// True if the value changed since sequence() returned \a a_seq
+    bool changed(uint64_t a_seq) const { return sequence() != a_seq; }
+};
+
+} // namespace utxx
+
+#endif // _UTXX_SEQLOCK_HPP_
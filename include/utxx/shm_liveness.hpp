@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------------
+/// \file   shm_liveness.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Liveness tracking of processes attached to shared-memory structures.
+///
+/// Lock-free shared-memory structures (such as concurrent_spsc_queue and
+/// ring_buffer) have no owner that the kernel could report dead the way
+/// it does for robust mutexes.  A shm_peer record, placed in the shared
+/// header of such a structure, holds the pid of the process attached to
+/// one of its sides, a generation incremented on every (re-)attachment,
+/// and the monotonic time of the last progress reported by that process.
+/// This lets the other side tell a live, a stalled and a dead peer apart,
+/// and lets a restarted process take the place of a dead one.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_SHM_LIVENESS_HPP_
+#define _UTXX_SHM_LIVENESS_HPP_
+
+#include <utxx/error.hpp>
+#include <atomic>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace utxx {
+
+/// State of a process attached to a side of a shared-memory structure
+enum class peer_state {
+      DETACHED  ///< No process is attached
+    , ALIVE     ///< The process exists and reported progress recently
+    , STALLED   ///< The process exists but didn't report progress in time
+    , DEAD      ///< The process no longer exists
+};
+
+/// Monotonic time in nanoseconds, comparable across processes
+inline int64_t monotonic_ns() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/// Check if a process with given pid exists
+inline bool process_alive(pid_t a_pid) {
+    return a_pid > 0 && (::kill(a_pid, 0) == 0 || errno == EPERM);
+}
+
+/// Liveness record of a process attached to one side of a shared-memory
+/// structure.  The record is position-independent and may be placed in
+/// shared memory.  Zero-filled memory is a valid DETACHED record.
+struct shm_peer {
+    std::atomic<int32_t>  pid;          ///< Attached process (0 - none)
+    std::atomic<uint32_t> generation;   ///< Number of attachments so far
+    std::atomic<int64_t>  heartbeat;    ///< monotonic_ns() of last progress
+
+    shm_peer() { reset(); }
+
+    void reset() {
+        pid.store(0, std::memory_order_relaxed);
+        generation.store(0, std::memory_order_relaxed);
+        heartbeat.store(0, std::memory_order_release);
+    }
+
+    /// Attach the current process to this side.
+    /// Attaching in place of a dead process is always allowed, in place of
+    /// a live one - only when \a a_force is true (e.g. when the caller knows
+    /// that the pid was reused by an unrelated process).
+    /// @return new generation of the side
+    uint32_t attach(bool a_force = false) {
+        int32_t self = ::getpid();
+        int32_t prev = pid.load(std::memory_order_acquire);
+        do {
+            if (prev != 0 && prev != self && !a_force && process_alive(prev))
+                UTXX_THROW_RUNTIME_ERROR
+                    ("Shared memory side is owned by live process ", prev);
+        } while (!pid.compare_exchange_weak(prev, self,
+                    std::memory_order_acq_rel, std::memory_order_acquire));
+
+        beat();
+        return generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    /// Detach the current process from this side if it's attached to it
+    void detach() {
+        int32_t self = ::getpid();
+        pid.compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+    }
+
+    /// Record progress of the attached process
+    void beat(int64_t a_now = monotonic_ns()) {
+        heartbeat.store(a_now, std::memory_order_release);
+    }
+
+    /// True if the current process is attached to this side
+    bool owned() const {
+        return pid.load(std::memory_order_acquire) == ::getpid();
+    }
+
+    /// Liveness of the attached process.
+    /// @param a_timeout_ns if positive, the process is considered STALLED when
+    ///                     it didn't report progress within this interval
+    peer_state state(int64_t a_timeout_ns = 0, int64_t a_now = 0) const {
+        int32_t p = pid.load(std::memory_order_acquire);
+        if (p == 0)
+            return peer_state::DETACHED;
+        if (!process_alive(p))
+            return peer_state::DEAD;
+        if (a_timeout_ns > 0) {
+            auto last = heartbeat.load(std::memory_order_acquire);
+            auto now  = a_now ? a_now : monotonic_ns();
+            if (now - last > a_timeout_ns)
+                return peer_state::STALLED;
+        }
+        return peer_state::ALIVE;
+    }
+};
+
+} // namespace utxx
+
+#endif // _UTXX_SHM_LIVENESS_HPP_
@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define _UTXX_SYNCH_HPP_
 
 #include <pthread.h>
+#include <utxx/config.h>
 #include <utxx/futex.hpp>
 #include <utxx/meta.hpp>
 
@@ -43,6 +44,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
 #include <condition_variable>
 #else
 #include <boost/thread/mutex.hpp>
@@ -331,6 +333,120 @@ public:
 
 //-----------------------------------------------------------------------------
 
+/// Distributed (big-reader) read-write lock.
+///
+/// Unlike read_write_spin_lock, whose readers all modify a shared counter,
+/// every reader increments a counter in its own cache-line padded slot, so
+/// concurrent readers don't bounce a cache line between cores.  A writer
+/// raises a flag that stops new readers and then waits for the reader
+/// counts of all slots to drop to zero, which makes write locking cost
+/// proportional to \a NSlots.  Use it for read-mostly data.
+///
+/// Threads are assigned slots round-robin on first use, so with no more
+/// than \a NSlots reader threads each thread has a slot of its own.
+/// Waiting is done by spinning, yielding the CPU after a while.
+///
+/// @tparam NSlots number of reader slots (power of 2)
+template <int NSlots = 64>
+class distributed_rw_lock {
+    static_assert((NSlots & (NSlots-1)) == 0, "NSlots must be power of 2");
+
+    struct alignas(UTXX_CL_SIZE) slot {
+        std::atomic<long> readers;
+        slot() : readers(0) {}
+    };
+
+    alignas(UTXX_CL_SIZE) std::atomic<int> m_writer;
+    slot                                   m_slots[NSlots];
+
+    static unsigned this_thread_slot() {
+        static std::atomic<unsigned> s_next(0);
+        static thread_local unsigned s_slot =
+            s_next.fetch_add(1, std::memory_order_relaxed) & (NSlots-1);
+        return s_slot;
+    }
+
+    static void pause(int& a_spins) {
+        if (++a_spins < 1000)
+            detail::cpu_relax();
+        else {
+            a_spins = 0;
+            std::this_thread::yield();
+        }
+    }
+
+public:
+    static const int s_slots = NSlots;
+
+    distributed_rw_lock() : m_writer(0) {}
+
+    distributed_rw_lock(const distributed_rw_lock&) = delete;
+    distributed_rw_lock& operator=(const distributed_rw_lock&) = delete;
+
+    void read_lock() {
+        auto& cnt = m_slots[this_thread_slot()].readers;
+        while (true) {
+            // Announce the reader before checking for a writer, so that the
+            // writer either sees the count or we see its flag
+            cnt.fetch_add(1, std::memory_order_seq_cst);
+            if (LIKELY(!m_writer.load(std::memory_order_seq_cst)))
+                return;
+            cnt.fetch_sub(1, std::memory_order_release);
+            for (int n = 0; m_writer.load(std::memory_order_relaxed); pause(n));
+        }
+    }
+
+    bool try_read_lock() {
+        auto& cnt = m_slots[this_thread_slot()].readers;
+        cnt.fetch_add(1, std::memory_order_seq_cst);
+        if (LIKELY(!m_writer.load(std::memory_order_seq_cst)))
+            return true;
+        cnt.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    void read_unlock() {
+        m_slots[this_thread_slot()].readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void write_lock() {
+        int n = 0;
+        for (int old = 0; !m_writer.compare_exchange_weak(old, 1, std::memory_order_seq_cst);
+             old = 0)
+            pause(n);
+        // Wait for the readers that got in before the flag was raised
+        for (auto& s : m_slots)
+            while (s.readers.load(std::memory_order_seq_cst))
+                pause(n);
+    }
+
+    bool try_write_lock() {
+        int old = 0;
+        if (!m_writer.compare_exchange_strong(old, 1, std::memory_order_seq_cst))
+            return false;
+        for (auto& s : m_slots)
+            if (s.readers.load(std::memory_order_seq_cst)) {
+                m_writer.store(0, std::memory_order_release);
+                return false;
+            }
+        return true;
+    }
+
+    void write_unlock() {
+        m_writer.store(0, std::memory_order_release);
+    }
+
+    // Interface of std::shared_timed_mutex (for std::shared_lock/std::unique_lock)
+    void lock()            { write_lock();            }
+    bool try_lock()        { return try_write_lock(); }
+    void unlock()          { write_unlock();          }
+    void lock_shared()     { read_lock();             }
+    bool try_lock_shared() { return try_read_lock();  }
+    void unlock_shared()   { read_unlock();           }
+};
+
+//-----------------------------------------------------------------------------
+
 class spin_lock {
     std::atomic<long> m_lock;
     long value() { return m_lock.load(std::memory_order_relaxed); }
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+/// \file   thread_cached_stat.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Thread-cached statistics merged lazily on read.
+///
+/// This generalizes thread_cached_int to arbitrary mergeable statistics,
+/// such as latency histograms, min/max gauges and running mean/variance.
+/// Every recording thread updates a private shard of the statistic.  Shards
+/// are aligned to the cache line size, so hot threads never modify a cache
+/// line holding another thread's shard.  Reading
+/// merges the shards of all threads (plus the shards of threads that have
+/// exited) into a single value.
+///
+/// A shard is guarded by a spin flag that is only contended while another
+/// thread reads the statistic, so recording a sample costs one uncontended
+/// atomic exchange on a thread-private cache line.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_THREAD_CACHED_STAT_HPP_
+#define _UTXX_THREAD_CACHED_STAT_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <utxx/config.h>
+#include <utxx/compiler_hints.hpp>
+#include <utxx/futex.hpp>
+#include <utxx/thread_local.hpp>
+#include <utxx/running_stat.hpp>
+#include <utxx/perf_histogram.hpp>
+#include <utxx/hdr_histogram.hpp>
+
+namespace utxx {
+
+/// Statistic of type \a Stat sharded per thread.
+///
+/// \a Stat must be copy-constructible and mergeable with
+/// "operator+=(const Stat&)".  Samples are recorded by calling Stat's
+/// add() function on the calling thread's shard.
+///
+/// Note that, like with thread_cached_int, reading requires iterating
+/// through all thread local objects with the same \a Tag while holding a
+/// lock, so the Tag space should be broken up if there are many instances.
+template <class Stat, class Tag = Stat>
+class thread_cached_stat : boost::noncopyable {
+    struct shard;
+
+public:
+    typedef Stat value_type;
+
+    /// @param a_init initial value of every shard (and of read() results),
+    ///               e.g. a histogram with a configured header
+    explicit thread_cached_stat(const Stat& a_init = Stat())
+        : m_init(a_init), m_retired(a_init)
+    {}
+
+    /// Add a sample to the calling thread's shard
+    template <class... Args>
+    void add(Args&&... a_args) {
+        shard* s = local();
+        s->lock();
+        s->m_stat.add(std::forward<Args>(a_args)...);
+        s->unlock();
+    }
+
+    /// Update the calling thread's shard by calling \a a_fun(Stat&)
+    template <class Fun>
+    void update(const Fun& a_fun) {
+        shard* s = local();
+        s->lock();
+        a_fun(s->m_stat);
+        s->unlock();
+    }
+
+    /// Merge the statistics of all threads
+    Stat read() const {
+        Stat res(m_init);
+        {
+            std::lock_guard<std::mutex> g(m_mutex);
+            res += m_retired;
+        }
+        for (auto& s : m_shards.access_all_threads()) {
+            s.lock();
+            res += s.m_stat;
+            s.unlock();
+        }
+        return res;
+    }
+
+    /// Merge the statistics of all threads and reset them.  Every sample
+    /// is accounted for exactly once across subsequent calls.
+    Stat read_and_reset() {
+        Stat res(m_init);
+        {
+            std::lock_guard<std::mutex> g(m_mutex);
+            res += m_retired;
+            assign(m_retired, m_init);
+        }
+        for (auto& s : m_shards.access_all_threads()) {
+            s.lock();
+            res += s.m_stat;
+            assign(s.m_stat, m_init);
+            s.unlock();
+        }
+        return res;
+    }
+
+    /// Reset the statistics of all threads
+    void reset() { read_and_reset(); }
+
+    // Shards may outlive this object in other threads, so they need to
+    // know that the parent is gone
+    ~thread_cached_stat() {
+        for (auto& s : m_shards.access_all_threads())
+            s.m_parent = nullptr;
+    }
+
+private:
+    Stat                        m_init;
+    mutable std::mutex          m_mutex;
+    Stat                        m_retired;  // Shards of exited threads
+    thr_local_ptr<shard, Tag>   m_shards;   // Must be last for dtor ordering
+
+    // Stat types may lack a copy assignment operator
+    static void assign(Stat& a_dst, const Stat& a_src) {
+        a_dst.~Stat();
+        new (&a_dst) Stat(a_src);
+    }
+
+    shard* local() {
+        shard* s = m_shards.get();
+        if (unlikely(s == nullptr)) {
+            s = new shard(*this);
+            m_shards.reset(s);
+        }
+        return s;
+    }
+
+    struct alignas(UTXX_CL_SIZE) shard {
+        thread_cached_stat*     m_parent;
+        mutable std::atomic<bool> m_lock;
+        Stat                    m_stat;
+
+        explicit shard(thread_cached_stat& a_parent)
+            : m_parent(&a_parent), m_lock(false), m_stat(a_parent.m_init)
+        {}
+
+        // operator new doesn't honor the over-alignment before C++17
+        static void* operator new(size_t a_size) {
+            void* p;
+            if (::posix_memalign(&p, UTXX_CL_SIZE, a_size) != 0)
+                throw std::bad_alloc();
+            return p;
+        }
+        static void operator delete(void* a_p) { ::free(a_p); }
+
+        void lock() const {
+            while (unlikely(m_lock.exchange(true, std::memory_order_acquire)))
+                while (m_lock.load(std::memory_order_relaxed))
+                    detail::cpu_relax();
+        }
+
+        void unlock() const { m_lock.store(false, std::memory_order_release); }
+
+        // Fold the samples of an exiting thread into the parent
+        ~shard() {
+            if (!m_parent)
+                return;
+            std::lock_guard<std::mutex> g(m_parent->m_mutex);
+            m_parent->m_retired += m_stat;
+        }
+    };
+};
+
+/// Per-thread count/sum/min/max gauge
+template <class T, class Tag = basic_running_sum<T>>
+using thread_cached_gauge = thread_cached_stat<basic_running_sum<T>, Tag>;
+
+/// Per-thread running mean/variance
+template <class T, class Tag = basic_running_variance<T>>
+using thread_cached_variance = thread_cached_stat<basic_running_variance<T>, Tag>;
+
+/// Per-thread latency histogram
+template <class Tag = perf_histogram>
+using thread_cached_histogram = thread_cached_stat<perf_histogram, Tag>;
+
+/// Per-thread high dynamic range histogram.  All shards are copies of the
+/// histogram passed to the constructor, which defines their value range.
+template <class Tag = hdr_histogram>
+using thread_cached_hdr_histogram = thread_cached_stat<hdr_histogram, Tag>;
+
+} // namespace utxx
+
+#endif // _UTXX_THREAD_CACHED_STAT_HPP_
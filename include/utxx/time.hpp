@@ -172,13 +172,13 @@ namespace utxx {
 
     /// Convert y/m/d into seconds since epoch 1970-1-1
     inline time_t mktime_utc(int y, unsigned m, unsigned d) {
-        return to_gregorian_days(y, m, d) * 86400;
+        return time_t(to_gregorian_days(y, m, d)) * 86400;
     }
 
     /// Convert date into seconds since epoch 1970-1-1
     inline time_t mktime_utc(int      year, unsigned month, unsigned day,
                              unsigned hour, unsigned min,   unsigned sec) {
-        time_t res = to_gregorian_days(year, month, day) * 86400;
+        time_t res = time_t(to_gregorian_days(year, month, day)) * 86400;
         res += 3600*hour + 60*min + sec;
         return res;
     }
@@ -0,0 +1,272 @@
+//----------------------------------------------------------------------------
+/// \file   time_parser.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Fast parsing of fixed-layout UTC timestamps to time_val.
+///
+/// The parsers handle the layouts found in exchange protocols:
+///   - FIX UTCTimestamp:   "YYYYMMDD-HH:MM:SS[.s{1,9}]"
+///   - FIX UTCDateOnly:    "YYYYMMDD"
+///   - FIX UTCTimeOnly:    "HH:MM:SS[.s{1,9}]"
+///   - ISO 8601:           "YYYY-MM-DD(T| )HH:MM:SS[.s{1,9}][Z|(+|-)HH[[:]MM]]"
+///
+/// Eight characters of a date or a time of day are validated and converted
+/// with a few 64-bit (SWAR) operations instead of a loop over characters.
+/// Timestamps in a stream of messages almost always fall on the same day,
+/// so the parser caches the raw characters of the last date along with the
+/// time of its midnight: a timestamp on the cached date costs a single
+/// comparison for the date, and the time of day is added to the midnight
+/// directly, bypassing mktime_utc().
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_TIME_PARSER_HPP_
+#define _UTXX_TIME_PARSER_HPP_
+
+#include <utxx/time_val.hpp>
+#include <utxx/time.hpp>
+#include <utxx/convert.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <stdint.h>
+#include <string.h>
+
+namespace utxx {
+
+namespace detail {
+    /// Load 8 characters so that the first one is in the lowest byte
+    inline uint64_t load_chars8(const char* a_p) {
+        uint64_t v;
+        memcpy(&v, a_p, 8);
+      #if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap64(v);
+      #endif
+        return v;
+    }
+
+    /// Mask with the high bit set in every byte of \a a_v that is not a digit
+    inline uint64_t non_digits8(uint64_t a_v) {
+        uint64_t x = a_v ^ 0x3030303030303030ull;
+        return (x | (x + 0x7676767676767676ull)) & 0x8080808080808080ull;
+    }
+}
+
+/// Parser of fixed-layout UTC timestamps (see file description).
+/// All parsing methods return a pointer past the parsed timestamp, or NULL
+/// if the input doesn't match the layout or holds an invalid date or time.
+/// The parser caches the midnight of the last parsed date, so it must not
+/// be shared by threads; use instance() for a thread-local parser.
+class time_parser {
+    // No date cached: m_date2 is out of range of the two ISO date characters
+    // and non-zero, so neither parse_iso_date() nor parse_fix_date() can hit
+    static const uint32_t s_no_date = ~0u;
+
+    uint64_t m_date;        // Raw characters of the cached date
+    uint32_t m_date2;       // Last two characters of a cached ISO date (0 - FIX)
+    int64_t  m_midnight;    // Nanoseconds since epoch at midnight of m_date
+
+    bool set_date(unsigned a_y, unsigned a_m, unsigned a_d) {
+        if (UNLIKELY(a_m - 1 > 11u || a_d - 1 >= days_in_a_month(a_m, is_leap(a_y))))
+            return false;
+        m_midnight = int64_t(to_gregorian_days(int(a_y), a_m, a_d)) * 86400 * 1000000000L;
+        return true;
+    }
+
+    /// Parse fraction of a second (up to 9 digits are significant)
+    static const char* parse_fraction(const char* p, const char* a_end, int64_t& a_ns) {
+        int      n;
+        uint64_t frac;
+        if (LIKELY(a_end - p >= 8)) {
+            uint64_t v  = detail::load_chars8(p);
+            uint64_t nd = detail::non_digits8(v);
+            n = nd ? __builtin_ctzll(nd) >> 3 : 8;
+            if (UNLIKELY(!n))
+                return nullptr;
+            // Right-align the digits in a field of 8 left-filled with '0'
+            int s = 8 * (8 - n);
+            v     = (v << s) | (0x3030303030303030ull & ((1ull << s) - 1));
+            frac  = detail::swar_digits8(v) * detail::cs_pow10_u64[8 - n];
+        } else {
+            frac = 0;
+            for (n = 0; n < 8 && p + n < a_end && unsigned(p[n] - '0') < 10u; ++n)
+                frac = frac * 10 + (p[n] - '0');
+            if (UNLIKELY(!n))
+                return nullptr;
+            frac *= detail::cs_pow10_u64[8 - n];
+        }
+        p    += n;
+        frac *= 10;
+        if (n == 8 && p < a_end && unsigned(*p - '0') < 10u)
+            frac += *p++ - '0';
+        // Digits past nanoseconds are ignored
+        while (p < a_end && unsigned(*p - '0') < 10u) ++p;
+        a_ns += int64_t(frac);
+        return p;
+    }
+
+public:
+    time_parser() : m_date(~0ull), m_date2(s_no_date), m_midnight(0) {}
+
+    /// Parser for use by the current thread
+    static time_parser& instance() {
+        static thread_local time_parser s_parser;
+        return s_parser;
+    }
+
+    /// Parse time of day "HH:MM:SS[.s{1,9}]" (FIX UTCTimeOnly).
+    /// Seconds may be 60 to account for a leap second.
+    /// @param a_ns nanoseconds since midnight
+    static const char* parse_time_of_day(const char* p, const char* a_end, int64_t& a_ns) {
+        if (UNLIKELY(a_end - p < 8))
+            return nullptr;
+        // Digits become 0..9, and ':' become 0
+        uint64_t x = detail::load_chars8(p) ^ 0x30303a30303a3030ull;
+        if (UNLIKELY(((x | (x + 0x7676767676767676ull)) & 0x8080808080808080ull) ||
+                     (x & 0x0000ff0000ff0000ull)))
+            return nullptr;
+        // Byte i becomes 10*digit[i] + digit[i+1]
+        x = x * 10 + (x >> 8);
+        unsigned h = x & 0xff, m = (x >> 24) & 0xff, s = (x >> 48) & 0xff;
+        if (UNLIKELY(h > 23 || m > 59 || s > 60))
+            return nullptr;
+        a_ns = int64_t(h * 3600 + m * 60 + s) * 1000000000L;
+        p   += 8;
+        return (p < a_end && *p == '.') ? parse_fraction(p + 1, a_end, a_ns) : p;
+    }
+
+    /// Parse date "YYYYMMDD" (FIX UTCDateOnly).
+    /// @param a_midnight nanoseconds since epoch at midnight of the date
+    const char* parse_fix_date(const char* p, const char* a_end, int64_t& a_midnight) {
+        if (UNLIKELY(a_end - p < 8))
+            return nullptr;
+        uint64_t v = detail::load_chars8(p);
+        if (UNLIKELY(v != m_date || m_date2)) {
+            if (detail::non_digits8(v))
+                return nullptr;
+            unsigned ymd = detail::swar_digits8(v);
+            if (!set_date(ymd / 10000, ymd / 100 % 100, ymd % 100))
+                return nullptr;
+            m_date  = v;
+            m_date2 = 0;
+        }
+        a_midnight = m_midnight;
+        return p + 8;
+    }
+
+    /// Parse date "YYYY-MM-DD".
+    /// @param a_midnight nanoseconds since epoch at midnight of the date
+    const char* parse_iso_date(const char* p, const char* a_end, int64_t& a_midnight) {
+        if (UNLIKELY(a_end - p < 10))
+            return nullptr;
+        uint64_t v  = detail::load_chars8(p);
+        uint16_t v2 = uint16_t(uint8_t(p[8]) | uint8_t(p[9]) << 8);
+        if (UNLIKELY(v != m_date || v2 != m_date2)) {
+            if (p[4] != '-' || p[7] != '-')
+                return nullptr;
+            // Drop the dashes: "YYYY-MM-" + "DD" -> "YYYYMMDD"
+            uint64_t d = (v & 0x00000000ffffffffull)
+                       | (v & 0x00ffff0000000000ull) >> 8
+                       | uint64_t(v2) << 48;
+            if (detail::non_digits8(d))
+                return nullptr;
+            unsigned ymd = detail::swar_digits8(d);
+            if (!set_date(ymd / 10000, ymd / 100 % 100, ymd % 100))
+                return nullptr;
+            m_date  = v;
+            m_date2 = v2;
+        }
+        a_midnight = m_midnight;
+        return p + 10;
+    }
+
+    /// Parse FIX UTCTimestamp "YYYYMMDD-HH:MM:SS[.s{1,9}]"
+    const char* parse_fix(const char* p, const char* a_end, time_val& a_tv) {
+        int64_t midnight, tod;
+        if (UNLIKELY(a_end - p < 17 || p[8] != '-'))
+            return nullptr;
+        if (UNLIKELY(!parse_fix_date(p, a_end, midnight)))
+            return nullptr;
+        p = parse_time_of_day(p + 9, a_end, tod);
+        if (LIKELY(p))
+            a_tv = time_val(nsecs(midnight + tod));
+        return p;
+    }
+
+    /// Parse ISO 8601 "YYYY-MM-DD(T| )HH:MM:SS[.s{1,9}][Z|(+|-)HH[[:]MM]]".
+    /// A timestamp without a time zone designator is taken to be in UTC.
+    const char* parse_iso8601(const char* p, const char* a_end, time_val& a_tv) {
+        int64_t midnight, tod;
+        if (UNLIKELY(a_end - p < 19 || (p[10] != 'T' && p[10] != ' ' && p[10] != 't')))
+            return nullptr;
+        if (UNLIKELY(!parse_iso_date(p, a_end, midnight)))
+            return nullptr;
+        p = parse_time_of_day(p + 11, a_end, tod);
+        if (UNLIKELY(!p))
+            return nullptr;
+        if (p < a_end) {
+            if (*p == 'Z' || *p == 'z')
+                ++p;
+            else if (*p == '+' || *p == '-') {
+                // Offset of the local time from UTC
+                int sign = *p++ == '-' ? -1 : 1;
+                unsigned h, m = 0;
+                if (a_end - p < 2 || unsigned(p[0]-'0') > 9 || unsigned(p[1]-'0') > 9)
+                    return nullptr;
+                h  = (p[0]-'0') * 10 + (p[1]-'0');
+                p += 2;
+                const char* q = (p < a_end && *p == ':') ? p + 1 : p;
+                if (a_end - q >= 2 && unsigned(q[0]-'0') < 10 && unsigned(q[1]-'0') < 10) {
+                    m = (q[0]-'0') * 10 + (q[1]-'0');
+                    p = q + 2;
+                } else if (q != p)
+                    return nullptr;
+                if (h > 23 || m > 59)
+                    return nullptr;
+                tod -= sign * int64_t(h * 3600 + m * 60) * 1000000000L;
+            }
+        }
+        a_tv = time_val(nsecs(midnight + tod));
+        return p;
+    }
+};
+
+/// Parse FIX UTCTimestamp "YYYYMMDD-HH:MM:SS[.s{1,9}]" using the
+/// thread-local time_parser.
+/// @return pointer past the timestamp or NULL on error
+inline const char* parse_fix_timestamp(const char* a_p, const char* a_end, time_val& a_tv) {
+    return time_parser::instance().parse_fix(a_p, a_end, a_tv);
+}
+
+/// Parse ISO 8601 "YYYY-MM-DD(T| )HH:MM:SS[.s{1,9}][Z|(+|-)HH[[:]MM]]"
+/// using the thread-local time_parser.
+/// @return pointer past the timestamp or NULL on error
+inline const char* parse_iso8601(const char* a_p, const char* a_end, time_val& a_tv) {
+    return time_parser::instance().parse_iso8601(a_p, a_end, a_tv);
+}
+
+} // namespace utxx
+
+#endif // _UTXX_TIME_PARSER_HPP_
@@ -562,6 +562,11 @@ namespace utxx {
     /// Same as gettimeofday() call
     inline time_val now_utc() { return time_val::universal_time(); }
 
+    /// Clock policy reading CLOCK_REALTIME (see also tsc_clock in tsc_clock.hpp)
+    struct realtime_clock {
+        static time_val now() { return time_val::universal_time(); }
+    };
+
     /// Convert time_val to boost::posix_time::ptime
     inline boost::posix_time::ptime
     to_ptime (time_val a_tv) {
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+/// \file   time_zone.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Time zone conversion based on compiled tzdata transition tables.
+///
+/// A time_zone is loaded once from a TZif file of the system's tzdata
+/// (e.g. /usr/share/zoneinfo/America/New_York) or from a POSIX TZ rule
+/// string (e.g. "EST5EDT,M3.2.0,M11.1.0").  The transitions of the zone
+/// are kept in a sorted table; the POSIX rule found at the end of a TZif
+/// file is expanded into the table up to year 2100, so that the "slim"
+/// tzdata files, which stop listing transitions at the last rule change,
+/// give correct DST boundaries for future dates.
+///
+/// Conversion from UTC to local time doesn't call libc: an index of the
+/// table by 2^20-second (~12 days) buckets gives the transition in effect
+/// at the beginning of the bucket, so that a lookup costs one indexed load
+/// and at most a couple of comparisons.  Leap seconds are not accounted for.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_TIME_ZONE_HPP_
+#define _UTXX_TIME_ZONE_HPP_
+
+#include <utxx/time_val.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace utxx {
+
+/// Rules of a time zone for conversion between UTC and local time
+class time_zone {
+public:
+    /// Type of local time in effect between two transitions
+    struct ttinfo {
+        int32_t utc_offset;     ///< Seconds east of UTC
+        bool    is_dst;         ///< True if daylight saving time is in effect
+        char    abbrev[7];      ///< Abbreviation of the zone (e.g. "EDT")
+    };
+
+    /// Returned by next_transition() when there are no more transitions
+    static constexpr time_t NO_TRANSITION = std::numeric_limits<time_t>::max();
+
+    /// Load a time zone from a TZif file.
+    /// @param a_name zone name (e.g. "America/New_York") found in $TZDIR or
+    ///               /usr/share/zoneinfo, or an absolute path to a TZif file
+    /// @throw io_error if the file cannot be read, or runtime_error if it's
+    ///        not a valid TZif file
+    static std::shared_ptr<const time_zone> load(const std::string& a_name);
+
+    /// Create a time zone from the content of a TZif file
+    /// @throw runtime_error if the content is not valid
+    static std::shared_ptr<const time_zone>
+    from_tzif(const std::string& a_name, const char* a_data, size_t a_size);
+
+    /// Create a time zone from a POSIX TZ rule (e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
+    /// @throw badarg_error if the rule is not valid
+    static std::shared_ptr<const time_zone> from_posix(const std::string& a_rule);
+
+    /// Get a time zone from the process-wide registry, loading it on first
+    /// use.  \a a_name is a tzdata zone name or a POSIX TZ rule.
+    static std::shared_ptr<const time_zone> get(const std::string& a_name);
+
+    /// The zone of local time, given by the TZ environment variable or by
+    /// /etc/localtime.  The zone is resolved again if TZ changes.
+    static std::shared_ptr<const time_zone> local();
+
+    /// The UTC zone
+    static const time_zone& utc();
+
+    /// Name of the zone (or the POSIX rule it was created from)
+    const std::string& name() const { return m_name; }
+
+    /// Local time type in effect at UTC time \a a_utc (seconds since epoch)
+    const ttinfo& find(time_t a_utc) const {
+        size_t n;   // Number of transitions at or before a_utc
+        auto   b = uint64_t(a_utc - m_index_base) >> BUCKET_BITS;
+        if (LIKELY(a_utc >= m_index_base && b < m_index.size())) {
+            n = m_index[b];
+            while (n < m_trans.size() && m_trans[n] <= a_utc) ++n;
+        } else
+            n = std::upper_bound(m_trans.begin(), m_trans.end(), int64_t(a_utc))
+              - m_trans.begin();
+        return m_ttinfo[n ? m_types[n-1] : 0];
+    }
+
+    /// Offset of local time from UTC in seconds at UTC time \a a_utc
+    int32_t utc_offset(time_t a_utc) const { return find(a_utc).utc_offset; }
+
+    /// Abbreviation of the zone at UTC time \a a_utc
+    const char* abbrev(time_t a_utc) const { return find(a_utc).abbrev; }
+
+    /// Convert UTC time to local wall-clock time
+    time_val to_local(time_val a_utc) const {
+        return a_utc + secs(utc_offset(a_utc.sec()));
+    }
+
+    /// Convert local wall-clock time to UTC.
+    /// A local time repeated by a backward transition resolves to its first
+    /// occurrence; a local time skipped by a forward transition is taken to
+    /// be in the offset preceding the transition (like mktime(3) does).
+    time_val to_utc(time_val a_local) const {
+        auto l = a_local.sec();
+        // Transitions are more than two days apart, and offsets are under
+        // one day, so these are the offsets before and after l
+        auto o1 = utc_offset(l - 86400), o2 = utc_offset(l + 86400);
+        bool v1 = utc_offset(l - o1) == o1, v2 = utc_offset(l - o2) == o2;
+        auto o  = v1 && v2 ? std::max(o1, o2) : v2 ? o2 : o1;
+        return a_local - secs(o);
+    }
+
+    /// UTC time of the first transition after UTC time \a a_utc
+    /// @return NO_TRANSITION if there are no more transitions
+    time_t next_transition(time_t a_utc) const {
+        auto it = std::upper_bound(m_trans.begin(), m_trans.end(), int64_t(a_utc));
+        return it == m_trans.end() ? NO_TRANSITION : time_t(*it);
+    }
+
+    /// UTC time of the last local midnight at or before UTC time \a a_utc
+    time_t midnight(time_t a_utc) const {
+        auto l = a_utc + utc_offset(a_utc);
+        auto d = (l >= 0 ? l : l - 86399) / 86400;
+        return to_utc(time_val(secs(d * 86400))).sec();
+    }
+
+    /// UTC time of the first local midnight after UTC time \a a_utc
+    time_t next_midnight(time_t a_utc) const {
+        auto l = a_utc + utc_offset(a_utc);
+        auto d = (l >= 0 ? l : l - 86399) / 86400;
+        return to_utc(time_val(secs((d + 1) * 86400))).sec();
+    }
+
+    /// All transitions (UTC seconds since epoch) of the zone
+    const std::vector<int64_t>& transitions() const { return m_trans; }
+
+private:
+    enum { BUCKET_BITS = 20 };
+
+    std::string           m_name;
+    std::vector<int64_t>  m_trans;      // Sorted UTC times of transitions
+    std::vector<uint8_t>  m_types;      // Index in m_ttinfo from m_trans[i]
+    std::vector<ttinfo>   m_ttinfo;     // m_ttinfo[0] is in effect before m_trans[0]
+    std::vector<uint32_t> m_index;      // Transitions at or before bucket start
+    int64_t               m_index_base; // UTC time of the start of bucket 0
+
+    time_zone() : m_index_base(0) {}
+
+    struct posix_rule;
+
+    uint8_t add_type(int32_t a_offset, bool a_dst, const std::string& a_abbrev);
+    void    expand(const posix_rule& a_rule, int64_t a_from);
+    void    build_index();
+};
+
+} // namespace utxx
+
+#endif // _UTXX_TIME_ZONE_HPP_
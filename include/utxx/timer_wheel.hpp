@@ -0,0 +1,416 @@
+//----------------------------------------------------------------------------
+/// \file   timer_wheel.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Hierarchical hashed timer wheel for large numbers of timers.
+///
+/// The wheel (G. Varghese, T. Lauck, "Hashed and Hierarchical Timing Wheels",
+/// SOSP 1987) keeps timers in LEVELS rings of 256 slots, level k holding
+/// timers due within 256^(k+1) ticks.  Scheduling and cancelling a timer
+/// are O(1) operations that link or unlink an intrusive wheel_timer node,
+/// so they allocate no memory.  When the lowest ring wraps around, the
+/// timers of the next slot of the upper level are redistributed ("cascaded")
+/// to the lower levels.  A bitmap of non-empty slots lets advance() skip
+/// idle ticks, so that the cost of advancing is proportional to the number
+/// of expiring timers rather than the elapsed time.
+///
+/// The wheel is not thread-safe.  It is driven by calling advance() with the
+/// current time either from a busy-poll loop, or from a single asio timer
+/// whose handler runs on the strand serializing all calls to the wheel
+/// (use next_expiry() to arm that timer).
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_TIMER_WHEEL_HPP_
+#define _UTXX_TIMER_WHEEL_HPP_
+
+#include <utxx/time_val.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <functional>
+#include <stdint.h>
+
+namespace utxx {
+
+class timer_wheel;
+
+namespace detail {
+    /// Link of an intrusive circular doubly-linked list
+    struct wheel_link {
+        wheel_link* m_prev;
+        wheel_link* m_next;
+
+        wheel_link() : m_prev(this), m_next(this) {}
+
+        bool empty() const { return m_next == this; }
+
+        void push_back(wheel_link* a) {
+            a->m_prev = m_prev; a->m_next = this;
+            m_prev->m_next = a; m_prev = a;
+        }
+
+        void unlink() {
+            m_prev->m_next = m_next; m_next->m_prev = m_prev;
+            m_prev = m_next = this;
+        }
+
+        /// Move all elements of this list to the empty list \a a_to
+        void splice_to(wheel_link& a_to) {
+            if (empty()) return;
+            a_to.m_next = m_next; a_to.m_prev = m_prev;
+            m_next->m_prev = &a_to; m_prev->m_next = &a_to;
+            m_prev = m_next = this;
+        }
+    };
+}
+
+/// Timer scheduled in a timer_wheel.
+/// The timer is owned by the user (it's typically embedded in the object
+/// it times out), and is cancelled when destroyed.
+class wheel_timer : private detail::wheel_link {
+public:
+    /// Expiration handler called with the timer and the time passed to
+    /// timer_wheel::advance().  The handler may reschedule or cancel this
+    /// or any other timer.
+    typedef std::function<void (wheel_timer&, time_val)> handler;
+
+    wheel_timer() : m_wheel(nullptr), m_expiry(0), m_interval(0), m_slot(NO_SLOT) {}
+    explicit wheel_timer(const handler& a_fun) : wheel_timer() { m_handler = a_fun; }
+
+    wheel_timer(const wheel_timer&) = delete;
+    wheel_timer& operator=(const wheel_timer&) = delete;
+
+    ~wheel_timer() { cancel(); }
+
+    /// Set expiration handler
+    void on_expire(const handler& a_fun) { m_handler = a_fun; }
+
+    /// True if the timer is scheduled
+    bool active() const { return m_slot != NO_SLOT; }
+
+    /// True if the timer repeats after expiration
+    bool repeating() const { return m_interval != 0; }
+
+    /// Cancel the timer if it's scheduled
+    void cancel();
+
+private:
+    friend class timer_wheel;
+
+    enum : uint16_t { NO_SLOT = 0xFFFF, PENDING_SLOT = 0xFFFE };
+
+    timer_wheel* m_wheel;
+    uint64_t     m_expiry;      // Tick at which the timer is due
+    uint64_t     m_interval;    // Repeat interval in ticks (0 - one-shot)
+    uint16_t     m_slot;        // Index of the wheel slot holding the timer
+    handler      m_handler;
+};
+
+/// Hierarchical hashed timer wheel (see file description)
+class timer_wheel {
+public:
+    enum {
+        LEVELS        = 4,
+        SLOT_BITS     = 8,
+        SLOTS         = 1 << SLOT_BITS,
+        MASK          = SLOTS - 1,
+        OVERFLOW_SLOT = LEVELS * SLOTS  // Slot of timers beyond the top level
+    };
+
+    /// @param a_resolution duration of a tick
+    /// @param a_now        current time (start of tick 0)
+    explicit timer_wheel(time_val a_resolution = msecs(1), time_val a_now = now_utc())
+        : m_start(a_now), m_now(a_now), m_res(a_resolution.nanoseconds())
+        , m_tick(0), m_count(0)
+    {
+        BOOST_ASSERT(m_res > 0);
+        for (auto& w : m_bitmap) w = 0;
+    }
+
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    ~timer_wheel() {
+        for (auto& s : m_slots)
+            while (!s.empty()) {
+                auto t = static_cast<wheel_timer*>(s.m_next);
+                t->unlink();
+                t->m_slot  = wheel_timer::NO_SLOT;
+                t->m_wheel = nullptr;
+            }
+    }
+
+    /// Duration of a tick
+    time_val resolution() const { return nsecs(m_res); }
+
+    /// Time passed to the last advance() (or to the constructor)
+    time_val now()        const { return m_now; }
+
+    /// Number of scheduled timers
+    size_t   size()       const { return m_count; }
+    bool     empty()      const { return m_count == 0; }
+
+    /// Schedule the timer to fire at \a a_expiry, and then every \a a_interval
+    /// if it's not zero.  A timer never fires before its expiration time, and
+    /// fires no later than the first advance() at or past the end of the tick
+    /// that contains it.  If the timer was scheduled, it's rescheduled.
+    void schedule(wheel_timer& a_timer, time_val a_expiry, time_val a_interval = time_val()) {
+        if (a_timer.active())
+            a_timer.cancel();
+        auto ns = (a_expiry - m_start).nanoseconds();
+        auto tk = ns <= 0 ? 0 : uint64_t((ns + m_res - 1) / m_res);
+        a_timer.m_wheel    = this;
+        a_timer.m_expiry   = tk < m_tick ? m_tick : tk;
+        a_timer.m_interval = a_interval.nanoseconds() <= 0 ? 0
+                           : std::max<uint64_t>(1, a_interval.nanoseconds() / m_res);
+        ++m_count;
+        insert(a_timer);
+    }
+
+    /// Schedule the timer to fire in \a a_delay from now(), and then every
+    /// \a a_interval if it's not zero.
+    void schedule_in(wheel_timer& a_timer, time_val a_delay, time_val a_interval = time_val()) {
+        schedule(a_timer, now() + a_delay, a_interval);
+    }
+
+    /// Cancel the timer
+    void cancel(wheel_timer& a_timer) {
+        BOOST_ASSERT(a_timer.m_wheel == this || !a_timer.active());
+        if (!a_timer.active())
+            return;
+        auto slot = a_timer.m_slot;
+        a_timer.unlink();
+        a_timer.m_slot = wheel_timer::NO_SLOT;
+        --m_count;
+        if (slot < OVERFLOW_SLOT && m_slots[slot].empty())
+            clear_bit(slot);
+    }
+
+    /// Expire all timers due at or before \a a_now
+    /// @return number of expired timers
+    size_t advance(time_val a_now) {
+        auto ns = (a_now - m_start).nanoseconds();
+        if (ns < 0)
+            return 0;
+        if (a_now > m_now)
+            m_now = a_now;
+        uint64_t target = uint64_t(ns / m_res);
+        size_t   n      = 0;
+
+        while (m_tick <= target) {
+            if (UNLIKELY(!m_count)) {
+                m_tick = target + 1;
+                break;
+            }
+            if ((m_tick & MASK) == 0)
+                cascade();
+
+            // Next non-empty slot of the lowest level in this revolution
+            int s = next_slot(0, m_tick & MASK);
+            if (s < 0) {
+                // Skip to the end of the revolution, or if the lowest level
+                // is empty, to the next cascade of timers from upper levels
+                uint64_t next = (m_tick | MASK) + 1;
+                if (level_empty(0))
+                    next = next_cascade(next);
+                m_tick = std::min(next, target + 1);
+                continue;
+            }
+            uint64_t tk = (m_tick & ~uint64_t(MASK)) + s;
+            if (tk > target) {
+                m_tick = target + 1;
+                break;
+            }
+            m_tick = tk + 1;
+            n     += expire(s, target, a_now);
+        }
+        return n;
+    }
+
+    /// Time when advance() needs to be called next: the expiration tick of
+    /// the nearest timer if it's due in the current revolution of the lowest
+    /// level, or otherwise the time when the nearest timers are cascaded from
+    /// the upper levels.  If there are no timers, returns an empty time_val.
+    time_val next_expiry() const {
+        if (!m_count)
+            return time_val();
+        uint64_t tk = m_tick;
+        if (m_tick & MASK) {
+            int s = next_slot(0, m_tick & MASK);
+            if (s >= 0)
+                return tick_time((m_tick & ~uint64_t(MASK)) + s);
+            // Timers left in the lowest level are due in its next revolution
+            tk = (m_tick | MASK) + 1;
+            if (!level_empty(0))
+                return tick_time(tk);
+        }
+        // At the start of a revolution of the lowest level: the nearest of
+        // its timers or of the cascades from the upper levels
+        int      s = next_slot(0, 0);
+        uint64_t c = next_cascade(tk);
+        return tick_time(s >= 0 ? std::min(tk + s, c) : c);
+    }
+
+private:
+    time_val           m_start;
+    time_val           m_now;
+    int64_t            m_res;                   // Tick duration in nanoseconds
+    uint64_t           m_tick;                  // Next tick to process
+    size_t             m_count;
+    detail::wheel_link m_slots[OVERFLOW_SLOT + 1];
+    uint64_t           m_bitmap[LEVELS * SLOTS / 64];
+
+    time_val tick_time(uint64_t a_tick) const {
+        return m_start + nsecs(int64_t(a_tick) * m_res);
+    }
+
+    void set_bit  (unsigned a_slot) { m_bitmap[a_slot >> 6] |=  (1ull << (a_slot & 63)); }
+    void clear_bit(unsigned a_slot) { m_bitmap[a_slot >> 6] &= ~(1ull << (a_slot & 63)); }
+
+    /// Index of the first non-empty slot at \a a_level starting from \a a_from
+    /// @return -1 if there are no timers in the rest of the level
+    int next_slot(int a_level, unsigned a_from) const {
+        const uint64_t* bm = m_bitmap + a_level * (SLOTS / 64);
+        for (unsigned i = a_from >> 6; i < SLOTS / 64; ++i) {
+            auto w = bm[i];
+            if (i == a_from >> 6)
+                w &= ~0ull << (a_from & 63);
+            if (w)
+                return int(i << 6) + __builtin_ctzll(w);
+        }
+        return -1;
+    }
+
+    bool level_empty(int a_level) const {
+        const uint64_t* bm = m_bitmap + a_level * (SLOTS / 64);
+        uint64_t w = 0;
+        for (unsigned i = 0; i < SLOTS / 64; ++i) w |= bm[i];
+        return !w;
+    }
+
+    /// First tick at or after \a a_tick (a boundary of the lowest level's
+    /// revolution) when timers are cascaded from some upper level
+    uint64_t next_cascade(uint64_t a_tick) const {
+        uint64_t next = ~uint64_t(0);
+        for (int k = 1; k <= LEVELS; ++k) {
+            auto     sh   = SLOT_BITS * k;
+            // Index of the first slot of level k cascaded at or after a_tick
+            uint64_t base = (a_tick + (uint64_t(1) << sh) - 1) >> sh;
+            int64_t  n    = -1;
+            if (k == LEVELS)
+                n = m_slots[OVERFLOW_SLOT].empty() ? -1 : 0;
+            else {
+                unsigned idx = base & MASK;
+                int      s   = next_slot(k, idx);
+                if (s >= 0)
+                    n = s - idx;
+                else if ((s = next_slot(k, 0)) >= 0)
+                    n = SLOTS - idx + s;
+            }
+            if (n >= 0)
+                next = std::min(next, (base + n) << sh);
+        }
+        return next;
+    }
+
+    void insert(wheel_timer& a_timer) {
+        auto     e     = a_timer.m_expiry;
+        uint64_t delta = e - m_tick;
+        unsigned slot  = OVERFLOW_SLOT;
+        for (int k = 0; k < LEVELS; ++k)
+            if (delta < (uint64_t(1) << (SLOT_BITS * (k + 1)))) {
+                slot = k * SLOTS + ((e >> (SLOT_BITS * k)) & MASK);
+                set_bit(slot);
+                break;
+            }
+        a_timer.m_slot = uint16_t(slot);
+        m_slots[slot].push_back(&a_timer);
+    }
+
+    /// Redistribute the timers of the upper levels' slots that are due in
+    /// the revolution of the lowest level starting at m_tick
+    void cascade() {
+        int h = 1;
+        while (h < LEVELS && ((m_tick >> (SLOT_BITS * h)) & MASK) == 0) ++h;
+        // All levels wrapped around: timers beyond the top level may now fit
+        if (h == LEVELS)
+            redistribute(OVERFLOW_SLOT);
+        for (int k = std::min<int>(h, LEVELS - 1); k > 0; --k)
+            redistribute(k * SLOTS + ((m_tick >> (SLOT_BITS * k)) & MASK));
+    }
+
+    void redistribute(unsigned a_slot) {
+        detail::wheel_link list;
+        m_slots[a_slot].splice_to(list);
+        if (a_slot < OVERFLOW_SLOT)
+            clear_bit(a_slot);
+        while (!list.empty()) {
+            auto t = static_cast<wheel_timer*>(list.m_next);
+            t->unlink();
+            insert(*t);
+        }
+    }
+
+    size_t expire(unsigned a_slot, uint64_t a_target, time_val a_now) {
+        detail::wheel_link pending;
+        m_slots[a_slot].splice_to(pending);
+        clear_bit(a_slot);
+        for (auto p = pending.m_next; p != &pending; p = p->m_next)
+            static_cast<wheel_timer*>(p)->m_slot = wheel_timer::PENDING_SLOT;
+
+        size_t n = 0;
+        while (!pending.empty()) {
+            auto t = static_cast<wheel_timer*>(pending.m_next);
+            t->unlink();
+            if (t->m_interval) {
+                // Skip the periods missed if advance() was called late
+                auto due = t->m_expiry + t->m_interval;
+                if (due <= a_target)
+                    due += ((a_target - due) / t->m_interval + 1) * t->m_interval;
+                t->m_expiry = due;
+                insert(*t);
+            } else {
+                t->m_slot = wheel_timer::NO_SLOT;
+                --m_count;
+            }
+            ++n;
+            if (t->m_handler)
+                t->m_handler(*t, a_now);
+        }
+        return n;
+    }
+};
+
+inline void wheel_timer::cancel() {
+    if (active())
+        m_wheel->cancel(*this);
+}
+
+} // namespace utxx
+
+#endif // _UTXX_TIMER_WHEEL_HPP_
@@ -63,6 +63,8 @@ protected:
     static boost::mutex             s_mutex;
     static thread_local long        s_next_utc_midnight_nseconds;
     static thread_local long        s_next_local_midnight_nseconds;
+    static thread_local long        s_local_midnight_nseconds;
+    static thread_local long        s_next_update_nseconds;
     static thread_local long        s_utc_nsec_offset;
     static thread_local char        s_utc_timestamp[16];
     static thread_local char        s_local_timestamp[16];
@@ -139,13 +141,10 @@ public:
         return now;
     }
 
+    /// Recompute cached dates and the UTC offset when \a a_now crosses the
+    /// UTC or local midnight or a transition of the local time zone.
     static void check_day_change(time_val a_now) {
-        // FIXME: the method below will produce incorrect time stamps during
-        // switch to/from daylight savings time because of the unaccounted
-        // utc_offset change.
-        auto ns = a_now.nanoseconds();
-        if (unlikely((ns >= s_next_utc_midnight_nseconds) ||
-                     (ns + s_utc_nsec_offset >= s_next_local_midnight_nseconds)))
+        if (unlikely(a_now.nanoseconds() >= s_next_update_nseconds))
             update_midnight_nseconds(a_now);
     }
 
@@ -162,8 +161,9 @@ public:
         return nsecs(s_next_utc_midnight_nseconds - DAY_NSEC);
     }
     /// Return the number of nanoseconds from epoch to midnight in local time.
+    /// The local day may be 23 or 25 hours long on a DST transition.
     static time_val local_midnight_time() {
-        return nsecs(s_next_local_midnight_nseconds - DAY_NSEC);
+        return nsecs(s_local_midnight_nseconds);
     }
 
     /// Return the number of seconds from epoch to midnight in UTC.
@@ -293,7 +293,9 @@ struct test_timestamp : public timestamp {
     /// Note: it only resets the midnight seconds in the current thread's TLS
     static void reset() {
         s_next_local_midnight_nseconds = 0;
+        s_local_midnight_nseconds      = 0;
         s_next_utc_midnight_nseconds   = 0;
+        s_next_update_nseconds         = 0;
     }
 
     /// Use for testing only.
@@ -0,0 +1,360 @@
+//----------------------------------------------------------------------------
+/// \file   tsc_clock.hpp
+/// \author Serge Aleynikov
+//----------------------------------------------------------------------------
+/// \brief Wall clock computed from the CPU's time-stamp counter.
+///
+/// time_val::universal_time() makes a clock_gettime(CLOCK_REALTIME) call
+/// on every invocation.  tsc_clock instead reads the invariant TSC with
+/// rdtscp and converts it to wall time using a linear function
+///     ns = base_ns + ((tsc - base_tsc) * mult) >> shift
+/// calibrated against CLOCK_REALTIME.  The parameters of the function are
+/// kept in a seqlock, so that readers never block.
+///
+/// The clock is re-synchronized with CLOCK_REALTIME by calling sync(),
+/// usually from a background thread started with start_sync().  Each sync
+/// refines the TSC frequency measured since the first sample and slews out
+/// the accumulated error over the next sync period, so the clock remains
+/// continuous and its deviation from CLOCK_REALTIME stays within the error
+/// of a single sample (well under a microsecond).  A step of the system
+/// clock (e.g. by settimeofday) larger than max_slew_ns is followed with a
+/// step of the TSC clock.
+///
+/// On CPUs without an invariant TSC the clock falls back to CLOCK_REALTIME.
+//----------------------------------------------------------------------------
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#ifndef _UTXX_TSC_CLOCK_HPP_
+#define _UTXX_TSC_CLOCK_HPP_
+
+#include <utxx/time_val.hpp>
+#include <utxx/seqlock.hpp>
+#include <utxx/error.hpp>
+#include <utxx/compiler_hints.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <strings.h>
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace utxx {
+
+/// Source of wall-clock time used for timestamping
+enum class clock_source {
+      REALTIME  ///< clock_gettime(CLOCK_REALTIME)
+    , TSC       ///< tsc_clock
+};
+
+/// Wall clock computed from the CPU's time-stamp counter.
+/// Use the process-wide instance() unless a separately calibrated clock is
+/// needed.  The static now() makes tsc_clock usable as a clock policy in
+/// place of realtime_clock.
+class tsc_clock {
+public:
+    /// Parameters of conversion of TSC ticks to nanoseconds since epoch
+    struct params {
+        uint64_t base_tsc;  ///< TSC value at the last synchronization
+        int64_t  base_ns;   ///< Clock reading at base_tsc
+        uint64_t mult;      ///< Nanoseconds per tick scaled by 2^shift
+        uint32_t shift;
+    };
+
+    enum {
+          s_shift           = 32
+        , s_max_slew_ppm    = 1000      ///< Max rate of error correction
+    };
+
+    /// @param a_calibrate_ms  duration of initial calibration
+    /// @param a_force         use the TSC even if it's not reported invariant
+    explicit tsc_clock(int a_calibrate_ms = 10, bool a_force = false)
+        : m_tsc(a_force || invariant_tsc())
+        , m_ref_tsc(0)
+        , m_ref_ns(0)
+        , m_max_slew_ns(1000000)
+        , m_last_error(0)
+        , m_syncs(0)
+        , m_stop(false)
+    {
+        calibrate(a_calibrate_ms);
+    }
+
+    ~tsc_clock() { stop_sync(); }
+
+    tsc_clock(const tsc_clock&) = delete;
+    tsc_clock& operator=(const tsc_clock&) = delete;
+
+    /// Process-wide clock instance
+    static tsc_clock& instance() {
+        static tsc_clock s_clock;
+        return s_clock;
+    }
+
+    /// Current time of the process-wide clock
+    static time_val now() { return time_val(nsecs(instance().now_ns())); }
+
+    /// True if the CPU has an invariant TSC
+    static bool invariant_tsc() {
+        #if defined(__i386__) || defined(__x86_64__)
+        unsigned a, b, c, d;
+        return __get_cpuid(0x80000007, &a, &b, &c, &d) && (d & (1u << 8));
+        #else
+        return false;
+        #endif
+    }
+
+    /// Current TSC value
+    static uint64_t ticks() {
+        #if defined(__i386__) || defined(__x86_64__)
+        unsigned aux;
+        return __rdtscp(&aux);
+        #else
+        return 0;
+        #endif
+    }
+
+    /// Current CLOCK_REALTIME time in nanoseconds
+    static int64_t realtime_ns() {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_REALTIME, &ts);
+        return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    /// True if the clock is driven by the TSC (otherwise by CLOCK_REALTIME)
+    bool    tsc()           const { return m_tsc; }
+
+    /// Current time in nanoseconds since epoch
+    int64_t now_ns() const {
+        if (UNLIKELY(!m_tsc))
+            return realtime_ns();
+        params p;
+        m_params.load(p);
+        return to_ns(p, ticks());
+    }
+
+    /// Current time
+    time_val now_tv() const { return time_val(nsecs(now_ns())); }
+
+    /// Convert a TSC value to nanoseconds since epoch
+    int64_t tsc_to_ns(uint64_t a_tsc) const {
+        params p;
+        m_params.load(p);
+        return to_ns(p, a_tsc);
+    }
+
+    /// Convert a number of TSC ticks to nanoseconds
+    int64_t ticks_to_ns(int64_t a_ticks) const {
+        params p;
+        m_params.load(p);
+        return int64_t(((__int128)a_ticks * p.mult) >> p.shift);
+    }
+
+    /// Current conversion parameters
+    params  parameters()    const { return m_params.load(); }
+
+    /// TSC frequency in ticks per second
+    double  frequency()     const { return double(1ull << s_shift) * 1e9 / parameters().mult; }
+
+    /// Difference between CLOCK_REALTIME and this clock measured by the
+    /// last sync() (in nanoseconds)
+    int64_t last_error()    const { return m_last_error.load(std::memory_order_relaxed); }
+
+    /// Number of sync() calls so far
+    long    syncs()         const { return m_syncs.load(std::memory_order_relaxed); }
+
+    /// Errors larger than this are corrected by a step of the clock
+    int64_t max_slew_ns()   const { return m_max_slew_ns; }
+    void    max_slew_ns(int64_t a_ns) { m_max_slew_ns = a_ns; }
+
+    /// Re-synchronize the clock with CLOCK_REALTIME
+    void sync() {
+        if (!m_tsc)
+            return;
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        uint64_t tsc = 0;
+        int64_t  ns  = 0;
+        sample(tsc, ns);
+
+        params  p   = m_params.load();
+        int64_t est = to_ns(p, tsc);
+        int64_t err = ns - est;
+        m_last_error.store(err, std::memory_order_relaxed);
+        m_syncs.fetch_add(1, std::memory_order_relaxed);
+
+        int64_t period = int64_t(tsc - p.base_tsc);
+        if (UNLIKELY(period <= 0))
+            return;
+
+        if (err > m_max_slew_ns || err < -m_max_slew_ns) {
+            // CLOCK_REALTIME was stepped: step this clock too, and start
+            // measuring the frequency anew
+            m_ref_tsc  = tsc;
+            m_ref_ns   = ns;
+            p.base_tsc = tsc;
+            p.base_ns  = ns;
+            m_params.store(p);
+            return;
+        }
+
+        // Frequency measured over the whole interval since the reference
+        // sample, so that the sampling error becomes negligible over time
+        uint64_t dt   = tsc - m_ref_tsc;
+        __int128 freq = dt ? ((__int128)(ns - m_ref_ns) << s_shift) / dt
+                           : (__int128)p.mult;
+
+        // Slew the error out over the next period of the same length
+        __int128 corr = ((__int128)err << s_shift) / period;
+        __int128 lim  = freq * s_max_slew_ppm / 1000000;
+        if      (corr >  lim) corr =  lim;
+        else if (corr < -lim) corr = -lim;
+
+        p.base_tsc = tsc;
+        p.base_ns  = est;
+        p.mult     = uint64_t(freq + corr);
+        m_params.store(p);
+    }
+
+    /// Start a background thread calling sync() every \a a_interval.
+    /// Does nothing if the thread is already running.
+    void start_sync(std::chrono::milliseconds a_interval = std::chrono::milliseconds(1000)) {
+        std::lock_guard<std::mutex> guard(m_thread_mutex);
+        if (!m_tsc || m_thread.joinable())
+            return;
+        m_stop   = false;
+        m_thread = std::thread([this, a_interval] {
+            std::unique_lock<std::mutex> lock(m_thread_mutex);
+            while (!m_cond.wait_for(lock, a_interval, [this] { return m_stop; })) {
+                lock.unlock();
+                sync();
+                lock.lock();
+            }
+        });
+    }
+
+    /// Stop the background thread started by start_sync()
+    void stop_sync() {
+        {
+            std::lock_guard<std::mutex> guard(m_thread_mutex);
+            if (!m_thread.joinable())
+                return;
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+
+    /// True if the background sync thread is running
+    bool syncing() const {
+        std::lock_guard<std::mutex> guard(m_thread_mutex);
+        return m_thread.joinable();
+    }
+
+private:
+    bool                    m_tsc;
+    seqlock<params>         m_params;       // Written under m_mutex
+    uint64_t                m_ref_tsc;      // Sample the frequency is measured from
+    int64_t                 m_ref_ns;
+    int64_t                 m_max_slew_ns;
+    std::atomic<int64_t>    m_last_error;
+    std::atomic<long>       m_syncs;
+    std::mutex              m_mutex;        // Serializes sync() calls
+
+    mutable std::mutex      m_thread_mutex;
+    std::condition_variable m_cond;
+    std::thread             m_thread;
+    bool                    m_stop;
+
+    static int64_t to_ns(const params& a_p, uint64_t a_tsc) {
+        // The difference is signed since the TSC may have been read before
+        // a concurrent sync() advanced base_tsc
+        int64_t d = int64_t(a_tsc - a_p.base_tsc);
+        return a_p.base_ns + int64_t(((__int128)d * a_p.mult) >> a_p.shift);
+    }
+
+    /// Read the TSC and CLOCK_REALTIME close together, picking the tightest
+    /// out of several attempts
+    static void sample(uint64_t& a_tsc, int64_t& a_ns) {
+        uint64_t best = ~0ull;
+        for (int i = 0; i < 8; ++i) {
+            uint64_t t0 = ticks();
+            int64_t  ns = realtime_ns();
+            uint64_t t1 = ticks();
+            if (t1 - t0 < best) {
+                best  = t1 - t0;
+                a_tsc = t0 + (t1 - t0) / 2;
+                a_ns  = ns;
+            }
+        }
+    }
+
+    void calibrate(int a_calibrate_ms) {
+        params p{0, 0, 1ull << s_shift, s_shift};
+        if (m_tsc) {
+            uint64_t t0 = 0, t1 = 0;
+            int64_t  n0 = 0, n1 = 0;
+            sample(t0, n0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(a_calibrate_ms));
+            sample(t1, n1);
+            if (t1 > t0 && n1 > n0) {
+                p.mult     = uint64_t(((__int128)(n1 - n0) << s_shift) / (t1 - t0));
+                p.base_tsc = t1;
+                p.base_ns  = n1;
+            } else
+                m_tsc = false;
+            m_ref_tsc = t0;
+            m_ref_ns  = n0;
+        }
+        m_params.store(p);
+    }
+};
+
+/// Current time according to the given clock source
+inline time_val now_utc(clock_source a_src) {
+    return a_src == clock_source::TSC ? tsc_clock::now() : now_utc();
+}
+
+/// Convert clock source to string
+inline const char* to_string(clock_source a_src) {
+    return a_src == clock_source::TSC ? "tsc" : "realtime";
+}
+
+/// Parse clock source ("realtime" or "tsc", case-insensitive)
+inline clock_source parse_clock_source(const std::string& a_src) {
+    if (strcasecmp(a_src.c_str(), "tsc")      == 0) return clock_source::TSC;
+    if (strcasecmp(a_src.c_str(), "realtime") == 0) return clock_source::REALTIME;
+    UTXX_THROW_BADARG_ERROR("Invalid clock source: ", a_src);
+}
+
+} // namespace utxx
+
+#endif // _UTXX_TSC_CLOCK_HPP_
@@ -45,6 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/static_assert.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/property_tree/detail/info_parser_utils.hpp>
+#include <utxx/convert.hpp>
 #include <stdexcept>
 #include <string.h>
 #include <stdio.h>
@@ -62,15 +63,7 @@ class variant: public boost::variant<null, bool, long, double, std::string>
         std::string operator () (null v) const { return "<NULL>";             }
         std::string operator () (bool v) const { return v ? "true" : "false"; }
         std::string operator () (long v) const { return std::to_string(v);    }
-        std::string operator () (double v) const {
-            char buf[128];
-            snprintf(buf, sizeof(buf)-1, "%f", v);
-            // Remove trailing zeros.
-            for (char* p = buf+strlen(buf); p > buf && *(p-1) != '.'; p--)
-                if (*p == '0')
-                    *p = '\0';
-            return buf;
-        }
+        std::string operator () (double v) const { return ftoa_shortest(v);  }
         std::string operator () (const std::string& v) const { return v; }
     };
 
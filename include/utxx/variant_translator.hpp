@@ -83,8 +83,11 @@ namespace property_tree {
                     return boost::optional<internal_type>(n);
                 }
             }
-            double d = strtod(value.c_str(), &e);
-            if (!*e && e == end) // is a double and has been decoded fully
+            double d;
+            if (utxx::atof_exp(value.c_str(), end, d) == end) // is a double decoded fully
+                return boost::optional<internal_type>(d);
+            d = strtod(value.c_str(), &e);  // e.g. "nan", "inf", hex floats
+            if (!*e && e == end)
                 return boost::optional<internal_type>(d);
 
             if (value == "true" || value == "false")
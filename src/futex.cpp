@@ -34,6 +34,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 #include <utxx/futex.hpp>
 #include <utxx/meta.hpp>
+#include <cassert>
+#include <time.h>
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/mman.h>
@@ -56,6 +58,16 @@ inline int futex_wake(volatile void* futex, int cnt_to_wake,
                         const struct timespec* timeout = NULL) {
     return ::syscall(SYS_futex,(futex),FUTEX_WAKE,(cnt_to_wake),(timeout));
 }
+inline int futex_wait_bitset(volatile void* futex, int val, uint32_t bitset,
+                        const struct timespec* abs_timeout = NULL) {
+    return ::syscall(SYS_futex,(futex),FUTEX_WAIT_BITSET,(val),(abs_timeout),
+                     NULL,(bitset));
+}
+inline int futex_wake_bitset(volatile void* futex, int cnt_to_wake,
+                        uint32_t bitset) {
+    return ::syscall(SYS_futex,(futex),FUTEX_WAKE_BITSET,(cnt_to_wake),NULL,
+                     NULL,(bitset));
+}
 #else
 #  error "Missing SYS_futex definition!"
 #endif
@@ -98,6 +110,28 @@ int futex_wake_slow(int* value, int count) {
     return res;
 }
 
+wakeup_result futex_wait_bitset_slow(int* old, int val, uint32_t bitset,
+                                     const struct timespec *abs) {
+    int res;
+    // The timeout is absolute, so it's safe to restart the call
+    while ((res = futex_wait_bitset(old, val, bitset, abs)) < 0
+           && errno == EINTR);
+    if (res == 0)
+        return wakeup_result::SIGNALED;
+    else if (errno == EWOULDBLOCK)
+        return wakeup_result::CHANGED;
+    else if (errno == ETIMEDOUT)
+        return wakeup_result::TIMEDOUT;
+    else
+        return wakeup_result::ERROR;
+}
+
+int futex_wake_bitset_slow(int* value, uint32_t bitset, int count) {
+    int res;
+    while ((res = futex_wake_bitset(value, count, bitset)) < 0 && errno == EINTR);
+    return res;
+}
+
 futex::futex(int initialize) {
     int pagesize = sysconf(_SC_PAGESIZE);
 
@@ -164,5 +198,46 @@ wait_done:
     return res;
 }
 
+uint32_t futex_event_group::wait(uint32_t a_mask, const struct timespec* a_timeout)
+{
+    assert(a_mask);
+
+    if (uint32_t ev = try_wait(a_mask))
+        return ev;
+
+    // FUTEX_WAIT_BITSET takes an absolute timeout
+    struct timespec deadline, *abs = NULL;
+    if (a_timeout) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec  += a_timeout->tv_sec;
+        deadline.tv_nsec += a_timeout->tv_nsec;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        abs = &deadline;
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    uint32_t ev;
+    while (!(ev = try_wait(a_mask))) {
+        uint32_t val = m_pending.load(std::memory_order_seq_cst);
+        if (val & a_mask)
+            continue;
+        // Sleep unless the futex word changed since we've looked at it.
+        // Signals of other events change the word too, in which case we
+        // just go back to sleep.
+        auto res = futex_wait_bitset_slow(word(), int(val), a_mask, abs);
+        if (res == wakeup_result::TIMEDOUT || res == wakeup_result::ERROR) {
+            ev = try_wait(a_mask);
+            break;
+        }
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return ev;
+}
+
 }   // namespace utxx
 
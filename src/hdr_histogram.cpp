@@ -0,0 +1,382 @@
+//----------------------------------------------------------------------------
+/// \file  hdr_histogram.cpp
+//----------------------------------------------------------------------------
+/// \brief Percentile reports and serialization of hdr_histogram.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <utxx/config.h>
+#include <utxx/hdr_histogram.hpp>
+#include <utxx/error.hpp>
+#include <limits>
+#include <sstream>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef UTXX_HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+namespace utxx {
+
+namespace {
+    // Cookies of HdrHistogram's V2 encoding (with the TLZE flag 0x10)
+    const uint32_t s_encoding_cookie   = 0x1c849313;
+    const uint32_t s_compressed_cookie = 0x1c849314;
+    const size_t   s_header_size       = 40;
+
+    void put_be(std::string& a_out, uint64_t a_val, int a_bytes) {
+        for (int i = a_bytes - 1; i >= 0; --i)
+            a_out.push_back(char(a_val >> (8 * i)));
+    }
+
+    uint64_t get_be(const char* a_p, int a_bytes) {
+        uint64_t v = 0;
+        for (int i = 0; i < a_bytes; ++i)
+            v = (v << 8) | uint8_t(a_p[i]);
+        return v;
+    }
+
+    // LEB128 of a ZigZag-encoded value, where the 9th byte holds 8 bits
+    void put_zigzag(std::string& a_out, int64_t a_val) {
+        uint64_t v = (uint64_t(a_val) << 1) ^ uint64_t(a_val >> 63);
+        for (int i = 0; i < 8 && v >= 0x80; ++i, v >>= 7)
+            a_out.push_back(char(v | 0x80));
+        a_out.push_back(char(v));
+    }
+
+    bool get_zigzag(const char*& a_p, const char* a_end, int64_t& a_val) {
+        uint64_t v = 0;
+        for (int i = 0; i < 9; ++i) {
+            if (a_p == a_end)
+                return false;
+            uint8_t c = uint8_t(*a_p++);
+            if (i == 8) {
+                v |= uint64_t(c) << 56;
+                break;
+            }
+            v |= uint64_t(c & 0x7F) << (7 * i);
+            if (!(c & 0x80))
+                break;
+        }
+        a_val = int64_t(v >> 1) ^ -int64_t(v & 1);
+        return true;
+    }
+
+    const char s_base64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string base64_encode(const std::string& a_in) {
+        std::string out;
+        out.reserve((a_in.size() + 2) / 3 * 4);
+        auto p = reinterpret_cast<const uint8_t*>(a_in.data());
+        for (size_t i = 0, n = a_in.size(); i < n; i += 3) {
+            uint32_t v = uint32_t(p[i]) << 16;
+            if (i + 1 < n) v |= uint32_t(p[i+1]) << 8;
+            if (i + 2 < n) v |= p[i+2];
+            out.push_back(s_base64[v >> 18]);
+            out.push_back(s_base64[(v >> 12) & 63]);
+            out.push_back(i + 1 < n ? s_base64[(v >> 6) & 63] : '=');
+            out.push_back(i + 2 < n ? s_base64[v & 63]        : '=');
+        }
+        return out;
+    }
+
+    bool base64_decode(const std::string& a_in, std::string& a_out) {
+        uint32_t v    = 0;
+        int      bits = 0;
+        for (auto c : a_in) {
+            if (c == '=')
+                break;
+            auto p = strchr(s_base64, c);
+            if (!p || !c)
+                return false;
+            v     = (v << 6) | uint32_t(p - s_base64);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                a_out.push_back(char(v >> bits));
+            }
+        }
+        return true;
+    }
+}
+
+hdr_histogram::hdr_histogram(int64_t a_lowest, int64_t a_highest, int a_digits)
+    : m_lowest(a_lowest), m_highest(a_highest), m_digits(a_digits)
+{
+    if (a_lowest < 1 || a_highest / 2 < a_lowest || a_digits < 1 || a_digits > 5)
+        UTXX_THROW_BADARG_ERROR("Invalid hdr_histogram range [", a_lowest, ", ",
+                                a_highest, "] or digits ", a_digits);
+
+    // Sub-buckets needed to tell apart values differing in the last digit
+    int64_t single_unit = 2;
+    for (int i = 0; i < a_digits; ++i) single_unit *= 10;
+    m_sub_half_mag = 64 - __builtin_clzll(uint64_t(single_unit - 1)) - 1;
+    m_unit_mag     = 63 - __builtin_clzll(uint64_t(a_lowest));
+    if (m_unit_mag + m_sub_half_mag + 1 > 61)
+        UTXX_THROW_BADARG_ERROR("Too large hdr_histogram lowest value ", a_lowest);
+
+    m_sub_count    = int64_t(1) << (m_sub_half_mag + 1);
+    m_sub_mask     = (m_sub_count - 1) << m_unit_mag;
+
+    // Buckets needed to cover a_highest
+    int64_t untrackable = m_sub_count << m_unit_mag;
+    m_bucket_count      = 1;
+    while (untrackable <= a_highest) {
+        ++m_bucket_count;
+        if (untrackable > std::numeric_limits<int64_t>::max() / 2)
+            break;
+        untrackable <<= 1;
+    }
+    m_counts.resize(size_t(m_bucket_count + 1) * size_t(m_sub_count / 2));
+}
+
+hdr_histogram& hdr_histogram::operator+=(const hdr_histogram& a_rhs)
+{
+    size_t i = 0;
+    // Counters of histograms with the same lowest value and precision map
+    // to the same values (up to the highest trackable value)
+    if (m_lowest == a_rhs.m_lowest && m_digits == a_rhs.m_digits)
+        for (size_t n = std::min(index(m_highest) + 1, a_rhs.m_counts.size()); i < n; ++i)
+            m_counts[i] += a_rhs.count_at_index(i);
+
+    for (size_t n = a_rhs.m_counts.size(); i < n; ++i)
+        if (auto c = a_rhs.count_at_index(i))
+            add(a_rhs.value_at_index(i), c);
+    return *this;
+}
+
+double hdr_histogram::mean() const
+{
+    double  sum = 0;
+    int64_t n   = 0;
+    for (size_t i = 0, e = used_size(); i < e; ++i)
+        if (auto c = count_at_index(i)) {
+            sum += double(median_equivalent(value_at_index(i))) * c;
+            n   += c;
+        }
+    return n ? sum / n : 0.0;
+}
+
+double hdr_histogram::stddev() const
+{
+    double  avg = mean(), sum = 0;
+    int64_t n   = 0;
+    for (size_t i = 0, e = used_size(); i < e; ++i)
+        if (auto c = count_at_index(i)) {
+            double d = double(median_equivalent(value_at_index(i))) - avg;
+            sum += d * d * c;
+            n   += c;
+        }
+    return n ? sqrt(sum / n) : 0.0;
+}
+
+int64_t hdr_histogram::value_at_percentile(double a_percentile) const
+{
+    auto    pct   = std::min(std::max(a_percentile, 0.0), 100.0);
+    auto    total = total_count();
+    int64_t rank  = std::max<int64_t>(1, int64_t(pct / 100 * double(total) + 0.5));
+    int64_t n     = 0;
+    for (size_t i = 0, e = m_counts.size(); i < e; ++i) {
+        n += count_at_index(i);
+        if (n >= rank)
+            return highest_equivalent(value_at_index(i));
+    }
+    return 0;
+}
+
+void hdr_histogram::dump(std::ostream& out, int a_ticks, double a_scale) const
+{
+    auto total = total_count();
+    if (!total) {
+        out << "  No data samples" << std::endl;
+        return;
+    }
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%12s %14s %10s %14s\n\n",
+             "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+    out << buf;
+
+    // Report points get denser as the percentile approaches 100%: a_ticks
+    // points per halving of the distance to 100%
+    double  pct = 0;
+    int64_t n   = 0;
+    for (size_t i = 0, e = used_size(); i < e; ++i) {
+        auto c = count_at_index(i);
+        if (!c)
+            continue;
+        n += c;
+        double value = double(highest_equivalent(value_at_index(i))) / a_scale;
+        double cur   = 100.0 * double(n) / double(total);
+        while (pct <= cur) {
+            snprintf(buf, sizeof(buf), "%12.*f %2.12f %10ld %14.2f\n",
+                     m_digits, value, pct / 100, long(n), 1 / (1 - pct / 100));
+            out << buf;
+            if (n == total)
+                break;
+            double half = pow(2, floor(log2(100 / (100 - pct))) + 1);
+            pct += 100 / (a_ticks * half);
+        }
+    }
+    snprintf(buf, sizeof(buf), "%12.*f %2.12f %10ld\n",
+             m_digits, double(max()) / a_scale, 1.0, long(total));
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n",
+             mean() / a_scale, stddev() / a_scale);
+    out << buf;
+    snprintf(buf, sizeof(buf), "#[Max     = %12.3f, Total count    = %12ld]\n",
+             double(max()) / a_scale, long(total));
+    out << buf;
+    snprintf(buf, sizeof(buf), "#[Buckets = %12d, SubBuckets     = %12d]\n",
+             m_bucket_count, int(m_sub_count));
+    out << buf;
+}
+
+std::string hdr_histogram::to_string(int a_ticks, double a_scale) const
+{
+    std::stringstream s;
+    dump(s, a_ticks, a_scale);
+    return s.str();
+}
+
+std::string hdr_histogram::encode() const
+{
+    // Counters are encoded as ZigZag LEB128 numbers, a run of N empty
+    // counters being encoded as -N
+    std::string payload;
+    for (size_t i = 0, n = used_size(); i < n; ) {
+        auto c = count_at_index(i++);
+        if (c) {
+            put_zigzag(payload, c);
+            continue;
+        }
+        int64_t zeros = 1;
+        for (; i < n && !count_at_index(i); ++i) ++zeros;
+        put_zigzag(payload, zeros > 1 ? -zeros : 0);
+    }
+
+    double ratio = 1.0;
+    uint64_t bits;
+    memcpy(&bits, &ratio, sizeof(bits));
+
+    std::string s;
+    s.reserve(s_header_size + payload.size());
+    put_be(s, s_encoding_cookie, 4);
+    put_be(s, payload.size(), 4);
+    put_be(s, 0, 4);            // Normalizing index offset
+    put_be(s, uint32_t(m_digits), 4);
+    put_be(s, uint64_t(m_lowest), 8);
+    put_be(s, uint64_t(m_highest), 8);
+    put_be(s, bits, 8);         // Integer to double conversion ratio
+    s += payload;
+
+#ifdef UTXX_HAVE_LIBZ
+    auto len = compressBound(s.size());
+    std::string z(8 + len, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(&z[8]), &len,
+                  reinterpret_cast<const Bytef*>(s.data()), s.size(),
+                  Z_DEFAULT_COMPRESSION) == Z_OK) {
+        z.resize(8 + len);
+        std::string hdr;
+        put_be(hdr, s_compressed_cookie, 4);
+        put_be(hdr, len, 4);
+        z.replace(0, 8, hdr);
+        return base64_encode(z);
+    }
+#endif
+    return base64_encode(s);
+}
+
+hdr_histogram hdr_histogram::decode(const std::string& a_base64)
+{
+    std::string s;
+    if (!base64_decode(a_base64, s) || s.size() < 8)
+        UTXX_THROW_RUNTIME_ERROR("Invalid base64 encoding of hdr_histogram");
+
+    if (get_be(s.data(), 4) == s_compressed_cookie) {
+#ifdef UTXX_HAVE_LIBZ
+        auto len = get_be(s.data() + 4, 4);
+        if (len > s.size() - 8)
+            UTXX_THROW_RUNTIME_ERROR("Truncated compressed hdr_histogram");
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        if (inflateInit(&zs) != Z_OK)
+            UTXX_THROW_RUNTIME_ERROR("Cannot initialize zlib");
+        zs.next_in  = reinterpret_cast<Bytef*>(&s[8]);
+        zs.avail_in = uInt(len);
+        std::string out;
+        int rc;
+        do {
+            char buf[16384];
+            zs.next_out  = reinterpret_cast<Bytef*>(buf);
+            zs.avail_out = sizeof(buf);
+            rc = inflate(&zs, Z_NO_FLUSH);
+            out.append(buf, sizeof(buf) - zs.avail_out);
+        } while (rc == Z_OK);
+        inflateEnd(&zs);
+        if (rc != Z_STREAM_END)
+            UTXX_THROW_RUNTIME_ERROR("Invalid compressed hdr_histogram");
+        s.swap(out);
+#else
+        UTXX_THROW_RUNTIME_ERROR("Compressed hdr_histogram requires zlib");
+#endif
+    }
+
+    if (s.size() < s_header_size || get_be(s.data(), 4) != s_encoding_cookie)
+        UTXX_THROW_RUNTIME_ERROR("Invalid hdr_histogram encoding");
+
+    auto len    = get_be(s.data() + 4,  4);
+    auto offset = get_be(s.data() + 8,  4);
+    auto digits = int(get_be(s.data() + 12, 4));
+    auto lowest = int64_t(get_be(s.data() + 16, 8));
+    auto high   = int64_t(get_be(s.data() + 24, 8));
+    if (len > s.size() - s_header_size || offset != 0)
+        UTXX_THROW_RUNTIME_ERROR("Unsupported hdr_histogram encoding");
+
+    hdr_histogram h(lowest, high, digits);
+    const char* p   = s.data() + s_header_size;
+    const char* end = p + len;
+    size_t      i   = 0;
+    while (p < end) {
+        int64_t v;
+        if (!get_zigzag(p, end, v))
+            UTXX_THROW_RUNTIME_ERROR("Truncated hdr_histogram counts");
+        if (v < 0)
+            i += size_t(-v);
+        else if (i < h.m_counts.size())
+            h.m_counts[i++] = v;
+        else
+            UTXX_THROW_RUNTIME_ERROR("Too many hdr_histogram counts");
+    }
+    return h;
+}
+
+} // namespace utxx
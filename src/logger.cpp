@@ -251,6 +251,10 @@ void logger::init(const config_tree& a_cfg, const sigset_t* a_ignore_signals)
         m_ident          = replace_macros(m_ident);
         std::string ts   = a_cfg.get<std::string>("logger.timestamp",     "time-usec");
         m_timestamp_type = parse_stamp_type(ts);
+        std::string tz   = a_cfg.get<std::string>("logger.timezone",      "");
+        timestamp_zone(tz.empty() ? nullptr : time_zone::get(tz));
+        time_source(parse_clock_source
+                   (a_cfg.get<std::string>("logger.clock", to_string(m_clock))));
         std::string levs = a_cfg.get<std::string>("logger.levels", "");
         if (!levs.empty())
             set_level_filter(static_cast<log_level>(parse_log_levels(levs)));
@@ -264,6 +268,16 @@ void logger::init(const config_tree& a_cfg, const sigset_t* a_ignore_signals)
         m_sched_yield_us = a_cfg.get<long>       ("logger.sched-yield-us", -1);
         m_silent_finish  = a_cfg.get<bool>       ("logger.silent-finish",  false);
 
+        auto& tp         = m_thread_placement;
+        tp.name          = a_cfg.get<std::string>("logger.thread.name",   tp.name);
+        auto cpus        = a_cfg.get<std::string>("logger.thread.cpus",   "");
+        if (!cpus.empty())
+            tp.cpus      = os::parse_cpu_list(cpus);
+        auto policy      = a_cfg.get<std::string>("logger.thread.sched-policy", "");
+        if (!policy.empty())
+            tp.policy    = os::parse_sched_policy(policy);
+        tp.priority      = a_cfg.get<int>        ("logger.thread.priority", tp.priority);
+
         if ((int)m_timestamp_type < 0)
             throw std::runtime_error("Invalid timestamp type: " + ts);
 
@@ -345,8 +359,19 @@ void logger::run()
     if (m_on_before_run)
         m_on_before_run();
 
-    if (!m_ident.empty())
-        pthread_setname_np(pthread_self(), m_ident.c_str());
+    try {
+        auto tp = m_thread_placement;
+        if (tp.name.empty())
+            tp.name = m_ident;
+        tp.apply();
+    } catch (std::exception& e) {
+        // Failure to place the thread (e.g. lack of CAP_SYS_NICE for
+        // real-time scheduling) is not fatal for logging
+        if (m_error)
+            m_error(e.what());
+        else
+            fprintf(stderr, "Logger thread placement error: %s\n", e.what());
+    }
 
     int event_val = 1;
     while (!m_abort)
@@ -472,7 +497,11 @@ format_header(const logger::msg& a_msg, char* a_buf, const char* a_end)
 
     // Write Timestamp
     if (timestamp_type() != stamp_type::NO_TIMESTAMP) {
-        p   += timestamp::format(timestamp_type(), a_msg.m_timestamp, p, a_end - p);
+        p   += m_timestamp_zone
+             ? timestamp::format(timestamp_type(),
+                                 m_timestamp_zone->to_local(a_msg.m_timestamp),
+                                 p, a_end - p, true, false, false)
+             : timestamp::format(timestamp_type(), a_msg.m_timestamp, p, a_end - p);
         *p++ = '|';
     }
     // Write Level
@@ -710,7 +739,11 @@ std::ostream& logger::dump(std::ostream& out) const
         << "    show-ident          = " << val(m_show_ident)            << '\n'
         << "    show-thread         = " << val(m_show_thread)           << '\n'
         << "    ident               = " << m_ident                      << '\n'
-        << "    timestamp-type      = " << to_string(m_timestamp_type)  << '\n';
+        << "    thread              = " << m_thread_placement.to_string() << '\n'
+        << "    timestamp-type      = " << to_string(m_timestamp_type)  << '\n'
+        << "    timezone            = " << (m_timestamp_zone
+                                       ? m_timestamp_zone->name() : "local") << '\n'
+        << "    clock               = " << to_string(m_clock)           << '\n';
 
     // Check the list of registered implementations. If corresponding
     // configuration section is found, initialize the implementation.
@@ -163,10 +163,10 @@ bool logger_impl_file::init(const variant_tree& a_config)
 }
 
 class guard {
-    boost::mutex& m;
+    adaptive_mutex& m;
     bool use_mutex;
 public:
-    guard(boost::mutex& a_m, bool a_use_mutex) : m(a_m), use_mutex(a_use_mutex) {
+    guard(adaptive_mutex& a_m, bool a_use_mutex) : m(a_m), use_mutex(a_use_mutex) {
         if (use_mutex) m.lock();
     }
     ~guard() { 
@@ -179,7 +179,7 @@ void logger_impl_file::log_msg(const logger::msg& a_msg, const char* a_buf, size
 {
     // See begining-of-file comment on thread-safety of the concurrent write(2) call.
     // Note that since the use of mutex is conditional, we can't use the
-    // boost::lock_guard<boost::mutex> guard and roll out our own.
+    // std::lock_guard<adaptive_mutex> guard and roll out our own.
     guard g(m_mutex, m_use_mutex);
 
     if (write(m_fd, a_buf, a_size) < 0)
@@ -38,6 +38,7 @@
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <utxx/os.hpp>
 
 #define unlikely(expr) __builtin_expect(!!(expr), 0)
 #define likely(expr)   __builtin_expect(!!(expr), 1)
@@ -123,6 +124,8 @@ int         display_packets           = 0;
 int         display_packets_hex       = 0;
 const char* output_file               = NULL;
 const char* write_file                = NULL;
+const char* cpu_list                  = NULL;
+int         rt_priority               = 0;
 
 void usage(const char* program) {
   printf("Listen to multicast traffic from a given (source addr) address:port\n\n"
@@ -130,7 +133,8 @@ void usage(const char* program) {
          "          [-a Addr] [-n Mcastaddr -p Port [-s SourceAddr]] [-v] [-q] [-e false]\n"
          "          [-i ReportingIntervalSec] [-I SockReportInterval]\n"
          "          [-d DurationSec] [-b RecvBufSize] [-L MaxChannelReportLines]\n"
-         "          [-l ReportingLabel] [-r PrintPacketSize] [-o OutputFile]\n\n"
+         "          [-l ReportingLabel] [-r PrintPacketSize] [-o OutputFile]\n"
+         "          [-A CpuList] [-R Priority]\n\n"
          "      -c CfgAddrs - Filename containing list of addresses to process\n"
          "                    (use \"-\" for stdin)\n"
          "      -a Addr     - Optional interface address or multicast address\n"
@@ -155,7 +159,9 @@ void usage(const char* program) {
          "      -X [Size]   - Print packet up to Size bytes in HEX format\n"
          "      -q          - Quiet (no output)\n"
          "      -o Filename - Output log file\n"
-         "      -w Filename - Write packets to file\n\n"
+         "      -w Filename - Write packets to file\n"
+         "      -A CpuList  - Bind the process to CPUs (e.g. \"2,4-5\")\n"
+         "      -R Priority - Run with SCHED_FIFO real-time priority (1..49)\n\n"
          "If there is no incoming data, press several Ctrl-C to break\n\n"
          "Return code: = 0  - if the process received at least one packet\n"
          "             > 0  - if no packets were received or there was an error\n\n"
@@ -465,10 +471,25 @@ int main(int argc, char *argv[])
       quiet = 1;
     else if (!strcmp(argv[i], "-l") && i < argc-1)
       label = argv[++i];
+    else if (!strcmp(argv[i], "-A") && i < argc-1)
+      cpu_list = argv[++i];
+    else if (!strcmp(argv[i], "-R") && i < argc-1)
+      rt_priority = atoi(argv[++i]);
     else
       usage(argv[0]);
   }
 
+  /* Thread placement */
+  try {
+    utxx::os::thread_placement tp("mreceive", cpu_list ? cpu_list : "",
+      rt_priority ? utxx::os::sched_policy::FIFO : utxx::os::sched_policy::OTHER,
+      rt_priority);
+    tp.apply();
+  } catch (std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    exit(1);
+  }
+
   /* No "-c" and "-a" options given: obtain address from other parameters */
   if (!addrs_count) {
     if (!imcast_addr || !iport)
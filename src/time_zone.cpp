@@ -0,0 +1,427 @@
+//----------------------------------------------------------------------------
+/// \file  time_zone.cpp
+//----------------------------------------------------------------------------
+/// \brief Loading of tzdata transition tables and POSIX TZ rules.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <utxx/time_zone.hpp>
+#include <utxx/time.hpp>
+#include <utxx/path.hpp>
+#include <utxx/error.hpp>
+#include <map>
+#include <mutex>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace utxx {
+
+constexpr time_t time_zone::NO_TRANSITION;
+
+namespace {
+    // Transitions given by a POSIX rule are expanded up to this year
+    const int s_last_year = 2100;
+}
+
+//----------------------------------------------------------------------------
+// POSIX TZ rule: std offset [dst [offset] [,start[/time],end[/time]]]
+//----------------------------------------------------------------------------
+struct time_zone::posix_rule {
+    struct date {
+        char    kind;   // 'J' - Julian day 1..365, 'N' - day 0..365, 'M' - m.w.d
+        int     m, w, d;
+        int32_t time;   // Seconds since local midnight
+    };
+
+    std::string std_abbr, dst_abbr;
+    int32_t     std_off = 0;        // Seconds east of UTC
+    int32_t     dst_off = 0;
+    bool        has_dst = false;
+    date        start, end;
+
+    bool parse(const char* p) {
+        int32_t off;
+        if (!parse_abbr(p, std_abbr) || !parse_hms(p, off, 24))
+            return false;
+        std_off = -off;
+        if (!*p)
+            return true;
+        if (!parse_abbr(p, dst_abbr))
+            return false;
+        has_dst = true;
+        dst_off = std_off + 3600;
+        if (*p && *p != ',') {
+            if (!parse_hms(p, off, 24))
+                return false;
+            dst_off = -off;
+        }
+        if (!*p) {
+            // Rules are not given - use the ones of the US
+            const char* us = ",M3.2.0,M11.1.0";
+            p = us;
+        }
+        if (*p++ != ',' || !parse_date(p, start) || *p++ != ',' || !parse_date(p, end))
+            return false;
+        return *p == '\0';
+    }
+
+    /// Days since epoch of the rule's date in year \a a_y
+    static int day(const date& a_d, int a_y) {
+        int jan1 = to_gregorian_days(a_y, 1, 1);
+        switch (a_d.kind) {
+            case 'J': return jan1 + a_d.d - 1 + (is_leap(a_y) && a_d.d >= 60);
+            case 'N': return jan1 + a_d.d;
+            default: {
+                int first = to_gregorian_days(a_y, a_d.m, 1);
+                int dim   = days_in_a_month(a_d.m, is_leap(a_y));
+                int n     = (a_d.d - weekday_from_days(first) + 7) % 7 + (a_d.w - 1) * 7;
+                while (n >= dim) n -= 7;
+                return first + n;
+            }
+        }
+    }
+
+private:
+    static bool parse_abbr(const char*& p, std::string& a_abbr) {
+        if (*p == '<') {
+            auto q = strchr(p, '>');
+            if (!q) return false;
+            a_abbr.assign(p+1, q);
+            p = q+1;
+        } else {
+            auto q = p;
+            while (isalpha(*p)) ++p;
+            a_abbr.assign(q, p);
+        }
+        return a_abbr.size() >= 3;
+    }
+
+    static bool parse_num(const char*& p, int& a_n, int a_max) {
+        if (!isdigit(*p)) return false;
+        for (a_n = 0; isdigit(*p); ++p)
+            if ((a_n = a_n * 10 + (*p - '0')) > a_max)
+                return false;
+        return true;
+    }
+
+    // [+|-]hh[:mm[:ss]]
+    static bool parse_hms(const char*& p, int32_t& a_sec, int a_max_hours) {
+        int sign = 1, h, m = 0, s = 0;
+        if (*p == '+' || *p == '-')
+            sign = *p++ == '-' ? -1 : 1;
+        if (!parse_num(p, h, a_max_hours))
+            return false;
+        if (*p == ':' && (!parse_num(++p, m, 59) || (*p == ':' && !parse_num(++p, s, 59))))
+            return false;
+        a_sec = sign * (h * 3600 + m * 60 + s);
+        return true;
+    }
+
+    static bool parse_date(const char*& p, date& a_d) {
+        a_d.kind = *p;
+        if (*p == 'M') {
+            if (!parse_num(++p, a_d.m, 12) || a_d.m < 1 || *p != '.' ||
+                !parse_num(++p, a_d.w, 5)  || a_d.w < 1 || *p != '.' ||
+                !parse_num(++p, a_d.d, 6))
+                return false;
+        } else if (*p == 'J') {
+            if (!parse_num(++p, a_d.d, 365) || a_d.d < 1)
+                return false;
+        } else {
+            a_d.kind = 'N';
+            if (!parse_num(p, a_d.d, 365))
+                return false;
+        }
+        a_d.time = 7200;
+        return *p != '/' || parse_hms(++p, a_d.time, 167);
+    }
+};
+
+//----------------------------------------------------------------------------
+// time_zone
+//----------------------------------------------------------------------------
+uint8_t time_zone::add_type(int32_t a_offset, bool a_dst, const std::string& a_abbrev)
+{
+    ttinfo t;
+    t.utc_offset = a_offset;
+    t.is_dst     = a_dst;
+    strncpy(t.abbrev, a_abbrev.c_str(), sizeof(t.abbrev)-1);
+    t.abbrev[sizeof(t.abbrev)-1] = '\0';
+
+    for (size_t i = 0; i < m_ttinfo.size(); ++i) {
+        auto& x = m_ttinfo[i];
+        if (x.utc_offset == t.utc_offset && x.is_dst == t.is_dst &&
+            !strcmp(x.abbrev, t.abbrev))
+            return uint8_t(i);
+    }
+    if (m_ttinfo.size() > 255)
+        UTXX_THROW_RUNTIME_ERROR("Too many local time types in zone ", m_name);
+    m_ttinfo.push_back(t);
+    return uint8_t(m_ttinfo.size()-1);
+}
+
+void time_zone::expand(const posix_rule& a_rule, int64_t a_from)
+{
+    auto std_type = add_type(a_rule.std_off, false, a_rule.std_abbr);
+    if (!a_rule.has_dst) {
+        // Rule without DST: a single transition to the standard time
+        if (!m_types.empty() ? m_types.back() != std_type : std_type != 0) {
+            m_trans.push_back(a_from + 1);
+            m_types.push_back(std_type);
+        }
+        return;
+    }
+    auto dst_type = add_type(a_rule.dst_off, true, a_rule.dst_abbr);
+
+    auto y0 = std::get<0>(time_val(secs(std::max<int64_t>(a_from, 0))).to_ymd()) - 1;
+    for (int y = y0; y <= s_last_year; ++y) {
+        int64_t s = int64_t(posix_rule::day(a_rule.start, y)) * 86400
+                  + a_rule.start.time - a_rule.std_off;
+        int64_t e = int64_t(posix_rule::day(a_rule.end,   y)) * 86400
+                  + a_rule.end.time   - a_rule.dst_off;
+        std::pair<int64_t, uint8_t> tr[2] = {{s, dst_type}, {e, std_type}};
+        if (e < s) std::swap(tr[0], tr[1]);    // Southern hemisphere
+        for (auto& t : tr) {
+            if (t.first <= a_from)
+                continue;
+            if (!m_trans.empty() && t.first <= m_trans.back()) {
+                // Rules like "all year DST" give coinciding transitions
+                m_trans.back() = t.first;
+                m_types.back() = t.second;
+            } else if (m_types.empty() || m_types.back() != t.second) {
+                m_trans.push_back(t.first);
+                m_types.push_back(t.second);
+            }
+        }
+    }
+}
+
+void time_zone::build_index()
+{
+    m_index.clear();
+    if (m_trans.empty())
+        return;
+    m_index_base = std::max<int64_t>(m_trans.front(), 0) & ~((int64_t(1) << BUCKET_BITS)-1);
+    size_t n = 0;
+    for (int64_t t = m_index_base; t <= m_trans.back(); t += int64_t(1) << BUCKET_BITS) {
+        while (n < m_trans.size() && m_trans[n] <= t) ++n;
+        m_index.push_back(uint32_t(n));
+    }
+}
+
+std::shared_ptr<const time_zone>
+time_zone::from_posix(const std::string& a_rule)
+{
+    posix_rule r;
+    if (!r.parse(a_rule.c_str()))
+        UTXX_THROW_BADARG_ERROR("Invalid POSIX time zone rule: ", a_rule);
+
+    std::shared_ptr<time_zone> tz(new time_zone);
+    tz->m_name = a_rule;
+    tz->expand(r, std::numeric_limits<int64_t>::min() / 2);
+    tz->build_index();
+    return tz;
+}
+
+std::shared_ptr<const time_zone>
+time_zone::from_tzif(const std::string& a_name, const char* a_data, size_t a_size)
+{
+    auto p   = reinterpret_cast<const uint8_t*>(a_data);
+    auto end = p + a_size;
+
+    auto be32 = [](const uint8_t* q) {
+        return int32_t(uint32_t(q[0]) << 24 | uint32_t(q[1]) << 16 | uint32_t(q[2]) << 8 | q[3]);
+    };
+    auto be64 = [&](const uint8_t* q) {
+        return int64_t(uint64_t(uint32_t(be32(q))) << 32 | uint32_t(be32(q+4)));
+    };
+    auto bad  = [&](const char* a_what) {
+        UTXX_THROW_RUNTIME_ERROR("Invalid TZif data of zone ", a_name, ": ", a_what);
+    };
+
+    // Header: magic, version, 15 reserved bytes, 6 counts
+    struct { uint32_t isut, isstd, leap, time, type, chars; } c;
+    auto header = [&]() {
+        if (end - p < 44 || memcmp(p, "TZif", 4))
+            bad("bad header");
+        c.isut  = be32(p+20); c.isstd = be32(p+24); c.leap  = be32(p+28);
+        c.time  = be32(p+32); c.type  = be32(p+36); c.chars = be32(p+40);
+        if (c.type == 0 || c.type > 256 || c.time > 1000000 || c.chars > 65536 ||
+            c.leap > 65536 || c.isut > c.type || c.isstd > c.type)
+            bad("bad counts");
+        p += 44;
+    };
+    auto data_size = [&](size_t a_tsize) {
+        return c.time * (a_tsize + 1) + c.type * 6 + c.chars
+             + c.leap * (a_tsize + 4) + c.isstd + c.isut;
+    };
+
+    header();
+    int    version = a_data[4] ? a_data[4] - '0' : 1;
+    size_t tsize   = 4;
+    if (version >= 2) {
+        // Skip the 32-bit data block in favor of the 64-bit one
+        if (size_t(end - p) < data_size(4))
+            bad("truncated data");
+        p += data_size(4);
+        header();
+        tsize = 8;
+    }
+    if (size_t(end - p) < data_size(tsize))
+        bad("truncated data");
+
+    std::shared_ptr<time_zone> tz(new time_zone);
+    tz->m_name = a_name;
+
+    auto times = p;
+    auto idx   = times + c.time * tsize;
+    auto types = idx   + c.time;
+    auto chars = reinterpret_cast<const char*>(types + c.type * 6);
+
+    uint8_t map[256];
+    for (uint32_t i = 0; i < c.type; ++i) {
+        auto q = types + i * 6;
+        if (q[5] >= c.chars)
+            bad("bad abbreviation index");
+        auto abbr = std::string(chars + q[5], strnlen(chars + q[5], c.chars - q[5]));
+        map[i] = tz->add_type(be32(q), q[4] != 0, abbr);
+    }
+    for (uint32_t i = 0; i < c.time; ++i) {
+        auto t = tsize == 8 ? be64(times + i * 8) : int64_t(be32(times + i * 4));
+        if (idx[i] >= c.type || (i && t <= tz->m_trans.back()))
+            bad("bad transition");
+        tz->m_trans.push_back(t);
+        tz->m_types.push_back(map[idx[i]]);
+    }
+    p += data_size(tsize);
+
+    // Footer of version 2+: "\n<POSIX TZ rule>\n"
+    if (version >= 2 && end - p > 1 && *p == '\n') {
+        auto q = std::find(p+1, end, '\n');
+        std::string rule(p+1, q);
+        posix_rule  r;
+        if (!rule.empty() && r.parse(rule.c_str()))
+            tz->expand(r, tz->m_trans.empty()
+                          ? std::numeric_limits<int64_t>::min() / 2
+                          : tz->m_trans.back());
+    }
+
+    tz->build_index();
+    return tz;
+}
+
+std::shared_ptr<const time_zone>
+time_zone::load(const std::string& a_name)
+{
+    std::string file = a_name;
+    if (a_name.empty() || a_name[0] != '/') {
+        auto dir = getenv("TZDIR");
+        file = std::string(dir && *dir ? dir : "/usr/share/zoneinfo") + '/' + a_name;
+    }
+    auto data = path::read_file(file);
+    return from_tzif(a_name, data.c_str(), data.size());
+}
+
+namespace {
+    std::mutex& registry_mutex() {
+        static std::mutex s_mutex;
+        return s_mutex;
+    }
+}
+
+std::shared_ptr<const time_zone>
+time_zone::get(const std::string& a_name)
+{
+    static std::map<std::string, std::shared_ptr<const time_zone>> s_zones;
+
+    std::lock_guard<std::mutex> g(registry_mutex());
+    auto it = s_zones.find(a_name);
+    if (it != s_zones.end())
+        return it->second;
+    std::shared_ptr<const time_zone> tz;
+    if (a_name == "UTC")
+        tz = std::shared_ptr<const time_zone>(&utc(), [](const time_zone*){});
+    else
+        try {
+            tz = load(a_name);
+        } catch (io_error&) {
+            posix_rule r;
+            if (!r.parse(a_name.c_str()))
+                throw;
+            tz = from_posix(a_name);
+        }
+    s_zones.emplace(a_name, tz);
+    return tz;
+}
+
+const time_zone& time_zone::utc()
+{
+    static std::shared_ptr<const time_zone> s_utc = from_posix("UTC0");
+    return *s_utc;
+}
+
+std::shared_ptr<const time_zone>
+time_zone::local()
+{
+    static std::string                      s_spec;
+    static std::shared_ptr<const time_zone> s_local;
+
+    auto env  = getenv("TZ");
+    auto spec = env ? std::string(":") + env : std::string();
+
+    {
+        std::lock_guard<std::mutex> g(registry_mutex());
+        if (s_local && spec == s_spec)
+            return s_local;
+    }
+
+    // Resolve the zone the way tzset(3) does
+    std::shared_ptr<const time_zone> tz;
+    if (!env) {
+        try {
+            // Name the zone after the file /etc/localtime links to
+            auto link = path::file_readlink("/etc/localtime");
+            auto pos  = link.find("zoneinfo/");
+            auto tzif = path::read_file("/etc/localtime");
+            tz = from_tzif(pos == std::string::npos ? "localtime" : link.substr(pos + 9),
+                           tzif.c_str(), tzif.size());
+        } catch (std::exception&) {}
+    } else if (*env) {
+        try { tz = get(*env == ':' ? env+1 : env); } catch (std::exception&) {}
+    }
+    if (!tz)
+        tz = std::shared_ptr<const time_zone>(&utc(), [](const time_zone*){});
+
+    std::lock_guard<std::mutex> g(registry_mutex());
+    s_spec  = spec;
+    s_local = tz;
+    return tz;
+}
+
+} // namespace utxx
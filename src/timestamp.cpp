@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/compiler_hints.hpp>
 #include <utxx/string.hpp>
 #include <utxx/time.hpp>
+#include <utxx/time_zone.hpp>
 #include <utxx/error.hpp>
 #include <stdio.h>
 
@@ -42,7 +43,9 @@ namespace utxx {
 
 boost::mutex            timestamp::s_mutex;
 thread_local long       timestamp::s_next_local_midnight_nseconds = 0;
+thread_local long       timestamp::s_local_midnight_nseconds      = 0;
 thread_local long       timestamp::s_next_utc_midnight_nseconds   = 0;
+thread_local long       timestamp::s_next_update_nseconds         = 0;
 thread_local time_t     timestamp::s_utc_nsec_offset              = 0;
 thread_local char       timestamp::s_local_timestamp[16];
 thread_local char       timestamp::s_utc_timestamp[16];
@@ -95,20 +98,25 @@ char* timestamp::write_date(char* a_buf, time_t a_utc_seconds, bool a_utc,
 
 void timestamp::update_midnight_nseconds(time_val a_now)
 {
-    auto s = a_now.sec();
-    struct tm tm;
-    localtime_r(&s, &tm);
-    s_utc_nsec_offset = tm.tm_gmtoff * 1000000000L;
+    auto  s  = a_now.sec();
+    auto  tz = time_zone::local();
+    auto& tt = tz->find(s);
+    s_utc_nsec_offset = tt.utc_offset * 1000000000L;
     auto now_midnight_nsecs   = a_now.nanoseconds() -
                                 a_now.nanoseconds() % (86400L * 1000000000L);
-    auto local_midnight_nsecs = now_midnight_nsecs - s_utc_nsec_offset;
 
     s_next_utc_midnight_nseconds   = now_midnight_nsecs + 86400L * 1000000000L;
-    s_next_local_midnight_nseconds = a_now.nanoseconds() >= local_midnight_nsecs
-                                   ? (s_next_utc_midnight_nseconds - s_utc_nsec_offset)
-                                   : local_midnight_nsecs;
+    s_next_local_midnight_nseconds = tz->next_midnight(s) * 1000000000L;
+    s_local_midnight_nseconds      = tz->midnight(s)      * 1000000000L;
 
-    strncpy(s_local_timezone, tm.tm_zone, sizeof(s_local_timezone)-1);
+    // The UTC offset of local time remains the same till the next transition
+    auto next_transition = tz->next_transition(s);
+    s_next_update_nseconds = std::min(s_next_utc_midnight_nseconds,
+                                      s_next_local_midnight_nseconds);
+    if (next_transition < s_next_update_nseconds / 1000000000L)
+        s_next_update_nseconds = next_transition * 1000000000L;
+
+    strncpy(s_local_timezone, tt.abbrev, sizeof(s_local_timezone)-1);
     s_local_timezone[sizeof(s_local_timezone)-1] = '\0';
 
     // the mutex is not needed here at all - s_timestamp lives in TLS storage
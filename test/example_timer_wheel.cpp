@@ -0,0 +1,204 @@
+//----------------------------------------------------------------------------
+/// \file  example_timer_wheel.cpp
+//----------------------------------------------------------------------------
+/// \brief Scaling of timer_wheel vs. one asio timer per timeout.
+///
+/// For every number of timers the example measures the cost of (re)arming
+/// all timers (as done when resetting session timeouts on activity), and
+/// the latency of their expiration.  The timer wheel is driven either by a
+/// single asio timer whose handler runs on a strand, or by a busy-poll loop.
+///
+/// Usage: example_timer_wheel [NumTimers ...]
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <utxx/timer_wheel.hpp>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace utxx;
+
+namespace {
+    const int REARMS = 5;                   // Times each timer is rearmed
+    const int SPREAD = 200000;              // Expirations within 200ms (in us)
+
+    struct stats {
+        double arm_ns;                      // Cost of arming a timer
+        double avg_late_us;                 // Average expiration latency
+        double max_late_us;                 // Maximum expiration latency
+    };
+
+    void add_latency(time_val a_due, double& a_sum, double& a_max) {
+        double late = (now_utc() - a_due).microseconds();
+        a_sum += late;
+        a_max  = std::max(a_max, late);
+    }
+
+    void print(const char* a_name, size_t a_n, const stats& a_st) {
+        printf("%-26s %7zu timers: arm %7.1f ns, latency avg %8.1f us, max %8.1f us\n",
+               a_name, a_n, a_st.arm_ns, a_st.avg_late_us, a_st.max_late_us);
+    }
+
+    /// One boost::asio::steady_timer per timeout
+    stats run_asio(const std::vector<int>& a_delays) {
+        namespace asio = boost::asio;
+        asio::io_service ios;
+        auto             n = a_delays.size();
+        std::vector<std::unique_ptr<asio::steady_timer>> timers(n);
+        std::vector<time_val> due(n);
+        double sum = 0, max = 0;
+
+        for (auto& t : timers)
+            t.reset(new asio::steady_timer(ios));
+
+        timer tm;
+        for (int r = 0; r < REARMS; ++r) {
+            auto now = now_utc();
+            for (size_t i = 0; i < n; ++i) {
+                // Rearming cancels the pending wait, whose handler is
+                // dispatched with operation_aborted
+                auto d = a_delays[(i + r) % n];
+                due[i] = now + usecs(d);
+                timers[i]->expires_from_now(std::chrono::microseconds(d));
+                timers[i]->async_wait([&, i](const boost::system::error_code& ec) {
+                    if (!ec) add_latency(due[i], sum, max);
+                });
+            }
+            ios.poll();
+        }
+        double arm = tm.elapsed_nsec() / (n * REARMS);
+
+        ios.run();
+        return stats{arm, sum / n, max};
+    }
+
+    /// Timer wheel driven by a single asio timer on a strand
+    stats run_wheel_asio(const std::vector<int>& a_delays) {
+        namespace asio = boost::asio;
+        asio::io_service        ios;
+        asio::io_service::strand strand(ios);
+        asio::steady_timer      driver(ios);
+        timer_wheel             wheel(usecs(100));
+        auto                    n = a_delays.size();
+        std::vector<wheel_timer> timers(n);
+        std::vector<time_val>    due(n);
+        double sum = 0, max = 0;
+
+        for (size_t i = 0; i < n; ++i)
+            timers[i].on_expire([&, i](wheel_timer&, time_val) {
+                add_latency(due[i], sum, max);
+            });
+
+        // Expire due timers and arm the driver for the next expiration
+        std::function<void (const boost::system::error_code&)> on_tick =
+            [&](const boost::system::error_code& ec) {
+                if (ec) return;
+                wheel.advance(now_utc());
+                if (wheel.empty()) return;
+                auto wait = (wheel.next_expiry() - now_utc()).microseconds();
+                driver.expires_from_now(std::chrono::microseconds(std::max<long>(0, wait)));
+                driver.async_wait(strand.wrap(on_tick));
+            };
+
+        timer tm;
+        for (int r = 0; r < REARMS; ++r) {
+            wheel.advance(now_utc());
+            auto now = wheel.now();
+            for (size_t i = 0; i < n; ++i) {
+                auto d = a_delays[(i + r) % n];
+                due[i] = now + usecs(d);
+                wheel.schedule(timers[i], due[i]);
+            }
+        }
+        double arm = tm.elapsed_nsec() / (n * REARMS);
+
+        strand.post([&] { on_tick(boost::system::error_code()); });
+        ios.run();
+        return stats{arm, sum / n, max};
+    }
+
+    /// Timer wheel driven by a busy-poll loop
+    stats run_wheel_poll(const std::vector<int>& a_delays) {
+        timer_wheel              wheel(usecs(1));
+        auto                     n = a_delays.size();
+        std::vector<wheel_timer> timers(n);
+        std::vector<time_val>    due(n);
+        double sum = 0, max = 0;
+
+        for (size_t i = 0; i < n; ++i)
+            timers[i].on_expire([&, i](wheel_timer&, time_val) {
+                add_latency(due[i], sum, max);
+            });
+
+        timer tm;
+        for (int r = 0; r < REARMS; ++r) {
+            wheel.advance(now_utc());
+            auto now = wheel.now();
+            for (size_t i = 0; i < n; ++i) {
+                auto d = a_delays[(i + r) % n];
+                due[i] = now + usecs(d);
+                wheel.schedule(timers[i], due[i]);
+            }
+        }
+        double arm = tm.elapsed_nsec() / (n * REARMS);
+
+        while (!wheel.empty())
+            wheel.advance(now_utc());
+        return stats{arm, sum / n, max};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i)
+        counts.push_back(atol(argv[i]));
+    if (counts.empty())
+        counts = {1000, 10000, 100000};
+
+    std::mt19937 rng(1);
+
+    for (auto n : counts) {
+        std::vector<int> delays(n);
+        for (auto& d : delays)
+            d = rng() % SPREAD;
+
+        print("asio::steady_timer",        n, run_asio(delays));
+        print("timer_wheel (asio strand)", n, run_wheel_asio(delays));
+        print("timer_wheel (busy poll)",   n, run_wheel_poll(delays));
+    }
+
+    return 0;
+}
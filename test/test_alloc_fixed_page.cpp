@@ -34,8 +34,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <boost/test/unit_test.hpp>
 #include <utxx/alloc_fixed_page.hpp>
+#include <utxx/concurrent_alloc_fixed_page.hpp>
 #include <utxx/verbosity.hpp>
 #include <vector>
+#include <thread>
+#include <set>
 #include <iostream>
 
 using namespace utxx;
@@ -64,3 +67,65 @@ BOOST_AUTO_TEST_CASE( test_alloc_fixed_page )
 
 }
 
+BOOST_AUTO_TEST_CASE( test_alloc_fixed_page_policy )
+{
+    typedef memory::mmap_page_policy<memory::page_kind::HUGETLB, -1, true> policy;
+    const size_t page_size = 2*1024*1024;
+
+    memory::aligned_page_allocator<test, page_size, policy> alloc;
+    std::vector<test*> v;
+    for (int i = 0; i < 100000; i++) {
+        test* p = alloc.allocate(1);
+        p->buf[0] = char(i);
+        v.push_back(p);
+    }
+    // Pages are aligned on the page size
+    BOOST_CHECK_EQUAL(0u, reinterpret_cast<size_t>(alloc.address()) % page_size);
+    for (int i = 0; i < 100000; i++) {
+        BOOST_REQUIRE_EQUAL(char(i), v[i]->buf[0]);
+        alloc.deallocate(v[i], 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_fixed_page_concurrent )
+{
+    typedef memory::concurrent_aligned_page_allocator<
+        test, 64*1024, 4,
+        memory::mmap_page_policy<memory::page_kind::TRANSPARENT_HUGE>
+    > alloc_t;
+
+    alloc_t alloc;
+    const int N = 100000;
+    std::vector<test*> v1(N), v2(N);
+
+    // Objects allocated by two threads are freed by the main thread
+    auto f = [&](std::vector<test*>& v, char c) {
+        for (int i = 0; i < N; i++) {
+            v[i] = alloc.allocate(1);
+            memset(v[i]->buf, c, sizeof(v[i]->buf));
+        }
+    };
+    std::thread t1(f, std::ref(v1), 'a');
+    std::thread t2(f, std::ref(v2), 'b');
+    t1.join();
+    t2.join();
+
+    // Pages recycled by this thread are cached and reused
+    auto page = [](test* x) { return reinterpret_cast<size_t>(x) & ~(64*1024ul-1); };
+    std::set<size_t> pages;
+    for (int i = 0; i < N; i++) {
+        pages.insert(page(v1[i]));
+        pages.insert(page(v2[i]));
+    }
+
+    for (int i = 0; i < N; i++) {
+        BOOST_REQUIRE_EQUAL('a', v1[i]->buf[sizeof(test)-1]);
+        BOOST_REQUIRE_EQUAL('b', v2[i]->buf[0]);
+        alloc.deallocate(v1[i]);
+        alloc.deallocate(v2[i]);
+    }
+
+    test* p = alloc.allocate();
+    BOOST_CHECK(pages.count(page(p)));
+    alloc.deallocate(p);
+}
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+/// \file  test_alloc_page_policy.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases for alloc_page_policy.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <utxx/alloc_page_policy.hpp>
+#include <utxx/allocator.hpp>
+#include <string.h>
+
+using namespace utxx;
+using namespace utxx::memory;
+
+BOOST_AUTO_TEST_CASE( test_alloc_page_policy_map )
+{
+    BOOST_CHECK(sys_page_size() >= 4096);
+    BOOST_CHECK(huge_page_size() >= sys_page_size());
+
+    const size_t sz = 3*1024*1024 + 10;
+
+    for (auto kind : {page_kind::REGULAR, page_kind::TRANSPARENT_HUGE, page_kind::HUGETLB}) {
+        // Bind to node 0 (best effort) and pre-fault
+        page_options opts(kind, 0, true);
+        size_t align = 1024*1024;
+        char*  p     = static_cast<char*>(map_pages(sz, align, opts));
+        BOOST_REQUIRE(p);
+        BOOST_CHECK_EQUAL(0u, reinterpret_cast<size_t>(p) % align);
+        BOOST_CHECK(mapped_size(sz, opts) >= sz);
+        memset(p, 1, sz);
+        BOOST_CHECK_EQUAL(1, p[sz-1]);
+        unmap_pages(p, sz, opts);
+    }
+
+    BOOST_CHECK_EQUAL(EINVAL, bind_numa_node(NULL, 0, -1));
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_page_policy_hugetlb_fallback )
+{
+    // Request more huge pages than are free, so that MAP_HUGETLB fails and
+    // the region is mapped with regular pages
+    size_t nfree = 0;
+    if (FILE* f = ::fopen("/proc/meminfo", "r")) {
+        char line[128];
+        while (::fgets(line, sizeof(line), f))
+            if (::sscanf(line, "HugePages_Free: %zu", &nfree) == 1)
+                break;
+        ::fclose(f);
+    }
+    const size_t sz = (nfree + 1) * huge_page_size();
+    page_options opts(page_kind::HUGETLB);
+
+    for (size_t align : {huge_page_size(), 4 * huge_page_size()})
+        for (int i = 0; i < 8; ++i) {
+            char* p = static_cast<char*>(map_pages(sz, align, opts));
+            BOOST_REQUIRE(p);
+            BOOST_CHECK_EQUAL(0u, reinterpret_cast<size_t>(p) % align);
+            p[0] = p[sz-1] = 1;
+            unmap_pages(p, sz, opts);
+        }
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_page_policy_shmem )
+{
+    const char* file = "/dev/shm/test_utxx_shmem_manager";
+    const size_t sz  = 1024*1024;
+
+    {
+        shmem_manager m(file, sz, shmem_manager::TRUNCATE_SHARED_MEMORY, false,
+                        page_options(page_kind::TRANSPARENT_HUGE, -1, true));
+        BOOST_CHECK(m.truncated());
+        BOOST_CHECK_EQUAL(sz, m.size());
+        char* p = static_cast<char*>(m.reserve(10));
+        BOOST_REQUIRE(p);
+        BOOST_CHECK_EQUAL(m.address(), p);
+        strcpy(p, "abc");
+        BOOST_CHECK_EQUAL(m.address() + 16, m.reserve(100));
+        BOOST_CHECK(!m.reserve(sz));
+    }
+    {
+        shmem_manager m(file, 0, shmem_manager::ATTACH_SHARED_MEMORY, true);
+        BOOST_CHECK(!m.truncated());
+        BOOST_CHECK_EQUAL(sz, m.size());
+        BOOST_CHECK_EQUAL("abc", m.address());
+    }
+    BOOST_CHECK(::access(file, F_OK) != 0);
+    BOOST_CHECK_THROW(shmem_manager m(file), io_error);
+}
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+/// \file  test_alloc_thread_cached.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for alloc_thread_cached.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/alloc_cached.hpp>
+#include <utxx/alloc_thread_cached.hpp>
+#include <utxx/concurrent_spsc_queue.hpp>
+#include <utxx/time_val.hpp>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+using namespace utxx::memory;
+
+namespace {
+    using backend_t = cached_allocator<char>;
+    using tcache_t  = thread_cached_allocator<backend_t, 32>;
+
+    /// Each thread allocates a batch of objects and frees them
+    template <class Alloc>
+    double run_bench(Alloc& a_alloc, int a_threads, long a_iterations) {
+        const int        batch = 64;
+        std::atomic<int> ready(0);
+        std::vector<std::thread> threads;
+        timer t;
+        for (int n = 0; n < a_threads; ++n)
+            threads.emplace_back([&] {
+                void* objs[batch];
+                ++ready;
+                while (ready < a_threads);
+                for (long i = 0; i < a_iterations; i += batch) {
+                    for (int j = 0; j < batch; ++j) {
+                        objs[j] = a_alloc.allocate(64 + (j & 0x3) * 64);
+                        *static_cast<long*>(objs[j]) = j;
+                    }
+                    for (int j = 0; j < batch; ++j)
+                        a_alloc.free(objs[j]);
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        return t.elapsed();
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_thread_cached )
+{
+    backend_t backend;
+    {
+        tcache_t alloc(backend, 2);
+
+        void* p = alloc.allocate(100);
+        BOOST_REQUIRE(p);
+        alloc.free(p);
+        // LIFO reuse from the thread's magazine
+        BOOST_CHECK_EQUAL(p, alloc.allocate(100));
+        alloc.free(p);
+
+        // The first allocation refilled the magazine from the back-end in
+        // a single batch
+        int sc = backend_t::size_class_of(100);
+        BOOST_CHECK_EQUAL(0, backend.cache_size(sc));
+
+        // Large objects bypass the cache
+        void* q = alloc.allocate(1 << 22);
+        BOOST_REQUIRE(q);
+        BOOST_CHECK_EQUAL(1u, backend.large_objects());
+        alloc.free(q);
+        BOOST_CHECK_EQUAL(0u, backend.large_objects());
+
+        // Overflowing two magazines hands one over to the depot
+        std::vector<void*> v;
+        for (int i = 0; i < 100; ++i)
+            v.push_back(alloc.allocate(100));
+        for (auto x : v)
+            alloc.free(x);
+        BOOST_CHECK(alloc.depot_size(sc) > 0);
+
+        alloc.flush_thread_cache();
+        BOOST_CHECK_EQUAL(2, alloc.depot_size(sc));  // Capped by max_depot
+        BOOST_CHECK(backend.cache_size(sc) > 0);
+    }
+    // All cached chunks are returned to the back-end on destruction.
+    // The back-end is always consulted in batches of magazine size.
+    int sc = backend_t::size_class_of(100);
+    BOOST_CHECK(backend.cache_size(sc) >= 100);
+    BOOST_CHECK_EQUAL(0, backend.cache_size(sc) % 32);
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_thread_cached_reallocate )
+{
+    // reallocate() uses the same size classes as allocate() and free()
+    backend_t backend;
+    char* p = static_cast<char*>(backend.allocate(1));
+    BOOST_CHECK(p == backend.reallocate(p, 2));
+    memcpy(p, "abc", 4);
+    p = static_cast<char*>(backend.reallocate(p, 100));
+    BOOST_REQUIRE(p);
+    BOOST_CHECK_EQUAL("abc", p);
+    backend.free(p);
+    BOOST_CHECK_EQUAL(1, backend.cache_size(backend_t::size_class_of(1)));
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_thread_cached_cross_thread )
+{
+    backend_t backend;
+    tcache_t  alloc(backend);
+
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    concurrent_spsc_queue<long*> queue(1024);
+    long sum = 0;
+
+    // Objects allocated by the producer are freed by the consumer
+    std::thread consumer([&] {
+        for (long i = 0; i < ITERATIONS; ++i) {
+            long* p;
+            while (!queue.pop(p));
+            sum += *p;
+            alloc.free(p);
+        }
+        alloc.flush_thread_cache();
+    });
+
+    for (long i = 0; i < ITERATIONS; ++i) {
+        long* p = static_cast<long*>(alloc.allocate(sizeof(long)));
+        BOOST_REQUIRE(p);
+        *p = i;
+        while (!queue.push(p));
+    }
+
+    consumer.join();
+    BOOST_CHECK_EQUAL(ITERATIONS * (ITERATIONS - 1) / 2, sum);
+}
+
+BOOST_AUTO_TEST_CASE( test_alloc_thread_cached_perf )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 4;
+
+    backend_t backend;
+    double    elapsed1 = run_bench(backend, THREADS, ITERATIONS);
+
+    tcache_t  alloc(backend);
+    double    elapsed2 = run_bench(alloc, THREADS, ITERATIONS);
+
+    auto ops = 2.0 * ITERATIONS;
+    BOOST_TEST_MESSAGE(
+        (boost::format("cached_allocator        (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * elapsed1 / ops)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("thread_cached_allocator (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * elapsed2 / ops)).str());
+}
@@ -72,6 +72,22 @@ BOOST_AUTO_TEST_CASE( test_async_file_logger_err_handler )
     logger.stop();
 }
 
+BOOST_AUTO_TEST_CASE( test_async_file_logger_thread_placement )
+{
+    ::unlink(s_filename);
+    text_file_logger<> logger;
+
+    // The placement is applied by the logging thread before it does any
+    // work, and a failure is reported by start()
+    logger.thread_placement(os::thread_placement("", "", os::sched_policy::FIFO, 90));
+    BOOST_CHECK_THROW(logger.start(s_filename), badarg_error);
+
+    logger.thread_placement(os::thread_placement("async-log", ""));
+    BOOST_REQUIRE_EQUAL(0, logger.start(s_filename));
+    logger.stop();
+    ::unlink(s_filename);
+}
+
 BOOST_AUTO_TEST_CASE( test_async_file_logger_perf )
 {
     enum { ITERATIONS = 500000 };
@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------
+/// \file  test_btree_map.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases for btree_map.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file may be included in different open-source projects.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/container/btree_map.hpp>
+#include <utxx/container/assoc_vector.hpp>
+#include <utxx/time_val.hpp>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace utxx;
+
+namespace {
+    template <class Map, class Ref>
+    void check_same(const Map& a_map, const Ref& a_ref) {
+        BOOST_REQUIRE_EQUAL(a_ref.size(), a_map.size());
+        auto r = a_ref.begin();
+        for (auto it = a_map.cbegin(), e = a_map.cend(); it != e; ++it, ++r) {
+            BOOST_REQUIRE(r->first  == it->first);
+            BOOST_REQUIRE(r->second == it->second);
+        }
+        // Reverse traversal
+        auto rr = a_ref.rbegin();
+        for (auto it = a_map.crbegin(), e = a_map.crend(); it != e; ++it, ++rr)
+            BOOST_REQUIRE(rr->first == it->first);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_btree_map )
+{
+    btree_map<int, string> v{{1,"a"}, {2, "b"}, {4, "c"}, {7, "d"}};
+
+    BOOST_CHECK_EQUAL(4u, v.size());
+    auto it = v.find(2);
+    BOOST_CHECK(it != v.end());
+    BOOST_CHECK_EQUAL("b", it->second);
+    it = v.find(4);
+    BOOST_CHECK_EQUAL("c", it->second);
+    BOOST_CHECK(v.find(3) == v.end());
+
+    it = v.lower_bound(3);
+    BOOST_CHECK_EQUAL(4, it->first);
+    it = v.upper_bound(3);
+    BOOST_CHECK_EQUAL(4, it->first);
+    it = v.upper_bound(4);
+    BOOST_CHECK_EQUAL(7, it->first);
+    BOOST_CHECK(v.upper_bound(7) == v.end());
+    BOOST_CHECK(v.lower_bound(0) == v.begin());
+
+    BOOST_CHECK(!v.insert(make_pair(4, string("x"))).second);
+    BOOST_CHECK(v.insert(make_pair(5, string("e"))).second);
+    v[6] = "f";
+    BOOST_CHECK_EQUAL("f", v[6]);
+    BOOST_CHECK_EQUAL(1u, v.count(5));
+    BOOST_CHECK_EQUAL(1u, v.erase(5));
+    BOOST_CHECK_EQUAL(0u, v.erase(5));
+    BOOST_CHECK_EQUAL(0u, v.count(5));
+    BOOST_CHECK_EQUAL(7, (--v.end())->first);
+
+    auto v2(v);
+    BOOST_CHECK(v2 == v);
+    v2.erase(v2.begin());
+    BOOST_CHECK(v2 != v);
+    BOOST_CHECK(v < v2);
+
+    v.clear();
+    BOOST_CHECK(v.empty());
+    BOOST_CHECK(v.begin() == v.end());
+}
+
+BOOST_AUTO_TEST_CASE( test_btree_map_random )
+{
+    using map_t = btree_map<long, long>;
+    std::mt19937_64 rnd(1);
+    map_t           m;
+    map<long, long> ref;
+
+    // Narrow key range gives a good mix of hits and misses
+    for (int i = 0; i < 200000; ++i) {
+        long k = long(rnd() % 20000) - 10000;
+        if (rnd() % 3) {
+            auto r1 = m.insert(make_pair(k, long(i)));
+            auto r2 = ref.insert(make_pair(k, long(i)));
+            BOOST_REQUIRE_EQUAL(r2.second, r1.second);
+            BOOST_REQUIRE_EQUAL(r2.first->second, r1.first->second);
+        } else
+            BOOST_REQUIRE_EQUAL(ref.erase(k), m.erase(k));
+
+        if (i % 10000 == 0) {
+            long x = long(rnd() % 20000) - 10000;
+            auto lb = m.lower_bound(x);
+            auto rb = ref.lower_bound(x);
+            BOOST_REQUIRE_EQUAL(rb == ref.end(), lb == m.end());
+            if (rb != ref.end()) BOOST_REQUIRE_EQUAL(rb->first, lb->first);
+            auto ub = m.upper_bound(x);
+            auto ru = ref.upper_bound(x);
+            BOOST_REQUIRE_EQUAL(ru == ref.end(), ub == m.end());
+            if (ru != ref.end()) BOOST_REQUIRE_EQUAL(ru->first, ub->first);
+        }
+    }
+
+    check_same(m, ref);
+    BOOST_CHECK(m.depth() > 2);
+
+    // Range erase
+    m.erase(m.lower_bound(-5000), m.lower_bound(5000));
+    ref.erase(ref.lower_bound(-5000), ref.lower_bound(5000));
+    check_same(m, ref);
+
+    // Drain the tree through the iterator interface
+    for (auto it = m.begin(); it != m.end(); )
+        it = m.erase(it);
+    BOOST_CHECK(m.empty());
+    BOOST_CHECK_EQUAL(0, m.depth());
+}
+
+BOOST_AUTO_TEST_CASE( test_btree_map_key_types )
+{
+    // Unsigned keys take the biased SIMD compare path
+    btree_map<uint32_t, int> u;
+    map<uint32_t, int>       ur;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        uint32_t k = i * 2654435761u;
+        u[k] = ur[k] = int(i);
+    }
+    check_same(u, ur);
+    BOOST_CHECK(u.find(0x80000000u) == u.end());
+
+    // Non-integral keys and custom comparators use the binary search
+    btree_map<string, int, greater<string>> s;
+    map<string, int, greater<string>>       sr;
+    for (int i = 0; i < 1000; ++i) {
+        auto k = to_string(i * 7919 % 1000);
+        s[k] = sr[k] = i;
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        auto k = to_string(i);
+        BOOST_REQUIRE_EQUAL(sr.erase(k), s.erase(k));
+    }
+    check_same(s, sr);
+}
+
+BOOST_AUTO_TEST_CASE( test_btree_map_perf )
+{
+    const int ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 100000;
+
+    std::mt19937_64   rnd(2);
+    std::vector<long> keys(ITERATIONS);
+    for (auto& k : keys) k = long(rnd() >> 1);
+
+    btree_map<long, long>    bt;
+    assoc_vector<long, long> av;
+
+    timer t;
+    for (auto k : keys) bt.insert(make_pair(k, k));
+    double bt_insert = t.elapsed();
+
+    t.reset();
+    for (auto k : keys) av.insert(make_pair(k, k));
+    double av_insert = t.elapsed();
+
+    long sum = 0;
+    t.reset();
+    for (auto k : keys) sum += bt.find(k)->second;
+    double bt_find = t.elapsed();
+
+    t.reset();
+    for (auto k : keys) sum -= av.find(k)->second;
+    double av_find = t.elapsed();
+
+    BOOST_CHECK_EQUAL(0, sum);
+    BOOST_CHECK_EQUAL(av.size(), bt.size());
+
+    BOOST_TEST_MESSAGE(
+        (boost::format("btree_map    insert: %.3f us/call, find: %.3f us/call")
+            % (1000000.0 * bt_insert / ITERATIONS)
+            % (1000000.0 * bt_find   / ITERATIONS)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("assoc_vector insert: %.3f us/call, find: %.3f us/call")
+            % (1000000.0 * av_insert / ITERATIONS)
+            % (1000000.0 * av_find   / ITERATIONS)).str());
+}
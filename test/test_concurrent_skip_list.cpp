@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------------
+/// \file  test_concurrent_skip_list.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases for concurrent_skip_list.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/container/concurrent_priority_queue.hpp>
+#include <utxx/time_val.hpp>
+#include <mutex>
+#include <map>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+using namespace utxx::container;
+
+namespace {
+    std::atomic<long> s_live(0);
+
+    struct item {
+        long value;
+        item(long v = 0) : value(v) { ++s_live; }
+        item(const item& a) : value(a.value) { ++s_live; }
+        item& operator=(const item& a) { value = a.value; return *this; }
+        ~item() { --s_live; }
+    };
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_skip_list )
+{
+    memory::epoch_domain d;
+    concurrent_skip_list<int> list(d);
+
+    BOOST_CHECK(list.empty());
+    int v;
+    uint64_t key;
+    BOOST_CHECK(!list.pop_min(v));
+    BOOST_CHECK(!list.peek_min(key));
+
+    // Equal keys are popped in the insertion order
+    list.insert(30, 1);
+    auto h = list.insert(10, 2);
+    list.insert(20, 3);
+    list.insert(10, 4);
+    list.insert(5,  5);
+    BOOST_CHECK_EQUAL(5, list.size());
+    BOOST_CHECK(list.peek_min(key));
+    BOOST_CHECK_EQUAL(5u, key);
+
+    BOOST_CHECK(list.contains(h));
+    BOOST_CHECK(list.erase(h));
+    BOOST_CHECK(!list.erase(h));
+    BOOST_CHECK(!list.contains(h));
+
+    int expect[][2] = {{5,5}, {10,4}, {20,3}, {30,1}};
+    for (auto& e : expect) {
+        BOOST_REQUIRE(list.pop_min(v, &key));
+        BOOST_CHECK_EQUAL(uint64_t(e[0]), key);
+        BOOST_CHECK_EQUAL(e[1], v);
+    }
+    BOOST_CHECK(list.empty());
+    BOOST_CHECK_EQUAL(0, list.size());
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_skip_list_random )
+{
+    memory::epoch_domain d;
+    concurrent_priority_queue<long> q(d);
+    std::mt19937_64 rnd(1);
+    std::multimap<uint64_t, long> ref;
+
+    for (long i = 0; i < 100000; ++i) {
+        uint64_t k = rnd() % 1000;
+        if (rnd() % 3) {
+            q.insert(k, i);
+            ref.emplace(k, i);
+        } else if (!ref.empty()) {
+            long     v;
+            uint64_t key;
+            BOOST_REQUIRE(q.pop_min(v, &key));
+            BOOST_REQUIRE_EQUAL(ref.begin()->first, key);
+            BOOST_REQUIRE_EQUAL(ref.begin()->second, v);
+            ref.erase(ref.begin());
+        }
+    }
+    BOOST_CHECK_EQUAL(long(ref.size()), q.size());
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_skip_list_threads )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 200000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 4;
+
+    s_live = 0;
+    {
+        memory::epoch_domain d;
+        concurrent_skip_list<item> list(d);
+        std::atomic<long> inserted(0), removed(0), errors(0);
+        std::vector<std::thread> threads;
+
+        // Each thread inserts items with random deadlines, erases some of
+        // them by handle and pops the earliest ones
+        timer t;
+        for (int n = 0; n < THREADS; ++n)
+            threads.emplace_back([&, n] {
+                std::mt19937_64 rnd(n);
+                std::vector<concurrent_skip_list<item>::handle> handles;
+                long ins = 0, rem = 0;
+                item v;
+                for (long i = 0; i < ITERATIONS; ++i) {
+                    long x = long(rnd() % 1000000);
+                    handles.push_back(list.insert(x, item(x)));
+                    ins += x;
+                    if (i % 4 == 0) {
+                        auto& h = handles[rnd() % handles.size()];
+                        if (list.erase(h))
+                            rem += long(h.key);
+                    }
+                    if (i % 2 == 0) {
+                        uint64_t key;
+                        if (list.pop_min(v, &key)) {
+                            if (long(key) != v.value) ++errors;
+                            rem += v.value;
+                        }
+                    }
+                }
+                inserted += ins;
+                removed  += rem;
+            });
+        for (auto& th : threads)
+            th.join();
+        double elapsed = t.elapsed();
+
+        BOOST_CHECK_EQUAL(0, errors);
+
+        // Drain the rest verifying the order
+        item     v;
+        uint64_t key, prev = 0;
+        long     rem = 0;
+        while (list.pop_min(v, &key)) {
+            BOOST_REQUIRE(key >= prev);
+            prev = key;
+            rem += v.value;
+        }
+        BOOST_CHECK_EQUAL(inserted, removed + rem);
+        BOOST_CHECK(list.empty());
+
+        // All removed nodes are reclaimed
+        d.flush();
+        BOOST_CHECK_EQUAL(0, d.drain());
+        BOOST_CHECK_EQUAL(1, s_live);   // 'v'
+
+        BOOST_TEST_MESSAGE(
+            (boost::format("concurrent_skip_list (%d threads): %.3f us/insert")
+                % THREADS % (1e6 * elapsed / (THREADS * ITERATIONS))).str());
+    }
+    BOOST_CHECK_EQUAL(0, s_live);
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_skip_list_perf )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 200000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 4;
+
+    typedef std::pair<uint64_t, long> pair_t;
+    std::priority_queue<pair_t, std::vector<pair_t>, std::greater<pair_t>> pq;
+    std::mutex mtx;
+    concurrent_priority_queue<long> cpq;
+
+    auto run = [&](bool a_locked) {
+        std::vector<std::thread> threads;
+        timer t;
+        for (int n = 0; n < THREADS; ++n)
+            threads.emplace_back([&, n] {
+                std::mt19937_64 rnd(n);
+                long v;
+                for (long i = 0; i < ITERATIONS; ++i) {
+                    uint64_t k = rnd() % 1000000;
+                    if (a_locked) {
+                        std::lock_guard<std::mutex> g(mtx);
+                        pq.emplace(k, i);
+                        if (i & 1) pq.pop();
+                    } else {
+                        cpq.insert(k, i);
+                        if (i & 1) cpq.pop_min(v);
+                    }
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        return t.elapsed();
+    };
+
+    double t1 = run(true);
+    double t2 = run(false);
+    double ops = 1.5 * THREADS * ITERATIONS;
+    BOOST_TEST_MESSAGE(
+        (boost::format("std::priority_queue+mutex (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * t1 / ops)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("concurrent_priority_queue (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * t2 / ops)).str());
+}
@@ -7,6 +7,9 @@
 #include <memory>
 #include <thread>
 #include <math.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 namespace utxx {
 
@@ -308,4 +311,92 @@ BOOST_AUTO_TEST_CASE( test_concurrent_spsc_iterator )
     }
 }
 
+BOOST_AUTO_TEST_CASE( test_concurrent_spsc_recovery )
+{
+    typedef concurrent_spsc_queue<long> queue_t;
+    typedef queue_t::side_t             side_t;
+
+    const uint32_t sz  = queue_t::memory_size(16);
+    void*          mem = ::mmap(NULL, sz, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BOOST_REQUIRE(mem != MAP_FAILED);
+
+    // Storage without a queue header is initialized as an empty queue
+    memset(mem, 0xAB, sz);
+    queue_t consumer(mem, sz, side_t::consumer);
+    BOOST_CHECK(consumer.empty());
+    BOOST_CHECK_EQUAL(0u, consumer.generation(side_t::consumer));
+    BOOST_CHECK_EQUAL(1u, consumer.attach());
+    BOOST_CHECK(consumer.peer_status(side_t::producer) == peer_state::DETACHED);
+    BOOST_CHECK(consumer.peer_status(side_t::consumer) == peer_state::ALIVE);
+
+    // Re-attaching with a different capacity is rejected
+    BOOST_CHECK_THROW(queue_t(mem, queue_t::memory_size(8), side_t::consumer),
+                      badarg_error);
+
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(0, ::pipe(fds));
+
+    // The producer process publishes some items and gets killed
+    pid_t pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+    if (pid == 0) {
+        queue_t producer(mem, sz, side_t::producer);
+        producer.attach();
+        for (long i = 0; i < 5; ++i)
+            producer.push(i);
+        producer.heartbeat();
+        if (::write(fds[1], "x", 1) != 1)
+            ::_exit(1);
+        for (;;)
+            ::pause();
+    }
+
+    char c;
+    BOOST_REQUIRE_EQUAL(1, ::read(fds[0], &c, 1));
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    BOOST_CHECK(consumer.peer_status(side_t::producer) == peer_state::ALIVE);
+    BOOST_CHECK_EQUAL(1u, consumer.generation(side_t::producer));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    BOOST_CHECK(consumer.peer_status(side_t::producer, 1000000)
+                == peer_state::STALLED);
+
+    // The side is still owned by a live process
+    queue_t producer(mem, sz, side_t::producer);
+    BOOST_CHECK_THROW(producer.recover(), runtime_error);
+
+    ::kill(pid, SIGKILL);
+    ::waitpid(pid, NULL, 0);
+    BOOST_CHECK(consumer.peer_status(side_t::producer) == peer_state::DEAD);
+
+    long v;
+    BOOST_CHECK(consumer.pop(v)); BOOST_CHECK_EQUAL(0, v);
+    BOOST_CHECK(consumer.pop(v)); BOOST_CHECK_EQUAL(1, v);
+
+    // A restarted producer resumes after the last committed item
+    BOOST_CHECK_EQUAL(5u, producer.recover());
+    BOOST_CHECK_EQUAL(2u, consumer.generation(side_t::producer));
+    BOOST_CHECK(consumer.peer_status(side_t::producer) == peer_state::ALIVE);
+    for (long i = 5; i < 8; ++i)
+        BOOST_CHECK(producer.push(i));
+
+    // So does a restarted consumer
+    queue_t consumer2(mem, sz, side_t::consumer);
+    BOOST_CHECK_EQUAL(2u, consumer2.recover());
+    BOOST_CHECK_EQUAL(2u, consumer2.generation(side_t::consumer));
+    for (long i = 2; i < 8; ++i) {
+        BOOST_CHECK(consumer2.pop(v));
+        BOOST_CHECK_EQUAL(i, v);
+    }
+    BOOST_CHECK(consumer2.empty());
+
+    producer.detach();
+    BOOST_CHECK(consumer2.peer_status(side_t::producer) == peer_state::DETACHED);
+    consumer2.detach();
+
+    ::munmap(mem, sz);
+}
+
 } // namespace utxx
@@ -180,3 +180,43 @@ BOOST_AUTO_TEST_CASE( test_concurrent_stack )
     BOOST_REQUIRE_EQUAL(producer_threads*iterations, cons_count);
 }
 
+
+BOOST_AUTO_TEST_CASE( test_concurrent_stack_lock_free )
+{
+    memory::epoch_domain d;
+    lock_free_stack<long> stack(d);
+
+    for (long i = 1; i <= 10; ++i)
+        stack.push(i);
+    long v;
+    for (long i = 10; i > 0; --i) {
+        BOOST_REQUIRE(stack.pop(v));
+        BOOST_REQUIRE_EQUAL(i, v);
+    }
+    BOOST_REQUIRE(!stack.pop(v));
+    BOOST_REQUIRE(stack.empty());
+
+    const long iterations = ::getenv("ITERATIONS") ? atoi(::getenv("ITERATIONS")) : 100000;
+    const int  threads    = 4;
+    std::atomic<long>        sum(0);
+    std::vector<std::thread> thr;
+
+    // Every thread pushes and pops under contention, so that popped
+    // nodes are retired while other threads may still be reading them
+    for (int n = 0; n < threads; ++n)
+        thr.emplace_back([&] {
+            long s = 0, x;
+            for (long i = 1; i <= iterations; ++i) {
+                stack.push(i);
+                if (stack.pop(x)) s += x;
+            }
+            while (stack.pop(x)) s += x;
+            sum += s;
+        });
+    for (auto& t : thr)
+        t.join();
+
+    BOOST_REQUIRE(stack.empty());
+    BOOST_REQUIRE_EQUAL(threads * (iterations * (iterations+1) / 2), sum);
+    BOOST_REQUIRE_EQUAL(0, d.drain());
+}
@@ -42,6 +42,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/timer/timer.hpp>
 #endif
 #include <limits>
+#include <random>
+#include <functional>
+#include <utxx/time_val.hpp>
 
 using namespace utxx;
 
@@ -650,6 +653,282 @@ BOOST_AUTO_TEST_CASE( test_convert_ftoa )
     BOOST_CHECK_EQUAL("-123.82494", std::string(buf, 10));
 }
 
+BOOST_AUTO_TEST_CASE( test_convert_ftoa_shortest )
+{
+    char buf[32];
+    auto ftoa = [&](double f) { int n = ftoa_shortest(f, buf, sizeof(buf)); return std::string(buf, n); };
+
+    BOOST_CHECK_EQUAL("0.0",                     ftoa(0.0));
+    BOOST_CHECK_EQUAL("-0.0",                    ftoa(-0.0));
+    BOOST_CHECK_EQUAL("1.0",                     ftoa(1.0));
+    BOOST_CHECK_EQUAL("-25.0",                   ftoa(-25.0));
+    BOOST_CHECK_EQUAL("0.1",                     ftoa(0.1));
+    BOOST_CHECK_EQUAL("0.30000000000000004",     ftoa(0.1 + 0.2));
+    BOOST_CHECK_EQUAL("123.45",                  ftoa(123.45));
+    BOOST_CHECK_EQUAL("-0.0025",                 ftoa(-0.0025));
+    BOOST_CHECK_EQUAL("0.000001",                ftoa(1e-6));
+    BOOST_CHECK_EQUAL("1e-7",                    ftoa(1e-7));
+    BOOST_CHECK_EQUAL("2.5e-7",                  ftoa(2.5e-7));
+    BOOST_CHECK_EQUAL("1200000.0",               ftoa(1.2e6));
+    BOOST_CHECK_EQUAL("100000000000000000000.0", ftoa(1e20));
+    BOOST_CHECK_EQUAL("1e+21",                   ftoa(1e21));
+    BOOST_CHECK_EQUAL("9007199254740992.0",      ftoa(9007199254740992.0));
+    BOOST_CHECK_EQUAL("1.7976931348623157e+308", ftoa(std::numeric_limits<double>::max()));
+    BOOST_CHECK_EQUAL("2.2250738585072014e-308", ftoa(std::numeric_limits<double>::min()));
+    BOOST_CHECK_EQUAL("5e-324",                  ftoa(std::numeric_limits<double>::denorm_min()));
+    BOOST_CHECK_EQUAL("inf",                     ftoa(std::numeric_limits<double>::infinity()));
+    BOOST_CHECK_EQUAL("-inf",                    ftoa(-std::numeric_limits<double>::infinity()));
+    BOOST_CHECK_EQUAL("nan",                     ftoa(std::numeric_limits<double>::quiet_NaN()));
+    BOOST_CHECK_EQUAL("0.3333333333333333",      ftoa_shortest(1.0 / 3));
+
+    // Insufficient buffer
+    BOOST_CHECK_EQUAL(-1, ftoa_shortest(123.45, buf, 6));
+    BOOST_CHECK_EQUAL(6,  ftoa_shortest(123.45, buf, 7));
+    BOOST_CHECK_EQUAL("123.45", buf);
+
+    // Round trip of random numbers with the least number of digits
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 100000; ++i) {
+        union { uint64_t u; double d; } x;
+        x.u = rng();
+        if (std::isnan(x.d) || std::isinf(x.d))
+            continue;
+        int  n = ftoa_shortest(x.d, buf, sizeof(buf));
+        double r;
+        BOOST_REQUIRE(atof_exp(buf, buf + n, r) == buf + n);
+        BOOST_REQUIRE_EQUAL(x.d, r);
+        BOOST_REQUIRE_EQUAL(x.d, strtod(buf, nullptr));
+
+        // One less significant digit doesn't round trip
+        std::string digits;
+        for (auto p = buf; p != buf + n && *p != 'e'; ++p)
+            if (isdigit(*p))
+                digits += *p;
+        digits.erase(0, digits.find_first_not_of('0'));
+        digits.erase(digits.find_last_not_of('0') + 1);
+        if (digits.size() > 1) {
+            char s[32];
+            snprintf(s, sizeof(s), "%.*e", int(digits.size()) - 2, x.d);
+            BOOST_REQUIRE_NE(x.d, strtod(s, nullptr));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_atof )
+{
+    auto parse = [](const char* s, double& d) { return atof_exp(s, s + strlen(s), d) - s; };
+    double d;
+
+    BOOST_CHECK_EQUAL(4, parse("12.5", d));                  BOOST_CHECK_EQUAL(12.5,    d);
+    BOOST_CHECK_EQUAL(6, parse("  -0.5", d));                BOOST_CHECK_EQUAL(-0.5,    d);
+    BOOST_CHECK_EQUAL(4, parse("+.25", d));                  BOOST_CHECK_EQUAL(0.25,    d);
+    BOOST_CHECK_EQUAL(2, parse("7.", d));                    BOOST_CHECK_EQUAL(7.0,     d);
+    BOOST_CHECK_EQUAL(4, parse("1e-7", d));                  BOOST_CHECK_EQUAL(1e-7,    d);
+    BOOST_CHECK_EQUAL(7, parse("1.5E+10", d));               BOOST_CHECK_EQUAL(1.5e10,  d);
+    BOOST_CHECK_EQUAL(3, parse("100e", d));                  BOOST_CHECK_EQUAL(100.0,   d);
+    BOOST_CHECK_EQUAL(3, parse("2.5|3", d));                 BOOST_CHECK_EQUAL(2.5,     d);
+    BOOST_CHECK_EQUAL(6, parse("1e-400", d));                BOOST_CHECK_EQUAL(0.0,     d);
+    BOOST_CHECK_EQUAL(5, parse("1e400", d));
+    BOOST_CHECK(std::isinf(d));
+    BOOST_CHECK_EQUAL(0, parse("abc", d));
+    BOOST_CHECK_EQUAL(0, parse("  -", d));
+    BOOST_CHECK_EQUAL(0, parse(".", d));
+
+    // Exactly halfway cases and long mantissas
+    const char* s_tests[] = {
+        "9007199254740993",
+        "2.2250738585072011e-308",
+        "4.9406564584124654e-324",
+        "2.4703282292062328e-324",
+        "1.7976931348623158e308",
+        "0.1000000000000000055511151231257827021181583404541015625",
+        "123456789012345678901234567890",
+        "3.14159265358979323846264338327950288419716939937510",
+    };
+    for (auto s : s_tests) {
+        BOOST_CHECK_EQUAL(strlen(s), size_t(parse(s, d)));
+        BOOST_CHECK_EQUAL(strtod(s, nullptr), d);
+    }
+
+    // Agrees with the C library
+    std::mt19937_64 rng(2);
+    char buf[64];
+    for (int i = 0; i < 100000; ++i) {
+        union { uint64_t u; double d; } x;
+        x.u = rng();
+        if (std::isnan(x.d) || std::isinf(x.d))
+            continue;
+        int n = snprintf(buf, sizeof(buf), "%.*g", int(rng() % 20) + 1, x.d);
+        BOOST_REQUIRE_EQUAL(n, parse(buf, d));
+        BOOST_REQUIRE_EQUAL(strtod(buf, nullptr), d);
+    }
+
+    const char* fs = "0.1";
+    float f;
+    BOOST_CHECK(atof(fs, fs + 3, f) == fs + 3);
+    BOOST_CHECK_EQUAL(0.1f, f);
+
+    // atof() skips leading zeros and doesn't parse the exponent
+    auto parse_fixed = [](const char* s, double& d) { return atof(s, s + strlen(s), d) - s; };
+    BOOST_CHECK_EQUAL(7, parse_fixed("0012.25", d));         BOOST_CHECK_EQUAL(12.25,   d);
+    BOOST_CHECK_EQUAL(4, parse_fixed(" 000", d));            BOOST_CHECK_EQUAL(0.0,     d);
+    BOOST_CHECK_EQUAL(3, parse_fixed("1.5e3", d));           BOOST_CHECK_EQUAL(1.5,     d);
+    BOOST_CHECK_EQUAL(8, parse_fixed("-0.30000", d));        BOOST_CHECK_EQUAL(-0.3,    d);
+    BOOST_CHECK_EQUAL(0, parse_fixed("abc", d));
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_ftoa_atof_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+
+    // Mix of prices and arbitrary numbers
+    std::mt19937_64     rng(3);
+    std::vector<double> nums(1024);
+    for (size_t i = 0; i < nums.size(); ++i)
+        nums[i] = i % 2 ? double(rng() % 10000000) / 100 : double(rng() % 1000000) / 7;
+
+    std::vector<std::string> strs;
+    for (auto d : nums)
+        strs.push_back(ftoa_shortest(d));
+
+    char   buf[32];
+    long   sum = 0;
+    double res = 0, d;
+    auto   run = [&](const char* a_name, std::function<void(long)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            a_fun(i & 1023);
+        BOOST_TEST_MESSAGE((boost::format("%-22s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    run("ftoa_shortest",      [&](long i) { sum += ftoa_shortest(nums[i], buf, sizeof(buf)); });
+    run("snprintf(%.17g)",    [&](long i) { sum += snprintf(buf, sizeof(buf), "%.17g", nums[i]); });
+    run("ftoa_left(prec=6)",  [&](long i) { sum += ftoa_left(nums[i], buf, sizeof(buf), 6); });
+    run("snprintf(%.6f)",     [&](long i) { sum += snprintf(buf, sizeof(buf), "%.6f", nums[i]); });
+    run("atof",               [&](long i) {
+        auto& s = strs[i]; atof(s.c_str(), s.c_str() + s.size(), d); res += d; });
+    run("strtod",             [&](long i) { res += strtod(strs[i].c_str(), nullptr); });
+
+    BOOST_CHECK(sum > 0 && res > 0);
+}
+
+namespace {
+    template <int N>
+    void check_fixed_digits(std::mt19937_64& a_rng, bool a_simd) {
+        const char s_bad[] = { '/', ':', ' ', '-', '.', 'a', '\0', char(0x80), char(0xB0) };
+        char buf[N];
+        for (int i = 0; i < 10000; ++i) {
+            uint64_t n = a_rng() % detail::cs_pow10_u64[N];
+            BOOST_REQUIRE(utoa_fixed<N>(buf, n) == buf + N);
+            uint64_t v = ~0ul;
+            BOOST_REQUIRE(detail::fixed_digits<N>::parse(buf, v, a_simd));
+            BOOST_REQUIRE_EQUAL(n, v);
+            // Any non-digit character invalidates the field
+            int  pos = a_rng() % N;
+            char c   = buf[pos];
+            buf[pos] = s_bad[a_rng() % sizeof(s_bad)];
+            BOOST_REQUIRE(!detail::fixed_digits<N>::parse(buf, v, a_simd));
+            buf[pos] = c;
+        }
+    }
+
+    template <int... N>
+    void check_fixed_digits(bool a_simd) {
+        std::mt19937_64 rng(5);
+        int dummy[] = { (check_fixed_digits<N>(rng, a_simd), 0)... };
+        (void)dummy;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_fixed_digits )
+{
+    uint64_t v;
+    BOOST_CHECK(atoul_fixed<1>("7", v));                     BOOST_CHECK_EQUAL(7u, v);
+    BOOST_CHECK(atoul_fixed<6>("000120", v));                BOOST_CHECK_EQUAL(120u, v);
+    BOOST_CHECK(atoul_fixed<16>("0123456789012345", v));     BOOST_CHECK_EQUAL(123456789012345ul, v);
+    BOOST_CHECK(atoul_fixed<19>("9999999999999999999", v));  BOOST_CHECK_EQUAL(9999999999999999999ul, v);
+    BOOST_CHECK(!atoul_fixed<6>(" 00120", v));
+    BOOST_CHECK(!atoul_fixed<12>("00012345678x", v));
+
+    char buf[21];
+    BOOST_CHECK_EQUAL("0000012345", std::string(buf, utoa_fixed<10>(buf, 12345)));
+    BOOST_CHECK_EQUAL("0",          std::string(buf, utoa_fixed<1>(buf, 0)));
+    BOOST_CHECK_EQUAL("18446744073709551615",
+                      std::string(buf, utoa_fixed<20>(buf, ~0ul)));
+
+    check_fixed_digits<1,2,3,5,7,8,9,11,13,15,16,17,18,19>(false);
+    if (detail::has_sse41())
+        check_fixed_digits<1,2,3,5,7,8,9,11,13,15,16,17,18,19>(true);
+    else
+        BOOST_TEST_MESSAGE("SSE4.1 is not supported - skipped SIMD kernel tests");
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_itoa10 )
+{
+    char buf[24];
+    auto str = [&](char* e) { return std::string(buf, e); };
+
+    BOOST_CHECK_EQUAL("0",          str(itoa10(0, buf)));
+    BOOST_CHECK_EQUAL("9",          str(itoa10(9u, buf)));
+    BOOST_CHECK_EQUAL("10",         str(itoa10(10l, buf)));
+    BOOST_CHECK_EQUAL("-128",       str(itoa10(int8_t(-128), buf)));
+    BOOST_CHECK_EQUAL("65535",      str(itoa10(uint16_t(65535), buf)));
+    BOOST_CHECK_EQUAL("-2147483648",str(itoa10(std::numeric_limits<int>::min(), buf)));
+    BOOST_CHECK_EQUAL("-9223372036854775808",
+                      str(itoa10(std::numeric_limits<int64_t>::min(), buf)));
+    BOOST_CHECK_EQUAL("18446744073709551615",
+                      str(itoa10(std::numeric_limits<uint64_t>::max(), buf)));
+    BOOST_CHECK_EQUAL("-42",        int_to_string(-42));
+
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        int64_t n = int64_t(rng()) >> (rng() % 64);
+        BOOST_REQUIRE_EQUAL(std::to_string(n), str(itoa10(n, buf)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_convert_fixed_digits_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+
+    std::mt19937_64       rng(9);
+    std::vector<uint64_t> nums(1024);
+    std::vector<char>     strs(nums.size() * 16);
+    for (size_t i = 0; i < nums.size(); ++i) {
+        nums[i] = rng() % 10000000000000000ul;
+        utoa_fixed<16>(&strs[i * 16], nums[i]);
+    }
+
+    char     buf[32];
+    uint64_t sum = 0, v;
+    auto     run = [&](const char* a_name, std::function<void(long)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            a_fun(i & 1023);
+        BOOST_TEST_MESSAGE((boost::format("%-26s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    bool simd = detail::has_sse41();
+    run("atoul_fixed<16>",          [&](long i) { atoul_fixed<16>(&strs[i*16], v); sum += v; });
+    run("atoul_fixed<16> (scalar)", [&](long i) {
+        detail::fixed_digits<16>::parse(&strs[i*16], v, false); sum += v; });
+    run("atoul_fixed<8>",           [&](long i) { atoul_fixed<8>(&strs[i*16], v); sum += v; });
+    run("unsafe_fixed_atoul<16>",   [&](long i) {
+        const char* p = &strs[i*16]; sum += unsafe_fixed_atoul<16>(p); });
+    run("atoi_left<16>",            [&](long i) {
+        atoi_left<uint64_t, 16>(&strs[i*16], v); sum += v; });
+    run("utoa_fixed<16>",           [&](long i) { sum += *utoa_fixed<16>(buf, nums[i]); });
+    run("itoa_right<16>",           [&](long i) {
+        sum += *itoa_right<uint64_t, 16>(buf, nums[i], '0'); });
+    run("itoa10",                   [&](long i) { sum += *itoa10(nums[i], buf); });
+    run("snprintf(%lu)",            [&](long i) { sum += snprintf(buf, sizeof(buf), "%lu", nums[i]); });
+
+    BOOST_TEST_MESSAGE("SIMD kernels: " << (simd ? "SSE4.1" : "none"));
+    BOOST_CHECK(sum > 0);
+}
+
 BOOST_AUTO_TEST_CASE( test_convert_itoa_right_string )
 {
     BOOST_REQUIRE_EQUAL("0001", (itoa_right<int, 4>(1, '0')));
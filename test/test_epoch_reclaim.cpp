@@ -0,0 +1,182 @@
+//----------------------------------------------------------------------------
+/// \file  test_epoch_reclaim.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases for epoch_reclaim.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/epoch_reclaim.hpp>
+#include <utxx/container/concurrent_fifo.hpp>
+#include <utxx/time_val.hpp>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+using namespace utxx::memory;
+
+namespace {
+    std::atomic<long> s_live(0);
+
+    struct tracked {
+        long value;
+        explicit tracked(long v = 0) : value(v) { ++s_live; }
+        ~tracked() { --s_live; }
+    };
+}
+
+BOOST_AUTO_TEST_CASE( test_epoch_reclaim )
+{
+    s_live = 0;
+    long disposed = 0;
+    {
+        epoch_domain d;
+        auto e = d.epoch();
+
+        {
+            epoch_domain::guard g(d);
+            // Nested guards are allowed
+            { epoch_domain::guard g2(d); }
+
+            for (int i = 0; i < epoch_domain::s_bag_size; ++i)
+                d.retire(new tracked(i));
+
+            // The bag was sealed but the pinned thread prevents the epoch
+            // from advancing far enough to reclaim it
+            BOOST_CHECK_EQUAL(epoch_domain::s_bag_size, d.pending());
+            BOOST_CHECK_EQUAL(0, d.collect());
+            BOOST_CHECK_EQUAL(0, d.collect());
+            BOOST_CHECK_EQUAL(epoch_domain::s_bag_size, s_live);
+            BOOST_CHECK(d.epoch() <= e + 1);
+        }
+
+        BOOST_CHECK_EQUAL(0, d.drain());
+        BOOST_CHECK_EQUAL(0, s_live);
+        BOOST_CHECK(d.epoch() >= e + 2);
+
+        // Partially filled bags are collected after a flush
+        for (int i = 0; i < 10; ++i)
+            d.retire(new tracked(i));
+        BOOST_CHECK_EQUAL(0, d.pending());
+        d.flush();
+        BOOST_CHECK_EQUAL(10, d.pending());
+        BOOST_CHECK_EQUAL(0, d.drain());
+        BOOST_CHECK_EQUAL(0, s_live);
+
+        // Custom deleter with a context
+        d.retire(new tracked(1), [](void* ctx, void* p) {
+            ++*static_cast<long*>(ctx);
+            delete static_cast<tracked*>(p);
+        }, &disposed);
+
+        // Retire bags of exiting threads are handed over to the domain
+        std::thread([&] {
+            for (int i = 0; i < 5; ++i)
+                d.retire(new tracked(i));
+        }).join();
+        BOOST_CHECK_EQUAL(5, d.pending());
+        d.drain();
+        BOOST_CHECK_EQUAL(1, s_live);
+        BOOST_CHECK_EQUAL(0, disposed);
+    }
+    // Remaining objects are disposed of by the domain's destructor
+    BOOST_CHECK_EQUAL(0, s_live);
+    BOOST_CHECK_EQUAL(1, disposed);
+}
+
+BOOST_AUTO_TEST_CASE( test_epoch_reclaim_background )
+{
+    s_live = 0;
+    epoch_domain d;
+    d.start_reclaimer(100);
+
+    const int N = 100 * epoch_domain::s_bag_size;
+    std::vector<std::thread> threads;
+    for (int n = 0; n < 4; ++n)
+        threads.emplace_back([&] {
+            for (int i = 0; i < N; ++i) {
+                epoch_domain::guard g(d);
+                d.retire(new tracked(i));
+            }
+        });
+    for (auto& t : threads)
+        t.join();
+
+    // The reclaimer disposes of all sealed bags without further retirements
+    for (int i = 0; i < 1000 && d.pending() > 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    BOOST_CHECK_EQUAL(0, d.pending());
+    BOOST_CHECK_EQUAL(0, s_live);
+    d.stop_reclaimer();
+}
+
+BOOST_AUTO_TEST_CASE( test_epoch_reclaim_queue )
+{
+    typedef container::reclaiming_lock_free_queue<long> queue_t;
+
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 2;
+
+    queue_t                  queue;
+    std::atomic<long>        sum(0), count(0);
+    std::vector<std::thread> threads;
+
+    timer t;
+    for (int n = 0; n < THREADS; ++n) {
+        threads.emplace_back([&] {
+            for (long i = 1; i <= ITERATIONS; ++i)
+                queue.enqueue(i);
+        });
+        threads.emplace_back([&] {
+            long v, s = 0;
+            while (count.load(std::memory_order_relaxed) < THREADS * ITERATIONS)
+                if (queue.dequeue(v)) {
+                    s += v;
+                    ++count;
+                }
+            sum += s;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    double elapsed = t.elapsed();
+
+    BOOST_CHECK(queue.empty());
+    BOOST_CHECK_EQUAL(THREADS * (ITERATIONS * (ITERATIONS + 1) / 2), sum);
+
+    // Dequeued nodes were returned to the heap rather than cached
+    auto& d = epoch_domain::global();
+    d.flush();
+    BOOST_CHECK_EQUAL(0, d.drain());
+
+    BOOST_TEST_MESSAGE(
+        (boost::format("reclaiming_lock_free_queue (%d+%d threads): %.1f ns/op")
+            % THREADS % THREADS % (1e9 * elapsed / (2.0 * THREADS * ITERATIONS))).str());
+}
@@ -37,8 +37,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/test/unit_test.hpp>
 #include <utxx/futex.hpp>
 #include <utxx/timestamp.hpp>
+#include <utxx/time_val.hpp>
 #include <utxx/verbosity.hpp>
+#include <boost/format.hpp>
 #include <thread>
+#include <vector>
 
 // Compile with:
 //   make CPPFLAGS="-DDEBUG_ASYNC_LOGGER=2 -DPERF_STATS" -j3
@@ -125,4 +128,202 @@ BOOST_AUTO_TEST_CASE( test_futex )
     BOOST_REQUIRE(true);
 }
 
+namespace {
+    template <class Mutex>
+    double run_mutex_bench(Mutex& a_mutex, int a_threads, long a_iterations,
+                           long& a_counter)
+    {
+        std::vector<std::thread> threads;
+        timer t;
+        for (int n = 0; n < a_threads; ++n)
+            threads.emplace_back([&] {
+                for (long i = 0; i < a_iterations; ++i) {
+                    std::lock_guard<Mutex> g(a_mutex);
+                    ++a_counter;
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        return t.elapsed();
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_futex_adaptive_mutex )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 4;
+
+    {
+        adaptive_stats_mutex m;
+        BOOST_CHECK(!m.locked());
+        BOOST_CHECK(m.try_lock());
+        BOOST_CHECK(m.locked());
+        BOOST_CHECK(!m.try_lock());
+        m.unlock();
+
+        // A waiter that can't acquire the lock by spinning parks on the futex
+        std::atomic<bool> started(false);
+        m.lock();
+        std::thread th([&] { started = true; m.lock(); m.unlock(); });
+        while (!started)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        m.unlock();
+        th.join();
+
+        // Whether the waiter got to lock() before unlock() depends on
+        // scheduling, so the contention stats are only checked if it did
+        auto st = m.stats();
+        BOOST_CHECK_EQUAL(3u, st.acquisitions);
+        BOOST_CHECK(!m.locked());
+        BOOST_CHECK(st.contended <= 1u);
+        if (st.contended) {
+            BOOST_CHECK(st.parks >= 1u);
+            BOOST_CHECK(st.wait_ns > 0);
+        }
+        BOOST_CHECK(m.spin_count() >= 0 && m.spin_count() <= adaptive_mutex::s_max_spin);
+
+        m.reset_stats();
+        BOOST_CHECK_EQUAL(0u, m.stats().acquisitions);
+    }
+
+    long c1 = 0, c2 = 0, c3 = 0;
+    adaptive_mutex       m1;
+    adaptive_stats_mutex m2;
+    std::mutex           m3;
+    double e1 = run_mutex_bench(m1, THREADS, ITERATIONS, c1);
+    double e2 = run_mutex_bench(m2, THREADS, ITERATIONS, c2);
+    double e3 = run_mutex_bench(m3, THREADS, ITERATIONS, c3);
+
+    BOOST_CHECK_EQUAL(THREADS * ITERATIONS, c1);
+    BOOST_CHECK_EQUAL(THREADS * ITERATIONS, c2);
+    BOOST_CHECK_EQUAL(THREADS * ITERATIONS, c3);
+
+    auto st = m2.stats();
+    BOOST_CHECK_EQUAL((unsigned long)(THREADS * ITERATIONS), st.acquisitions);
+
+    auto ops = double(THREADS * ITERATIONS);
+    BOOST_TEST_MESSAGE(
+        (boost::format("adaptive_mutex       (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * e1 / ops)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("adaptive_stats_mutex (%d threads): %.1f ns/op "
+                       "(contended=%lu, spins=%lu, parks=%lu, wait=%.1fus, budget=%d)")
+            % THREADS % (1e9 * e2 / ops) % st.contended % st.spins % st.parks
+            % (st.wait_ns / 1000.0) % m2.spin_count()).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("std::mutex           (%d threads): %.1f ns/op")
+            % THREADS % (1e9 * e3 / ops)).str());
+}
+
+BOOST_AUTO_TEST_CASE( test_futex_event_group )
+{
+    futex_event_group g;
+
+    // Signals are latched until consumed
+    BOOST_CHECK_EQUAL(0, g.signal(futex_event_group::mask(3)));
+    BOOST_CHECK_EQUAL(futex_event_group::mask(3), g.pending());
+    BOOST_CHECK_EQUAL(0u, g.try_wait(futex_event_group::mask(1)));
+    BOOST_CHECK_EQUAL(futex_event_group::mask(3), g.try_wait());
+    BOOST_CHECK_EQUAL(0u, g.pending());
+    BOOST_CHECK_EQUAL(0u, g.wait(futex_event_group::mask(0), std::chrono::milliseconds(10)));
+
+    // Each worker waits for its own event, and only the targeted ones wake up
+    const int N = 8;
+    std::atomic<int>  wakeups[N];
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N; ++i) {
+        wakeups[i] = 0;
+        threads.emplace_back([&, i] {
+            while (true) {
+                g.wait(futex_event_group::mask(i));
+                if (stop) break;
+                ++wakeups[i];
+            }
+        });
+    }
+
+    const uint32_t odd = 0xAA;
+    g.signal(odd);
+    for (int i = 0; i < 1000; ++i) {
+        int n = 0;
+        for (int j = 1; j < N; j += 2) n += wakeups[j];
+        if (n == N/2) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < N; ++i)
+        BOOST_CHECK_EQUAL(i & 1, wakeups[i]);
+    BOOST_CHECK_EQUAL(0u, g.pending());
+
+    stop = true;
+    g.signal((1u << N) - 1);
+    for (auto& th : threads)
+        th.join();
+    BOOST_CHECK_EQUAL(0, g.waiters());
+}
+
+namespace {
+    /// Fan out ITERATIONS rounds of events to a_threads workers, and wait for
+    /// all of them to acknowledge each round
+    template <class Signal, class Wait>
+    double run_fanout_bench(int a_threads, long a_iterations,
+                            Signal&& a_signal, Wait&& a_wait)
+    {
+        futex_event_group        done;
+        std::atomic<bool>        stop(false);
+        std::vector<std::thread> threads;
+        const uint32_t           all = a_threads == 32 ? ~0u : (1u << a_threads) - 1;
+
+        for (int i = 0; i < a_threads; ++i)
+            threads.emplace_back([&, i] {
+                while (true) {
+                    a_wait(i);
+                    if (stop) break;
+                    done.signal(futex_event_group::mask(i));
+                }
+            });
+
+        timer t;
+        for (long n = 0; n < a_iterations; ++n) {
+            a_signal(all);
+            for (uint32_t got = 0; got != all; got |= done.wait(all));
+        }
+        double elapsed = t.elapsed();
+
+        stop = true;
+        a_signal(all);
+        for (auto& th : threads)
+            th.join();
+        return elapsed;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_futex_event_group_perf )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 10000;
+    const int  THREADS    = std::min(32, getenv("THREADS") ? atoi(getenv("THREADS")) : 8);
+
+    futex_event_group group;
+    double e1 = run_fanout_bench(THREADS, ITERATIONS,
+        [&](uint32_t mask) { group.signal(mask); },
+        [&](int i)         { group.wait(futex_event_group::mask(i)); });
+
+    std::vector<futex_event_group> events(THREADS);
+    double e2 = run_fanout_bench(THREADS, ITERATIONS,
+        [&](uint32_t mask) {
+            for (int i = 0; i < THREADS; ++i)
+                if (mask & futex_event_group::mask(i))
+                    events[i].signal(1);
+        },
+        [&](int i)         { events[i].wait(1); });
+
+    BOOST_TEST_MESSAGE(
+        (boost::format("futex_event_group fan-out (%d threads): %.1f us/round")
+            % THREADS % (1e6 * e1 / ITERATIONS)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("per-thread futex  fan-out (%d threads): %.1f us/round")
+            % THREADS % (1e6 * e2 / ITERATIONS)).str());
+}
+
 #endif
@@ -0,0 +1,247 @@
+//----------------------------------------------------------------------------
+/// \file  test_hdr_histogram.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for hdr_histogram.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/hdr_histogram.hpp>
+#include <utxx/thread_cached_stat.hpp>
+#include <utxx/error.hpp>
+#include <utxx/time_val.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+
+namespace {
+    // Latencies in nanoseconds with a long tail
+    std::vector<int64_t> latencies(size_t a_count, unsigned a_seed = 1) {
+        std::mt19937_64                  rng(a_seed);
+        std::lognormal_distribution<>    dist(9.0, 1.5);
+        std::vector<int64_t>             res(a_count);
+        for (auto& v : res)
+            v = int64_t(dist(rng));
+        return res;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_config )
+{
+    hdr_histogram h;
+    BOOST_CHECK_EQUAL(1,                   h.lowest());
+    BOOST_CHECK_EQUAL(3600 * 1000000000L,  h.highest());
+    BOOST_CHECK_EQUAL(3,                   h.digits());
+    BOOST_CHECK_EQUAL(2048,                h.sub_buckets());
+    BOOST_CHECK_EQUAL(32,                  h.bucket_count());
+    BOOST_CHECK_EQUAL(33u * 1024,          h.counts_size());
+
+    hdr_histogram h2(1000, 1000000000L, 2);
+    BOOST_CHECK_EQUAL(256,                 h2.sub_buckets());
+
+    BOOST_CHECK_THROW(hdr_histogram(0, 100, 3),  badarg_error);
+    BOOST_CHECK_THROW(hdr_histogram(10, 15, 3),  badarg_error);
+    BOOST_CHECK_THROW(hdr_histogram(1, 100, 6),  badarg_error);
+
+    // Empty histogram
+    BOOST_CHECK_EQUAL(0, h.total_count());
+    BOOST_CHECK_EQUAL(0, h.max());
+    BOOST_CHECK_EQUAL(0, h.value_at_percentile(99));
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_precision )
+{
+    hdr_histogram   h;
+    std::mt19937_64 rng(1);
+
+    // Values up to 2048 are exact, and the width of the range of values
+    // counted together is within 10^-3 of the value
+    for (int64_t v = 0; v < 2048; ++v)
+        BOOST_REQUIRE_EQUAL(v, h.highest_equivalent(v));
+    for (int i = 0; i < 100000; ++i) {
+        auto v  = int64_t(rng() % h.highest());
+        auto lo = h.lowest_equivalent(v), hi = h.highest_equivalent(v);
+        if (lo > v || hi < v || hi - lo >= std::max<int64_t>(1, v / 1000) ||
+            h.lowest_equivalent(hi + 1) != hi + 1)
+            BOOST_REQUIRE_MESSAGE(false, v << ": [" << lo << ", " << hi << ']');
+    }
+
+    // Out of range values are clamped
+    h.add(-5);
+    h.add(h.highest() * 2);
+    BOOST_CHECK_EQUAL(1, h.count_at_value(0));
+    BOOST_CHECK_EQUAL(1, h.count_at_value(h.highest()));
+    BOOST_CHECK_EQUAL(h.highest_equivalent(h.highest()), h.max());
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_percentiles )
+{
+    auto          v = latencies(1000000);
+    hdr_histogram h;
+    for (auto x : v)
+        h.add(x);
+
+    BOOST_CHECK_EQUAL(int64_t(v.size()), h.total_count());
+
+    std::sort(v.begin(), v.end());
+    BOOST_CHECK_EQUAL(h.lowest_equivalent(v.front()), h.min());
+    BOOST_CHECK_EQUAL(h.highest_equivalent(v.back()), h.max());
+
+    // The percentile is the highest value equivalent to the value at its rank
+    for (double p : {0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 99.99, 99.999, 100.0}) {
+        auto rank = std::max<size_t>(1, size_t(p / 100 * v.size() + 0.5));
+        BOOST_CHECK_MESSAGE(h.value_at_percentile(p) == h.highest_equivalent(v[rank-1]),
+                            "p" << p << ": " << h.value_at_percentile(p)
+                            << " != " << v[rank-1]);
+    }
+
+    double sum = 0;
+    for (auto x : v) sum += x;
+    BOOST_CHECK_CLOSE(sum / v.size(), h.mean(), 0.1);
+
+    auto s = h.to_string(5, 1000.0);
+    BOOST_TEST_MESSAGE("Latency distribution (us):\n" << s);
+    // Report points reach past p99.99
+    BOOST_CHECK(s.find(" 0.99990") != std::string::npos);
+    BOOST_CHECK(s.find(" 1.000000000000    1000000\n") != std::string::npos);
+    BOOST_CHECK(s.find("#[Buckets =           32, SubBuckets     =         2048]")
+                != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_merge )
+{
+    auto          v = latencies(100000);
+    hdr_histogram all, a, b;
+    hdr_histogram c(1, 1000000, 3);         // Same layout, shorter range
+    hdr_histogram d(100, 3600 * 1000000000L, 2);
+
+    for (size_t i = 0; i < v.size(); ++i) {
+        all.add(v[i]);
+        (i & 1 ? a : b).add(v[i]);
+    }
+    a += b;
+    for (auto p : {50.0, 99.0, 99.9, 100.0})
+        BOOST_CHECK_EQUAL(all.value_at_percentile(p), a.value_at_percentile(p));
+
+    // Merging histograms of different ranges and precision
+    c += all;
+    BOOST_CHECK_EQUAL(all.total_count(), c.total_count());
+    BOOST_CHECK_EQUAL(c.highest_equivalent(c.highest()), c.max());
+    d += all;
+    BOOST_CHECK_EQUAL(all.total_count(), d.total_count());
+    BOOST_CHECK_EQUAL(d.highest_equivalent(all.value_at_percentile(99)),
+                      d.value_at_percentile(99));
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_concurrent )
+{
+    const int     THREADS = 4;
+    const int     N       = 250000;
+    hdr_histogram h;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; ++i)
+        threads.emplace_back([&, i] {
+            for (auto x : latencies(N, i + 1))
+                h.add_atomic(x);
+        });
+    for (auto& t : threads) t.join();
+    BOOST_CHECK_EQUAL(THREADS * N, h.total_count());
+
+    // Per-thread histograms merged on demand
+    thread_cached_hdr_histogram<> th;
+    threads.clear();
+    for (int i = 0; i < THREADS; ++i)
+        threads.emplace_back([&, i] {
+            for (auto x : latencies(N, i + 1))
+                th.add(x);
+        });
+    for (auto& t : threads) t.join();
+    auto m = th.read();
+    BOOST_CHECK_EQUAL(THREADS * N, m.total_count());
+    for (auto p : {50.0, 99.9, 99.99})
+        BOOST_CHECK_EQUAL(h.value_at_percentile(p), m.value_at_percentile(p));
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_encode )
+{
+    hdr_histogram h(1, 3600 * 1000000000L, 3);
+    for (auto x : latencies(100000))
+        h.add(x);
+
+    auto s = h.encode();
+    BOOST_TEST_MESSAGE("Encoded " << h.counts_size() * 8 << " bytes to " << s.size());
+  #ifdef UTXX_HAVE_LIBZ
+    BOOST_CHECK_EQUAL("HISTFAAA", s.substr(0, 8));
+  #endif
+
+    auto d = hdr_histogram::decode(s);
+    BOOST_CHECK_EQUAL(h.lowest(),  d.lowest());
+    BOOST_CHECK_EQUAL(h.highest(), d.highest());
+    BOOST_CHECK_EQUAL(h.digits(),  d.digits());
+    BOOST_CHECK_EQUAL(h.total_count(), d.total_count());
+    BOOST_CHECK(h.to_string() == d.to_string());
+
+    hdr_histogram e(10, 100000, 1);
+    BOOST_CHECK_EQUAL(0, hdr_histogram::decode(e.encode()).total_count());
+
+    BOOST_CHECK_THROW(hdr_histogram::decode("not base64!"), runtime_error);
+    BOOST_CHECK_THROW(hdr_histogram::decode("SElTVEZBQUE="), runtime_error);
+    BOOST_CHECK_THROW(hdr_histogram::decode(s.substr(0, s.size() / 2)), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_hdr_histogram_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 1000000;
+
+    auto           v = latencies(4096);
+    hdr_histogram  h;
+    perf_histogram ph;
+
+    auto run = [&](const char* a_name, std::function<void(int64_t)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            a_fun(v[i & 4095]);
+        BOOST_TEST_MESSAGE((boost::format("%-26s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    run("hdr_histogram::add",        [&](int64_t x) { h.add(x);        });
+    run("hdr_histogram::add_atomic", [&](int64_t x) { h.add_atomic(x); });
+    run("perf_histogram::add",       [&](int64_t x) { ph.add(double(x) * 1e-9); });
+
+    timer t;
+    auto  p = h.value_at_percentile(99.99);
+    BOOST_TEST_MESSAGE((boost::format("%-26s: %6.1f us") % "value_at_percentile"
+                        % t.elapsed_usec()).str());
+    BOOST_CHECK(p > 0);
+    BOOST_CHECK_EQUAL(2 * ITERATIONS, h.total_count());
+}
@@ -143,3 +143,15 @@ BOOST_AUTO_TEST_CASE( cpu_calibration )
     }
 }
 
+BOOST_AUTO_TEST_CASE( test_high_res_timer_tsc )
+{
+    high_res_timer timer;
+    timer.start();
+    ::usleep(10000);
+    timer.stop();
+    BOOST_CHECK(timer.elapsed_nsec_tsc() >=   9000000u);
+    BOOST_CHECK(timer.elapsed_nsec_tsc() <  1000000000u);
+
+    auto diff = (high_res_timer::now_tsc() - now_utc()).nanoseconds();
+    BOOST_CHECK(std::abs(diff) < 10000000);
+}
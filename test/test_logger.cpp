@@ -180,6 +180,7 @@ BOOST_AUTO_TEST_CASE( test_logger1 )
         LOG_WARNING("This is a %d %s", i, "warning");
         LOG_FATAL  ("This is a %d %s", i, "fatal error");
         LOG_INFO   ("This is a %d %s", i, "info");
+        LOG_INFO   (UTXX_FMT("This is a {} {} #{:04} @ {:.2f}"), i, "info", 789, 1.5);
         test::inner::log(i);
     }
 
@@ -257,6 +258,78 @@ BOOST_AUTO_TEST_CASE( test_logger2 )
 
     log.finalize();
 }
+
+BOOST_AUTO_TEST_CASE( test_logger_thread_placement )
+{
+    // Pin to a CPU available to the process (not necessarily CPU 0)
+    auto avail = os::thread_affinity();
+    BOOST_REQUIRE(!avail.empty());
+    int  cpu   = avail.front();
+
+    variant_tree pt;
+    pt.put("logger.ident",                 variant("my-logger"));
+    pt.put("logger.silent-finish",         true);
+    pt.put("logger.thread.name",           variant("log-thread"));
+    pt.put("logger.thread.cpus",           variant(std::to_string(cpu)));
+    pt.put("logger.thread.sched-policy",   variant("batch"));
+
+    logger& log = logger::instance();
+    if (log.initialized())
+        log.finalize();
+
+    std::string      name;
+    std::vector<int> cpus;
+    log.set_on_after_run([&] {
+        name = os::thread_name();
+        cpus = os::thread_affinity();
+    });
+
+    log.init(pt);
+    BOOST_CHECK_EQUAL("log-thread", log.thread_placement().name);
+    BOOST_CHECK(os::sched_policy::BATCH == log.thread_placement().policy);
+    log.finalize();
+    log.set_on_after_run(nullptr);
+    log.set_thread_placement(os::thread_placement());
+
+    BOOST_CHECK_EQUAL("log-thread", name);
+    BOOST_CHECK(cpus == std::vector<int>{cpu});
+}
+
+BOOST_AUTO_TEST_CASE( test_logger_clock )
+{
+    variant_tree pt;
+    pt.put("logger.silent-finish",         true);
+    pt.put("logger.clock",                 variant("tsc"));
+
+    logger& log = logger::instance();
+    if (log.initialized())
+        log.finalize();
+
+    log.init(pt);
+    BOOST_CHECK(clock_source::TSC == log.time_source());
+    BOOST_CHECK(!tsc_clock::instance().tsc() || tsc_clock::instance().syncing());
+    BOOST_CHECK(std::abs((log.now() - now_utc()).microseconds()) < 10000);
+    log.finalize();
+    log.time_source(clock_source::REALTIME);
+}
+
+BOOST_AUTO_TEST_CASE( test_logger_timezone )
+{
+    variant_tree pt;
+    pt.put("logger.silent-finish",         true);
+    pt.put("logger.timezone",              variant("JST-9"));
+
+    logger& log = logger::instance();
+    if (log.initialized())
+        log.finalize();
+
+    log.init(pt);
+    BOOST_REQUIRE(log.timestamp_zone());
+    BOOST_CHECK_EQUAL("JST-9", log.timestamp_zone()->name());
+    BOOST_CHECK_EQUAL(9*3600,  log.timestamp_zone()->utc_offset(now_utc().sec()));
+    log.finalize();
+    log.timestamp_zone(nullptr);
+}
 #endif
 
 #ifdef UTXX_STANDALONE
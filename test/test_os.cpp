@@ -32,7 +32,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <boost/test/unit_test.hpp>
 #include <utxx/os.hpp>
+#include <utxx/cpu.hpp>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <sys/stat.h>
 
 using namespace std;
 using namespace utxx;
@@ -43,4 +48,104 @@ BOOST_AUTO_TEST_CASE( test_os )
     auto username = os::username();
 
     BOOST_REQUIRE_EQUAL(user, username);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE( test_os_cpu_list )
+{
+    auto v = os::parse_cpu_list("0-3,8,10-11\n");
+    BOOST_CHECK_EQUAL(7u, v.size());
+    BOOST_CHECK_EQUAL(8,  v[4]);
+    BOOST_CHECK_EQUAL("0-3,8,10-11", os::format_cpu_list(v));
+    BOOST_CHECK_EQUAL("1-2,5", os::format_cpu_list({5, 2, 1, 2}));
+    BOOST_CHECK(os::parse_cpu_list("").empty());
+    BOOST_CHECK_THROW(os::parse_cpu_list("1-"),  badarg_error);
+    BOOST_CHECK_THROW(os::parse_cpu_list("3-1"), badarg_error);
+    BOOST_CHECK_THROW(os::parse_cpu_list("a"),   badarg_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_os_thread_placement )
+{
+    // Boost.Test assertions aren't thread-safe, so the results are checked
+    // after the thread is joined
+    std::string      short_name, name;
+    std::vector<int> cpus, placed;
+    bool             placement_empty = true;
+    int              rt_rejected = 0;
+    bool             batch_ok = false;
+
+    std::thread th([&] {
+        os::set_thread_name("test-placement-thread");
+        short_name = os::thread_name();
+
+        cpus = os::thread_affinity();
+        if (cpus.empty())
+            return;
+        os::thread_placement tp("worker", std::to_string(cpus.front()));
+        placement_empty = tp.empty();
+        tp.apply();
+        name   = os::thread_name();
+        placed = os::thread_affinity();
+
+        // Real-time priorities above the safety limit are rejected
+        for (int prio : {90, 0})
+            try { os::set_thread_scheduling(os::sched_policy::FIFO, prio); }
+            catch (badarg_error&) { ++rt_rejected; }
+        try { os::set_thread_scheduling(os::sched_policy::BATCH); batch_ok = true; }
+        catch (...) {}
+    });
+    th.join();
+
+    BOOST_CHECK_EQUAL("test-placemen", short_name.substr(0, 13));
+    BOOST_CHECK_EQUAL(15u, short_name.size());
+    BOOST_REQUIRE(!cpus.empty());
+    BOOST_CHECK(!placement_empty);
+    BOOST_CHECK_EQUAL("worker", name);
+    BOOST_CHECK(placed == std::vector<int>{cpus.front()});
+    BOOST_CHECK_EQUAL(2, rt_rejected);
+    BOOST_CHECK(batch_ok);
+    BOOST_CHECK(os::sched_policy::RR == os::parse_sched_policy("RR"));
+    BOOST_CHECK_THROW(os::parse_sched_policy("xxx"), badarg_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_os_cpu_topology )
+{
+    // Fake sysfs of a 2-core host with hyperthreading and 2 NUMA nodes
+    char tmpl[] = "/tmp/utxx-sysfs-XXXXXX";
+    BOOST_REQUIRE(mkdtemp(tmpl));
+    std::string root(tmpl);
+    auto write = [](const std::string& file, const std::string& val) {
+        std::ofstream(file) << val << '\n';
+    };
+    write(root + "/online",   "0-3");
+    write(root + "/isolated", "3");
+    for (int i = 0; i < 4; ++i) {
+        auto dir = root + "/cpu" + std::to_string(i);
+        BOOST_REQUIRE_EQUAL(0, mkdir(dir.c_str(), 0755));
+        BOOST_REQUIRE_EQUAL(0, mkdir((dir + "/topology").c_str(), 0755));
+        BOOST_REQUIRE_EQUAL(0, mkdir((dir + "/node" + std::to_string(i / 2)).c_str(), 0755));
+        write(dir + "/topology/core_id", std::to_string(i % 2));
+        write(dir + "/topology/physical_package_id", "0");
+        write(dir + "/topology/thread_siblings_list", i % 2 ? "1,3" : "0,2");
+    }
+
+    cpu_topology topo(root);
+    BOOST_CHECK_EQUAL(4u, topo.cpus().size());
+    BOOST_CHECK_EQUAL(1,  topo.packages());
+    BOOST_CHECK(topo.siblings(2)       == (std::vector<int>{0, 2}));
+    BOOST_CHECK(topo.physical_cores()  == (std::vector<int>{0, 1}));
+    BOOST_CHECK(topo.isolated()        == (std::vector<int>{3}));
+    BOOST_CHECK(topo.node_cpus(1)      == (std::vector<int>{2, 3}));
+    BOOST_REQUIRE(topo.find(3));
+    BOOST_CHECK(topo.find(3)->isolated);
+    BOOST_CHECK_EQUAL(1, topo.find(3)->core);
+    BOOST_CHECK(!topo.find(4));
+
+    BOOST_CHECK(system(("rm -rf " + root).c_str()) == 0);
+
+    // The host's topology is consistent
+    auto& host = cpu_topology::instance();
+    BOOST_CHECK(!host.cpus().empty());
+    for (auto& c : host.cpus())
+        BOOST_CHECK(std::find(c.siblings.begin(), c.siblings.end(), c.id)
+                    != c.siblings.end());
+}
@@ -246,3 +246,184 @@ BOOST_AUTO_TEST_CASE( test_persist_array_concurrent )
     }
     ::unlink(s_filename);
 }
+
+BOOST_AUTO_TEST_CASE( test_persist_array_adaptive_mutex )
+{
+    // Locks other than the default std::mutex are selected explicitly, and
+    // the file is reopened with the same Lock type
+    typedef persist_array<blob, 4, adaptive_mutex> persist_adaptive_type;
+
+    ::unlink(s_filename);
+    {
+        persist_adaptive_type a;
+        BOOST_REQUIRE(a.init(s_filename, 16, false));
+        for (int i = 0; i < 10; ++i)
+            a.add(blob(i, i));
+    }
+    {
+        persist_adaptive_type a;
+        BOOST_REQUIRE(!a.init(s_filename, 16, false));
+        BOOST_REQUIRE_EQUAL(10u, a.count());
+        BOOST_CHECK_EQUAL(9, a[9].i2);
+    }
+    ::unlink(s_filename);
+}
+
+BOOST_AUTO_TEST_CASE( test_persist_array_seqlock )
+{
+    typedef persist_array<blob, 4, persist_seqlock> persist_seq_type;
+
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 100000;
+    const int  READERS    = 2;
+    const int  RECS       = 8;
+
+    ::unlink(s_filename);
+    {
+        // Files of mutex-based arrays are not opened in the seqlock mode
+        persist_type a;
+        BOOST_REQUIRE(a.init(s_filename, RECS, false));
+    }
+    {
+        persist_seq_type a;
+        BOOST_REQUIRE_THROW(a.init(s_filename, RECS, false), utxx::runtime_error);
+    }
+    ::unlink(s_filename);
+
+    persist_seq_type a;
+    BOOST_REQUIRE(a.init(s_filename, RECS, false));
+    for (int i = 0; i < RECS; ++i)
+        BOOST_REQUIRE_EQUAL((size_t)i, a.add(blob(i, 0)));
+
+    auto& lock = a.get_lock(1);
+    auto  v    = lock.version();
+    a.update(1, [](blob& b) { b.i2 = 5; });
+    BOOST_CHECK_EQUAL(v+2, lock.version());
+    BOOST_CHECK_EQUAL(5,   a.read(1).i2);
+
+    // A single writer keeps all fields of a record equal, and readers must
+    // never observe a partially written record
+    for (int i = 0; i < RECS; ++i)
+        a.update(i, [](blob& b) { b.i2 = 0; for (auto& x : b.data) x = 0; });
+
+    std::atomic<bool> done(false);
+    std::atomic<long> torn(0), reads(0);
+    std::atomic<int>  started(0);
+    std::vector<std::thread> readers;
+    for (int n = 0; n < READERS; ++n)
+        readers.emplace_back([&] {
+            blob b;
+            long cnt = 0;
+            ++started;
+            while (!done.load(std::memory_order_relaxed)) {
+                a.read(cnt++ % RECS, b);
+                for (auto x : b.data)
+                    if (x != b.i2) { ++torn; break; }
+            }
+            reads += cnt;
+        });
+
+    while (started < READERS)
+        std::this_thread::yield();
+
+    for (long i = 1; i <= ITERATIONS; ++i)
+        a.update(i % RECS, [i](blob& b) {
+            b.i2 = i;
+            for (auto& x : b.data) x = i;
+        });
+
+    done = true;
+    for (auto& t : readers)
+        t.join();
+
+    BOOST_CHECK_EQUAL(0, torn);
+    BOOST_CHECK(reads > 0);
+    for (int i = 0; i < RECS; ++i)
+        BOOST_CHECK_EQUAL(i, a.read(i).i1);
+    BOOST_CHECK_EQUAL(ITERATIONS, a.read(ITERATIONS % RECS).i2);
+
+    // The versions of the lock stripes are reset on reopening the file
+    persist_seq_type a2;
+    BOOST_REQUIRE(!a2.init(s_filename, RECS, false));
+    BOOST_CHECK_EQUAL(0u, a2.get_lock(1).version());
+    BOOST_CHECK_EQUAL(ITERATIONS, a2.read(ITERATIONS % RECS).i2);
+
+    ::unlink(s_filename);
+}
+
+BOOST_AUTO_TEST_CASE( test_persist_array_checkpoint )
+{
+    const size_t RECS = 4096;
+    std::string  crc_file = std::string(s_filename) + ".crc";
+
+    ::unlink(s_filename);
+    ::unlink(crc_file.c_str());
+    {
+        persist_type a;
+        a.enable_checksums();
+        BOOST_REQUIRE(a.init(s_filename, RECS, false));
+        BOOST_REQUIRE(a.checksums_enabled());
+        BOOST_CHECK(a.torn_records().empty());
+
+        // Header page plus the pages of all records
+        for (size_t i = 0; i < RECS; ++i)
+            a.add(blob(i, i));
+        size_t all = a.checkpoint();
+        BOOST_CHECK(all > 1);
+        BOOST_CHECK_EQUAL(0u, a.checkpoint());
+
+        // Only the pages of modified records are written
+        a.update(10, [](blob& b) { b.i2 = 100; });
+        BOOST_CHECK_EQUAL(1u, a.checkpoint());
+        a.update(21, [](blob& b) { b.i2 = 200; });
+        {
+            persist_type::scoped_lock g(a.get_lock(20));
+            a.get(20)->i2 = 300;
+            a.mark_dirty(20);
+        }
+        BOOST_CHECK_EQUAL(1u, a.checkpoint(true));
+
+        // Simulate a crash in the middle of writing a record
+        a.get(30)->i2 = -1;
+        a.checkpoint();
+    }
+    {
+        // The checksums are validated on reopening the file
+        persist_type a;
+        a.enable_checksums();
+        BOOST_REQUIRE(!a.init(s_filename, RECS, false));
+        BOOST_REQUIRE_EQUAL(1u, a.torn_records().size());
+        BOOST_CHECK_EQUAL(30u, a.torn_records()[0]);
+        BOOST_CHECK_EQUAL(100, a[10].i2);
+        BOOST_CHECK_EQUAL(300, a[20].i2);
+
+        // Rewriting the record fixes its checksum
+        a.add(30, blob(30, 30));
+        a.checkpoint();
+    }
+    {
+        // Growing the storage grows the checksum file, and allocated
+        // records that were never written are not reported as torn
+        persist_type a;
+        a.enable_checksums();
+        BOOST_REQUIRE(!a.init(s_filename, 2*RECS, false));
+        BOOST_CHECK(a.torn_records().empty());
+        a.allocate_rec();
+        a.add(blob(1, 1));
+        a.checkpoint();
+    }
+    {
+        persist_type a;
+        a.enable_checksums();
+        BOOST_REQUIRE(!a.init(s_filename, 2*RECS, true));
+        BOOST_CHECK(a.torn_records().empty());
+        BOOST_CHECK_EQUAL(RECS+2, a.count());
+        BOOST_CHECK_EQUAL(1, a[RECS+1].i2);
+    }
+
+    // Without checksums enabled the side file is left intact
+    persist_type a;
+    a.init(s_filename, 2*RECS, false);
+    a.remove();
+    BOOST_CHECK(::access(crc_file.c_str(), F_OK) == 0);
+    ::unlink(crc_file.c_str());
+}
@@ -35,6 +35,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <iostream>
 #include <iomanip>
 #include <unistd.h>
+#include <thread>
+#include <atomic>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread.hpp>
 #ifdef UTXX_HAVE_BOOST_TIMER_TIMER_HPP
@@ -226,3 +229,77 @@ BOOST_AUTO_TEST_CASE( test_persist_blob_concurrent )
 }
 
 #endif
+
+BOOST_AUTO_TEST_CASE( test_persist_blob_versioned_copies )
+{
+    typedef persist_blob<test_blob, versioned_copies<3>> blob_type;
+
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 100000;
+
+    ::unlink(s_filename);
+    {
+        // Files of the single-copy layout are not opened in multi-copy mode
+        persist_blob<test_blob> o;
+        BOOST_REQUIRE_NO_THROW(o.init(s_filename, NULL, false));
+    }
+    {
+        blob_type o;
+        BOOST_REQUIRE_THROW(o.init(s_filename, NULL, false), utxx::runtime_error);
+    }
+    ::unlink(s_filename);
+
+    blob_type o;
+    test_blob orig(1, 2);
+    BOOST_REQUIRE(o.init(s_filename, &orig, false));
+    BOOST_CHECK_EQUAL(0u, o.generation());
+    BOOST_CHECK_EQUAL(2,  o.get().i2);
+
+    for (long i = 1; i <= 5; ++i) {
+        o.set(test_blob(i, i << 1));
+        BOOST_CHECK_EQUAL((uint64_t)i, o.generation());
+        BOOST_CHECK_EQUAL(i,      o.get().i1);
+        BOOST_CHECK_EQUAL(i << 1, o->i2);
+    }
+
+    // A reader that attached to the file sees the published copy
+    {
+        blob_type r;
+        BOOST_REQUIRE(!r.init(s_filename));
+        BOOST_CHECK_EQUAL(5, r.get().i1);
+        BOOST_CHECK_EQUAL(5u, r.generation());
+    }
+
+    // Readers never observe a copy being written
+    std::atomic<bool> done(false);
+    std::atomic<long> errors(0), reads(0);
+    std::atomic<int>  started(0);
+    std::vector<std::thread> readers;
+    for (int n = 0; n < 2; ++n)
+        readers.emplace_back([&] {
+            long cnt = 0;
+            ++started;
+            while (!done.load(std::memory_order_relaxed)) {
+                test_blob b = o.get();
+                if (b.i2 != b.i1 << 1)
+                    ++errors;
+                ++cnt;
+            }
+            reads += cnt;
+        });
+
+    while (started < 2)
+        std::this_thread::yield();
+
+    for (long i = 0; i < ITERATIONS; i++)
+        o.set(test_blob(i, i << 1));
+
+    done = true;
+    for (auto& t : readers)
+        t.join();
+
+    BOOST_CHECK_EQUAL(0, errors);
+    BOOST_CHECK(reads > 0);
+    BOOST_CHECK_EQUAL(ITERATIONS-1, o.get().i1);
+
+    ::unlink(s_filename);
+}
@@ -33,6 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/print.hpp>
 #include <utxx/time_val.hpp>
 #include <iostream>
+#include <cmath>
 
 using namespace utxx;
 
@@ -42,6 +43,7 @@ BOOST_AUTO_TEST_CASE( test_print )
 
     { std::string s = print(1);      BOOST_CHECK_EQUAL("1",     s); }
     { std::string s = print(1.0);    BOOST_CHECK_EQUAL("1.0",   s); }
+    { std::string s = print(1e20);   BOOST_CHECK_EQUAL("100000000000000000000.0", s); }
     { std::string s = print(true);   BOOST_CHECK_EQUAL("true",  s); }
     { std::string s = print('c');    BOOST_CHECK_EQUAL("c",     s); }
     { std::string s = print(false);  BOOST_CHECK_EQUAL("false", s); }
@@ -69,6 +71,60 @@ BOOST_AUTO_TEST_CASE( test_print )
     { std::string s = print(make_width<7, LEFT>(str)); BOOST_CHECK_EQUAL("xxx    ", s); }
 }
 
+BOOST_AUTO_TEST_CASE( test_print_double )
+{
+    detail::basic_buffered_print<> b;
+    b.print(1.0 / 3);
+    BOOST_CHECK_EQUAL("0.333333", b.to_string());
+    b.reset();
+    b.precision(-1);
+    b.print(1.0 / 3, ' ', 123.45, ' ', 2.5e-7, ' ', -1.0);
+    BOOST_CHECK_EQUAL("0.3333333333333333 123.45 2.5e-7 -1.0", b.to_string());
+    b.reset();
+    b.precision(2);
+    b.print(-1234567.891);
+    BOOST_CHECK_EQUAL("-1234567.89", b.to_string());
+}
+
+BOOST_AUTO_TEST_CASE( test_print_format )
+{
+    std::string str("xxx");
+
+    BOOST_CHECK_EQUAL("",              format(UTXX_FMT("")));
+    BOOST_CHECK_EQUAL("abc",           format(UTXX_FMT("abc")));
+    BOOST_CHECK_EQUAL("{abc}",         format(UTXX_FMT("{{{}}}"), "abc"));
+    BOOST_CHECK_EQUAL("1 -2 3",        format(UTXX_FMT("{} {} {}"), 1, -2l, 3u));
+    BOOST_CHECK_EQUAL("xxx|abc|c|true",format(UTXX_FMT("{}|{}|{}|{}"), str, "abc", 'c', true));
+    BOOST_CHECK_EQUAL("   12|12   |",  format(UTXX_FMT("{:5}|{:<5}|"), 12, 12));
+    BOOST_CHECK_EQUAL("abc  |  abc|",  format(UTXX_FMT("{:5}|{:>5}|"), "abc", "abc"));
+    BOOST_CHECK_EQUAL("__abc|xxx..|",  format(UTXX_FMT("{:_>5}|{:.<5}|"), "abc", str));
+    BOOST_CHECK_EQUAL("-0012|00012",   format(UTXX_FMT("{:05}|{:05d}"), -12, 12));
+    BOOST_CHECK_EQUAL("ff|FF|ffffffff",format(UTXX_FMT("{:x}|{:X}|{:x}"), 255, 255, -1));
+    BOOST_CHECK_EQUAL("0000beef",      format(UTXX_FMT("{:08x}"), 0xBEEF));
+    BOOST_CHECK_EQUAL("ab|abcdef",     format(UTXX_FMT("{:.2}|{:.9s}"), "abcdef", "abcdef"));
+    BOOST_CHECK_EQUAL("-128|255",      format(UTXX_FMT("{}|{}"), int8_t(-128), uint8_t(255)));
+    BOOST_CHECK_EQUAL("-9223372036854775808",
+                      format(UTXX_FMT("{}"), std::numeric_limits<int64_t>::min()));
+
+    // Floating point
+    BOOST_CHECK_EQUAL("0.1|1.0|1e+30", format(UTXX_FMT("{}|{}|{}"), 0.1, 1.0, 1e30));
+    BOOST_CHECK_EQUAL("2.5|2.500|3",   format(UTXX_FMT("{:.3}|{:.3f}|{:.0}"), 2.5, 2.5, 2.5));
+    BOOST_CHECK_EQUAL("  -1.50|-001.50", format(UTXX_FMT("{:7.2f}|{:07.2f}"), -1.5, -1.5));
+    BOOST_CHECK_EQUAL("123456789012345.25",
+                      format(UTXX_FMT("{:.2f}"), 123456789012345.25));
+    BOOST_CHECK_EQUAL("nan|-inf",      format(UTXX_FMT("{:.2f}|{}"), NAN, -INFINITY));
+
+    // Output longer than the internal buffer and appending to it
+    detail::basic_buffered_print<16> b;
+    b.print("x=");
+    b.format(UTXX_FMT("{:>20}|{}"), 12345, std::string(100, 'y'));
+    BOOST_CHECK_EQUAL("x=" + std::string(15, ' ') + "12345|" + std::string(100, 'y'),
+                      b.to_string());
+    b.reset();
+    b.format(UTXX_FMT("{} {}"), 1, 2);
+    b.format(UTXX_FMT("{}"), '!');
+    BOOST_CHECK_EQUAL("1 2!", b.to_string());
+}
 
 BOOST_AUTO_TEST_CASE( test_print_perf )
 {
@@ -105,5 +161,40 @@ BOOST_AUTO_TEST_CASE( test_print_perf )
     BOOST_TEST_MESSAGE(" utxx::print speed: " << fixed(double(ITERATIONS)/elapsed2, 10, 0) << " calls/s");
     BOOST_TEST_MESSAGE("    printf / print: " << fixed(elapsed1/elapsed2, 6, 4) << " times");
 
+    // Formatting of a whole line: snprintf vs. print vs. compile-time format
+    {
+        char buf[256];
+        timer tm;
+        for (int i=0; i < ITERATIONS; i++)
+            snprintf(buf, sizeof(buf), "Order %d %s %8d @ %.2f [%s]",
+                     i, "BUY", 10000, 12345.6789, "this is a test string");
+        elapsed1 = tm.elapsed();
+    }
+    {
+        detail::basic_buffered_print<> b;
+        timer tm;
+        for (int i=0; i < ITERATIONS; i++) {
+            b.reset();
+            b.print("Order ", i, ' ', "BUY", ' ', width<8, RIGHT, int>(10000),
+                    " @ ", fixed(12345.6789, 2), " [", "this is a test string", ']');
+        }
+        elapsed2 = tm.elapsed();
+    }
+    double elapsed3;
+    {
+        detail::basic_buffered_print<> b;
+        timer tm;
+        for (int i=0; i < ITERATIONS; i++) {
+            b.reset();
+            b.format(UTXX_FMT("Order {} {} {:8} @ {:.2f} [{}]"),
+                     i, "BUY", 10000, 12345.6789, "this is a test string");
+        }
+        elapsed3 = tm.elapsed();
+    }
+
+    BOOST_TEST_MESSAGE(" line snprintf: " << fixed(elapsed1 * 1e9 / ITERATIONS, 6, 1) << " ns");
+    BOOST_TEST_MESSAGE(" line print   : " << fixed(elapsed2 * 1e9 / ITERATIONS, 6, 1) << " ns");
+    BOOST_TEST_MESSAGE(" line format  : " << fixed(elapsed3 * 1e9 / ITERATIONS, 6, 1) << " ns");
+
 }
 
@@ -35,6 +35,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <utxx/test_helper.hpp>
 #include <utxx/rate_throttler.hpp>
 #include <utxx/timestamp.hpp>
+#include <boost/format.hpp>
+#include <random>
+#include <thread>
 
 using namespace utxx;
 
@@ -121,3 +124,238 @@ BOOST_AUTO_TEST_CASE( test_rate_throttler_basic )
 
     BOOST_REQUIRE_EQUAL(29.0 / 3, l_throttler.running_avg());
 }
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_gcra )
+{
+    // Same sequence as in the time spacing test above
+    auto now = time_val(2015, 6, 1, 12, 0, 0, 0);
+    gcra_throttle thr(10, 1000, now);           // Throttle 10 samples / second
+
+    BOOST_CHECK_EQUAL(100000000, thr.step_nsec());
+    BOOST_CHECK_EQUAL(10u,  thr.available(now));
+    BOOST_CHECK_EQUAL(1u,   thr.add(1, now));
+    BOOST_CHECK_EQUAL(1u,   thr.add(1, now));
+    BOOST_CHECK_EQUAL(8u,   thr.available(now));
+
+    now.add_msec(100);
+    BOOST_CHECK_EQUAL(9u,   thr.available(now));
+    BOOST_CHECK_EQUAL(5u,   thr.add(5, now));
+    BOOST_CHECK_EQUAL(4u,   thr.available(now));
+
+    // All-or-nothing
+    BOOST_CHECK(!thr.try_add(5, now));
+    BOOST_CHECK_EQUAL(4u,   thr.available(now));
+    BOOST_CHECK_EQUAL(4u,   thr.add(5, now));
+    BOOST_CHECK_EQUAL(0u,   thr.available(now));
+    BOOST_CHECK(!thr.try_add(1, now));
+    BOOST_CHECK(time_val(2015,6,1, 12,0,0, 200000) == thr.next_time(1, now));
+    BOOST_CHECK(time_val(2015,6,1, 12,0,0, 400000) == thr.next_time(3, now));
+
+    now.add_msec(100);
+    BOOST_CHECK(thr.try_add(1, now));
+
+    // Idle time doesn't accumulate more than the rate
+    now.add_sec(10);
+    BOOST_CHECK_EQUAL(10u,  thr.available(now));
+    BOOST_CHECK_EQUAL(10u,  thr.add(20, now));
+
+    // A burst followed by the sustained rate admits 2*rate-1 in a window
+    now.add_sec(10);
+    int n = 0;
+    for (int i = 0; i < 1000; ++i)
+        n += thr.add(1, now + msecs(i));
+    BOOST_CHECK_EQUAL(19, n);
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_token_bucket )
+{
+    auto now = time_val(2015, 6, 1, 12, 0, 0, 0);
+    token_bucket tb(5, 10, now);                // 5 tokens, refilled at 10/s
+
+    BOOST_CHECK_EQUAL(5u,   tb.capacity());
+    BOOST_CHECK_EQUAL(10.0, tb.rate());
+    BOOST_CHECK_EQUAL(5u,   tb.available(now));
+    BOOST_CHECK_EQUAL(5u,   tb.add(7, now));
+    BOOST_CHECK(!tb.try_add(1, now));
+    BOOST_CHECK(!tb.try_add(1, now + msecs(99)));
+    BOOST_CHECK( tb.try_add(1, now + msecs(100)));
+    BOOST_CHECK_EQUAL(2u,   tb.available(now + msecs(300)));
+    BOOST_CHECK_EQUAL(5u,   tb.available(now + secs(60)));
+
+    tb.reset(now);
+    BOOST_CHECK_EQUAL(5u,   tb.available(now));
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_gcra_threads )
+{
+    // Threads sharing a throttle admit exactly the rate in total
+    const int     THREADS = 4;
+    const int     RATE    = 10000;
+    auto          now     = time_val(2015, 6, 1, 12, 0, 0, 0);
+    gcra_throttle thr(RATE, 1000, now);
+    std::atomic<long> total(0);
+
+    auto run = [&](time_val a_now) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREADS; ++i)
+            threads.emplace_back([&] {
+                long n = 0;
+                for (int j = 0; j < RATE; ++j)
+                    n += thr.add(1 + j % 3, a_now);
+                total += n;
+            });
+        for (auto& t : threads) t.join();
+    };
+
+    run(now);
+    BOOST_CHECK_EQUAL(RATE, total);
+
+    // A quarter of the window later a quarter of the rate is available
+    total = 0;
+    run(now + msecs(250));
+    BOOST_CHECK_EQUAL(RATE / 4, total);
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_sliding_window )
+{
+    auto now = time_val(2015, 6, 1, 12, 0, 0, 0);
+    sliding_window_throttle thr(10, 1000, 10);  // 10 samples / second
+
+    BOOST_CHECK_EQUAL(10u,  thr.buckets());
+    BOOST_CHECK_EQUAL(1000, thr.window_msec());
+    BOOST_CHECK_EQUAL(10u,  thr.available(now));
+    BOOST_CHECK_EQUAL(3u,   thr.add(3, now));
+    BOOST_CHECK(!thr.try_add(8, now));
+    BOOST_CHECK_EQUAL(7u,   thr.available(now));
+    BOOST_CHECK_EQUAL(7u,   thr.add(8, now + msecs(500)));
+    BOOST_CHECK_EQUAL(0u,   thr.available(now + msecs(999)));
+    BOOST_CHECK(!thr.try_add(1, now + msecs(1000)));
+    BOOST_CHECK_EQUAL(3u,   thr.available(now + msecs(1100)));
+    BOOST_CHECK_EQUAL(10u,  thr.available(now + msecs(1600)));
+
+    // Time going backwards past a reused sub-window is refused
+    BOOST_CHECK(thr.try_add(1, now + msecs(1600)));
+    BOOST_CHECK(!thr.try_add(1, now));
+    thr.reset();
+    BOOST_CHECK_EQUAL(10u,  thr.available(now + msecs(1600)));
+
+    // One sample per msec: no window holds more than the rate
+    sliding_window_throttle sw(10, 1000, 10);
+    std::vector<time_val> admitted;
+    for (int i = 0; i < 3000; ++i)
+        if (sw.add(1, now + msecs(i)))
+            admitted.push_back(now + msecs(i));
+    BOOST_CHECK(admitted.size() >= 25);
+    for (size_t i = 0, j = 0; i < admitted.size(); ++i) {
+        while (admitted[i] - admitted[j] >= msecs(1000)) ++j;
+        BOOST_REQUIRE_LE(i - j + 1, 10u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_sliding_window_threads )
+{
+    // Threads sharing a throttle never exceed the rate
+    const int THREADS = 4;
+    const int RATE    = 10000;
+    auto      now     = time_val(2015, 6, 1, 12, 0, 0, 0);
+    sliding_window_throttle thr(RATE, 1000, 10);
+    std::atomic<long> total(0);
+
+    auto run = [&](time_val a_now) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < THREADS; ++i)
+            threads.emplace_back([&] {
+                long n = 0;
+                for (int j = 0; j < RATE; ++j)
+                    n += thr.add(1 + j % 3, a_now);
+                total += n;
+            });
+        for (auto& t : threads) t.join();
+    };
+
+    run(now);
+    BOOST_CHECK_LE(total, RATE);
+    BOOST_CHECK_GE(total, RATE * 9 / 10);
+
+    // The samples expire after a window and one sub-window
+    total = 0;
+    run(now + msecs(999));
+    BOOST_CHECK_EQUAL(0, total);
+    run(now + msecs(1100));
+    BOOST_CHECK_LE(total, RATE);
+    BOOST_CHECK_GE(total, RATE * 9 / 10);
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_token_bucket_array )
+{
+    const size_t N   = 1003;
+    auto         now = time_val(2015, 6, 1, 12, 0, 0, 0);
+    token_bucket_array arr(N, 10, 100, now);    // 10 tokens, refilled at 100/s
+
+    BOOST_CHECK_EQUAL(N, arr.size());
+    for (int i = 0; i < 10; ++i)
+        BOOST_CHECK(arr.try_acquire(7));
+    BOOST_CHECK(!arr.try_acquire(7));
+    BOOST_CHECK(!arr.try_acquire(8, 11));
+    arr.set(8, 20, 1000);
+    BOOST_CHECK(arr.try_acquire(8, 11));
+
+    // Random token counts, capacities and rates against a scalar reference
+    std::mt19937 rng(1);
+    std::vector<float> exp(N);
+    for (size_t i = 0; i < N; ++i) {
+        arr.set(i, float(rng() % 100), float(rng() % 1000));
+        arr.try_acquire(i, float(rng() % 100));
+    }
+    for (int k = 1; k <= 5; ++k) {
+        for (size_t i = 0; i < N; ++i)
+            exp[i] = std::min(arr.tokens(i) + arr.rate(i) * 0.01f, arr.capacity(i));
+        arr.refill(now + msecs(10 * k));
+        int bad = 0;
+        for (size_t i = 0; i < N; ++i)
+            if (std::abs(arr.tokens(i) - exp[i]) > 1e-3 && ++bad < 5)
+                BOOST_ERROR("Bucket " << i << ": " << arr.tokens(i) << " != " << exp[i]);
+    }
+    BOOST_CHECK(arr.last_refill() == now + msecs(50));
+
+    // Time going backwards is ignored
+    arr.refill(now);
+    BOOST_CHECK(arr.last_refill() == now + msecs(50));
+}
+
+BOOST_AUTO_TEST_CASE( test_rate_throttler_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 1000000;
+
+    auto now = time_val(2015, 6, 1, 12, 0, 0, 0);
+    long sum = 0;
+
+    auto run = [&](const char* a_name, std::function<long(time_val)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            sum += a_fun(now + usecs(i));
+        BOOST_TEST_MESSAGE((boost::format("%-24s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    time_spacing_throttle ts(100000, 1000, now);
+    gcra_throttle         gc(100000, 1000, now);
+    sliding_window_throttle sw(100000, 1000, 10);
+    basic_rate_throttler<16, 2> rt(1);
+    run("time_spacing_throttle",  [&](time_val t) { return ts.add(1, t); });
+    run("gcra_throttle",          [&](time_val t) { return gc.add(1, t); });
+    run("sliding_window_throttle",[&](time_val t) { return sw.add(1, t); });
+    run("basic_rate_throttler",   [&](time_val t) { return rt.add(t, 1); });
+
+    // Refilling 10000 buckets
+    token_bucket_array arr(10000, 100, 1000, now);
+    timer t;
+    long  n = std::max(1L, ITERATIONS / 10000);
+    for (long i = 0; i < n; ++i) {
+        arr.try_acquire(i % 10000, 50);
+        arr.refill(0.001f);
+    }
+    BOOST_TEST_MESSAGE((boost::format("%-24s: %6.1f ns/bucket") % "token_bucket_array"
+                        % (t.elapsed() * 1e9 / (n * 10000))).str());
+    BOOST_CHECK(sum != 0);
+}
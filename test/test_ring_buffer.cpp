@@ -34,6 +34,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <utxx/ring_buffer.hpp>
 #include <memory>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 namespace utxx {
 
@@ -42,10 +46,10 @@ void test(const char* a_desc, size_t a_exp_capacity, size_t a_capacity,
           void* a_memory, size_t a_mem_sz, bool a_construct = true) {
     BOOST_TEST_MESSAGE("Testing " << a_desc << " ring buffer");
 
-    std::unique_ptr<Buffer, void(*)(Buffer*&)>
+    std::unique_ptr<Buffer, void(*)(Buffer*)>
         buf(
             Buffer::create(a_capacity, a_memory, a_mem_sz, a_construct),
-            &Buffer::destroy
+            [](Buffer* p) { Buffer::destroy(p); }
         );
 
     BOOST_CHECK_EQUAL(a_exp_capacity, buf->capacity());
@@ -101,4 +105,58 @@ BOOST_AUTO_TEST_CASE( test_ring_buffer )
     delete [] p;
 }
 
+BOOST_AUTO_TEST_CASE( test_ring_buffer_recovery )
+{
+    typedef ring_buffer<int, 0, true> buf_t;
+
+    size_t n   = buf_t::memory_size(4);
+    void*  mem = ::mmap(NULL, n, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BOOST_REQUIRE(mem != MAP_FAILED);
+
+    buf_t* buf = buf_t::create(4, mem, n, true);
+    BOOST_CHECK(buf->writer_status() == peer_state::DETACHED);
+    BOOST_CHECK_EQUAL(1u, buf->attach_writer());
+    buf->add(1);
+    buf->add(2);
+    BOOST_CHECK(buf->writer_status() == peer_state::ALIVE);
+
+    // A writer in another process cannot take over a live one
+    pid_t pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+    if (pid == 0) {
+        try   { buf->attach_writer(); }
+        catch (runtime_error&) { ::_exit(0); }
+        ::_exit(1);
+    }
+    int status;
+    ::waitpid(pid, &status, 0);
+    BOOST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // ... unless forced to, after which the new writer dies
+    pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+    if (pid == 0) {
+        buf->attach_writer(true);
+        ::_exit(0);
+    }
+    ::waitpid(pid, NULL, 0);
+    BOOST_CHECK(buf->writer_status() == peer_state::DEAD);
+
+    // Re-attach to the existing buffer and resume writing
+    buf_t* buf2 = buf_t::create(4, mem, n, false);
+    BOOST_CHECK_EQUAL(2u, buf2->recover());
+    BOOST_CHECK_EQUAL(3u, buf2->writer_generation());
+    BOOST_CHECK(buf2->writer_status(1000000000) == peer_state::ALIVE);
+    buf2->add(3);
+    BOOST_CHECK_EQUAL(3, *buf2->back());
+    BOOST_CHECK_EQUAL(3u, buf2->total_count());
+
+    buf2->detach_writer();
+    BOOST_CHECK(buf2->writer_status() == peer_state::DETACHED);
+    buf_t::destroy(buf2);
+    buf_t::destroy(buf);
+    ::munmap(mem, n);
+}
+
 } // namespace utxx
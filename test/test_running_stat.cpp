@@ -33,7 +33,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <boost/test/unit_test.hpp>
 #include <boost/bind.hpp>
 #include <boost/concept_check.hpp>
+#include <boost/format.hpp>
 #include <algorithm>
+#include <random>
+#include <vector>
 #include <utxx/running_stat.hpp>
 #include <utxx/detail/mean_variance.hpp>
 #include <utxx/time_val.hpp>
@@ -412,3 +415,219 @@ BOOST_AUTO_TEST_CASE( test_running_stat_moving_average_check )
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE( test_running_stat_batch )
+{
+    std::mt19937_64                  rng(1);
+    std::normal_distribution<double> dist(0.0, 1.0);
+
+    for (size_t n : {0, 1, 3, 7, 8, 1001}) {
+        std::vector<double> v(n);
+        for (auto& x : v) x = dist(rng);
+
+        running_variance a, b;
+        running_sum      s;
+        for (auto x : v) a.add(x);
+        b.add_batch(v.data(), n);
+        s.add_batch(v.data(), n);
+
+        BOOST_REQUIRE_EQUAL(a.count(), b.count());
+        BOOST_REQUIRE_EQUAL(a.count(), s.count());
+        BOOST_CHECK_EQUAL(a.min(),  b.min());
+        BOOST_CHECK_EQUAL(a.max(),  b.max());
+        BOOST_CHECK_EQUAL(a.min(),  s.min());
+        BOOST_CHECK_EQUAL(a.max(),  s.max());
+        BOOST_CHECK_EQUAL(a.last(), b.last());
+        BOOST_CHECK_SMALL(a.sum()  - b.sum(),  1e-10);
+        BOOST_CHECK_SMALL(a.mean() - b.mean(), 1e-12);
+        BOOST_CHECK_SMALL(a.variance() - b.variance(), 1e-12);
+    }
+
+    // Integer samples
+    int num[] = {2, 4, 6, 8, 10, 12, 14, 16, 18};
+    basic_running_variance<int> iv;
+    iv.add_batch(num, 9);
+    BOOST_CHECK_EQUAL(90,   iv.sum());
+    BOOST_CHECK_EQUAL(2,    iv.min());
+    BOOST_CHECK_EQUAL(18,   iv.max());
+    BOOST_CHECK_EQUAL(detail::variance(num, *(&num+1)), iv.variance());
+
+    // Merging per-thread statistics of batches with a large offset, whose
+    // variance is lost by the naive sum of squares
+    std::vector<double> v(10000);
+    for (auto& x : v) x = 1e9 + dist(rng);
+    running_variance all, merged;
+    all.add_batch(v.data(), v.size());
+    for (size_t i = 0; i < v.size(); i += 1000) {
+        running_variance part;
+        part.add_batch(&v[i], 1000);
+        merged += part;
+    }
+    double mean = detail::mean(v.data(), v.data() + v.size()), var = 0;
+    for (auto x : v) var += (x - mean) * (x - mean);
+    var /= v.size();
+    BOOST_CHECK_CLOSE(var, all.variance(),    1e-6);
+    BOOST_CHECK_CLOSE(var, merged.variance(), 1e-6);
+    BOOST_CHECK_CLOSE(mean, merged.mean(),    1e-12);
+}
+
+BOOST_AUTO_TEST_CASE( test_running_stat_moving_variance )
+{
+    std::mt19937_64 rng(1);
+
+    // Compare against the variance of the window computed at every step
+    auto check = [&](auto& a_mv, auto a_gen, double a_eps) {
+        using T = typename std::decay<decltype(a_gen())>::type;
+        std::vector<T> v(10000);
+        for (auto& x : v) x = a_gen();
+        size_t w = a_mv.capacity();
+        for (size_t i = 0; i < v.size(); ++i) {
+            a_mv.add(v[i]);
+            size_t b = i + 1 > w ? i + 1 - w : 0, n = i + 1 - b;
+            double sum = 0, var = 0;
+            for (size_t j = b; j <= i; ++j) sum += v[j];
+            double mean = sum / n;
+            for (size_t j = b; j <= i; ++j) var += (v[j] - mean) * (v[j] - mean);
+            var /= n;
+            if (std::abs(mean - a_mv.mean()) > a_eps * (1 + std::abs(mean)) ||
+                std::abs(var  - a_mv.variance()) > a_eps * (1 + var))
+                BOOST_REQUIRE_MESSAGE(false, "Sample " << i << ": " << mean << " "
+                                      << var << " != " << a_mv.mean() << " "
+                                      << a_mv.variance());
+        }
+    };
+
+    std::normal_distribution<double> dist(100.0, 5.0);
+    basic_moving_variance<double, 16> md;
+    check(md, [&] { return dist(rng); }, 1e-9);
+    basic_moving_variance<int, 0, true> mi(64);
+    check(mi, [&] { return int(rng() % 1000); }, 1e-9);
+    BOOST_CHECK_EQUAL(64u, mi.size());
+    BOOST_CHECK(mi.minmax().first >= 0 && mi.minmax().second < 1000);
+
+    mi.clear();
+    BOOST_CHECK_EQUAL(0.0, mi.mean());
+    BOOST_CHECK_EQUAL(0.0, mi.variance());
+    int num[] = {2, 4, 6, 8};
+    mi.add_batch(num, 4);
+    BOOST_CHECK_EQUAL(5.0, mi.mean());
+    BOOST_CHECK_EQUAL(5.0, mi.variance());
+}
+
+BOOST_AUTO_TEST_CASE( test_running_stat_exp_moving_variance )
+{
+    BOOST_CHECK_THROW(exp_moving_variance(0.0), std::out_of_range);
+    BOOST_CHECK_THROW(exp_moving_variance(1.5), std::out_of_range);
+    BOOST_CHECK_EQUAL(0.1, exp_moving_variance::span_alpha(19));
+
+    exp_moving_variance e(0.5);
+    e.add(10);
+    BOOST_CHECK_EQUAL(10.0, e.mean());
+    BOOST_CHECK_EQUAL(0.0,  e.variance());
+    e.add(20);
+    BOOST_CHECK_EQUAL(15.0, e.mean());
+    BOOST_CHECK_EQUAL(25.0, e.variance());
+    e.add(15);
+    BOOST_CHECK_EQUAL(15.0, e.mean());
+    BOOST_CHECK_EQUAL(12.5, e.variance());
+    BOOST_CHECK_EQUAL(3u,   e.count());
+    BOOST_CHECK_EQUAL(15.0, e.last());
+
+    // Variance of a stationary series converges to the series variance
+    std::mt19937_64                  rng(1);
+    std::normal_distribution<double> dist(50.0, 2.0);
+    std::vector<double>              v(100000);
+    for (auto& x : v) x = dist(rng);
+    exp_moving_variance s(exp_moving_variance::span_alpha(10000));
+    s.add_batch(v.data(), v.size());
+    BOOST_CHECK_CLOSE(50.0, s.mean(),      0.5);
+    BOOST_CHECK_CLOSE(2.0,  s.deviation(), 5.0);
+
+    // The array of series matches the individual series
+    const size_t N = 1003;
+    exp_moving_variance_array        arr(N, 0.05);
+    std::vector<exp_moving_variance> ref(N, exp_moving_variance(0.05));
+    std::vector<double>              tick(N);
+    for (int k = 0; k < 100; ++k) {
+        for (size_t i = 0; i < N; ++i) {
+            tick[i] = 100.0 * i + dist(rng);
+            ref[i].add(tick[i]);
+        }
+        arr.update(tick.data());
+    }
+    BOOST_CHECK_EQUAL(100u, arr.count());
+    for (size_t i = 0; i < N; ++i) {
+        BOOST_REQUIRE_CLOSE(ref[i].mean(),     arr.mean(i),     1e-10);
+        BOOST_REQUIRE_CLOSE(ref[i].variance(), arr.variance(i), 1e-8);
+    }
+    arr.clear();
+    BOOST_CHECK_EQUAL(0u,  arr.count());
+    BOOST_CHECK_EQUAL(0.0, arr.mean(5));
+}
+
+BOOST_AUTO_TEST_CASE( test_running_stat_weighted_average_batch )
+{
+    std::mt19937_64  rng(3);
+    weighted_average w(5), b(5);
+    std::vector<size_t> secs(1000);
+    std::vector<double> vals(1000);
+    size_t now = 1000;
+    for (size_t i = 0; i < secs.size(); ++i) {
+        now    += rng() % 3;
+        secs[i] = now;
+        vals[i] = double(rng() % 1000);
+        w.calculate(secs[i], vals[i]);
+    }
+    BOOST_CHECK_EQUAL(w.last_weighted(), b.add_batch(secs.data(), vals.data(), secs.size()));
+    BOOST_CHECK_EQUAL(w.last_value(),    b.last_value());
+    BOOST_CHECK_EQUAL(w.last_weighted(), b.add_batch(secs.data(), vals.data(), 0));
+}
+
+BOOST_AUTO_TEST_CASE( test_running_stat_batch_perf )
+{
+    const long BATCH      = 1024;
+    const long ITERATIONS = (getenv("ITERATIONS")
+                          ? atoi(getenv("ITERATIONS")) : 10000000) / BATCH * BATCH;
+
+    std::mt19937_64                  rng(1);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double>              v(BATCH);
+    for (auto& x : v) x = dist(rng);
+
+    auto report = [=](const char* a_name, double a_elapsed) {
+        BOOST_TEST_MESSAGE((boost::format("%-32s: %6.2f ns/sample")
+                            % a_name % (a_elapsed * 1e9 / ITERATIONS)).str());
+    };
+
+    running_variance a, b;
+    timer t;
+    for (long i = 0; i < ITERATIONS; ++i)
+        a.add(v[i & (BATCH-1)]);
+    report("running_variance::add", t.elapsed());
+
+    t.reset();
+    for (long i = 0; i < ITERATIONS; i += BATCH)
+        b.add_batch(v.data(), BATCH);
+    report("running_variance::add_batch", t.elapsed());
+    BOOST_CHECK_CLOSE(a.variance(), b.variance(), 1e-8);
+
+    basic_moving_variance<double> mv(256);
+    t.reset();
+    for (long i = 0; i < ITERATIONS; ++i)
+        mv.add(v[i & (BATCH-1)]);
+    report("moving_variance::add (win 256)", t.elapsed());
+
+    exp_moving_variance e(0.01);
+    t.reset();
+    for (long i = 0; i < ITERATIONS; ++i)
+        e.add(v[i & (BATCH-1)]);
+    report("exp_moving_variance::add", t.elapsed());
+
+    // Thousands of instruments updated per tick
+    exp_moving_variance_array arr(BATCH, 0.01);
+    t.reset();
+    for (long i = 0; i < ITERATIONS; i += BATCH)
+        arr.update(v.data());
+    report("exp_moving_variance_array", t.elapsed());
+    BOOST_CHECK(mv.variance() > 0 && e.variance() > 0 && arr.variance(0) >= 0);
+}
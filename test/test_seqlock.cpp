@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+/// \file  test_seqlock.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for seqlock.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/seqlock.hpp>
+#include <utxx/synch.hpp>
+#include <utxx/time_val.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+
+using namespace utxx;
+
+namespace {
+    /// Best bid/offer: all fields of a consistent snapshot are equal
+    struct bbo {
+        long   bid_px, bid_qty, ask_px, ask_qty;
+        int    seqno;
+
+        explicit bbo(long n = 0)
+            : bid_px(n), bid_qty(n), ask_px(n), ask_qty(n), seqno(int(n)) {}
+
+        bool consistent() const {
+            return bid_px == bid_qty && bid_px == ask_px &&
+                   bid_px == ask_qty && bid_px == seqno;
+        }
+    };
+
+    /// One writer updates the value \a a_iterations times while \a a_readers
+    /// take snapshots.  @return number of inconsistent snapshots
+    template <class SeqLock>
+    long run_seqlock(SeqLock& a_lock, int a_readers, long a_iterations,
+                     double& a_elapsed, long& a_reads)
+    {
+        std::atomic<int>  started(0);
+        std::atomic<bool> done(false);
+        std::atomic<long> torn(0), reads(0);
+        std::vector<std::thread> threads;
+
+        for (int n = 0; n < a_readers; ++n)
+            threads.emplace_back([&] {
+                long cnt = 0, last = 0;
+                ++started;
+                while (!done.load(std::memory_order_relaxed)) {
+                    bbo v = a_lock.load();
+                    if (!v.consistent() || v.bid_px < last)
+                        ++torn;
+                    last = v.bid_px;
+                    ++cnt;
+                }
+                reads += cnt;
+            });
+
+        while (started < a_readers)
+            std::this_thread::yield();
+
+        timer t;
+        for (long i = 1; i <= a_iterations; ++i)
+            a_lock.store(bbo(i));
+        a_elapsed = t.elapsed();
+
+        done = true;
+        for (auto& th : threads)
+            th.join();
+        a_reads = reads;
+        return torn;
+    }
+
+    /// Same as run_seqlock() with the value protected by a lock
+    template <class Lock>
+    double run_locked(int a_readers, long a_iterations) {
+        Lock              lock;
+        bbo               value;
+        std::atomic<int>  started(0);
+        std::atomic<bool> done(false);
+        std::vector<std::thread> threads;
+
+        for (int n = 0; n < a_readers; ++n)
+            threads.emplace_back([&] {
+                ++started;
+                while (!done.load(std::memory_order_relaxed)) {
+                    std::lock_guard<Lock> g(lock);
+                    bbo v = value;
+                    (void)v;
+                }
+            });
+
+        while (started < a_readers)
+            std::this_thread::yield();
+
+        timer t;
+        for (long i = 1; i <= a_iterations; ++i) {
+            std::lock_guard<Lock> g(lock);
+            value = bbo(i);
+        }
+        double elapsed = t.elapsed();
+
+        done = true;
+        for (auto& th : threads)
+            th.join();
+        return elapsed;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_seqlock )
+{
+    seqlock<bbo> s;
+    BOOST_CHECK_EQUAL(0u, s.sequence());
+    BOOST_CHECK(s.load().consistent());
+    BOOST_CHECK_EQUAL(0, s.load().bid_px);
+
+    s.store(bbo(5));
+    BOOST_CHECK_EQUAL(2u, s.sequence());
+    BOOST_CHECK_EQUAL(5, s.load().ask_qty);
+
+    auto seq = s.sequence();
+    s.update([](bbo& v) { v.seqno = 10; });
+    BOOST_CHECK(s.changed(seq));
+    BOOST_CHECK_EQUAL(10, s.load().seqno);
+    BOOST_CHECK_EQUAL(5,  s.load().bid_px);
+
+    // A read overlapping with a write fails
+    bbo v;
+    s.write_lock();
+    BOOST_CHECK(!s.try_load(v));
+    s.write_unlock();
+    BOOST_CHECK(s.try_load(v));
+    BOOST_CHECK_EQUAL(10, v.seqno);
+
+    // Zero-filled shared memory is a valid seqlock
+    typedef seqlock<bbo, true> shm_seqlock;
+    void* mem = ::mmap(NULL, sizeof(shm_seqlock), PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BOOST_REQUIRE(mem != MAP_FAILED);
+    auto& shm = *static_cast<shm_seqlock*>(mem);
+    BOOST_CHECK(shm.load().consistent());
+    shm.store(bbo(7));
+    BOOST_CHECK_EQUAL(7, shm.load().bid_qty);
+    ::munmap(mem, sizeof(shm_seqlock));
+}
+
+BOOST_AUTO_TEST_CASE( test_seqlock_concurrent )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 3;
+
+    double e1, e2;
+    long   r1, r2;
+
+    seqlock<bbo> s1;
+    BOOST_CHECK_EQUAL(0, run_seqlock(s1, THREADS, ITERATIONS, e1, r1));
+    BOOST_CHECK_EQUAL(bbo(ITERATIONS).seqno, s1.load().seqno);
+
+    // Multiple writers are serialized
+    seqlock<bbo, true> s2;
+    std::thread w([&] {
+        for (long i = 0; i < ITERATIONS / 10; ++i)
+            s2.update([](bbo& v) { v = bbo(v.bid_px + 1); });
+    });
+    for (long i = 0; i < ITERATIONS / 10; ++i)
+        s2.update([](bbo& v) { v = bbo(v.bid_px + 1); });
+    w.join();
+    BOOST_CHECK(s2.load().consistent());
+    BOOST_CHECK_EQUAL(2 * (ITERATIONS / 10), s2.load().bid_px);
+
+    seqlock<bbo, true> s3;
+    BOOST_CHECK_EQUAL(0, run_seqlock(s3, THREADS, ITERATIONS, e2, r2));
+
+    double e3 = run_locked<synch::spin_lock>(THREADS, ITERATIONS);
+    double e4 = run_locked<std::mutex>(THREADS, ITERATIONS);
+
+    BOOST_TEST_MESSAGE(
+        (boost::format("seqlock             (1 writer, %d readers): %.1f ns/write, %ld reads")
+            % THREADS % (1e9 * e1 / ITERATIONS) % r1).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("seqlock multiwriter (1 writer, %d readers): %.1f ns/write, %ld reads")
+            % THREADS % (1e9 * e2 / ITERATIONS) % r2).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("spin_lock           (1 writer, %d readers): %.1f ns/write")
+            % THREADS % (1e9 * e3 / ITERATIONS)).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("std::mutex          (1 writer, %d readers): %.1f ns/write")
+            % THREADS % (1e9 * e4 / ITERATIONS)).str());
+}
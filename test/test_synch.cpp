@@ -0,0 +1,149 @@
+//----------------------------------------------------------------------------
+/// \file  test_synch.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for read-write locks in synch.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/synch.hpp>
+#include <utxx/time_val.hpp>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+using namespace utxx::synch;
+
+namespace {
+    /// Each of \a a_readers threads acquires the read lock \a a_iterations
+    /// times.  @return average time of a lock/unlock pair in nanoseconds.
+    template <class Lock>
+    double run_readers(Lock& a_lock, int a_readers, long a_iterations) {
+        std::atomic<int>  ready(0);
+        std::atomic<long> sum(0);
+        long              data = 1;
+        std::vector<std::thread> threads;
+
+        timer t;
+        for (int n = 0; n < a_readers; ++n)
+            threads.emplace_back([&] {
+                long s = 0;
+                ++ready;
+                while (ready < a_readers)
+                    std::this_thread::yield();
+                for (long i = 0; i < a_iterations; ++i) {
+                    a_lock.read_lock();
+                    s += data;
+                    a_lock.read_unlock();
+                }
+                sum += s;
+            });
+        for (auto& th : threads)
+            th.join();
+        double elapsed = t.elapsed();
+
+        BOOST_CHECK_EQUAL(a_readers * a_iterations, sum);
+        return 1e9 * elapsed / a_iterations;
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_synch_distributed_rw_lock )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 100000;
+
+    distributed_rw_lock<8> lock;
+
+    lock.read_lock();
+    BOOST_CHECK(lock.try_read_lock());
+    BOOST_CHECK(!lock.try_write_lock());
+    lock.read_unlock();
+    lock.read_unlock();
+
+    lock.write_lock();
+    BOOST_CHECK(!lock.try_read_lock());
+    BOOST_CHECK(!lock.try_write_lock());
+    lock.write_unlock();
+
+    {
+        std::unique_lock<distributed_rw_lock<8>> g(lock);
+        BOOST_CHECK(!lock.try_lock_shared());
+    }
+    BOOST_CHECK(lock.try_lock());
+    lock.unlock();
+
+    // Writers keep two counters equal, readers must never see them differ
+    long a = 0, b = 0;
+    std::atomic<bool> done(false);
+    std::atomic<long> errors(0);
+    std::vector<std::thread> threads;
+
+    for (int n = 0; n < 4; ++n)
+        threads.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                lock.read_lock();
+                if (a != b) ++errors;
+                lock.read_unlock();
+            }
+        });
+    std::vector<std::thread> writers;
+    for (int n = 0; n < 2; ++n)
+        writers.emplace_back([&] {
+            for (long i = 0; i < ITERATIONS / 10; ++i) {
+                lock.write_lock();
+                ++a; ++b;
+                lock.write_unlock();
+            }
+        });
+    for (auto& th : writers)
+        th.join();
+    done = true;
+    for (auto& th : threads)
+        th.join();
+
+    BOOST_CHECK_EQUAL(0, errors);
+    BOOST_CHECK_EQUAL(2 * (ITERATIONS / 10), a);
+}
+
+BOOST_AUTO_TEST_CASE( test_synch_rw_lock_perf )
+{
+    const long ITERATIONS  = getenv("ITERATIONS")  ? atol(getenv("ITERATIONS"))  : 100000;
+    const int  MAX_READERS = getenv("MAX_READERS") ? atoi(getenv("MAX_READERS")) : 64;
+
+    for (int readers = 1; readers <= MAX_READERS; readers *= 2) {
+        read_write_spin_lock    l1;
+        distributed_rw_lock<64> l2;
+        double t1 = run_readers(l1, readers, ITERATIONS);
+        double t2 = run_readers(l2, readers, ITERATIONS);
+
+        BOOST_TEST_MESSAGE(
+            (boost::format("%2d readers: read_write_spin_lock %6.1f ns/op, "
+                           "distributed_rw_lock %6.1f ns/op")
+                % readers % t1 % t2).str());
+    }
+}
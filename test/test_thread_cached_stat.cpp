@@ -0,0 +1,155 @@
+//----------------------------------------------------------------------------
+/// \file  test_thread_cached_stat.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for thread_cached_stat.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/thread_cached_stat.hpp>
+#include <utxx/time_val.hpp>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+
+BOOST_AUTO_TEST_CASE( test_thread_cached_stat_merge )
+{
+    // Merging partial variances gives the same result as a single pass
+    basic_running_variance<double> all, a, b;
+    for (int i = 0; i < 100; ++i) {
+        double x = (i * 37) % 101 + 0.5 * i;
+        all.add(x);
+        (i < 30 ? a : b).add(x);
+    }
+    a += b;
+    BOOST_CHECK_EQUAL(all.count(), a.count());
+    BOOST_CHECK_CLOSE(all.mean(),     a.mean(),     1e-9);
+    BOOST_CHECK_CLOSE(all.variance(), a.variance(), 1e-9);
+    BOOST_CHECK_EQUAL(all.min(),      a.min());
+    BOOST_CHECK_EQUAL(all.max(),      a.max());
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_cached_stat )
+{
+    const int  THREADS = 4;
+    const long N       = 10000;
+
+    thread_cached_gauge<long>      gauge;
+    thread_cached_variance<double> var;
+    thread_cached_histogram<>      hist(perf_histogram("latency"));
+
+    gauge.add(-5);
+    BOOST_CHECK_EQUAL(1u, gauge.read().count());
+
+    std::atomic<int>  done(0);
+    std::atomic<bool> exit(false);
+    std::vector<std::thread> threads;
+    for (int n = 0; n < THREADS; ++n)
+        threads.emplace_back([&, n] {
+            for (long i = 1; i <= N; ++i) {
+                gauge.add(i * (n+1));
+                var.add(double(i));
+                hist.add(0.000001 * (i % 100));
+            }
+            ++done;
+            while (!exit)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+
+    while (done < THREADS)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // Shards of live threads are merged on read
+    auto g = gauge.read();
+    BOOST_CHECK_EQUAL(size_t(THREADS * N + 1), g.count());
+    BOOST_CHECK_EQUAL(-5,            g.min());
+    BOOST_CHECK_EQUAL(N * THREADS,   g.max());
+    BOOST_CHECK_EQUAL(N*(N+1)/2 * (THREADS*(THREADS+1)/2) - 5, g.sum());
+
+    auto v = var.read();
+    BOOST_CHECK_EQUAL(size_t(THREADS * N), v.count());
+    BOOST_CHECK_CLOSE((N + 1) / 2.0, v.mean(), 1e-9);
+    BOOST_CHECK_CLOSE((double(N) * N - 1) / 12.0, v.variance(), 1e-6);
+
+    BOOST_CHECK_EQUAL(THREADS * N, hist.read().count());
+    BOOST_CHECK(hist.read().to_string().find("latency") != std::string::npos);
+
+    exit = true;
+    for (auto& t : threads)
+        t.join();
+
+    // Shards of exited threads are retained by the parent
+    BOOST_CHECK_EQUAL(size_t(THREADS * N + 1), gauge.read().count());
+    BOOST_CHECK_EQUAL(THREADS * N, hist.read_and_reset().count());
+    BOOST_CHECK_EQUAL(0, hist.read().count());
+
+    var.update([](basic_running_variance<double>& s) { s.add(1.0); s.add(3.0); });
+    var.reset();
+    BOOST_CHECK_EQUAL(0u, var.read().count());
+}
+
+BOOST_AUTO_TEST_CASE( test_thread_cached_stat_perf )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 4;
+
+    auto run = [&](std::function<void(long)> a_fun) {
+        std::vector<std::thread> threads;
+        timer t;
+        for (int n = 0; n < THREADS; ++n)
+            threads.emplace_back([&] {
+                for (long i = 0; i < ITERATIONS; ++i)
+                    a_fun(i);
+            });
+        for (auto& th : threads)
+            th.join();
+        return 1e9 * t.elapsed() / (THREADS * ITERATIONS);
+    };
+
+    basic_running_variance<double> shared;
+    std::mutex                     mutex;
+    thread_cached_variance<double> cached;
+
+    double t1 = run([&](long i) {
+        std::lock_guard<std::mutex> g(mutex);
+        shared.add(double(i));
+    });
+    double t2 = run([&](long i) { cached.add(double(i)); });
+
+    BOOST_CHECK_EQUAL(shared.count(), cached.read().count());
+    BOOST_CHECK_CLOSE(shared.variance(), cached.read().variance(), 1e-6);
+
+    BOOST_TEST_MESSAGE(
+        (boost::format("running_variance + mutex  (%d threads): %.1f ns/op")
+            % THREADS % t1).str());
+    BOOST_TEST_MESSAGE(
+        (boost::format("thread_cached_variance    (%d threads): %.1f ns/op")
+            % THREADS % t2).str());
+}
@@ -0,0 +1,272 @@
+//----------------------------------------------------------------------------
+/// \file  test_time_parser.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for time_parser.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/time_parser.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+using namespace utxx;
+
+namespace {
+    const char* parse_fix(time_parser& a_p, const std::string& s, time_val& tv) {
+        return a_p.parse_fix(s.c_str(), s.c_str() + s.size(), tv);
+    }
+    const char* parse_iso(time_parser& a_p, const std::string& s, time_val& tv) {
+        return a_p.parse_iso8601(s.c_str(), s.c_str() + s.size(), tv);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_fix )
+{
+    time_parser p;
+    time_val    tv;
+    std::string s = "20260315-13:45:07";
+
+    BOOST_REQUIRE(parse_fix(p, s, tv) == s.c_str() + s.size());
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 0).nanoseconds(), tv.nanoseconds());
+
+    s = "20260315-13:45:07.123";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 123000).nanoseconds(), tv.nanoseconds());
+
+    s = "20260315-13:45:07.123456";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 123456).nanoseconds(), tv.nanoseconds());
+
+    s = "20260315-13:45:07.123456789";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 123456).nanoseconds() + 789,
+                      tv.nanoseconds());
+
+    // Digits past nanoseconds are consumed and ignored
+    s = "20260315-13:45:07.1234567891|";
+    BOOST_CHECK_EQUAL(s.c_str() + s.size() - 1, parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 123456).nanoseconds() + 789,
+                      tv.nanoseconds());
+
+    // Timestamp followed by a FIX field separator
+    s = "20260315-13:45:07.5\0011=2";
+    BOOST_CHECK_EQUAL(s.c_str() + 19, parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 500000).nanoseconds(), tv.nanoseconds());
+
+    // Crossing to the next day (and a leap day) invalidates the cached midnight
+    s = "20240228-23:59:59";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2024, 2, 28, 23, 59, 59, 0).nanoseconds(), tv.nanoseconds());
+    s = "20240229-00:00:00";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2024, 2, 29, 0, 0, 0, 0).nanoseconds(), tv.nanoseconds());
+
+    // Date only and time only
+    int64_t ns;
+    s = "19700102";
+    BOOST_CHECK(p.parse_fix_date(s.c_str(), s.c_str() + s.size(), ns));
+    BOOST_CHECK_EQUAL(86400 * 1000000000L, ns);
+    s = "00:00:01.000000002";
+    BOOST_CHECK(time_parser::parse_time_of_day(s.c_str(), s.c_str() + s.size(), ns));
+    BOOST_CHECK_EQUAL(1000000002L, ns);
+
+    // Leap second
+    s = "20161231-23:59:60";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2017, 1, 1, 0, 0, 0, 0).nanoseconds(), tv.nanoseconds());
+
+    // Thread-local parser
+    s = "20260315-13:45:07";
+    BOOST_REQUIRE(parse_fix_timestamp(s.c_str(), s.c_str() + s.size(), tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 3, 15, 13, 45, 7, 0).nanoseconds(), tv.nanoseconds());
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_fresh )
+{
+    // A new parser has no cached date to match the garbage against
+    int64_t ns = -1;
+    const char zeros[8] = {0};
+    char       ones [10];
+    memset(ones, 0xff, sizeof(ones));
+    {
+        time_parser p;
+        BOOST_CHECK(!p.parse_fix_date(zeros, zeros + 8,  ns));
+        BOOST_CHECK(!p.parse_fix_date(ones,  ones  + 8,  ns));
+        BOOST_CHECK(!p.parse_iso_date(ones,  ones  + 10, ns));
+        BOOST_CHECK_EQUAL(-1, ns);
+    }
+    {
+        time_parser p;
+        time_val    tv;
+        BOOST_CHECK(!parse_fix(p, std::string(17, '\0'), tv));
+        BOOST_CHECK(!parse_iso(p, std::string(19, '\0'), tv));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_iso8601 )
+{
+    time_parser p;
+    time_val    tv;
+    auto        exp = time_val(2026, 10, 19, 8, 30, 15, 250000).nanoseconds();
+
+    for (auto s : {"2026-10-19T08:30:15.25", "2026-10-19 08:30:15.250000Z",
+                   "2026-10-19T10:30:15.25+02:00", "2026-10-19T10:30:15.25+02",
+                   "2026-10-19T03:00:15.25-0530"}) {
+        std::string str(s);
+        BOOST_CHECK_MESSAGE(parse_iso(p, str, tv) == str.c_str() + str.size(), s);
+        BOOST_CHECK_MESSAGE(exp == tv.nanoseconds(), s);
+    }
+
+    // Crossing the date boundary because of the time zone offset
+    std::string s = "2026-10-20T01:00:00+03:00";
+    BOOST_REQUIRE(parse_iso(p, s, tv));
+    BOOST_CHECK_EQUAL(time_val(2026, 10, 19, 22, 0, 0, 0).nanoseconds(), tv.nanoseconds());
+
+    s = "1999-12-31T23:59:59Z";
+    BOOST_REQUIRE(parse_iso8601(s.c_str(), s.c_str() + s.size(), tv));
+    BOOST_CHECK_EQUAL(time_val(1999, 12, 31, 23, 59, 59, 0).nanoseconds(), tv.nanoseconds());
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_errors )
+{
+    time_parser p;
+    time_val    tv;
+
+    for (auto s : {"", "20260315", "20260315-13:45", "20260315 13:45:07",
+                   "2026031513:45:07", "20261315-13:45:07", "20260015-13:45:07",
+                   "20260230-13:45:07", "20250229-13:45:07", "20260300-13:45:07",
+                   "2026031a-13:45:07", "20260315-24:00:00", "20260315-13:60:00",
+                   "20260315-13:45:61", "20260315-13-45-07", "20260315-1a:45:07",
+                   "20260315-13:45:07.", "20260315-13:45:07.x"})
+        BOOST_CHECK_MESSAGE(!parse_fix(p, s, tv), s);
+
+    // Invalid date after a valid one must not hit the cache
+    std::string s = "20260315-13:45:07";
+    BOOST_REQUIRE(parse_fix(p, s, tv));
+    s = "20260315T13:45:07";
+    BOOST_CHECK(!parse_fix(p, s, tv));
+
+    for (auto s : {"2026-10-19", "2026-10-19X08:30:15", "2026/10/19T08:30:15",
+                   "2026-13-19T08:30:15", "2026-02-29T08:30:15", "2026-10-19T08:30",
+                   "2026-10-19T08:30:15+2", "2026-10-19T08:30:15+02:", "2026-10-19T08:30:15+24",
+                   "2026-10-19T08:30:15+02:60", "2026-10-19T08:30:15.+02"})
+        BOOST_CHECK_MESSAGE(!parse_iso(p, s, tv), s);
+
+    // The parser never reads past the end of input
+    s = "20260315-13:45:07.123";
+    for (size_t n = 0; n < 17; ++n) {
+        std::string t(s, 0, n);
+        BOOST_CHECK(!parse_fix(p, t, tv));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_random )
+{
+    std::mt19937_64 rng(1);
+    time_parser     p;
+    time_val        tv;
+    char            buf[64];
+    int             ok = 0;
+
+    for (int i = 0; i < 100000; ++i, ++ok) {
+        int      y  = 1970 + rng() % 130;
+        unsigned m  = 1 + rng() % 12;
+        unsigned d  = 1 + rng() % days_in_a_month(m, is_leap(y));
+        unsigned h  = rng() % 24, mi = rng() % 60, s = rng() % 60;
+        unsigned us = rng() % 1000000;
+        auto     exp = time_val(y, m, d, h, mi, s, us).nanoseconds();
+
+        int n = sprintf(buf, "%04d%02u%02u-%02u:%02u:%02u.%06u", y, m, d, h, mi, s, us);
+        if (!parse_fix(p, std::string(buf, n), tv) || tv.nanoseconds() != exp)
+            BOOST_REQUIRE_MESSAGE(false, buf);
+
+        n = sprintf(buf, "%04d-%02u-%02uT%02u:%02u:%02u.%06uZ", y, m, d, h, mi, s, us);
+        if (!parse_iso(p, std::string(buf, n), tv) || tv.nanoseconds() != exp)
+            BOOST_REQUIRE_MESSAGE(false, buf);
+    }
+    BOOST_CHECK_EQUAL(100000, ok);
+}
+
+BOOST_AUTO_TEST_CASE( test_time_parser_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 1000000;
+
+    // A day of FIX timestamps with millisecond precision
+    std::mt19937_64          rng(1);
+    std::vector<std::string> fix, iso;
+    for (int i = 0; i < 1024; ++i) {
+        char buf[64];
+        unsigned h = 9 + i * 8 / 1024, mi = rng() % 60, s = rng() % 60, ms = rng() % 1000;
+        sprintf(buf, "20261019-%02u:%02u:%02u.%03u", h, mi, s, ms);
+        fix.push_back(buf);
+        sprintf(buf, "2026-10-19T%02u:%02u:%02u.%03uZ", h, mi, s, ms);
+        iso.push_back(buf);
+    }
+
+    time_parser p;
+    time_val    tv;
+    long        sum = 0;
+    auto run = [&](const char* a_name, std::function<void(long)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            a_fun(i & 1023);
+        BOOST_TEST_MESSAGE((boost::format("%-24s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    run("time_parser::parse_fix", [&](long i) {
+        auto& s = fix[i];
+        p.parse_fix(s.c_str(), s.c_str() + s.size(), tv);
+        sum += tv.nanoseconds();
+    });
+    run("time_parser::parse_iso", [&](long i) {
+        auto& s = iso[i];
+        p.parse_iso8601(s.c_str(), s.c_str() + s.size(), tv);
+        sum += tv.nanoseconds();
+    });
+    run("strptime+mktime_utc", [&](long i) {
+        struct tm tm;
+        auto q = strptime(fix[i].c_str(), "%Y%m%d-%H:%M:%S", &tm);
+        tv = time_val(secs(mktime_utc(&tm))) + msecs(atoi(q + 1));
+        sum += tv.nanoseconds();
+    });
+    run("sscanf+time_val", [&](long i) {
+        unsigned y, m, d, h, mi, s, ms;
+        sscanf(fix[i].c_str(), "%4u%2u%2u-%2u:%2u:%2u.%3u", &y, &m, &d, &h, &mi, &s, &ms);
+        tv = time_val(y, m, d, h, mi, s, ms * 1000);
+        sum += tv.nanoseconds();
+    });
+
+    BOOST_CHECK(sum != 0);
+}
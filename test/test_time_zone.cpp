@@ -0,0 +1,258 @@
+//----------------------------------------------------------------------------
+/// \file  test_time_zone.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for time_zone.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/time_zone.hpp>
+#include <utxx/timestamp.hpp>
+#include <utxx/path.hpp>
+#include <random>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace utxx;
+
+namespace {
+    // Set TZ for the scope of a test
+    struct tz_guard {
+        std::string m_old;
+        bool        m_set;
+        explicit tz_guard(const char* a_tz) {
+            auto old = getenv("TZ");
+            m_set    = old != nullptr;
+            if (old) m_old = old;
+            setenv("TZ", a_tz, 1);
+            tzset();
+        }
+        ~tz_guard() {
+            if (m_set) setenv("TZ", m_old.c_str(), 1);
+            else       unsetenv("TZ");
+            tzset();
+            test_timestamp::reset();
+        }
+    };
+
+    // Format a timestamp without checking the current time for day change
+    std::string fmt(time_val a_tv, stamp_type a_tp, bool a_utc = false) {
+        timestamp::buf_type buf;
+        timestamp::format(a_tp, a_tv, buf, sizeof(buf), a_utc, false, false);
+        return buf;
+    }
+
+    bool have_zone(const char* a_name) {
+        return path::file_exists(std::string("/usr/share/zoneinfo/") + a_name);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_vs_libc )
+{
+    std::mt19937_64 rng(1);
+
+    for (auto name : {"America/New_York", "Europe/London", "Australia/Sydney",
+                      "Asia/Kolkata",     "Asia/Tokyo",    "America/Sao_Paulo",
+                      "Europe/Moscow",    "America/Chicago"}) {
+        if (!have_zone(name)) {
+            BOOST_TEST_MESSAGE("Skipping missing zone " << name);
+            continue;
+        }
+        tz_guard g(name);
+        auto tz = time_zone::get(name);
+        BOOST_CHECK_EQUAL(name, tz->name());
+
+        int bad = 0;
+        for (int i = 0; i < 20000 && bad < 5; ++i) {
+            // From 1970 to 2099
+            time_t t = time_t(rng() % (130ull * 365 * 86400));
+            struct tm tm;
+            localtime_r(&t, &tm);
+            auto& tt = tz->find(t);
+            if (tt.utc_offset != tm.tm_gmtoff || tt.is_dst != (tm.tm_isdst > 0) ||
+                strcmp(tt.abbrev, tm.tm_zone)) {
+                BOOST_ERROR(name << " at " << t << ": " << tt.utc_offset << ' '
+                            << tt.abbrev << " != " << tm.tm_gmtoff << ' ' << tm.tm_zone);
+                ++bad;
+            }
+            // Round trip of local time
+            auto tv = time_val(secs(t));
+            if (tz->to_utc(tz->to_local(tv)) != tv &&
+                // Except for the repeated hour after a backward transition
+                tz->utc_offset(t - 7200) == tt.utc_offset) {
+                BOOST_ERROR(name << " round trip failed at " << t);
+                ++bad;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_new_york )
+{
+    if (!have_zone("America/New_York"))
+        return;
+
+    auto tz = time_zone::get("America/New_York");
+    BOOST_CHECK(tz == time_zone::get("America/New_York"));
+
+    // 2026-03-08 02:00 EST -> 03:00 EDT, 2026-11-01 02:00 EDT -> 01:00 EST
+    auto spring = time_val::universal_time(2026,  3, 8, 7, 0, 0, 0).sec();
+    auto fall   = time_val::universal_time(2026, 11, 1, 6, 0, 0, 0).sec();
+
+    BOOST_CHECK_EQUAL(-5*3600, tz->utc_offset(spring - 1));
+    BOOST_CHECK_EQUAL(-4*3600, tz->utc_offset(spring));
+    BOOST_CHECK_EQUAL("EST",   tz->abbrev(spring - 1));
+    BOOST_CHECK_EQUAL("EDT",   tz->abbrev(spring));
+    BOOST_CHECK_EQUAL(-4*3600, tz->utc_offset(fall - 1));
+    BOOST_CHECK_EQUAL(-5*3600, tz->utc_offset(fall));
+    BOOST_CHECK_EQUAL(spring,  tz->next_transition(spring - 3600));
+    BOOST_CHECK_EQUAL(fall,    tz->next_transition(spring));
+
+    // Skipped local time 02:30 is taken as EST, i.e. 03:30 EDT
+    auto l = time_val::universal_time(2026, 3, 8, 2, 30, 0, 0);
+    BOOST_CHECK_EQUAL(spring + 1800, tz->to_utc(l).sec());
+    // Repeated local time 01:30 resolves to its first occurrence (EDT)
+    l = time_val::universal_time(2026, 11, 1, 1, 30, 0, 0);
+    BOOST_CHECK_EQUAL(fall - 1800, tz->to_utc(l).sec());
+
+    // The day of the spring transition is 23 hours long
+    auto mid = time_val::universal_time(2026, 3, 8, 5, 0, 0, 0).sec();
+    BOOST_CHECK_EQUAL(mid + 23*3600, tz->next_midnight(mid));
+    BOOST_CHECK_EQUAL(mid + 23*3600, tz->next_midnight(spring));
+    BOOST_CHECK_EQUAL(mid,           tz->midnight(mid));
+    BOOST_CHECK_EQUAL(mid,           tz->midnight(mid + 23*3600 - 1));
+    BOOST_CHECK_EQUAL(mid + 23*3600, tz->midnight(mid + 23*3600));
+
+    // The POSIX rule gives the same transitions as tzdata after 2007
+    auto rule = time_zone::from_posix("EST5EDT,M3.2.0,M11.1.0");
+    for (time_t t = time_val::universal_time(2007, 1, 1, 0, 0, 0, 0).sec();
+                t < time_val::universal_time(2099, 1, 1, 0, 0, 0, 0).sec(); t += 3*3600)
+        if (rule->utc_offset(t) != tz->utc_offset(t)) {
+            BOOST_ERROR("Offset mismatch at " << t);
+            break;
+        }
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_posix )
+{
+    // Southern hemisphere with an explicit transition time
+    auto tz = time_zone::from_posix("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    auto t  = time_val::universal_time(2026, 1, 15, 0, 0, 0, 0).sec();
+    BOOST_CHECK_EQUAL(11*3600, tz->utc_offset(t));
+    BOOST_CHECK_EQUAL("AEDT",  tz->abbrev(t));
+    t = time_val::universal_time(2026, 7, 15, 0, 0, 0, 0).sec();
+    BOOST_CHECK_EQUAL(10*3600, tz->utc_offset(t));
+
+    // No DST, quoted abbreviation, offset with minutes
+    tz = time_zone::from_posix("<+0530>-5:30");
+    BOOST_CHECK_EQUAL(5*3600+1800, tz->utc_offset(t));
+    BOOST_CHECK_EQUAL("+0530",     tz->abbrev(t));
+    BOOST_CHECK_EQUAL(time_zone::NO_TRANSITION, tz->next_transition(t));
+
+    BOOST_CHECK_EQUAL(0, time_zone::utc().utc_offset(t));
+
+    BOOST_CHECK_THROW(time_zone::from_posix("E5"),               badarg_error);
+    BOOST_CHECK_THROW(time_zone::from_posix("EST5EDT,M13.1.0,M11.1.0"), badarg_error);
+    BOOST_CHECK_THROW(time_zone::from_posix("EST5EDT,M3.2.0"),   badarg_error);
+    BOOST_CHECK_THROW(time_zone::load("No/Such_Zone"),           io_error);
+
+    const char junk[] = "TZif2 this is not a zone file";
+    BOOST_CHECK_THROW(time_zone::from_tzif("junk", junk, sizeof(junk)), runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_timestamp )
+{
+    // The cached local offset of timestamp switches at a DST transition
+    // in the middle of the day
+    tz_guard g("EST5EDT,M3.2.0,M11.1.0");
+    BOOST_CHECK_EQUAL("EST5EDT,M3.2.0,M11.1.0", time_zone::local()->name());
+
+    auto spring = time_val::universal_time(2026, 3, 8, 7, 0, 0, 0);
+    timestamp::check_day_change(spring - secs(3600));
+    BOOST_CHECK_EQUAL(-5*3600, timestamp::utc_offset());
+    BOOST_CHECK_EQUAL("EST",   timestamp::local_timezone());
+    BOOST_CHECK_EQUAL("06:00:00", fmt(spring - secs(3600), TIME, true));
+    BOOST_CHECK_EQUAL("01:00:00", fmt(spring - secs(3600), TIME));
+
+    timestamp::check_day_change(spring + secs(1));
+    BOOST_CHECK_EQUAL(-4*3600, timestamp::utc_offset());
+    BOOST_CHECK_EQUAL("EDT",   timestamp::local_timezone());
+    BOOST_CHECK_EQUAL("03:00:01", fmt(spring + secs(1), TIME));
+    BOOST_CHECK_EQUAL("20260308-03:00:01", fmt(spring + secs(1), DATE_TIME));
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_timestamp_midnight )
+{
+    // Local midnight on the 23 and 25 hour days of DST transitions
+    tz_guard g("EST5EDT,M3.2.0,M11.1.0");
+    test_timestamp::reset();
+
+    auto mid = time_val::universal_time(2026, 3, 8, 5, 0, 0, 0);
+    timestamp::check_day_change(mid + secs(20*3600));
+    BOOST_CHECK(mid                == timestamp::local_midnight_time());
+    BOOST_CHECK(mid + secs(23*3600) == timestamp::local_next_midnight_time());
+    BOOST_CHECK_EQUAL(20*3600*1000000L,
+                      timestamp::local_usec_since_midnight(mid + secs(20*3600)));
+
+    test_timestamp::reset();
+    mid = time_val::universal_time(2026, 11, 1, 4, 0, 0, 0);
+    timestamp::check_day_change(mid + secs(24*3600));
+    BOOST_CHECK(mid                == timestamp::local_midnight_time());
+    BOOST_CHECK(mid + secs(25*3600) == timestamp::local_next_midnight_time());
+    BOOST_CHECK_EQUAL(24*3600*1000000L,
+                      timestamp::local_usec_since_midnight(mid + secs(24*3600)));
+}
+
+BOOST_AUTO_TEST_CASE( test_time_zone_speed )
+{
+    if (!have_zone("America/New_York"))
+        return;
+
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 1000000;
+
+    tz_guard g("America/New_York");
+    auto     tz  = time_zone::get("America/New_York");
+    auto     now = time_val::universal_time(2026, 10, 19, 0, 0, 0, 0).sec();
+    long     sum = 0;
+
+    auto run = [&](const char* a_name, std::function<long(time_t)> a_fun) {
+        timer t;
+        for (long i = 0; i < ITERATIONS; ++i)
+            sum += a_fun(now + i * 997 % (86400 * 365));
+        BOOST_TEST_MESSAGE((boost::format("%-22s: %6.1f ns/call")
+                            % a_name % (t.elapsed() * 1e9 / ITERATIONS)).str());
+    };
+
+    run("time_zone::utc_offset", [&](time_t t) { return tz->utc_offset(t); });
+    run("localtime_r",           [&](time_t t) {
+        struct tm tm; localtime_r(&t, &tm); return tm.tm_gmtoff;
+    });
+
+    BOOST_CHECK(sum != 0);
+}
@@ -0,0 +1,287 @@
+//----------------------------------------------------------------------------
+/// \file  test_timer_wheel.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for timer_wheel.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/timer_wheel.hpp>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace utxx;
+
+namespace {
+    const time_val START = time_val(2026, 10, 19, 0, 0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_basic )
+{
+    timer_wheel w(msecs(1), START);
+    int         fired = 0;
+    time_val    when;
+    wheel_timer t([&](wheel_timer&, time_val a_now) { ++fired; when = a_now; });
+
+    BOOST_CHECK(w.next_expiry().empty());
+    w.schedule(t, START + msecs(5));
+    BOOST_CHECK(t.active());
+    BOOST_CHECK_EQUAL(1u, w.size());
+    BOOST_CHECK(START + msecs(5) == w.next_expiry());
+
+    BOOST_CHECK_EQUAL(0u, w.advance(START + usecs(4999)));
+    BOOST_CHECK_EQUAL(0,  fired);
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(5)));
+    BOOST_CHECK_EQUAL(1,  fired);
+    BOOST_CHECK(when == START + msecs(5));
+    BOOST_CHECK(!t.active());
+    BOOST_CHECK(w.empty());
+
+    // Expiration inside a tick is rounded up to the end of the tick
+    w.schedule(t, START + usecs(7100));
+    BOOST_CHECK_EQUAL(0u, w.advance(START + usecs(7999)));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(8)));
+
+    // Expiration in the past fires on the next advance()
+    w.schedule(t, START);
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(9)));
+
+    // Cancelled timer doesn't fire
+    w.schedule_in(t, msecs(3));
+    t.cancel();
+    BOOST_CHECK(!t.active());
+    BOOST_CHECK_EQUAL(0u, w.advance(START + secs(1)));
+    BOOST_CHECK_EQUAL(3, fired);
+
+    // Destroyed timer is removed from the wheel
+    {
+        wheel_timer t2;
+        w.schedule_in(t2, msecs(3));
+        BOOST_CHECK_EQUAL(1u, w.size());
+    }
+    BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_repeating )
+{
+    timer_wheel           w(msecs(1), START);
+    std::vector<time_val> fired;
+    wheel_timer           t([&](wheel_timer&, time_val a_now) { fired.push_back(a_now); });
+
+    w.schedule(t, START + msecs(10), msecs(10));
+    BOOST_CHECK(t.repeating());
+    for (int i = 1; i <= 50; ++i)
+        w.advance(START + msecs(i));
+    BOOST_CHECK_EQUAL(5u, fired.size());
+    BOOST_CHECK(fired.back() == START + msecs(50));
+    BOOST_CHECK(t.active());
+
+    // Missed periods are skipped when advance() is called late
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(125)));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(130)));
+    BOOST_CHECK_EQUAL(0u, w.advance(START + msecs(139)));
+    BOOST_CHECK_EQUAL(7u, fired.size());
+
+    // A repeating timer may cancel itself from the handler
+    t.on_expire([&](wheel_timer& a_t, time_val) { a_t.cancel(); });
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(140)));
+    BOOST_CHECK(!t.active());
+    BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_cancel_from_handler )
+{
+    timer_wheel w(msecs(1), START);
+    wheel_timer a, b, c;
+    int         na = 0, nb = 0, nc = 0;
+
+    // Timers expiring in the same tick: the first one cancels the others
+    // and reschedules itself
+    a.on_expire([&](wheel_timer& t, time_val) {
+        ++na; b.cancel(); c.cancel(); w.schedule_in(t, msecs(1));
+    });
+    b.on_expire([&](wheel_timer&, time_val) { ++nb; });
+    c.on_expire([&](wheel_timer&, time_val) { ++nc; });
+
+    w.schedule(a, START + msecs(3));
+    w.schedule(b, START + msecs(3));
+    w.schedule(c, START + msecs(3), msecs(1));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(3)));
+    BOOST_CHECK_EQUAL(1,  na);
+    BOOST_CHECK_EQUAL(0,  nb + nc);
+    BOOST_CHECK_EQUAL(1u, w.size());
+    BOOST_CHECK_EQUAL(1u, w.advance(START + msecs(4)));
+    BOOST_CHECK_EQUAL(2,  na);
+    a.cancel();
+    BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_far )
+{
+    // Timers beyond the top level (2^32 ticks of 1us, ~71 minutes)
+    timer_wheel w(usecs(1), START);
+    wheel_timer t[4];
+    int         fired = 0;
+    for (auto& x : t)
+        x.on_expire([&](wheel_timer&, time_val) { ++fired; });
+
+    w.schedule(t[0], START + secs(10));
+    w.schedule(t[1], START + secs(3 * 3600));
+    w.schedule(t[2], START + secs(7 * 86400) + usecs(3));
+    w.schedule(t[3], START + secs(5));
+
+    BOOST_CHECK(START + secs(5) >= w.next_expiry());
+    BOOST_CHECK_EQUAL(1u, w.advance(START + secs(5)));
+    BOOST_CHECK_EQUAL(0u, w.advance(START + secs(10) - usecs(1)));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + secs(10)));
+    BOOST_CHECK_EQUAL(0u, w.advance(START + secs(3 * 3600) - usecs(1)));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + secs(3 * 3600)));
+    BOOST_CHECK_EQUAL(0u, w.advance(START + secs(7 * 86400) + usecs(2)));
+    BOOST_CHECK_EQUAL(1u, w.advance(START + secs(7 * 86400) + usecs(3)));
+    BOOST_CHECK_EQUAL(4,  fired);
+    BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_random )
+{
+    // Compare against the expected expiration tick of every timer while
+    // advancing the wheel in random steps and rescheduling timers at random
+    std::mt19937_64 rng(1);
+    const int       N = 20000;
+    timer_wheel     w(msecs(1), START);
+    std::vector<std::unique_ptr<wheel_timer>> timers(N);
+    std::vector<int64_t> due(N, -1);                    // Expected tick, -1 if inactive
+    int64_t         now   = 0;                          // Current tick
+    long            fired = 0, bad = 0;
+
+    auto delay = [&]() -> int64_t {
+        switch (rng() % 4) {
+            case 0:  return rng() % 256;
+            case 1:  return rng() % 65536;
+            case 2:  return rng() % (1 << 24);
+            default: return rng() % (1ll << 34);
+        }
+    };
+
+    for (int i = 0; i < N; ++i) {
+        timers[i].reset(new wheel_timer([&, i](wheel_timer&, time_val a_now) {
+            ++fired;
+            auto tick = (a_now - START).milliseconds();
+            if (due[i] < 0 || due[i] > tick || tick != now) {
+                if (++bad < 10)
+                    BOOST_ERROR("Timer " << i << " due at " << due[i] << " fired at " << tick);
+            }
+            due[i] = -1;
+        }));
+        due[i] = now + delay();
+        w.schedule(*timers[i], START + msecs(due[i]));
+    }
+
+    for (int step = 0; step < 20000 && !w.empty(); ++step) {
+        // Advance by a small step most of the time, occasionally jump far,
+        // and check that no timers due by the new time are left
+        now += rng() % 8 ? rng() % 64 : rng() % (1ll << 28);
+        w.advance(START + msecs(now));
+        for (int i = 0; i < 10; ++i) {
+            auto j = rng() % N;
+            if (rng() % 2) {
+                due[j] = now + 1 + delay();
+                w.schedule(*timers[j], START + msecs(due[j]));
+            } else {
+                timers[j]->cancel();
+                due[j] = -1;
+            }
+        }
+        if (step % 1000)
+            continue;
+        // next_expiry() is never later than the nearest timer
+        int64_t next = std::numeric_limits<int64_t>::max();
+        for (int i = 0; i < N; ++i) {
+            if (due[i] >= 0 && due[i] <= now && ++bad < 10)
+                BOOST_ERROR("Timer " << i << " due at " << due[i] << " not fired at " << now);
+            if (due[i] >= 0)
+                next = std::min(next, due[i]);
+        }
+        if (!w.empty() && (w.next_expiry() - START).milliseconds() > next && ++bad < 10)
+            BOOST_ERROR("Next expiry " << (w.next_expiry() - START).milliseconds()
+                        << " is after " << next);
+    }
+    size_t active = 0;
+    for (auto d : due) active += d >= 0;
+    BOOST_CHECK_EQUAL(active, w.size());
+    BOOST_CHECK_EQUAL(0, bad);
+    BOOST_CHECK(fired > N);
+    BOOST_TEST_MESSAGE("Fired " << fired << " timers");
+}
+
+BOOST_AUTO_TEST_CASE( test_timer_wheel_speed )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atoi(getenv("ITERATIONS")) : 1000000;
+    const int  N          = 100000;
+
+    std::mt19937_64          rng(1);
+    timer_wheel              w(usecs(1), START);
+    std::vector<wheel_timer> timers(N);
+    long                     fired = 0;
+    for (auto& t : timers)
+        t.on_expire([&](wheel_timer&, time_val) { ++fired; });
+
+    std::vector<time_val> delays(1024);
+    for (auto& d : delays)
+        d = usecs(rng() % 1000000);
+
+    timer t;
+    for (long i = 0; i < ITERATIONS; ++i)
+        w.schedule_in(timers[i % N], delays[i & 1023]);
+    double sched = t.elapsed();
+
+    t.reset();
+    for (long i = 0; i < ITERATIONS; ++i)
+        timers[i % N].cancel();
+    double cancel = t.elapsed();
+
+    for (long i = 0; i < N; ++i)
+        w.schedule_in(timers[i], delays[i & 1023]);
+    t.reset();
+    size_t n = 0;
+    for (auto now = START; !w.empty(); now += usecs(100))
+        n += w.advance(now);
+    double expire = t.elapsed();
+
+    BOOST_TEST_MESSAGE((boost::format("timer_wheel::schedule: %6.1f ns/call")
+                        % (sched  * 1e9 / ITERATIONS)).str());
+    BOOST_TEST_MESSAGE((boost::format("timer_wheel::cancel  : %6.1f ns/call")
+                        % (cancel * 1e9 / ITERATIONS)).str());
+    BOOST_TEST_MESSAGE((boost::format("timer_wheel::advance : %6.1f ns/timer")
+                        % (expire * 1e9 / N)).str());
+    BOOST_CHECK_EQUAL(size_t(N), n);
+    BOOST_CHECK_EQUAL(N, fired);
+}
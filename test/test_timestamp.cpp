@@ -505,7 +505,7 @@ BOOST_AUTO_TEST_CASE( test_timestamp_since_midnight )
     auto ml = timestamp::local_next_midnight_time();
 
     auto tu = time_val::universal_time(2000, 1, 3, 0, 0, 0, 0);
-    auto tl = tu + nsecs(timestamp::utc_offset_nseconds());
+    auto tl = tu - nsecs(timestamp::utc_offset_nseconds());
 
     BOOST_CHECK_EQUAL(mu.nsec(), tu.nsec());
     BOOST_CHECK_EQUAL(ml.nsec(), tl.nsec());
@@ -549,7 +549,7 @@ BOOST_AUTO_TEST_CASE( test_timestamp_since_midnight )
     ml = timestamp::local_next_midnight_time();
 
     tu = time_val::universal_time(2000, 1, 4, 0, 0, 0, 0);
-    tl = tu + nsecs(timestamp::utc_offset_nseconds());
+    tl = tu - nsecs(timestamp::utc_offset_nseconds());
 
     BOOST_CHECK_EQUAL(mu.nsec(), tu.nsec());
     BOOST_CHECK_EQUAL(ml.nsec(), tl.nsec());
@@ -559,4 +559,7 @@ BOOST_AUTO_TEST_CASE( test_timestamp_since_midnight )
 
     if (env)
         setenv("TZ", env, 1);
+    else
+        unsetenv("TZ");
+    test_timestamp::reset();
 }
@@ -0,0 +1,175 @@
+//----------------------------------------------------------------------------
+/// \file  test_tsc_clock.cpp
+//----------------------------------------------------------------------------
+/// \brief Test cases and benchmark for tsc_clock.hpp.
+//----------------------------------------------------------------------------
+// Copyright (c) 2026 Serge Aleynikov <saleyn@gmail.com>
+// Created: 2026-10-19
+//----------------------------------------------------------------------------
+/*
+***** BEGIN LICENSE BLOCK *****
+
+This file is a part of the utxx open-source project.
+
+Copyright (C) 2026 Serge Aleynikov <saleyn@gmail.com>
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+***** END LICENSE BLOCK *****
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/format.hpp>
+#include <utxx/tsc_clock.hpp>
+#include <utxx/rate_throttler.hpp>
+#include <utxx/perf_histogram.hpp>
+#include <thread>
+#include <vector>
+
+using namespace utxx;
+
+BOOST_AUTO_TEST_CASE( test_tsc_clock )
+{
+    tsc_clock clk;
+
+    if (!clk.tsc()) {
+        BOOST_TEST_MESSAGE("No invariant TSC, tsc_clock uses CLOCK_REALTIME");
+        auto diff = clk.now_ns() - tsc_clock::realtime_ns();
+        BOOST_CHECK(std::abs(diff) < 10000000);
+        return;
+    }
+
+    auto p = clk.parameters();
+    BOOST_CHECK_EQUAL(uint32_t(tsc_clock::s_shift), p.shift);
+    BOOST_CHECK(clk.frequency() > 1e8);
+
+    // The clock follows CLOCK_REALTIME after re-synchronization (the
+    // tolerances leave room for preemption on loaded machines)
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        clk.sync();
+        BOOST_CHECK_MESSAGE(std::abs(clk.last_error()) < 1000000,
+                            "error=" << clk.last_error());
+    }
+    BOOST_CHECK_EQUAL(5, clk.syncs());
+
+    auto diff = clk.now_ns() - tsc_clock::realtime_ns();
+    BOOST_CHECK_MESSAGE(std::abs(diff) < 1000000, "diff=" << diff);
+
+    // The clock is continuous across re-synchronizations
+    int64_t last = clk.now_ns();
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 10000 == 0)
+            clk.sync();
+        int64_t now = clk.now_ns();
+        BOOST_REQUIRE(now >= last);
+        last = now;
+    }
+
+    // A step larger than max_slew_ns is applied immediately
+    clk.max_slew_ns(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    clk.sync();
+    auto q = clk.parameters();
+    BOOST_CHECK(q.base_tsc > p.base_tsc);
+    BOOST_CHECK(std::abs(clk.tsc_to_ns(q.base_tsc) - q.base_ns) < 1);
+
+    BOOST_CHECK(std::abs(clk.ticks_to_ns(int64_t(clk.frequency())) - 1000000000) < 10000000);
+
+    // Background synchronization
+    clk.start_sync(std::chrono::milliseconds(1));
+    BOOST_CHECK(clk.syncing());
+    auto n = clk.syncs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    clk.stop_sync();
+    BOOST_CHECK(!clk.syncing());
+    BOOST_CHECK(clk.syncs() > n);
+}
+
+BOOST_AUTO_TEST_CASE( test_tsc_clock_source )
+{
+    BOOST_CHECK(clock_source::TSC      == parse_clock_source("tsc"));
+    BOOST_CHECK(clock_source::REALTIME == parse_clock_source("RealTime"));
+    BOOST_CHECK_THROW(parse_clock_source("abc"), badarg_error);
+    BOOST_CHECK_EQUAL("tsc", to_string(clock_source::TSC));
+
+    tsc_clock::instance();  // Calibrate before measuring
+
+    auto d1 = now_utc(clock_source::TSC)      - now_utc();
+    auto d2 = now_utc(clock_source::REALTIME) - now_utc();
+    BOOST_CHECK(std::abs(d1.microseconds()) < 10000);
+    BOOST_CHECK(std::abs(d2.microseconds()) < 10000);
+
+    // Clock policies
+    auto now = tsc_clock::now();
+    basic_time_spacing_throttle<uint32_t, tsc_clock> thr(10, 1000, now);
+    BOOST_CHECK_EQUAL(10u, thr.available(now));
+    BOOST_CHECK_EQUAL(10u, thr.add(20, now));
+    BOOST_CHECK(thr.available() < 10u);
+
+    basic_rate_throttler<4, 2, tsc_clock> rt(2);
+    BOOST_CHECK_EQUAL(1, rt.add());
+    BOOST_CHECK_EQUAL(3, rt.add(2));
+    BOOST_CHECK_EQUAL(3, rt.refresh());
+
+    perf_histogram h("tsc", perf_histogram::TSC);
+    for (int i = 0; i < 10; ++i) {
+        perf_histogram::sample s(h);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    BOOST_CHECK_EQUAL(10, h.count());
+    BOOST_CHECK(h.to_string().find("Time (min/avg/max)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( test_tsc_clock_perf )
+{
+    const long ITERATIONS = getenv("ITERATIONS") ? atol(getenv("ITERATIONS")) : 1000000;
+    const int  THREADS    = getenv("THREADS")    ? atoi(getenv("THREADS"))    : 2;
+
+    auto& clk = tsc_clock::instance();
+    clk.start_sync(std::chrono::milliseconds(10));
+
+    auto run = [=](const char* a_name, std::function<int64_t()> a_fun) {
+        std::atomic<long> errors(0);
+        std::vector<std::thread> threads;
+        timer t;
+        for (int n = 0; n < THREADS; ++n)
+            threads.emplace_back([&] {
+                int64_t last = a_fun();
+                for (long i = 0; i < ITERATIONS; ++i) {
+                    int64_t now = a_fun();
+                    if (now < last)
+                        ++errors;
+                    last = now;
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        double elapsed = t.elapsed();
+        BOOST_TEST_MESSAGE((boost::format("%-22s: %.1f ns/call (%d threads, %ld backward steps)")
+            % a_name % (1e9 * elapsed * THREADS / (ITERATIONS * THREADS)) % THREADS
+            % long(errors)).str());
+        return long(errors);
+    };
+
+    BOOST_CHECK_EQUAL(0, run("tsc_clock::now()",
+                             [] { return tsc_clock::now().nanoseconds(); }));
+    run("time_val::universal_time",
+        [] { return time_val::universal_time().nanoseconds(); });
+
+    BOOST_TEST_MESSAGE((boost::format("tsc_clock: frequency %.0f Hz, last error %ld ns")
+        % clk.frequency() % clk.last_error()).str());
+    clk.stop_sync();
+}
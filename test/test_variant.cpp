@@ -168,6 +168,13 @@ BOOST_AUTO_TEST_CASE( test_variant )
         BOOST_REQUIRE_EQUAL(variant::TYPE_DOUBLE, v.type());
         BOOST_REQUIRE_EQUAL(1.0, v.to_float()); }
 
+    {   // Doubles are printed with all significant digits
+        BOOST_REQUIRE_EQUAL("1.0",                variant(1.0).to_string());
+        BOOST_REQUIRE_EQUAL("0.1",                variant(0.1).to_string());
+        BOOST_REQUIRE_EQUAL("3.141592653589793",  variant(3.141592653589793).to_string());
+        BOOST_REQUIRE_EQUAL("1e-9",               variant(1e-9).to_string());
+    }
+
     {   variant v = variant("test");
         BOOST_REQUIRE_EQUAL(variant::TYPE_STRING, v.type());
         BOOST_REQUIRE_EQUAL("test", v.to_str());
@@ -332,6 +339,7 @@ BOOST_AUTO_TEST_CASE( test_variant_tree_parse )
         "key1 1\n"
         "key2 true\n"
         "key3 10.0\n"
+        "key31 -1.5e-7\n"
         "key4 test\n"
         "key4 \"str\"\n"
         "key5 1K\n"
@@ -349,6 +357,7 @@ BOOST_AUTO_TEST_CASE( test_variant_tree_parse )
         BOOST_REQUIRE_EQUAL(1, tree.get<int>("key1"));
         BOOST_REQUIRE_EQUAL(true, tree.get<bool>("key2"));
         BOOST_REQUIRE_EQUAL(10.0, tree.get<double>("key3"));
+        BOOST_REQUIRE_EQUAL(-1.5e-7, tree.get<double>("key31"));
         BOOST_REQUIRE_EQUAL(2u, tree.count("key4"));
         BOOST_REQUIRE_EQUAL(1024,       tree.get<int>("key5"));
         BOOST_REQUIRE_EQUAL(1048576,    tree.get<int>("key6"));